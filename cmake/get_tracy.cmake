@@ -1,6 +1,6 @@
 cmake_minimum_required(VERSION 3.20 FATAL_ERROR)
 
-option(TRACY_ENABLE OFF)
+option(TRACY_ENABLE "Instrument the samples with Tracy" OFF)
 
 # set(TRACY_MANUAL_LIFETIME ON)
 # set(TRACY_DELAYED_INIT ON)
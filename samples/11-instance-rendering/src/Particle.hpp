@@ -0,0 +1,126 @@
+#pragma once
+
+#include "common/stdafx.hpp"
+
+class Particle
+{
+public:
+    Particle();
+
+    float getLifetime() const;
+
+    float getScale() const;
+
+    glm::vec3 getPosition() const;
+
+    glm::vec3 getVelocity() const;
+
+    bool isAlive() const;
+
+    virtual glm::mat4 getModelMatrix() const;
+
+    void setLifetime(float lifetime);
+
+    void setScale(float scale);
+
+    void setPosition(glm::vec3 position);
+
+    void setVelocity(glm::vec3 velocity);
+
+    void kill();
+
+private:
+    glm::vec3 m_position;
+    glm::vec3 m_velocity;
+    float m_scale;
+    float m_lifetime;
+};
+
+template <class TParticle>
+class AbstractParticleAttributeGenerator
+{
+public:
+    virtual void generate(TParticle* particle) = 0;
+};
+
+template <class TParticle>
+class AbstractParticleEmitter
+{
+public:
+    virtual void emit(TParticle* particle) = 0;
+};
+
+template <class TParticle>
+class AbstractParticleAffector
+{
+public:
+    virtual void affect(TParticle* particle, float deltaTime) = 0;
+};
+
+template <class TParticle>
+class AbstractParticleRenderer
+{
+public:
+    virtual void beforeDraw(const std::vector<std::shared_ptr<TParticle>>& particles, glm::mat4 projectionMatrix, glm::mat4 viewMatrix) {};
+
+    virtual void draw(const std::vector<std::shared_ptr<TParticle>>& particles, glm::mat4 projectionMatrix, glm::mat4 viewMatrix) = 0;
+};
+
+template <class TParticle>
+class ParticleSystem
+{
+public:
+    ParticleSystem(
+        unsigned int amount,
+        std::unique_ptr<AbstractParticleEmitter<TParticle>> emitter,
+        std::vector<std::shared_ptr<AbstractParticleAffector<TParticle>>> affectors,
+        std::unique_ptr<AbstractParticleRenderer<TParticle>> renderer
+    ) :
+        m_amount(amount),
+        m_emitter(std::move(emitter)),
+        m_renderer(std::move(renderer)),
+        m_affectors(affectors)
+    {
+        m_particles.reserve(m_amount);
+
+        for (auto i = 0; i < m_amount; ++i)
+        {
+            m_particles.push_back(std::make_shared<TParticle>());
+        }
+    }
+
+    void update(float deltaTime)
+    {
+        PROFILE_ZONE("ParticleSystem#update");
+
+        for (auto& particle : m_particles)
+        {
+            if (!particle->isAlive())
+            {
+                m_emitter->emit(particle.get());
+                continue;
+            }
+
+            for (auto& affector : m_affectors)
+            {
+                affector->affect(particle.get(), deltaTime);
+            }
+        }
+    }
+
+    void draw(glm::mat4 projectionMatrix, glm::mat4 viewMatrix)
+    {
+        PROFILE_ZONE("ParticleSystem#draw");
+
+        m_renderer->beforeDraw(m_particles, projectionMatrix, viewMatrix);
+        m_renderer->draw(m_particles, projectionMatrix, viewMatrix);
+    }
+
+private:
+    std::vector<std::shared_ptr<TParticle>> m_particles;
+    unsigned int m_amount;
+
+    std::unique_ptr<AbstractParticleEmitter<TParticle>> m_emitter;
+    std::unique_ptr<AbstractParticleRenderer<TParticle>> m_renderer;
+    std::vector<std::shared_ptr<AbstractParticleAffector<TParticle>>> m_affectors;
+};
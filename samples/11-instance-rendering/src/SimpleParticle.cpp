@@ -0,0 +1,251 @@
+#include "SimpleParticle.hpp"
+
+SimpleParticle::SimpleParticle() :
+    Particle(), m_mass(0.0f), m_rotation(0.0f)
+{
+}
+
+float SimpleParticle::getMass() const
+{
+    return m_mass;
+}
+
+float SimpleParticle::getRotation() const
+{
+    return m_rotation;
+}
+
+glm::mat4 SimpleParticle::getModelMatrix() const
+{
+    return glm::translate(
+        glm::rotate(
+            glm::scale(glm::mat4(1.0f), glm::vec3(getScale())),
+            glm::radians(m_rotation),
+            glm::vec3(0.0f, 0.0f, 1.0f)
+        ),
+        getPosition()
+    );
+}
+
+void SimpleParticle::setMass(float mass)
+{
+    m_mass = mass;
+}
+
+void SimpleParticle::setRotation(float rotation)
+{
+    m_rotation = rotation;
+}
+
+SimpleParticleEmitter::SimpleParticleEmitter(
+    float lifetime,
+    glm::vec3 position,
+    glm::vec3 velocity,
+    float scale,
+    float mass
+) :
+    m_lifetime(lifetime),
+    m_origin(position),
+    m_velocity(velocity),
+    m_scale(scale),
+    m_mass(mass)
+{
+}
+
+void SimpleParticleEmitter::emit(SimpleParticle* particle)
+{
+    PROFILE_ZONE("SampleParticleEmitter#emit");
+
+    particle->setLifetime(m_lifetime * static_cast<float>((std::rand() % 473) / 473.0f));
+    particle->setPosition(m_origin);
+    particle->setVelocity(glm::normalize(m_velocity) * static_cast<float>((std::rand() % 439) / 439.0f));
+    particle->setMass(m_mass * static_cast<float>((std::rand() % 173) / 173.0f));
+    particle->setRotation(glm::radians(glm::pi<float>() * 0.5f));
+    particle->setScale(m_scale * static_cast<float>((std::rand() % 93) / 93.0f));
+}
+
+void SimpleParticleAffector::affect(SimpleParticle* particle, float deltaTime)
+{
+    PROFILE_ZONE("SampleParticleAffector#affect");
+
+    float speed = bezier<3>(particle->getLifetime(), 0.32f, 0.0f, 1.0f, 0.12f);
+
+    particle->setLifetime(particle->getLifetime() - deltaTime);
+    particle->setVelocity(particle->getVelocity() + speed * particle->getMass() * GRAVITY * deltaTime);
+    particle->setPosition(particle->getPosition() + particle->getVelocity() * deltaTime);
+    particle->setRotation(particle->getRotation() + 2.0f * deltaTime);
+}
+
+float SimpleParticleAffector::polynomial(unsigned int n, unsigned int i)
+{
+    static std::map<std::pair<unsigned int, unsigned int>, float> cache;
+
+    const auto key = std::make_pair(n, i);
+
+    if (cache.contains(key))
+    {
+        return cache[key];
+    }
+
+    const auto value = factorial(n) / (factorial(i) * factorial(n - i));
+
+    cache[key] = value;
+
+    return value;
+}
+
+unsigned int SimpleParticleAffector::factorial(unsigned int n)
+{
+    static std::map<unsigned int, unsigned int> cache;
+
+    if (cache.contains(n))
+    {
+        return cache[n];
+    }
+
+    if (n == 0)
+    {
+        return 1;
+    }
+
+    const auto value = n * factorial(n - 1);
+
+    cache[n] = value;
+
+    return value;
+}
+
+SimpleParticleRenderer::SimpleParticleRenderer(std::unique_ptr<Model> model, std::unique_ptr<globjects::Texture> texture) :
+    m_model(std::move(model)),
+    m_texture(std::move(texture))
+{
+    std::cout << "[INFO] Compiling particle rendering vertex shader...";
+
+    auto particleRenderingVertexShaderSource = globjects::Shader::sourceFromFile("media/particle.vert");
+    auto particleRenderingVertexShaderTemplate = globjects::Shader::applyGlobalReplacements(particleRenderingVertexShaderSource.get());
+    m_particleRenderingVertexShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_VERTEX_SHADER), particleRenderingVertexShaderTemplate.get());
+
+    if (!m_particleRenderingVertexShader->compile())
+    {
+        std::cerr << "[ERROR] Can not compile particle rendering vertex shader" << std::endl;
+        // TODO: throw an exception?
+    }
+
+    std::cout << "done" << std::endl;
+
+    std::cout << "[INFO] Compiling particle rendering fragment shader...";
+
+    auto particleRenderingFragmentShaderSource = globjects::Shader::sourceFromFile("media/particle.frag");
+    auto particleRenderingFragmentShaderTemplate = globjects::Shader::applyGlobalReplacements(particleRenderingFragmentShaderSource.get());
+    m_particleRenderingFragmentShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_FRAGMENT_SHADER), particleRenderingFragmentShaderTemplate.get());
+
+    if (!m_particleRenderingFragmentShader->compile())
+    {
+        std::cerr << "[ERROR] Can not compile particle fragment shader" << std::endl;
+        // TODO: throw an exception?
+    }
+
+    std::cout << "done" << std::endl;
+
+    std::cout << "[INFO] Linking particle rendering shaders...";
+
+    m_particleRenderingProgram = std::make_unique<globjects::Program>();
+    m_particleRenderingProgram->attach(m_particleRenderingVertexShader.get(), m_particleRenderingFragmentShader.get());
+
+    m_sharedStorageBufferObject = std::make_unique<globjects::Buffer>();
+
+    std::cout << "done" << std::endl;
+}
+
+void SimpleParticleRenderer::beforeDraw(const std::vector<std::shared_ptr<SimpleParticle>>& particles, glm::mat4 projectionMatrix, glm::mat4 viewMatrix)
+{
+    PROFILE_ZONE("SimpleParticleRenderer#beforeDraw");
+
+    std::pmr::vector<SimpleParticleData> particleData(&FrameArena::forThisThread());
+
+    generateParticleData(particles, projectionMatrix, viewMatrix, particleData);
+
+    const auto particleDataSize = static_cast<gl::GLsizeiptr>(particleData.size() * sizeof(SimpleParticleData));
+
+    m_sharedStorageBufferObject->setData(particleDataSize, particleData.data(), static_cast<gl::GLenum>(GL_DYNAMIC_COPY));
+
+    PROFILE_GPU_ALLOC(m_sharedStorageBufferObject.get(), particleDataSize, "buffers");
+}
+
+void SimpleParticleRenderer::generateParticleData(const std::vector<std::shared_ptr<SimpleParticle>>& particles, const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix, std::pmr::vector<SimpleParticleData>& particleData)
+{
+    particleData.clear();
+    particleData.reserve(particles.size());
+
+    for (auto& particle : particles)
+    {
+        glm::mat4 modelMatrix = particle->getModelMatrix();
+
+        /*
+        * reset the rotation for the particles by replacing the model matrix' top 3x3 sub-matrix, containing the rotation and scale,
+        * with the transposed top 3x3 sub-matrix of the view matrix, as per ThinMatrix' particles tutorial.
+        *
+        * this effectively makes the result of multiplication viewMatrix * modelMatrix have an identity matrix at the top 3x3 sub-matrix.
+        *
+        * hence after the multiplication we have to scale and rotate the model matrix again, this time in the "camera space", so to speak
+        * meaning the particle is already facing camera, so we can scale and rotate it relatively to itself
+        */
+        modelMatrix[0][0] = viewMatrix[0][0];
+        modelMatrix[0][1] = viewMatrix[1][0];
+        modelMatrix[0][2] = viewMatrix[2][0];
+
+        modelMatrix[1][0] = viewMatrix[0][1];
+        modelMatrix[1][1] = viewMatrix[1][1];
+        modelMatrix[1][2] = viewMatrix[2][1];
+
+        modelMatrix[2][0] = viewMatrix[0][2];
+        modelMatrix[2][1] = viewMatrix[1][2];
+        modelMatrix[2][2] = viewMatrix[2][2];
+
+        glm::mat4 modelViewMatrix = viewMatrix * modelMatrix;
+
+        glm::mat4 finalModelMatrix = glm::scale(
+            glm::rotate(
+                modelViewMatrix,
+                glm::radians(particle->getRotation()),
+                glm::vec3(0.0f, 0.0f, 1.0f)
+            ),
+            glm::vec3(particle->getScale())
+        );
+
+        auto transformationMatrix = projectionMatrix * finalModelMatrix;
+        particleData.push_back({ transformationMatrix, particle->getLifetime() });
+    }
+}
+
+void SimpleParticleRenderer::draw(const std::vector<std::shared_ptr<SimpleParticle>>& particles, glm::mat4 projectionMatrix, glm::mat4 viewMatrix)
+{
+    PROFILE_GPU_ZONE("SimpleParticleRenderer#draw");
+
+    ::glEnable(GL_BLEND);
+    ::glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    ::glDepthMask(false);
+
+    m_particleRenderingProgram->use();
+
+    m_model->bind();
+
+    m_texture->bindActive(0);
+
+    // last `3` refers to the binding point defined in the shader by passing the `binding = 3` param to `layout` definition of a uniform buffer:
+    // layout (std430, binding = 3) buffer ParticleData { Particle[] particles; };
+    m_sharedStorageBufferObject->bindBase(GL_SHADER_STORAGE_BUFFER, 3);
+
+    m_model->drawInstanced(particles.size());
+
+    m_sharedStorageBufferObject->unbind(GL_SHADER_STORAGE_BUFFER, 3);
+
+    m_texture->unbindActive(0);
+
+    m_model->unbind();
+
+    m_particleRenderingProgram->release();
+
+    ::glDisable(GL_BLEND);
+    ::glDepthMask(true);
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "common/stdafx.hpp"
+
+#include "common/Model.hpp"
+
+#include "Particle.hpp"
+
+class SimpleParticle : public Particle
+{
+public:
+    SimpleParticle();
+
+    float getMass() const;
+
+    float getRotation() const;
+
+    glm::mat4 getModelMatrix() const override;
+
+    void setMass(float mass);
+
+    void setRotation(float rotation);
+
+private:
+    float m_mass;
+    float m_rotation;
+};
+
+class SimpleParticleEmitter : public AbstractParticleEmitter<SimpleParticle>
+{
+public:
+    SimpleParticleEmitter(
+        float lifetime,
+        glm::vec3 position,
+        glm::vec3 velocity,
+        float scale,
+        float mass
+    );
+
+    void emit(SimpleParticle* particle) override;
+
+private:
+    glm::vec3 m_velocity;
+    glm::vec3 m_origin;
+    float m_lifetime;
+    float m_mass;
+    float m_scale;
+};
+
+class SimpleParticleAffector : public AbstractParticleAffector<SimpleParticle>
+{
+public:
+    const glm::vec3 GRAVITY{ 0.0f, -9.8f, 0.0f };
+
+    void affect(SimpleParticle* particle, float deltaTime) override;
+
+protected:
+    template <unsigned int splineOrder, unsigned int iteration>
+    float bezier(float t, float p_0)
+    {
+        return p_0 * std::powf(1.0f - t, static_cast<float>(splineOrder));
+    }
+
+    /*! \brief Calculate interpolated value using the Bezier curve
+    * \param splineOrder the order of the Bezier curve; 2 for quadratic, 3 for cubic, etc.
+    * \param t the parameter for the Bezier function
+    * \param args the list of points defining the Bezier curve; must be \p splineOrder + 1
+    * \return The function \f$y = B_{splineOrder}(x)\f$ applied to argument \p t
+    */
+    template <unsigned int splineOrder, unsigned int iteration = splineOrder, typename... TArgs>
+    float bezier(float t, float p_i, TArgs... args)
+    {
+        return bezier<splineOrder, iteration - 1>(t, args...);
+    }
+
+    //! Generates polynomial coefficients
+    /*!
+    * \param n total number of polynomial coefficients
+    * \param i current polynomial coefficient index
+    */
+    float polynomial(unsigned int n, unsigned int i);
+
+    unsigned int factorial(unsigned int n);
+};
+
+/*! OpenGL *requires* you to align data in the buffers to 16 bytes
+ * Since `mat4 transformationMatrix` uses 4 (cols) * 4 (rows) * 4 (bytes) = 64 bytes already andthe last member, `float lifetime`, uses only 4 bytes,
+ * we need to tell C++ to align the whole structure to blocks of 16 bytes
+ */
+struct alignas(16) SimpleParticleData
+{
+    glm::mat4 transformationMatrix;
+    float lifetime;
+};
+
+class SimpleParticleRenderer : public AbstractParticleRenderer<SimpleParticle>
+{
+public:
+    SimpleParticleRenderer(std::unique_ptr<Model> model, std::unique_ptr<globjects::Texture> texture);
+
+    // the particle data only lives until the end of the frame, in the frame arena
+    void beforeDraw(const std::vector<std::shared_ptr<SimpleParticle>>& particles, glm::mat4 projectionMatrix, glm::mat4 viewMatrix) override;
+
+    void draw(const std::vector<std::shared_ptr<SimpleParticle>>& particles, glm::mat4 projectionMatrix, glm::mat4 viewMatrix) override;
+
+    // the CPU side of beforeDraw(): camera-facing transformations of the particles, does not touch the GL state
+    static void generateParticleData(const std::vector<std::shared_ptr<SimpleParticle>>& particles, const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix, std::pmr::vector<SimpleParticleData>& particleData);
+
+private:
+    std::unique_ptr<globjects::Program> m_particleRenderingProgram;
+
+    std::unique_ptr<globjects::Buffer> m_sharedStorageBufferObject;
+
+    std::unique_ptr<globjects::Shader> m_particleRenderingVertexShader;
+    std::unique_ptr<globjects::Shader> m_particleRenderingFragmentShader;
+
+    std::unique_ptr<Model> m_model;
+    std::unique_ptr<globjects::Texture> m_texture;
+};
@@ -27,11 +27,20 @@ Mesh::Mesh(
 
 Mesh::~Mesh()
 {
+    PROFILE_GPU_FREE(m_vertexBuffer.get(), "buffers");
+    PROFILE_GPU_FREE(m_indexBuffer.get(), "buffers");
+    PROFILE_GPU_FREE(m_normalBuffer.get(), "buffers");
+    PROFILE_GPU_FREE(m_uvBuffer.get(), "buffers");
+
+    for (auto& texture : m_textures)
+    {
+        PROFILE_GPU_FREE(texture.get(), "textures");
+    }
 }
 
 std::unique_ptr<Mesh> Mesh::fromAiMesh(const aiScene* scene, aiMesh* mesh, std::vector<std::filesystem::path> materialLookupPaths)
 {
-    ZoneScopedN("Mesh::fromAiMesh");
+    PROFILE_ZONE("Mesh::fromAiMesh");
 
     std::cout << "[INFO] Creating buffer objects...";
 
@@ -85,10 +94,14 @@ std::unique_ptr<Mesh> Mesh::fromAiMesh(const aiScene* scene, aiMesh* mesh, std::
 
     vertexBuffer->setData(vertices, static_cast<gl::GLenum>(GL_STATIC_DRAW));
 
+    PROFILE_GPU_ALLOC(vertexBuffer.get(), vertices.size() * sizeof(glm::vec3), "buffers");
+
     auto indexBuffer = std::make_unique<globjects::Buffer>();
 
     indexBuffer->setData(indices, static_cast<gl::GLenum>(GL_STATIC_DRAW));
 
+    PROFILE_GPU_ALLOC(indexBuffer.get(), indices.size() * sizeof(GLuint), "buffers");
+
     auto vao = std::make_unique<globjects::VertexArray>();
 
     vao->bindElementBuffer(indexBuffer.get());
@@ -104,6 +117,8 @@ std::unique_ptr<Mesh> Mesh::fromAiMesh(const aiScene* scene, aiMesh* mesh, std::
     {
         normalBuffer->setData(normals, static_cast<gl::GLenum>(GL_STATIC_DRAW));
 
+        PROFILE_GPU_ALLOC(normalBuffer.get(), normals.size() * sizeof(glm::vec3), "buffers");
+
         vao->binding(1)->setAttribute(1);
         vao->binding(1)->setBuffer(normalBuffer.get(), 0, sizeof(glm::vec3)); // number of elements in buffer, stride, size of buffer element
         vao->binding(1)->setFormat(3, static_cast<gl::GLenum>(GL_FLOAT)); // number of data elements per buffer element (vertex), type of data
@@ -118,6 +133,8 @@ std::unique_ptr<Mesh> Mesh::fromAiMesh(const aiScene* scene, aiMesh* mesh, std::
     {
         uvBuffer->setData(uvs, static_cast<gl::GLenum>(GL_STATIC_DRAW));
 
+        PROFILE_GPU_ALLOC(uvBuffer.get(), uvs.size() * sizeof(glm::vec2), "buffers");
+
         vao->binding(2)->setAttribute(2);
         vao->binding(2)->setBuffer(uvBuffer.get(), 0, sizeof(glm::vec2)); // number of elements in buffer, stride, size of buffer element
         vao->binding(2)->setFormat(2, static_cast<gl::GLenum>(GL_FLOAT)); // number of data elements per buffer element (vertex), type of data
@@ -188,6 +205,8 @@ std::unique_ptr<Mesh> Mesh::fromAiMesh(const aiScene* scene, aiMesh* mesh, std::
                 static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
                 reinterpret_cast<const gl::GLvoid*>(textureImage.getPixelsPtr()));
 
+            PROFILE_GPU_ALLOC(texture.get(), textureImage.getSize().x * textureImage.getSize().y * 4, "textures");
+
             textures.push_back(std::move(texture));
         }
 
@@ -211,8 +230,7 @@ std::unique_ptr<Mesh> Mesh::fromAiMesh(const aiScene* scene, aiMesh* mesh, std::
 
 void Mesh::draw()
 {
-    // ZoneScopedN("Mesh#draw");
-    TracyGpuZone("Mesh#draw");
+    PROFILE_GPU_ZONE("Mesh#draw");
 
     // number of values passed = number of elements * number of vertices per element
     // in this case: 2 triangles, 3 vertex indexes per triangle
@@ -225,7 +243,7 @@ void Mesh::draw()
 
 void Mesh::drawInstanced(unsigned int instances)
 {
-    ZoneScopedN("Mesh#drawInstanced");
+    PROFILE_ZONE("Mesh#drawInstanced");
 
     m_vao->drawElementsInstanced(
         static_cast<gl::GLenum>(GL_TRIANGLES),
@@ -237,7 +255,7 @@ void Mesh::drawInstanced(unsigned int instances)
 
 void Mesh::bind()
 {
-    ZoneScopedN("Mesh#bind");
+    PROFILE_ZONE("Mesh#bind");
 
     m_vao->bind();
 
@@ -249,7 +267,7 @@ void Mesh::bind()
 
 void Mesh::unbind()
 {
-    ZoneScopedN("Mesh#unbind");
+    PROFILE_ZONE("Mesh#unbind");
 
     for (auto& texture : m_textures)
     {
@@ -12,7 +12,7 @@ Model::~Model()
 
 std::unique_ptr<Model> Model::fromAiNode(const aiScene* scene, aiNode* node, std::vector<std::filesystem::path> materialLookupPaths)
 {
-    ZoneScopedN("Model::fromAiNode");
+    PROFILE_ZONE("Model::fromAiNode");
 
     std::vector<std::unique_ptr<Mesh>> meshes;
 
@@ -23,7 +23,7 @@ std::unique_ptr<Model> Model::fromAiNode(const aiScene* scene, aiNode* node, std
 
 void Model::setTransformation(glm::mat4 transformation)
 {
-    ZoneScopedN("Model#setTransformation");
+    PROFILE_ZONE("Model#setTransformation");
 
     m_transformation = transformation;
 }
@@ -35,7 +35,7 @@ glm::mat4 Model::getTransformation() const
 
 void Model::draw()
 {
-    ZoneScopedN("Model#draw");
+    PROFILE_ZONE("Model#draw");
 
     for (auto& mesh : m_meshes)
     {
@@ -45,7 +45,7 @@ void Model::draw()
 
 void Model::drawInstanced(unsigned int instances)
 {
-    ZoneScopedN("Model#drawInstanced");
+    PROFILE_ZONE("Model#drawInstanced");
 
     for (auto& mesh : m_meshes)
     {
@@ -55,7 +55,7 @@ void Model::drawInstanced(unsigned int instances)
 
 void Model::bind()
 {
-    ZoneScopedN("Model#bind");
+    PROFILE_ZONE("Model#bind");
 
     for (auto& mesh : m_meshes)
     {
@@ -65,7 +65,7 @@ void Model::bind()
 
 void Model::unbind()
 {
-    ZoneScopedN("Model#unbind");
+    PROFILE_ZONE("Model#unbind");
 
     for (auto& mesh : m_meshes)
     {
@@ -75,7 +75,7 @@ void Model::unbind()
 
 void Model::processAiNode(const aiScene* scene, aiNode* node, std::vector<std::filesystem::path> materialLookupPaths, std::vector<std::unique_ptr<Mesh>>& meshes)
 {
-    ZoneScopedN("Model::processAiNode");
+    PROFILE_ZONE("Model::processAiNode");
 
     for (auto t = 0; t < node->mNumMeshes; ++t)
     {
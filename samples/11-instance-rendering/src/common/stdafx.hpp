@@ -2,6 +2,7 @@
 
 #include <filesystem>
 #include <iostream>
+#include <memory_resource>
 #include <random>
 #include <sstream>
 
@@ -37,10 +38,9 @@
 #include <SFML/OpenGL.hpp>
 #include <SFML/Window.hpp>
 
-#include <tracy/Tracy.hpp>
+#include <FrameArena.hpp>
+#include <Profiling.hpp>
 
 #ifdef WIN32
 using namespace gl;
 #endif
-
-#include <tracy/TracyOpenGL.hpp>
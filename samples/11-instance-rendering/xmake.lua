@@ -3,13 +3,12 @@ add_requires("glm")
 add_requires("vcpkg::globjects", { alias = "globjects" })
 add_requires("vcpkg::glbinding", { alias = "glbinding" })
 add_requires("assimp")
-add_requires("vcpkg::tracy", { alias = "tracy" })
 
 target("11-instance-rendering")
   set_languages("cxx20")
   set_kind("binary")
 
-  add_packages("sfml", "glm", "globjects", "glbinding", "assimp", "tracy")
+  add_packages("sfml", "glm", "globjects", "glbinding", "assimp")
 
   if is_plat("macosx") then
     -- this prevents "-[SFOpenGLView enableKeyRepeat]: unrecognized selector sent to instance 0x7fa5c2507970" runtime exception
@@ -19,9 +18,11 @@ target("11-instance-rendering")
     add_frameworks("Foundation", "OpenGL", "IOKit", "Cocoa", "Carbon")
   end
 
+  add_deps("frame-arena", "profiling")
+
   set_pcxxheader("src/common/stdafx.hpp")
 
-  add_files("src/main.cpp", "src/common/Mesh.cpp", "src/common/Model.cpp")
+  add_files("src/main.cpp", "src/Particle.cpp", "src/SimpleParticle.cpp", "src/common/Mesh.cpp", "src/common/Model.cpp")
   add_includedirs("src/")
 
   after_build(function (target)
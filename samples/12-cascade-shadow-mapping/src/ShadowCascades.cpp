@@ -0,0 +1,106 @@
+#include "ShadowCascades.hpp"
+
+// these vertices define view frustum in screen space coordinates
+static constexpr std::array<glm::vec3, 8> _cameraFrustumSliceCornerVertices{
+    {
+        { -1.0f, -1.0f, -1.0f }, { 1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, -1.0f }, { -1.0f, 1.0f, -1.0f },
+        { -1.0f, -1.0f, 1.0f }, { 1.0f, -1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f }, { -1.0f, 1.0f, 1.0f },
+    }
+};
+
+void ShadowCascades::update(const glm::mat4& cameraProjection, const glm::mat4& cameraView, float nearPlane, float farPlane, glm::vec3 lightDirection, const std::vector<float>& splits)
+{
+    PROFILE_FUNCTION();
+
+    m_lightViewProjectionMatrices.clear();
+    m_splitDepths.clear();
+
+    glm::mat4 proj = glm::inverse(cameraProjection * cameraView);
+
+    std::array<glm::vec3, 8> _entireFrustum{};
+
+    std::transform(
+        _cameraFrustumSliceCornerVertices.begin(),
+        _cameraFrustumSliceCornerVertices.end(),
+        _entireFrustum.begin(),
+        [proj](glm::vec3 p) {
+            glm::vec4 v = proj * glm::vec4(p, 1.0f);
+            return glm::vec3(v) / v.w;
+        }
+    );
+
+    std::array<glm::vec3, 4> _frustumEdgeDirections {};
+
+    for (auto i = 0; i < 4; ++i)
+    {
+        _frustumEdgeDirections[i] = glm::normalize(_entireFrustum[4 + i] - _entireFrustum[i]);
+    }
+
+    const float _depth = farPlane - nearPlane;
+
+    for (auto splitIdx = 1; splitIdx < splits.size(); ++splitIdx)
+    {
+        // frustum slice vertices in world space
+        std::array<glm::vec3, 8> _frustumSliceVertices;
+
+        for (auto t = 0; t < 4; ++t)
+        {
+            _frustumSliceVertices[t] = _entireFrustum[t] + _frustumEdgeDirections[t] * _depth * splits[splitIdx - 1];
+            _frustumSliceVertices[4 + t] = _entireFrustum[t] + _frustumEdgeDirections[t] * _depth * splits[splitIdx];
+        }
+
+        // TODO: also check if camera is looking towards the light
+
+        glm::vec3 _frustumSliceCenter(0.0f);
+
+        for (auto p : _frustumSliceVertices)
+        {
+            _frustumSliceCenter += p;
+        }
+
+        _frustumSliceCenter /= 8.0f;
+
+        glm::vec3 _frustumRadiusVector(0.0f);
+
+        for (auto p : _frustumSliceVertices)
+        {
+            auto v = p - _frustumSliceCenter;
+
+            if (glm::length(_frustumRadiusVector) < glm::length(v))
+            {
+                _frustumRadiusVector = v;
+            }
+        }
+
+        // calculate new light projection
+        glm::vec3 _forward = glm::normalize(lightDirection);
+        glm::vec3 _right = glm::cross(_forward, glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::vec3 _up(0.0f, 1.0f, 0.0f);
+        glm::mat4 _lightView = glm::lookAt(_frustumSliceCenter - glm::normalize(lightDirection) * glm::length(_frustumRadiusVector), _frustumSliceCenter, _up);
+
+        const float _frustumRadius = glm::length(_frustumRadiusVector);
+
+        glm::mat4 _lightProjectionViewMatrix = glm::ortho(
+            _frustumSliceCenter.x - _frustumRadius,
+            _frustumSliceCenter.x + _frustumRadius,
+            _frustumSliceCenter.y - _frustumRadius,
+            _frustumSliceCenter.y + _frustumRadius,
+            0.0f,
+            _frustumSliceCenter.z + 2.0f * _frustumRadius
+        ) * _lightView;
+
+        m_lightViewProjectionMatrices.push_back(_lightProjectionViewMatrix);
+
+        m_splitDepths.push_back(_depth * splits[splitIdx] * 0.7f);
+    }
+}
+
+const std::vector<glm::mat4>& ShadowCascades::getLightViewProjectionMatrices() const
+{
+    return m_lightViewProjectionMatrices;
+}
+
+const std::vector<float>& ShadowCascades::getSplitDepths() const
+{
+    return m_splitDepths;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "common/stdafx.hpp"
+
+/**
+ * Splits the camera frustum into slices along its depth and fits an orthographic light projection around each of them.
+ * Does not issue any GL calls.
+ */
+class ShadowCascades
+{
+public:
+    // `splits` are the fractions of the camera frustum depth, from 0 to 1 - each pair of the adjacent ones makes a cascade
+    void update(const glm::mat4& cameraProjection, const glm::mat4& cameraView, float nearPlane, float farPlane, glm::vec3 lightDirection, const std::vector<float>& splits);
+
+    const std::vector<glm::mat4>& getLightViewProjectionMatrices() const;
+
+    // distance from the camera to the far end of each cascade
+    const std::vector<float>& getSplitDepths() const;
+
+protected:
+    std::vector<glm::mat4> m_lightViewProjectionMatrices;
+    std::vector<float> m_splitDepths;
+};
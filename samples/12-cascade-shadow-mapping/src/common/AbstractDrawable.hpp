@@ -1,5 +1,7 @@
 #pragma once
 
+#include "BoundingVolume.hpp"
+
 class AbstractDrawable
 {
 public:
@@ -10,4 +12,9 @@ public:
     virtual void bind() = 0;
 
     virtual void unbind() = 0;
+
+    // bounds in the world space, with the current transformation applied
+    virtual BoundingBox getWorldBoundingBox() const = 0;
+
+    virtual BoundingSphere getWorldBoundingSphere() const = 0;
 };
@@ -37,11 +37,34 @@ AbstractMesh::AbstractMesh(
     m_uvBuffer(std::move(uvBuffer)),
     m_transformation(1.0f)
 {
+    m_boundingBox = BoundingBox::fromPoints(m_vertices);
+
+    // not the smallest sphere, but a tight enough one for the culling
+    m_boundingSphere = BoundingSphere{ .center = m_boundingBox.getCenter(), .radius = 0.0f };
+
+    for (auto& vertex : m_vertices)
+    {
+        m_boundingSphere.radius = std::max(m_boundingSphere.radius, glm::length(vertex - m_boundingSphere.center));
+    }
+
+    m_worldBoundingBox = m_boundingBox;
+}
+
+AbstractMesh::~AbstractMesh()
+{
+    PROFILE_GPU_FREE(m_vertexBuffer.get(), "buffers");
+    PROFILE_GPU_FREE(m_indexBuffer.get(), "buffers");
+    PROFILE_GPU_FREE(m_normalBuffer.get(), "buffers");
+    PROFILE_GPU_FREE(m_tangentBuffer.get(), "buffers");
+    PROFILE_GPU_FREE(m_bitangentBuffer.get(), "buffers");
+    PROFILE_GPU_FREE(m_uvBuffer.get(), "buffers");
 }
 
 void AbstractMesh::setTransformation(glm::mat4 transformation)
 {
     m_transformation = transformation;
+
+    m_worldBoundingBox = m_boundingBox.transform(m_transformation);
 }
 
 glm::mat4 AbstractMesh::getTransformation() const
@@ -49,6 +72,26 @@ glm::mat4 AbstractMesh::getTransformation() const
     return m_transformation;
 }
 
+BoundingBox AbstractMesh::getBoundingBox() const
+{
+    return m_boundingBox;
+}
+
+BoundingSphere AbstractMesh::getBoundingSphere() const
+{
+    return m_boundingSphere;
+}
+
+BoundingBox AbstractMesh::getWorldBoundingBox() const
+{
+    return m_worldBoundingBox;
+}
+
+BoundingSphere AbstractMesh::getWorldBoundingSphere() const
+{
+    return m_boundingSphere.transform(m_transformation);
+}
+
 void AbstractMesh::draw()
 {
     // number of values passed = number of elements * number of vertices per element
@@ -29,6 +29,8 @@ public:
         std::unique_ptr<globjects::Buffer> bitangentBuffer,
         std::unique_ptr<globjects::Buffer> uvBuffer);
 
+    ~AbstractMesh();
+
     void setTransformation(glm::mat4 transformation);
 
     glm::mat4 getTransformation() const;
@@ -41,6 +43,15 @@ public:
 
     void unbind() override;
 
+    // model space bounds, calculated once the mesh is built
+    BoundingBox getBoundingBox() const;
+
+    BoundingSphere getBoundingSphere() const;
+
+    BoundingBox getWorldBoundingBox() const override;
+
+    BoundingSphere getWorldBoundingSphere() const override;
+
 protected:
     std::unique_ptr<globjects::VertexArray> m_vao;
 
@@ -61,6 +72,12 @@ protected:
     std::vector<glm::vec2> m_uvs;
 
     glm::mat4 m_transformation;
+
+    BoundingBox m_boundingBox;
+    BoundingSphere m_boundingSphere;
+
+    // cached by setTransformation()
+    BoundingBox m_worldBoundingBox;
 };
 
 class AbstractMeshBuilder
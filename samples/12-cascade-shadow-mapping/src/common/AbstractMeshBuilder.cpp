@@ -116,14 +116,20 @@ AbstractMeshBuilder* AbstractMeshBuilder::setUVAttributerIndex(unsigned int uvAt
 
 std::unique_ptr<AbstractMesh> AbstractMeshBuilder::build()
 {
+    PROFILE_FUNCTION();
+
     m_vertexBuffer = std::make_unique<globjects::Buffer>();
 
     m_vertexBuffer->setData(m_vertices, static_cast<gl::GLenum>(GL_STATIC_DRAW));
 
+    PROFILE_GPU_ALLOC(m_vertexBuffer.get(), m_vertices.size() * sizeof(glm::vec3), "buffers");
+
     m_indexBuffer = std::make_unique<globjects::Buffer>();
 
     m_indexBuffer->setData(m_indices, static_cast<gl::GLenum>(GL_STATIC_DRAW));
 
+    PROFILE_GPU_ALLOC(m_indexBuffer.get(), m_indices.size() * sizeof(unsigned int), "buffers");
+
     m_vao = std::make_unique<globjects::VertexArray>();
 
     m_vao->bindElementBuffer(m_indexBuffer.get());
@@ -139,6 +145,8 @@ std::unique_ptr<AbstractMesh> AbstractMeshBuilder::build()
     {
         m_normalBuffer->setData(m_normals, static_cast<gl::GLenum>(GL_STATIC_DRAW));
 
+        PROFILE_GPU_ALLOC(m_normalBuffer.get(), m_normals.size() * sizeof(glm::vec3), "buffers");
+
         m_vao->binding(m_normalAttributeIndex)->setAttribute(m_normalAttributeIndex);
         m_vao->binding(m_normalAttributeIndex)->setBuffer(m_normalBuffer.get(), 0, sizeof(glm::vec3)); // number of elements in buffer, stride, size of buffer element
         m_vao->binding(m_normalAttributeIndex)->setFormat(3, static_cast<gl::GLenum>(GL_FLOAT)); // number of data elements per buffer element (vertex), type of data
@@ -153,6 +161,8 @@ std::unique_ptr<AbstractMesh> AbstractMeshBuilder::build()
     {
         m_uvBuffer->setData(m_uvs, static_cast<gl::GLenum>(GL_STATIC_DRAW));
 
+        PROFILE_GPU_ALLOC(m_uvBuffer.get(), m_uvs.size() * sizeof(glm::vec2), "buffers");
+
         m_vao->binding(m_uvAttributeIndex)->setAttribute(m_uvAttributeIndex);
         m_vao->binding(m_uvAttributeIndex)->setBuffer(m_uvBuffer.get(), 0, sizeof(glm::vec2)); // number of elements in buffer, stride, size of buffer element
         m_vao->binding(m_uvAttributeIndex)->setFormat(2, static_cast<gl::GLenum>(GL_FLOAT)); // number of data elements per buffer element (vertex), type of data
@@ -167,6 +177,8 @@ std::unique_ptr<AbstractMesh> AbstractMeshBuilder::build()
     {
         m_tangentBuffer->setData(m_tangents, static_cast<gl::GLenum>(GL_STATIC_DRAW));
 
+        PROFILE_GPU_ALLOC(m_tangentBuffer.get(), m_tangents.size() * sizeof(glm::vec3), "buffers");
+
         m_vao->binding(m_tangentAttributeIndex)->setAttribute(m_tangentAttributeIndex);
         m_vao->binding(m_tangentAttributeIndex)->setBuffer(m_tangentBuffer.get(), 0, sizeof(glm::vec3)); // number of elements in buffer, stride, size of buffer element
         m_vao->binding(m_tangentAttributeIndex)->setFormat(3, static_cast<gl::GLenum>(GL_FLOAT)); // number of data elements per buffer element (vertex), type of data
@@ -181,6 +193,8 @@ std::unique_ptr<AbstractMesh> AbstractMeshBuilder::build()
     {
         m_bitangentBuffer->setData(m_bitangents, static_cast<gl::GLenum>(GL_STATIC_DRAW));
 
+        PROFILE_GPU_ALLOC(m_bitangentBuffer.get(), m_bitangents.size() * sizeof(glm::vec3), "buffers");
+
         m_vao->binding(m_bitangentAttributeIndex)->setAttribute(m_bitangentAttributeIndex);
         m_vao->binding(m_bitangentAttributeIndex)->setBuffer(m_bitangentBuffer.get(), 0, sizeof(glm::vec3)); // number of elements in buffer, stride, size of buffer element
         m_vao->binding(m_bitangentAttributeIndex)->setFormat(3, static_cast<gl::GLenum>(GL_FLOAT)); // number of data elements per buffer element (vertex), type of data
@@ -7,6 +7,8 @@ AssimpModel::AssimpModel(std::vector<std::unique_ptr<AbstractMesh>> meshes) :
 
 std::unique_ptr<AssimpModel> AssimpModel::fromAiNode(const aiScene* scene, aiNode* node, std::vector<std::filesystem::path> materialLookupPaths)
 {
+    PROFILE_FUNCTION();
+
     std::vector<std::unique_ptr<AbstractMesh>> meshes;
 
     processAiNode(scene, node, materialLookupPaths, meshes);
@@ -33,6 +35,8 @@ void AssimpModel::processAiNode(const aiScene* scene, aiNode* node, std::vector<
 
 std::unique_ptr<AbstractMesh> AssimpModel::fromAiMesh(const aiScene* scene, aiMesh* mesh, std::vector<std::filesystem::path> materialLookupPaths)
 {
+    PROFILE_FUNCTION();
+
     static std::map<std::string, globjects::Texture*> s_textureCache;
 
     std::cout << "[INFO] Creating buffer objects...";
@@ -172,6 +176,8 @@ std::unique_ptr<AbstractMesh> AssimpModel::fromAiMesh(const aiScene* scene, aiMe
                 static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
                 reinterpret_cast<const gl::GLvoid*>(textureImage.getPixelsPtr()));
 
+            PROFILE_GPU_ALLOC(texture, textureImage.getSize().x * textureImage.getSize().y * 4, "textures");
+
             s_textureCache[imagePath] = texture;
 
             textures.push_back(texture);
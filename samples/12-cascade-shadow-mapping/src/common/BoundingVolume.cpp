@@ -0,0 +1,82 @@
+#include "BoundingVolume.hpp"
+
+BoundingSphere BoundingSphere::transform(const glm::mat4& transformation) const
+{
+    float scale = std::max(
+        glm::length(glm::vec3(transformation[0])),
+        std::max(glm::length(glm::vec3(transformation[1])), glm::length(glm::vec3(transformation[2]))));
+
+    return BoundingSphere{
+        .center = glm::vec3(transformation * glm::vec4(center, 1.0f)),
+        .radius = radius * scale
+    };
+}
+
+BoundingBox BoundingBox::fromPoints(const std::vector<glm::vec3>& points)
+{
+    BoundingBox box = empty();
+
+    for (auto& point : points)
+    {
+        box.min = glm::min(box.min, point);
+        box.max = glm::max(box.max, point);
+    }
+
+    return box;
+}
+
+BoundingBox BoundingBox::empty()
+{
+    return BoundingBox{
+        .min = glm::vec3(std::numeric_limits<float>::max()),
+        .max = glm::vec3(std::numeric_limits<float>::lowest())
+    };
+}
+
+glm::vec3 BoundingBox::getCenter() const
+{
+    return (min + max) * 0.5f;
+}
+
+glm::vec3 BoundingBox::getExtent() const
+{
+    return (max - min) * 0.5f;
+}
+
+bool BoundingBox::isEmpty() const
+{
+    return min.x > max.x || min.y > max.y || min.z > max.z;
+}
+
+BoundingBox BoundingBox::merge(const BoundingBox& other) const
+{
+    return BoundingBox{
+        .min = glm::min(min, other.min),
+        .max = glm::max(max, other.max)
+    };
+}
+
+BoundingBox BoundingBox::transform(const glm::mat4& transformation) const
+{
+    if (isEmpty())
+    {
+        return *this;
+    }
+
+    // J. Arvo, "Transforming axis-aligned bounding boxes": the new extent along each axis is the sum of the absolute
+    // projections of the old extents onto it
+    glm::vec3 center = glm::vec3(transformation * glm::vec4(getCenter(), 1.0f));
+
+    glm::vec3 extent = getExtent();
+    glm::vec3 newExtent(0.0f);
+
+    for (auto i = 0; i < 3; ++i)
+    {
+        newExtent += glm::abs(glm::vec3(transformation[i])) * extent[i];
+    }
+
+    return BoundingBox{
+        .min = center - newExtent,
+        .max = center + newExtent
+    };
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "stdafx.hpp"
+
+struct BoundingSphere
+{
+    glm::vec3 center;
+    float radius;
+
+    // the radius is scaled by the largest scale of the transformation
+    BoundingSphere transform(const glm::mat4& transformation) const;
+};
+
+// axis-aligned
+struct BoundingBox
+{
+    glm::vec3 min;
+    glm::vec3 max;
+
+    static BoundingBox fromPoints(const std::vector<glm::vec3>& points);
+
+    // an "inside out" box, which turns into the other one when merged with it
+    static BoundingBox empty();
+
+    glm::vec3 getCenter() const;
+
+    // half of the size
+    glm::vec3 getExtent() const;
+
+    bool isEmpty() const;
+
+    BoundingBox merge(const BoundingBox& other) const;
+
+    // the box around the transformed one - not the tightest box around the transformed geometry, but never smaller than it
+    BoundingBox transform(const glm::mat4& transformation) const;
+};
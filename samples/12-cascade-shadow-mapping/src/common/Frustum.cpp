@@ -0,0 +1,125 @@
+#include "Frustum.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define FRUSTUM_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+Frustum Frustum::fromViewProjection(const glm::mat4& viewProjection)
+{
+    // G. Gribb, K. Hartmann, "Fast extraction of viewing frustum planes from the world-view-projection matrix"
+    glm::mat4 m = glm::transpose(viewProjection);
+
+    Frustum frustum;
+
+    frustum.m_planes = {
+        m[3] + m[0],
+        m[3] - m[0],
+        m[3] + m[1],
+        m[3] - m[1],
+        m[3] + m[2],
+        m[3] - m[2]
+    };
+
+    for (auto& plane : frustum.m_planes)
+    {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    return frustum;
+}
+
+bool Frustum::intersects(const BoundingBox& box) const
+{
+    glm::vec3 center = box.getCenter();
+    glm::vec3 extent = box.getExtent();
+
+    for (auto& plane : m_planes)
+    {
+        glm::vec3 normal = glm::vec3(plane);
+
+        // the box is completely behind the plane if even its corner farthest along the normal is
+        if (glm::dot(normal, center) + plane.w + glm::dot(glm::abs(normal), extent) < 0.0f)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Frustum::intersects(const BoundingSphere& sphere) const
+{
+    for (auto& plane : m_planes)
+    {
+        if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Frustum::markVisible(const std::vector<BoundingBox>& boxes, std::vector<std::uint8_t>& visibility) const
+{
+    visibility.resize(boxes.size(), 0);
+
+    size_t i = 0;
+
+#ifdef FRUSTUM_USE_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    for (; i + 4 <= boxes.size(); i += 4)
+    {
+        const BoundingBox& a = boxes[i];
+        const BoundingBox& b = boxes[i + 1];
+        const BoundingBox& c = boxes[i + 2];
+        const BoundingBox& d = boxes[i + 3];
+
+        // four boxes, one per lane
+        __m128 minX = _mm_setr_ps(a.min.x, b.min.x, c.min.x, d.min.x);
+        __m128 minY = _mm_setr_ps(a.min.y, b.min.y, c.min.y, d.min.y);
+        __m128 minZ = _mm_setr_ps(a.min.z, b.min.z, c.min.z, d.min.z);
+        __m128 maxX = _mm_setr_ps(a.max.x, b.max.x, c.max.x, d.max.x);
+        __m128 maxY = _mm_setr_ps(a.max.y, b.max.y, c.max.y, d.max.y);
+        __m128 maxZ = _mm_setr_ps(a.max.z, b.max.z, c.max.z, d.max.z);
+
+        __m128 centerX = _mm_mul_ps(_mm_add_ps(minX, maxX), half);
+        __m128 centerY = _mm_mul_ps(_mm_add_ps(minY, maxY), half);
+        __m128 centerZ = _mm_mul_ps(_mm_add_ps(minZ, maxZ), half);
+        __m128 extentX = _mm_mul_ps(_mm_sub_ps(maxX, minX), half);
+        __m128 extentY = _mm_mul_ps(_mm_sub_ps(maxY, minY), half);
+        __m128 extentZ = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+
+        // lanes of the boxes completely behind any of the planes
+        __m128 outside = _mm_setzero_ps();
+
+        for (auto& plane : m_planes)
+        {
+            __m128 distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(centerX, _mm_set1_ps(plane.x)), _mm_mul_ps(centerY, _mm_set1_ps(plane.y))),
+                _mm_add_ps(_mm_mul_ps(centerZ, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+
+            __m128 radius = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(extentX, _mm_set1_ps(std::abs(plane.x))), _mm_mul_ps(extentY, _mm_set1_ps(std::abs(plane.y)))),
+                _mm_mul_ps(extentZ, _mm_set1_ps(std::abs(plane.z))));
+
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+        }
+
+        int outsideMask = _mm_movemask_ps(outside);
+
+        for (auto t = 0; t < 4; ++t)
+        {
+            visibility[i + t] |= ((outsideMask >> t) & 1) ^ 1;
+        }
+    }
+#endif
+
+    for (; i < boxes.size(); ++i)
+    {
+        visibility[i] |= intersects(boxes[i]) ? 1 : 0;
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "stdafx.hpp"
+
+#include "BoundingVolume.hpp"
+
+class Frustum
+{
+public:
+    // planes of the clip space volume of `viewProjection` in the space it is applied to (world space for projection * view)
+    static Frustum fromViewProjection(const glm::mat4& viewProjection);
+
+    bool intersects(const BoundingBox& box) const;
+
+    bool intersects(const BoundingSphere& sphere) const;
+
+    /*
+     * Tests all the boxes at once, four at a time with SSE when it is available. Sets `visibility[i]` to 1 for each box
+     * intersecting the frustum and leaves the rest as they are - so testing the same boxes against a few frusta
+     * (e.g. all the shadow cascades) gives the boxes visible in any of them.
+     *
+     * Conservative: a box near a corner of the frustum might be reported visible even if it is completely outside.
+     */
+    void markVisible(const std::vector<BoundingBox>& boxes, std::vector<std::uint8_t>& visibility) const;
+
+protected:
+    // left, right, bottom, top, near, far; xyz is the normal pointing inside, w is the distance
+    std::array<glm::vec4, 6> m_planes;
+};
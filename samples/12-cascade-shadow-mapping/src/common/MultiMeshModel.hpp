@@ -4,6 +4,7 @@
 
 #include "AbstractDrawable.hpp"
 #include "AbstractMesh.hpp"
+#include "Frustum.hpp"
 
 class MultiMeshModel : public AbstractDrawable
 {
@@ -12,6 +13,9 @@ public:
 
     void draw() override;
 
+    // only draws the meshes intersecting any of the frusta - e.g. the camera one or all the shadow cascades
+    void draw(std::span<const Frustum> frusta);
+
     void drawInstanced(unsigned int instances) override;
 
     void bind() override;
@@ -22,7 +26,24 @@ public:
 
     glm::mat4 getTransformation() const;
 
+    // model space, all the meshes together
+    BoundingBox getBoundingBox() const;
+
+    BoundingBox getWorldBoundingBox() const override;
+
+    BoundingSphere getWorldBoundingSphere() const override;
+
 protected:
     std::vector<std::unique_ptr<AbstractMesh>> m_meshes;
     glm::mat4 m_transformation;
+
+    BoundingBox m_boundingBox;
+    BoundingSphere m_boundingSphere;
+
+    // cached by setTransformation(), the whole model and each of its meshes
+    BoundingBox m_worldBoundingBox;
+    std::vector<BoundingBox> m_meshWorldBoundingBoxes;
+
+    // for the frustum tests, not to allocate it on every draw
+    std::vector<std::uint8_t> m_meshVisibility;
 };
@@ -3,6 +3,23 @@
 MultiMeshModel::MultiMeshModel(std::vector<std::unique_ptr<AbstractMesh>> meshes) :
     m_meshes(std::move(meshes)), m_transformation(1.0f)
 {
+    m_boundingBox = BoundingBox::empty();
+
+    for (auto& mesh : m_meshes)
+    {
+        m_boundingBox = m_boundingBox.merge(mesh->getBoundingBox());
+    }
+
+    m_boundingSphere = BoundingSphere{ .center = m_boundingBox.getCenter(), .radius = 0.0f };
+
+    for (auto& mesh : m_meshes)
+    {
+        auto meshSphere = mesh->getBoundingSphere();
+
+        m_boundingSphere.radius = std::max(m_boundingSphere.radius, glm::length(meshSphere.center - m_boundingSphere.center) + meshSphere.radius);
+    }
+
+    setTransformation(m_transformation);
 }
 
 void MultiMeshModel::draw()
@@ -13,6 +30,29 @@ void MultiMeshModel::draw()
     }
 }
 
+void MultiMeshModel::draw(std::span<const Frustum> frusta)
+{
+    PROFILE_FUNCTION();
+
+    m_meshVisibility.assign(m_meshes.size(), 0);
+
+    for (auto& frustum : frusta)
+    {
+        if (frustum.intersects(m_worldBoundingBox))
+        {
+            frustum.markVisible(m_meshWorldBoundingBoxes, m_meshVisibility);
+        }
+    }
+
+    for (size_t i = 0; i < m_meshes.size(); ++i)
+    {
+        if (m_meshVisibility[i])
+        {
+            m_meshes[i]->draw();
+        }
+    }
+}
+
 void MultiMeshModel::drawInstanced(unsigned int instances)
 {
     for (auto& mesh : m_meshes)
@@ -41,9 +81,33 @@ void MultiMeshModel::setTransformation(glm::mat4 transformation)
 {
     // TODO: propagate onto meshes?
     m_transformation = transformation;
+
+    m_worldBoundingBox = m_boundingBox.transform(m_transformation);
+
+    m_meshWorldBoundingBoxes.resize(m_meshes.size());
+
+    for (size_t i = 0; i < m_meshes.size(); ++i)
+    {
+        m_meshWorldBoundingBoxes[i] = m_meshes[i]->getBoundingBox().transform(m_transformation);
+    }
 }
 
 glm::mat4 MultiMeshModel::getTransformation() const
 {
     return m_transformation;
 }
+
+BoundingBox MultiMeshModel::getBoundingBox() const
+{
+    return m_boundingBox;
+}
+
+BoundingBox MultiMeshModel::getWorldBoundingBox() const
+{
+    return m_worldBoundingBox;
+}
+
+BoundingSphere MultiMeshModel::getWorldBoundingSphere() const
+{
+    return m_boundingSphere.transform(m_transformation);
+}
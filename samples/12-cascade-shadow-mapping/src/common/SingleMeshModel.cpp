@@ -3,6 +3,7 @@
 SingleMeshModel::SingleMeshModel(std::unique_ptr<AbstractMesh> mesh) :
     m_mesh(std::move(mesh)), m_transformation(1.0f)
 {
+    m_worldBoundingBox = m_mesh->getBoundingBox();
 }
 
 void SingleMeshModel::draw()
@@ -10,6 +11,18 @@ void SingleMeshModel::draw()
     m_mesh->draw();
 }
 
+void SingleMeshModel::draw(std::span<const Frustum> frusta)
+{
+    for (auto& frustum : frusta)
+    {
+        if (frustum.intersects(m_worldBoundingBox))
+        {
+            m_mesh->draw();
+            return;
+        }
+    }
+}
+
 void SingleMeshModel::drawInstanced(unsigned int instances)
 {
     m_mesh->drawInstanced(instances);
@@ -28,9 +41,21 @@ void SingleMeshModel::unbind()
 void SingleMeshModel::setTransformation(glm::mat4 transformation)
 {
     m_transformation = transformation;
+
+    m_worldBoundingBox = m_mesh->getBoundingBox().transform(m_transformation);
 }
 
 glm::mat4 SingleMeshModel::getTransformation() const
 {
     return m_transformation;
 }
+
+BoundingBox SingleMeshModel::getWorldBoundingBox() const
+{
+    return m_worldBoundingBox;
+}
+
+BoundingSphere SingleMeshModel::getWorldBoundingSphere() const
+{
+    return m_mesh->getBoundingSphere().transform(m_transformation);
+}
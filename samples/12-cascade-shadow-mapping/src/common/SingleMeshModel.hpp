@@ -4,6 +4,7 @@
 
 #include "AbstractDrawable.hpp"
 #include "AbstractMesh.hpp"
+#include "Frustum.hpp"
 
 class SingleMeshModel : public AbstractDrawable
 {
@@ -12,6 +13,9 @@ public:
 
     void draw() override;
 
+    // does not draw anything if the mesh is outside of all the frusta
+    void draw(std::span<const Frustum> frusta);
+
     void drawInstanced(unsigned int instances) override;
 
     void bind() override;
@@ -22,7 +26,14 @@ public:
 
     glm::mat4 getTransformation() const;
 
+    BoundingBox getWorldBoundingBox() const override;
+
+    BoundingSphere getWorldBoundingSphere() const override;
+
 protected:
     std::unique_ptr<AbstractMesh> m_mesh;
     glm::mat4 m_transformation;
+
+    // cached by setTransformation()
+    BoundingBox m_worldBoundingBox;
 };
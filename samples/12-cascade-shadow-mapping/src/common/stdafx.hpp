@@ -1,8 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <filesystem>
 #include <iostream>
+#include <limits>
 #include <random>
+#include <span>
 #include <sstream>
 
 #include <glbinding/gl/gl.h>
@@ -37,6 +42,8 @@
 #include <SFML/OpenGL.hpp>
 #include <SFML/Window.hpp>
 
+#include <Profiling.hpp>
+
 #ifdef WIN32
 using namespace gl;
 #endif
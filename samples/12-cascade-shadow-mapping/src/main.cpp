@@ -2,8 +2,32 @@
 
 #include "common/AssimpModel.hpp"
 
-int main()
+#include "ShadowCascades.hpp"
+
+#include <BenchmarkRunner.hpp>
+#include <HeadlessContext.hpp>
+#include <InputRecording.hpp>
+
+int main(int argc, char* argv[])
 {
+    // with --benchmark, renders a scripted fly-through without a window and reports the frame times
+    auto benchmarkSettings = BenchmarkSettings::fromCommandLine("12-cascade-shadow-mapping", argc, argv);
+
+    // with --record, writes the input of every frame to a file; --replay plays it back with the same time steps
+    auto inputRecordingSettings = InputRecordingSettings::fromCommandLine(argc, argv);
+
+    std::unique_ptr<InputReplay> inputReplay;
+
+    if (inputRecordingSettings && !inputRecordingSettings->replayPath.empty())
+    {
+        inputReplay = InputReplay::fromFile(inputRecordingSettings->replayPath);
+
+        if (!inputReplay)
+        {
+            return 1;
+        }
+    }
+
     sf::ContextSettings settings;
     settings.depthBits = 24;
     settings.stencilBits = 8;
@@ -18,11 +42,53 @@ int main()
     auto videoMode = sf::VideoMode(1024, 768);
 #endif
 
-    sf::Window window(videoMode, "Hello, Cascade shadow mapping!", sf::Style::Default, settings);
+    std::unique_ptr<sf::Window> window;
+    std::unique_ptr<HeadlessContext> headlessContext;
 
-    globjects::init([](const char* name) {
-        return sf::Context::getFunction(name);
-    });
+    if (benchmarkSettings)
+    {
+        headlessContext = HeadlessContext::create(settings.majorVersion, settings.minorVersion);
+
+        if (!headlessContext)
+        {
+            std::cerr << "[ERROR] Can not create headless context" << std::endl;
+            return 1;
+        }
+
+        globjects::init(HeadlessContext::getFunction);
+    }
+    else if (inputReplay)
+    {
+        // the mouse movement is scaled by the viewport size, so the window has to stay as big as it was when recording
+        videoMode = sf::VideoMode(inputReplay->getWindowSize().x, inputReplay->getWindowSize().y);
+
+        window = std::make_unique<sf::Window>(videoMode, "Hello, Cascade shadow mapping!", sf::Style::Titlebar | sf::Style::Close, settings);
+    }
+    else
+    {
+        window = std::make_unique<sf::Window>(videoMode, "Hello, Cascade shadow mapping!", sf::Style::Default, settings);
+    }
+
+    if (window)
+    {
+        globjects::init([](const char* name) {
+            return sf::Context::getFunction(name);
+        });
+    }
+
+    std::unique_ptr<InputRecorder> inputRecorder;
+
+    if (window && inputRecordingSettings && !inputRecordingSettings->recordPath.empty())
+    {
+        inputRecorder = InputRecorder::create(inputRecordingSettings->recordPath, glm::uvec2(window->getSize().x, window->getSize().y));
+
+        if (!inputRecorder)
+        {
+            return 1;
+        }
+    }
+
+    PROFILE_GPU_CONTEXT();
 
     globjects::DebugMessage::enable(); // enable automatic messages if KHR_debug is available
 
@@ -259,6 +325,8 @@ int main()
         static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
         reinterpret_cast<const gl::GLvoid*>(textureImage.getPixelsPtr()));
 
+    PROFILE_GPU_ALLOC(defaultTexture.get(), textureImage.getSize().x * textureImage.getSize().y * 4, "textures");
+
     std::cout << "done" << std::endl;
 
     std::cout << "[DEBUG] Initializing framebuffers...";
@@ -283,6 +351,9 @@ int main()
         glm::vec3(shadowMapSize, 4) // this last `4` is the number of layers of a 3D texture; must be equal to the number of frustum splits we are making
     );
 
+    // four layers of 32-bit depth, plus about a third on top for the mip levels
+    PROFILE_GPU_ALLOC(shadowMapTexture.get(), static_cast<std::size_t>(shadowMapSize.x * shadowMapSize.y) * 4 * sizeof(float) * 4 / 3, "textures");
+
     std::cout << "done" << std::endl;
 
     std::cout << "[DEBUG] Initializing frame buffer...";
@@ -323,17 +394,11 @@ int main()
     glm::mat4 cameraProjection(1.0f);
     glm::mat4 cameraView(1.0f);
 
-    std::vector<glm::mat4> lightViewProjectionMatrices;
-    std::vector<float> splitDepths;
-    const std::vector<float> splits{ { 0.0f, 0.05f, 0.2f, 0.5f, 1.0f } };
+    ShadowCascades shadowCascades;
 
-    // these vertices define view frustum in screen space coordinates
-    constexpr std::array<glm::vec3, 8> _cameraFrustumSliceCornerVertices{
-        {
-            { -1.0f, -1.0f, -1.0f }, { 1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, -1.0f }, { -1.0f, 1.0f, -1.0f },
-            { -1.0f, -1.0f, 1.0f }, { 1.0f, -1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f }, { -1.0f, 1.0f, 1.0f },
-        }
-    };
+    // the objects outside of all the cascades do not cast any shadows we could see
+    std::vector<Frustum> cascadeFrusta;
+    const std::vector<float> splits{ { 0.0f, 0.05f, 0.2f, 0.5f, 1.0f } };
 
     sf::Clock clock;
 
@@ -342,48 +407,101 @@ int main()
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+    std::unique_ptr<BenchmarkRunner> benchmark;
+
+    if (benchmarkSettings)
+    {
+        // circles around the chicken, dipping down to the ground and back up every other keyframe
+        std::vector<CameraPath::Keyframe> cameraKeyframes;
+
+        for (auto i = 0; i <= 8; ++i)
+        {
+            float angle = glm::radians(45.0f * static_cast<float>(i));
+
+            cameraKeyframes.push_back(CameraPath::Keyframe{
+                .time = 1.5f * static_cast<float>(i),
+                .position = glm::vec3(std::sin(angle) * 3.0f, (i % 2 == 0) ? 1.0f : 2.5f, std::cos(angle) * 3.0f),
+                .target = glm::vec3(0.0f, 0.5f, 0.0f)
+            });
+        }
+
+        benchmark = std::make_unique<BenchmarkRunner>(*benchmarkSettings, CameraPath(cameraKeyframes));
+    }
+
 #ifndef WIN32
-    auto previousMousePos = glm::vec2(sf::Mouse::getPosition(window).x, sf::Mouse::getPosition(window).y);
-#endif
+    glm::vec2 previousMousePos(0.0f);
 
-    while (window.isOpen())
+    if (window)
     {
-        sf::Event event {};
+        previousMousePos = glm::vec2(sf::Mouse::getPosition(*window).x, sf::Mouse::getPosition(*window).y);
+    }
+#endif
 
-        // measure time since last frame, in seconds
-        float deltaTime = static_cast<float>(clock.restart().asSeconds());
+    while (benchmark ? benchmark->beginFrame() : window->isOpen())
+    {
+        const glm::uvec2 viewportSize = benchmark ? benchmark->getSize() : glm::uvec2(window->getSize().x, window->getSize().y);
 
-        while (window.pollEvent(event))
+        if (benchmark)
+        {
+            cameraPos = benchmark->getCameraPosition();
+            cameraForward = benchmark->getCameraForward();
+        }
+        else
         {
-            if (event.type == sf::Event::Closed)
+            sf::Event event {};
+
+            // measure time since last frame, in seconds
+            float deltaTime = static_cast<float>(clock.restart().asSeconds());
+
+            while (window->pollEvent(event))
             {
-                window.close();
-                break;
+                if (event.type == sf::Event::Closed)
+                {
+                    window->close();
+                    break;
+                }
             }
-        }
 
-        glm::vec2 currentMousePos = glm::vec2(sf::Mouse::getPosition(window).x, sf::Mouse::getPosition(window).y);
+            glm::vec2 currentMousePos = glm::vec2(sf::Mouse::getPosition(*window).x, sf::Mouse::getPosition(*window).y);
 
 #ifdef WIN32
-        glm::vec2 mouseDelta = currentMousePos - glm::vec2((window.getSize().x / 2), (window.getSize().y / 2));
-        sf::Mouse::setPosition(sf::Vector2<int>(window.getSize().x / 2, window.getSize().y / 2), window);
+            glm::vec2 mouseDelta = currentMousePos - glm::vec2((window->getSize().x / 2), (window->getSize().y / 2));
+            sf::Mouse::setPosition(sf::Vector2<int>(window->getSize().x / 2, window->getSize().y / 2), *window);
 #else
-        glm::vec2 mouseDelta = currentMousePos - previousMousePos;
-        previousMousePos = currentMousePos;
+            glm::vec2 mouseDelta = currentMousePos - previousMousePos;
+            previousMousePos = currentMousePos;
 #endif
 
-        {
-            float horizontalAngle = (mouseDelta.x / static_cast<float>(window.getSize().x)) * -1 * deltaTime * cameraRotateSpeed * fov;
-            float verticalAngle = (mouseDelta.y / static_cast<float>(window.getSize().y)) * -1 * deltaTime * cameraRotateSpeed * fov;
+            auto input = FrameInput::capture(deltaTime, glm::ivec2(mouseDelta), { sf::Keyboard::W, sf::Keyboard::S, sf::Keyboard::A, sf::Keyboard::D, sf::Keyboard::LShift });
+
+            if (inputReplay && !inputReplay->nextFrame(input))
+            {
+                std::cout << "[INFO] Replayed " << inputReplay->getFrame() << " frames" << std::endl;
+
+                window->close();
+                continue;
+            }
+
+            if (inputRecorder)
+            {
+                inputRecorder->record(input);
+            }
+
+            // from here on, the recorded input when replaying
+            deltaTime = input.deltaTime;
+            mouseDelta = glm::vec2(input.mouseDelta);
+
+            float horizontalAngle = (mouseDelta.x / static_cast<float>(viewportSize.x)) * -1 * deltaTime * cameraRotateSpeed * fov;
+            float verticalAngle = (mouseDelta.y / static_cast<float>(viewportSize.y)) * -1 * deltaTime * cameraRotateSpeed * fov;
 
             cameraForward = glm::rotate(cameraForward, horizontalAngle, cameraUp);
             cameraForward = glm::rotate(cameraForward, verticalAngle, cameraRight);
 
             cameraRight = glm::normalize(glm::rotate(cameraRight, horizontalAngle, cameraUp));
 
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::W))
+            if (input.isKeyPressed(sf::Keyboard::W))
             {
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::LShift))
+                if (input.isKeyPressed(sf::Keyboard::LShift))
                 {
                     cameraPos += cameraForward * cameraMoveSpeed * 10.0f * deltaTime;
                 }
@@ -393,9 +511,9 @@ int main()
                 }
             }
 
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::S))
+            if (input.isKeyPressed(sf::Keyboard::S))
             {
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::LShift))
+                if (input.isKeyPressed(sf::Keyboard::LShift))
                 {
                     cameraPos -= cameraForward * cameraMoveSpeed * 10.0f * deltaTime;
                 }
@@ -405,9 +523,9 @@ int main()
                 }
             }
 
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::A))
+            if (input.isKeyPressed(sf::Keyboard::A))
             {
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::LShift))
+                if (input.isKeyPressed(sf::Keyboard::LShift))
                 {
                     cameraPos -= glm::normalize(glm::cross(cameraForward, cameraUp)) * cameraMoveSpeed * 10.0f * deltaTime;
                 }
@@ -417,9 +535,9 @@ int main()
                 }
             }
 
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::D))
+            if (input.isKeyPressed(sf::Keyboard::D))
             {
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::LShift))
+                if (input.isKeyPressed(sf::Keyboard::LShift))
                 {
                     cameraPos += glm::normalize(glm::cross(cameraForward, cameraUp)) * cameraMoveSpeed * 10.0f * deltaTime;
                 }
@@ -428,188 +546,157 @@ int main()
                     cameraPos += glm::normalize(glm::cross(cameraForward, cameraUp)) * cameraMoveSpeed * deltaTime;
                 }
             }
-
-            cameraProjection = glm::perspective(glm::radians(fov), static_cast<float>(window.getSize().x) / static_cast<float>(window.getSize().y), nearPlane, farPlane);
-
-            cameraView = glm::lookAt(
-                cameraPos,
-                cameraPos + cameraForward,
-                cameraUp);
         }
 
-        {
-            lightViewProjectionMatrices.clear();
-            splitDepths.clear();
+        cameraProjection = glm::perspective(glm::radians(fov), static_cast<float>(viewportSize.x) / static_cast<float>(viewportSize.y), nearPlane, farPlane);
 
-            glm::mat4 proj = glm::inverse(cameraProjection * cameraView);
+        cameraView = glm::lookAt(
+            cameraPos,
+            cameraPos + cameraForward,
+            cameraUp);
 
-            std::array<glm::vec3, 8> _entireFrustum{};
-
-            std::transform(
-                _cameraFrustumSliceCornerVertices.begin(),
-                _cameraFrustumSliceCornerVertices.end(),
-                _entireFrustum.begin(),
-                [proj](glm::vec3 p) {
-                    glm::vec4 v = proj * glm::vec4(p, 1.0f);
-                    return glm::vec3(v) / v.w;
-                }
-            );
+        {
+            shadowCascades.update(cameraProjection, cameraView, nearPlane, farPlane, _lightDirection, splits);
 
-            std::array<glm::vec3, 4> _frustumEdgeDirections {};
+            cascadeFrusta.clear();
 
-            for (auto i = 0; i < 4; ++i)
+            for (auto& lightViewProjection : shadowCascades.getLightViewProjectionMatrices())
             {
-                _frustumEdgeDirections[i] = glm::normalize(_entireFrustum[4 + i] - _entireFrustum[i]);
+                cascadeFrusta.push_back(Frustum::fromViewProjection(lightViewProjection));
             }
 
-            const float _depth = farPlane - nearPlane;
-
-            for (auto splitIdx = 1; splitIdx < splits.size(); ++splitIdx)
-            {
-                // frustum slice vertices in world space
-                std::array<glm::vec3, 8> _frustumSliceVertices;
-
-                for (auto t = 0; t < 4; ++t)
-                {
-                    _frustumSliceVertices[t] = _entireFrustum[t] + _frustumEdgeDirections[t] * _depth * splits[splitIdx - 1];
-                    _frustumSliceVertices[4 + t] = _entireFrustum[t] + _frustumEdgeDirections[t] * _depth * splits[splitIdx];
-                }
-
-                // TODO: also check if camera is looking towards the light
-
-                glm::vec3 _frustumSliceCenter(0.0f);
-
-                for (auto p : _frustumSliceVertices)
-                {
-                    _frustumSliceCenter += p;
-                }
-
-                _frustumSliceCenter /= 8.0f;
-
-                glm::vec3 _frustumRadiusVector(0.0f);
+            shadowMappingLightViewProjectionMatrices->set(shadowCascades.getLightViewProjectionMatrices());
+            shadowRenderingLightViewProjectionsUniform->set(shadowCascades.getLightViewProjectionMatrices());
+            shadowRenderingSplitsUniform->set(shadowCascades.getSplitDepths());
+        }
 
-                for (auto p : _frustumSliceVertices)
-                {
-                    auto v = p - _frustumSliceCenter;
+        ::glViewport(0, 0, shadowMapSize.x, shadowMapSize.y);
 
-                    if (glm::length(_frustumRadiusVector) < glm::length(v))
-                    {
-                        _frustumRadiusVector = v;
-                    }
-                }
+        // first render pass - shadow mapping
 
-                // calculate new light projection
-                glm::vec3 _forward = glm::normalize(_lightDirection);
-                glm::vec3 _right = glm::cross(_forward, glm::vec3(0.0f, 1.0f, 0.0f));
-                glm::vec3 _up(0.0f, 1.0f, 0.0f);
-                glm::mat4 _lightView = glm::lookAt(_frustumSliceCenter - glm::normalize(_lightDirection) * glm::length(_frustumRadiusVector), _frustumSliceCenter, _up);
+        if (benchmark)
+        {
+            benchmark->beginPass("shadow-mapping");
+        }
 
-                const float _frustumRadius = glm::length(_frustumRadiusVector);
+        {
+            PROFILE_ZONE("shadow mapping");
+            PROFILE_GPU_ZONE("shadow mapping");
 
-                glm::mat4 _lightProjectionViewMatrix = glm::ortho(
-                    _frustumSliceCenter.x - _frustumRadius,
-                    _frustumSliceCenter.x + _frustumRadius,
-                    _frustumSliceCenter.y - _frustumRadius,
-                    _frustumSliceCenter.y + _frustumRadius,
-                    0.0f,
-                    _frustumSliceCenter.z + 2.0f * _frustumRadius
-                ) * _lightView;
+            framebuffer->bind();
 
-                lightViewProjectionMatrices.push_back(_lightProjectionViewMatrix);
+            ::glClearColor(static_cast<gl::GLfloat>(1.0f), static_cast<gl::GLfloat>(1.0f), static_cast<gl::GLfloat>(1.0f), static_cast<gl::GLfloat>(1.0f));
+            ::glClear(GL_DEPTH_BUFFER_BIT);
+            framebuffer->clearBuffer(static_cast<gl::GLenum>(GL_DEPTH), 0, glm::vec4(1.0f));
 
-                splitDepths.push_back(_depth * splits[splitIdx] * 0.7f);
-            }
+            glEnable(GL_DEPTH_TEST);
+            glEnable(GL_CULL_FACE);
 
-            shadowMappingLightViewProjectionMatrices->set(lightViewProjectionMatrices);
-            shadowRenderingLightViewProjectionsUniform->set(lightViewProjectionMatrices);
-            shadowRenderingSplitsUniform->set(splitDepths);
-        }
+            // cull front faces to prevent peter panning the generated shadow map
+            glCullFace(GL_FRONT);
 
-        ::glViewport(0, 0, shadowMapSize.x, shadowMapSize.y);
+            shadowMappingProgram->use();
 
-        // first render pass - shadow mapping
+            shadowMappingModelTransformationUniform->set(chickenModel->getTransformation());
 
-        framebuffer->bind();
+            chickenModel->bind();
+            chickenModel->draw(cascadeFrusta);
+            chickenModel->unbind();
 
-        ::glClearColor(static_cast<gl::GLfloat>(1.0f), static_cast<gl::GLfloat>(1.0f), static_cast<gl::GLfloat>(1.0f), static_cast<gl::GLfloat>(1.0f));
-        ::glClear(GL_DEPTH_BUFFER_BIT);
-        framebuffer->clearBuffer(static_cast<gl::GLenum>(GL_DEPTH), 0, glm::vec4(1.0f));
+            // the ground plane will get culled, we don't want that
+            glDisable(GL_CULL_FACE);
 
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_CULL_FACE);
+            shadowMappingModelTransformationUniform->set(quadModel->getTransformation());
 
-        // cull front faces to prevent peter panning the generated shadow map
-        glCullFace(GL_FRONT);
+            quadModel->bind();
+            quadModel->draw(cascadeFrusta);
+            quadModel->unbind();
 
-        shadowMappingProgram->use();
+            framebuffer->unbind();
 
-        shadowMappingModelTransformationUniform->set(chickenModel->getTransformation());
+            shadowMappingProgram->release();
 
-        chickenModel->bind();
-        chickenModel->draw();
-        chickenModel->unbind();
+            glEnable(GL_CULL_FACE);
+            glCullFace(GL_BACK);
+        }
 
-        // the ground plane will get culled, we don't want that
-        glDisable(GL_CULL_FACE);
+        if (benchmark)
+        {
+            benchmark->endPass();
 
-        shadowMappingModelTransformationUniform->set(quadModel->getTransformation());
+            // the headless context has no default framebuffer to render to
+            benchmark->bindFramebuffer();
+            benchmark->beginPass("shadow-rendering");
+        }
 
-        quadModel->bind();
-        quadModel->draw();
-        quadModel->unbind();
+        // second pass - switch to normal shader and render picture with depth information to the viewport
 
-        framebuffer->unbind();
+        {
+            PROFILE_ZONE("shadow rendering");
+            PROFILE_GPU_ZONE("shadow rendering");
 
-        shadowMappingProgram->release();
+            const Frustum cameraFrustum = Frustum::fromViewProjection(cameraProjection * cameraView);
 
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
+            ::glViewport(0, 0, static_cast<GLsizei>(viewportSize.x), static_cast<GLsizei>(viewportSize.y));
+            ::glClearColor(static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(1.0f));
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // second pass - switch to normal shader and render picture with depth information to the viewport
+            shadowRenderingProgram->use();
 
-        ::glViewport(0, 0, static_cast<GLsizei>(window.getSize().x), static_cast<GLsizei>(window.getSize().y));
-        ::glClearColor(static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(1.0f));
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            shadowRenderingLightPositionUniform->set(lightPosition);
+            shadowRenderingLightColorUniform->set(glm::vec3(1.0, 1.0, 1.0));
+            shadowRenderingCameraPositionUniform->set(cameraPos);
 
-        shadowRenderingProgram->use();
+            shadowRenderingProjectionTransformationUniform->set(cameraProjection);
+            shadowRenderingViewTransformationUniform->set(cameraView);
 
-        shadowRenderingLightPositionUniform->set(lightPosition);
-        shadowRenderingLightColorUniform->set(glm::vec3(1.0, 1.0, 1.0));
-        shadowRenderingCameraPositionUniform->set(cameraPos);
+            // draw chicken
 
-        shadowRenderingProjectionTransformationUniform->set(cameraProjection);
-        shadowRenderingViewTransformationUniform->set(cameraView);
+            shadowMapTexture->bindActive(0);
 
-        // draw chicken
+            shadowRenderingProgram->setUniform("shadowMaps", 0);
+            shadowRenderingProgram->setUniform("diffuseTexture", 1);
 
-        shadowMapTexture->bindActive(0);
+            shadowRenderingModelTransformationUniform->set(chickenModel->getTransformation());
 
-        shadowRenderingProgram->setUniform("shadowMaps", 0);
-        shadowRenderingProgram->setUniform("diffuseTexture", 1);
+            chickenModel->bind();
+            chickenModel->draw(std::span(&cameraFrustum, 1));
+            chickenModel->unbind();
 
-        shadowRenderingModelTransformationUniform->set(chickenModel->getTransformation());
+            shadowRenderingModelTransformationUniform->set(quadModel->getTransformation());
 
-        chickenModel->bind();
-        chickenModel->draw();
-        chickenModel->unbind();
+            defaultTexture->bindActive(1);
 
-        shadowRenderingModelTransformationUniform->set(quadModel->getTransformation());
+            quadModel->bind();
+            quadModel->draw(std::span(&cameraFrustum, 1));
+            quadModel->unbind();
 
-        defaultTexture->bindActive(1);
+            defaultTexture->unbindActive(1);
 
-        quadModel->bind();
-        quadModel->draw();
-        quadModel->unbind();
+            shadowMapTexture->unbindActive(0);
 
-        defaultTexture->unbindActive(1);
+            shadowRenderingProgram->release();
+        }
 
-        shadowMapTexture->unbindActive(0);
+        // done rendering the frame
 
-        shadowRenderingProgram->release();
+        if (benchmark)
+        {
+            benchmark->endPass();
+            benchmark->endFrame();
+        }
+        else
+        {
+            window->display();
+        }
 
-        // done rendering the frame
+        PROFILE_FRAME();
+        PROFILE_GPU_COLLECT();
+    }
 
-        window.display();
+    if (benchmark && !benchmark->writeReport())
+    {
+        return 1;
     }
 
     return 0;
@@ -10,6 +10,8 @@ target("12-cascade-shadow-mapping")
 
   add_packages("sfml", "glm", "globjects", "glbinding", "assimp")
 
+  add_deps("benchmark-harness", "input-recording", "profiling")
+
   if is_plat("macosx") then
     -- this prevents "-[SFOpenGLView enableKeyRepeat]: unrecognized selector sent to instance 0x7fa5c2507970" runtime exception
     add_ldflags("-ObjC")
@@ -20,7 +22,7 @@ target("12-cascade-shadow-mapping")
 
   set_pcxxheader("src/common/stdafx.hpp")
 
-  add_files("src/main.cpp", "src/common/AbstractMesh.cpp", "src/common/AbstractMeshBuilder.cpp", "src/common/AssimpModel.cpp", "src/common/MultimeshModel.cpp", "src/common/SingleMeshModel.cpp")
+  add_files("src/main.cpp", "src/ShadowCascades.cpp", "src/common/AbstractMesh.cpp", "src/common/AbstractMeshBuilder.cpp", "src/common/AssimpModel.cpp", "src/common/BoundingVolume.cpp", "src/common/Frustum.cpp", "src/common/MultimeshModel.cpp", "src/common/SingleMeshModel.cpp")
   add_includedirs("src/")
 
   after_build(function (target)
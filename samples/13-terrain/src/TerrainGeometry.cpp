@@ -0,0 +1,92 @@
+#include "TerrainGeometry.hpp"
+
+TerrainGeometry TerrainGeometry::fromHeightmap(const sf::Image& heightmap, float step)
+{
+    const auto width = heightmap.getSize().x;
+    const auto height = heightmap.getSize().y;
+
+    std::vector<glm::vec3> vertices;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> uvs;
+    std::vector<unsigned int> indices;
+
+    vertices.reserve(width * height);
+    normals.reserve(width * height);
+    uvs.reserve(width * height);
+    indices.reserve(6 * (width - 1) * (height - 1));
+
+    for (auto i = 0; i < height; ++i)
+    {
+        for (auto t = 0; t < width; ++t)
+        {
+            const auto color = heightmap.getPixel(t, i);
+
+            float x = t * step;
+            float y = color.r / 255.0f; // heightmaps are greyscale so all the components (r, g & b) of each pixel will have the same value
+            float z = i * step;
+
+            glm::vec3 position(x, y, z);
+            glm::vec2 uv(i / static_cast<float>(width - 1), t / static_cast<float>(height - 1));
+
+            vertices.push_back(position);
+            uvs.push_back(uv);
+        }
+    }
+
+    for (auto i = 0; i < height - 1; ++i)
+    {
+        for (auto t = 0; t < width - 1; ++t)
+        {
+            /*
+            * [(i+1)*size + t] [(i+1)*size+t+1]
+            * [i*size + t]     [i*size + t + 1]
+            *
+            * x.x
+            * |\.
+            * x-x
+            */
+            indices.push_back(((i + 1) * width) + t);
+            indices.push_back((i * width) + t + 1);
+            indices.push_back((i * width) + t);
+
+            /*
+            *
+            * x-x
+            * .\|
+            * x.x
+            */
+            indices.push_back(((i + 1) * width) + t);
+            indices.push_back(((i + 1) * width) + t + 1);
+            indices.push_back((i * width) + t + 1);
+
+            glm::vec3 v0 = vertices[i * width + t];
+            glm::vec3 v1 = vertices[(i + 1) * width + t];
+            glm::vec3 v2 = vertices[i * width + t + 1];
+
+            glm::vec3 normal = glm::cross(v1 - v0, v2 - v0);
+            normals.push_back(normal);
+        }
+
+        // last vertex of the row
+        {
+            glm::vec3 v0 = vertices[i * width + width - 1];
+            glm::vec3 v1 = vertices[(i + 1) * width + width - 1];
+            glm::vec3 v2 = vertices[i * width + width - 1 + 1];
+
+            glm::vec3 normal = glm::cross(v2 - v0, v1 - v0);
+            normals.push_back(normal);
+        }
+    }
+
+    // last vertex of the last row and last column
+    {
+        glm::vec3 v0 = vertices[height * width - 1];
+        glm::vec3 v1 = vertices[(height - 1) * width - 1];
+        glm::vec3 v2 = vertices[height * width - 2];
+
+        glm::vec3 normal = glm::cross(v2 - v0, v1 - v0);
+        normals.push_back(normal);
+    }
+
+    return { .vertices = std::move(vertices), .normals = std::move(normals), .uvs = std::move(uvs), .indices = std::move(indices) };
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "common/stdafx.hpp"
+
+/**
+ * The CPU side of the terrain: a grid of vertices `step` units apart, one per heightmap pixel, elevated by the pixel brightness.
+ * Does not issue any GL calls.
+ */
+struct TerrainGeometry
+{
+    std::vector<glm::vec3> vertices;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> uvs;
+    std::vector<unsigned int> indices;
+
+    static TerrainGeometry fromHeightmap(const sf::Image& heightmap, float step = 0.5f);
+};
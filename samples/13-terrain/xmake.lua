@@ -20,7 +20,7 @@ target("13-terrain")
 
   set_pcxxheader("src/common/stdafx.hpp")
 
-  add_files("src/main.cpp", "src/common/AbstractMesh.cpp", "src/common/AbstractMeshBuilder.cpp", "src/common/AssimpModel.cpp", "src/common/MultimeshModel.cpp", "src/common/SingleMeshModel.cpp")
+  add_files("src/main.cpp", "src/TerrainGeometry.cpp", "src/common/AbstractMesh.cpp", "src/common/AbstractMeshBuilder.cpp", "src/common/AssimpModel.cpp", "src/common/MultimeshModel.cpp", "src/common/SingleMeshModel.cpp")
   add_includedirs("src/")
 
   after_build(function (target)
@@ -1,9 +1,10 @@
 #version 430
 
-in GS_OUT
+layout (location = 0) out vec4 fragmentColor;
+
+in VS_OUT
 {
-    vec4 vertexPosition;
-    vec4 fragmentPosition;
+    vec3 fragmentPosition;
     vec3 normal;
     vec2 textureCoords;
 } fsIn;
@@ -15,5 +16,5 @@ void main()
     vec4 color = texture(diffuseTexture, fsIn.textureCoords);
 
     // TODO: add lighting component here
-    gl_FragColor = color;
+    fragmentColor = color;
 }
@@ -6,7 +6,6 @@ layout (location = 2) in vec2 vertexTextureCoords;
 
 out VS_OUT
 {
-    vec4 vertexPosition;
     vec3 fragmentPosition;
     vec3 normal;
     vec2 textureCoords;
@@ -18,12 +17,16 @@ out gl_PerVertex {
 
 uniform mat4 modelTransformation;
 
+// projection-view matrix of the cubemap face currently being rendered
+uniform mat4 projectionView;
+
 void main()
 {
-    vsOut.vertexPosition = modelTransformation * vec4(vertexPosition, 1.0);
-    vsOut.fragmentPosition = vec3(modelTransformation * vec4(vertexPosition, 1.0));
+    vec4 worldPosition = modelTransformation * vec4(vertexPosition, 1.0);
+
+    vsOut.fragmentPosition = vec3(worldPosition);
     vsOut.normal = vertexNormal;
     vsOut.textureCoords = vertexTextureCoords;
 
-    gl_Position = vsOut.vertexPosition;
+    gl_Position = projectionView * worldPosition;
 }
@@ -35,7 +35,8 @@ AbstractMesh::AbstractMesh(
     m_tangentBuffer(std::move(tangentBuffer)),
     m_bitangentBuffer(std::move(bitangentBuffer)),
     m_uvBuffer(std::move(uvBuffer)),
-    m_transformation(1.0f)
+    m_transformation(1.0f),
+    m_boundingSphere(BoundingSphere::fromPoints(m_vertices))
 {
 }
 
@@ -49,6 +50,11 @@ glm::mat4 AbstractMesh::getTransformation() const
     return m_transformation;
 }
 
+BoundingSphere AbstractMesh::getBoundingSphere() const
+{
+    return m_boundingSphere;
+}
+
 void AbstractMesh::draw()
 {
     // number of values passed = number of elements * number of vertices per element
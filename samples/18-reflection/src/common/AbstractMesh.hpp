@@ -3,6 +3,7 @@
 #include "stdafx.hpp"
 
 #include "AbstractDrawable.hpp"
+#include "BoundingSphere.hpp"
 
 class AbstractMesh : public AbstractDrawable
 {
@@ -31,6 +32,9 @@ public:
 
     glm::mat4 getTransformation() const;
 
+    // bounding sphere in the mesh' local space
+    BoundingSphere getBoundingSphere() const;
+
     void draw() override;
 
     void drawInstanced(unsigned int instances) override;
@@ -59,6 +63,8 @@ protected:
     std::vector<glm::vec2> m_uvs;
 
     glm::mat4 m_transformation;
+
+    BoundingSphere m_boundingSphere;
 };
 
 
@@ -0,0 +1,59 @@
+#include "BoundingSphere.hpp"
+
+BoundingSphere BoundingSphere::fromPoints(const std::vector<glm::vec3>& points)
+{
+    if (points.empty())
+    {
+        return { glm::vec3(0.0f), 0.0f };
+    }
+
+    glm::vec3 min = points[0];
+    glm::vec3 max = points[0];
+
+    for (auto& point : points)
+    {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    const auto center = (min + max) * 0.5f;
+
+    float radius = 0.0f;
+
+    for (auto& point : points)
+    {
+        radius = std::max(radius, glm::length(point - center));
+    }
+
+    return { center, radius };
+}
+
+BoundingSphere BoundingSphere::merge(const BoundingSphere& a, const BoundingSphere& b)
+{
+    const auto distance = glm::length(b.center - a.center);
+
+    if (distance + b.radius <= a.radius)
+    {
+        return a;
+    }
+
+    if (distance + a.radius <= b.radius)
+    {
+        return b;
+    }
+
+    const auto radius = (distance + a.radius + b.radius) * 0.5f;
+
+    return { a.center + (b.center - a.center) * ((radius - a.radius) / distance), radius };
+}
+
+BoundingSphere BoundingSphere::transform(const glm::mat4& transformation) const
+{
+    // non-uniform scale is accounted for by taking the largest of the three axis scales
+    const auto scale = std::max({
+        glm::length(glm::vec3(transformation[0])),
+        glm::length(glm::vec3(transformation[1])),
+        glm::length(glm::vec3(transformation[2])) });
+
+    return { glm::vec3(transformation * glm::vec4(center, 1.0f)), radius * scale };
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "stdafx.hpp"
+
+struct BoundingSphere
+{
+    glm::vec3 center;
+    float radius;
+
+    static BoundingSphere fromPoints(const std::vector<glm::vec3>& points);
+
+    static BoundingSphere merge(const BoundingSphere& a, const BoundingSphere& b);
+
+    BoundingSphere transform(const glm::mat4& transformation) const;
+};
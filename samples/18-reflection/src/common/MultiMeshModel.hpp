@@ -22,7 +22,11 @@ public:
 
     glm::mat4 getTransformation() const;
 
+    // bounding sphere in the model' local space, enclosing all of its meshes
+    BoundingSphere getBoundingSphere() const;
+
 protected:
     std::vector<std::unique_ptr<AbstractMesh>> m_meshes;
     glm::mat4 m_transformation;
+    BoundingSphere m_boundingSphere;
 };
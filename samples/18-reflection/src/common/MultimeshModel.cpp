@@ -1,8 +1,17 @@
 #include "MultiMeshModel.hpp"
 
 MultiMeshModel::MultiMeshModel(std::vector<std::unique_ptr<AbstractMesh>> meshes) :
-    m_meshes(std::move(meshes)), m_transformation(1.0f)
+    m_meshes(std::move(meshes)), m_transformation(1.0f), m_boundingSphere({ glm::vec3(0.0f), 0.0f })
 {
+    if (!m_meshes.empty())
+    {
+        m_boundingSphere = m_meshes[0]->getBoundingSphere();
+    }
+
+    for (auto& mesh : m_meshes)
+    {
+        m_boundingSphere = BoundingSphere::merge(m_boundingSphere, mesh->getBoundingSphere());
+    }
 }
 
 void MultiMeshModel::draw()
@@ -47,3 +56,8 @@ glm::mat4 MultiMeshModel::getTransformation() const
 {
     return m_transformation;
 }
+
+BoundingSphere MultiMeshModel::getBoundingSphere() const
+{
+    return m_boundingSphere;
+}
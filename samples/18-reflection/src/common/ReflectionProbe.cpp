@@ -0,0 +1,330 @@
+#include "ReflectionProbe.hpp"
+
+ReflectionProbe::ReflectionProbe(glm::vec3 position, float nearPlane, float farPlane, unsigned int maxResolution, unsigned int minResolution) :
+    m_position(position),
+    m_nearPlane(nearPlane),
+    m_farPlane(farPlane),
+    m_maxResolution(maxResolution),
+    m_minResolution(minResolution),
+    m_resolution(0),
+    m_facesPerFrame(2),
+    m_resolutionFalloffDistance(farPlane),
+    m_nextFace(0),
+    m_texture(std::make_unique<globjects::Texture>(static_cast<gl::GLenum>(GL_TEXTURE_CUBE_MAP))),
+    m_depthRenderbuffer(std::make_unique<globjects::Renderbuffer>())
+{
+    m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<gl::GLenum>(GL_LINEAR));
+    m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAG_FILTER), static_cast<gl::GLenum>(GL_LINEAR));
+
+    m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_S), static_cast<gl::GLenum>(GL_CLAMP_TO_EDGE));
+    m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_T), static_cast<gl::GLenum>(GL_CLAMP_TO_EDGE));
+    m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_R), static_cast<gl::GLenum>(GL_CLAMP_TO_EDGE));
+
+    for (auto& framebuffer : m_framebuffers)
+    {
+        framebuffer = std::make_unique<globjects::Framebuffer>();
+    }
+
+    m_dirtyFaces.fill(true);
+
+    updateFaceMatrices();
+
+    // no storage until the first update(): it takes the resize path, at the resolution the camera distance calls for,
+    // and fills all six faces at once
+}
+
+void ReflectionProbe::addCaster(MultiMeshModel* model, bool cullFaces)
+{
+    m_casters.push_back({
+        .model = model,
+        .cullFaces = cullFaces,
+        .transformation = model->getTransformation(),
+        .worldBoundingSphere = model->getBoundingSphere().transform(model->getTransformation()) });
+
+    markDirty(m_casters.back().worldBoundingSphere);
+}
+
+void ReflectionProbe::setPosition(glm::vec3 position)
+{
+    if (position == m_position)
+    {
+        return;
+    }
+
+    m_position = position;
+
+    updateFaceMatrices();
+    invalidate();
+}
+
+glm::vec3 ReflectionProbe::getPosition() const
+{
+    return m_position;
+}
+
+void ReflectionProbe::setFacesPerFrame(unsigned int facesPerFrame)
+{
+    m_facesPerFrame = std::clamp(facesPerFrame, 1u, 6u);
+}
+
+void ReflectionProbe::setResolutionFalloffDistance(float distance)
+{
+    m_resolutionFalloffDistance = distance;
+}
+
+void ReflectionProbe::invalidate()
+{
+    m_dirtyFaces.fill(true);
+}
+
+bool ReflectionProbe::isDirty() const
+{
+    return std::any_of(m_dirtyFaces.begin(), m_dirtyFaces.end(), [](bool dirty) { return dirty; });
+}
+
+unsigned int ReflectionProbe::getResolution() const
+{
+    return m_resolution;
+}
+
+globjects::Texture* ReflectionProbe::getTexture() const
+{
+    return m_texture.get();
+}
+
+unsigned int ReflectionProbe::update(glm::vec3 cameraPosition, globjects::Program* program)
+{
+    const auto resolution = selectResolution(cameraPosition);
+
+    // resizing throws away the contents of all the faces, so all of them have to be rendered this very frame
+    const auto isResized = resolution != m_resolution;
+
+    if (isResized)
+    {
+        resize(resolution);
+        invalidate();
+    }
+
+    detectChanges();
+
+    if (!isDirty())
+    {
+        return 0;
+    }
+
+    program->use();
+    program->setUniform("diffuseTexture", 1);
+
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+
+    ::glViewport(0, 0, m_resolution, m_resolution);
+    ::glClearColor(static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(1.0f));
+
+    const auto maxFaces = isResized ? 6u : m_facesPerFrame;
+
+    unsigned int renderedFaces = 0;
+
+    for (unsigned int i = 0; i < 6 && renderedFaces < maxFaces; ++i)
+    {
+        const auto face = (m_nextFace + i) % 6;
+
+        if (!m_dirtyFaces[face])
+        {
+            continue;
+        }
+
+        renderFace(face, program);
+
+        m_dirtyFaces[face] = false;
+        ++renderedFaces;
+    }
+
+    // continue from where we stopped next frame, so that all the faces get their turn
+    m_nextFace = (m_nextFace + renderedFaces) % 6;
+
+    program->release();
+
+    glEnable(GL_CULL_FACE);
+
+    return renderedFaces;
+}
+
+void ReflectionProbe::renderFace(unsigned int face, globjects::Program* program)
+{
+    m_framebuffers[face]->bind();
+
+    ::glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    program->setUniform("projectionView", m_projectionViewMatrices[face]);
+
+    for (auto& caster : m_casters)
+    {
+        // per-face culling instead of amplifying every triangle six times in the geometry shader
+        if (!isVisible(face, caster.worldBoundingSphere))
+        {
+            continue;
+        }
+
+        program->setUniform("modelTransformation", caster.transformation);
+
+        // some models (like the scroll, which is a modified plane) need culling to be disabled
+        if (!caster.cullFaces)
+        {
+            glDisable(GL_CULL_FACE);
+        }
+
+        caster.model->bind();
+        caster.model->draw();
+        caster.model->unbind();
+
+        if (!caster.cullFaces)
+        {
+            glEnable(GL_CULL_FACE);
+        }
+    }
+
+    m_framebuffers[face]->unbind();
+}
+
+void ReflectionProbe::detectChanges()
+{
+    for (auto& caster : m_casters)
+    {
+        const auto transformation = caster.model->getTransformation();
+
+        if (transformation == caster.transformation)
+        {
+            continue;
+        }
+
+        // both the old and the new position of an object need to be re-rendered
+        markDirty(caster.worldBoundingSphere);
+
+        caster.transformation = transformation;
+        caster.worldBoundingSphere = caster.model->getBoundingSphere().transform(transformation);
+
+        markDirty(caster.worldBoundingSphere);
+    }
+}
+
+void ReflectionProbe::markDirty(const BoundingSphere& sphere)
+{
+    for (unsigned int face = 0; face < 6; ++face)
+    {
+        if (isVisible(face, sphere))
+        {
+            m_dirtyFaces[face] = true;
+        }
+    }
+}
+
+bool ReflectionProbe::isVisible(unsigned int face, const BoundingSphere& sphere) const
+{
+    for (auto& plane : m_frustumPlanes[face])
+    {
+        if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+unsigned int ReflectionProbe::selectResolution(glm::vec3 cameraPosition) const
+{
+    const auto distance = glm::length(cameraPosition - m_position);
+
+    auto resolution = m_maxResolution;
+
+    for (auto threshold = m_resolutionFalloffDistance; distance > threshold && resolution > m_minResolution; threshold *= 2.0f)
+    {
+        resolution /= 2;
+    }
+
+    return std::max(resolution, m_minResolution);
+}
+
+void ReflectionProbe::resize(unsigned int resolution)
+{
+    m_resolution = resolution;
+
+    m_texture->bind();
+
+    for (auto i = 0; i < 6; ++i)
+    {
+        ::glTexImage2D(
+            static_cast<::GLenum>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i),
+            0,
+            GL_RGBA8,
+            m_resolution,
+            m_resolution,
+            0,
+            GL_RGBA,
+            GL_UNSIGNED_BYTE,
+            nullptr);
+    }
+
+    m_texture->unbind();
+
+    // faces are rendered one at a time, so they all can share one depth buffer
+    m_depthRenderbuffer->storage(static_cast<gl::GLenum>(GL_DEPTH_COMPONENT24), m_resolution, m_resolution);
+
+    for (auto i = 0; i < 6; ++i)
+    {
+        m_framebuffers[i]->bind();
+
+        ::glFramebufferTexture2D(
+            GL_FRAMEBUFFER,
+            GL_COLOR_ATTACHMENT0,
+            static_cast<::GLenum>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i),
+            m_texture->id(),
+            0);
+
+        m_framebuffers[i]->attachRenderBuffer(static_cast<gl::GLenum>(GL_DEPTH_ATTACHMENT), m_depthRenderbuffer.get());
+        m_framebuffers[i]->setDrawBuffer(static_cast<gl::GLenum>(GL_COLOR_ATTACHMENT0));
+
+        m_framebuffers[i]->unbind();
+    }
+}
+
+void ReflectionProbe::updateFaceMatrices()
+{
+    // this is a cubemap, hence aspect ratio **must** be 1:1
+    const auto projection = glm::perspective(glm::radians(90.0f), 1.0f, m_nearPlane, m_farPlane);
+
+    const std::array<std::pair<glm::vec3, glm::vec3>, 6> directions {
+        std::make_pair(glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)),
+        std::make_pair(glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)),
+        std::make_pair(glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)),
+        std::make_pair(glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f)),
+        std::make_pair(glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, -1.0f, 0.0f)),
+        std::make_pair(glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, -1.0f, 0.0f)),
+    };
+
+    for (auto face = 0; face < 6; ++face)
+    {
+        const auto& [direction, up] = directions[face];
+
+        m_projectionViewMatrices[face] = projection * glm::lookAt(m_position, m_position + direction, up);
+
+        // extract the frustum planes from the projection-view matrix (Gribb-Hartmann)
+        const auto m = glm::transpose(m_projectionViewMatrices[face]);
+
+        m_frustumPlanes[face] = {
+            m[3] + m[0],
+            m[3] - m[0],
+            m[3] + m[1],
+            m[3] - m[1],
+            m[3] + m[2],
+            m[3] - m[2],
+        };
+
+        for (auto& plane : m_frustumPlanes[face])
+        {
+            plane /= glm::length(glm::vec3(plane));
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "stdafx.hpp"
+
+#include "BoundingSphere.hpp"
+#include "MultiMeshModel.hpp"
+
+class ReflectionProbe
+{
+public:
+    ReflectionProbe(glm::vec3 position, float nearPlane, float farPlane, unsigned int maxResolution = 2048, unsigned int minResolution = 256);
+
+    // casters are only referenced - the probe does not own the models
+    void addCaster(MultiMeshModel* model, bool cullFaces = true);
+
+    void setPosition(glm::vec3 position);
+
+    glm::vec3 getPosition() const;
+
+    // how many cubemap faces are allowed to be re-rendered within a single update() call (2 by default);
+    // an update() which changes the resolution renders all six regardless
+    void setFacesPerFrame(unsigned int facesPerFrame);
+
+    // the probe renders at full resolution while the camera is closer than this distance;
+    // every time the distance doubles, the resolution is halved (down to the minimal resolution)
+    void setResolutionFalloffDistance(float distance);
+
+    void invalidate();
+
+    bool isDirty() const;
+
+    unsigned int getResolution() const;
+
+    globjects::Texture* getTexture() const;
+
+    // re-renders (some of) the faces affected by the changes since the last update;
+    // returns the number of faces actually rendered this call
+    unsigned int update(glm::vec3 cameraPosition, globjects::Program* program);
+
+protected:
+    struct Caster
+    {
+        MultiMeshModel* model;
+        bool cullFaces;
+        glm::mat4 transformation;
+        BoundingSphere worldBoundingSphere;
+    };
+
+    void renderFace(unsigned int face, globjects::Program* program);
+
+    void detectChanges();
+
+    void markDirty(const BoundingSphere& sphere);
+
+    bool isVisible(unsigned int face, const BoundingSphere& sphere) const;
+
+    unsigned int selectResolution(glm::vec3 cameraPosition) const;
+
+    void resize(unsigned int resolution);
+
+    void updateFaceMatrices();
+
+    glm::vec3 m_position;
+    float m_nearPlane;
+    float m_farPlane;
+
+    unsigned int m_maxResolution;
+    unsigned int m_minResolution;
+    unsigned int m_resolution;
+    unsigned int m_facesPerFrame;
+    float m_resolutionFalloffDistance;
+    unsigned int m_nextFace;
+
+    std::vector<Caster> m_casters;
+
+    std::array<bool, 6> m_dirtyFaces;
+    std::array<glm::mat4, 6> m_projectionViewMatrices;
+    std::array<std::array<glm::vec4, 6>, 6> m_frustumPlanes;
+
+    std::unique_ptr<globjects::Texture> m_texture;
+    std::unique_ptr<globjects::Renderbuffer> m_depthRenderbuffer;
+    std::array<std::unique_ptr<globjects::Framebuffer>, 6> m_framebuffers;
+};
@@ -1,6 +1,7 @@
 #include "common/stdafx.hpp"
 
 #include "common/AssimpModel.hpp"
+#include "common/ReflectionProbe.hpp"
 #include "common/Skybox.hpp"
 
 struct alignas(16) PointLightData
@@ -56,20 +57,6 @@ int main()
 
     std::cout << "done" << std::endl;
 
-    std::cout << "[INFO] Compiling reflection mapping geometry shader...";
-
-    auto reflectionMappingGeometrySource = globjects::Shader::sourceFromFile("media/reflection-mapping.geom");
-    auto reflectionMappingGeometryShaderTemplate = globjects::Shader::applyGlobalReplacements(reflectionMappingGeometrySource.get());
-    auto reflectionMappingGeometryShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_GEOMETRY_SHADER), reflectionMappingGeometryShaderTemplate.get());
-
-    if (!reflectionMappingGeometryShader->compile())
-    {
-        std::cerr << "[ERROR] Can not compile reflection mapping fragment shader" << std::endl;
-        return 1;
-    }
-
-    std::cout << "done" << std::endl;
-
     std::cout << "[INFO] Compiling reflection mapping fragment shader...";
 
     auto reflectionMappingFragmentSource = globjects::Shader::sourceFromFile("media/reflection-mapping.frag");
@@ -87,9 +74,7 @@ int main()
     std::cout << "[DEBUG] Linking reflection mapping shaders..." << std::endl;
 
     auto reflectionMappingProgram = std::make_unique<globjects::Program>();
-    reflectionMappingProgram->attach(reflectionMappingVertexShader.get(), reflectionMappingGeometryShader.get(), reflectionMappingFragmentShader.get());
-
-    auto reflectionMappingModelTransformationUniform = reflectionMappingProgram->getUniform<glm::mat4>("modelTransformation");
+    reflectionMappingProgram->attach(reflectionMappingVertexShader.get(), reflectionMappingFragmentShader.get());
 
     std::cout << "done" << std::endl;
 
@@ -353,68 +338,6 @@ int main()
 
     std::cout << "[DEBUG] Initializing framebuffers...";
 
-    std::cout << "[DEBUG] Initializing reflectionMapTexture...";
-
-    auto reflectionMapTexture = std::make_unique<globjects::Texture>(static_cast<gl::GLenum>(GL_TEXTURE_CUBE_MAP));
-
-    reflectionMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<gl::GLenum>(GL_LINEAR));
-    reflectionMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAG_FILTER), static_cast<gl::GLenum>(GL_LINEAR));
-
-    reflectionMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_S), static_cast<gl::GLenum>(GL_CLAMP_TO_BORDER));
-    reflectionMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_T), static_cast<gl::GLenum>(GL_CLAMP_TO_BORDER));
-    reflectionMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_R), static_cast<gl::GLenum>(GL_CLAMP_TO_BORDER));
-
-    reflectionMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_BORDER_COLOR), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
-
-    reflectionMapTexture->bind();
-
-    const auto reflectionMapSize = 2048;
-
-    for (auto i = 0; i < 6; ++i)
-    {
-        ::glTexImage2D(
-            static_cast<::GLenum>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i),
-            0,
-            GL_RGBA8,
-            reflectionMapSize,
-            reflectionMapSize,
-            0,
-            GL_RGBA,
-            GL_UNSIGNED_INT,
-            nullptr);
-    }
-
-    reflectionMapTexture->unbind();
-
-    auto reflectionMapDepthTexture = std::make_unique<globjects::Texture>(static_cast<gl::GLenum>(GL_TEXTURE_CUBE_MAP));
-
-    reflectionMapDepthTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<gl::GLenum>(GL_LINEAR));
-    reflectionMapDepthTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAG_FILTER), static_cast<gl::GLenum>(GL_LINEAR));
-
-    reflectionMapDepthTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_S), static_cast<gl::GLenum>(GL_CLAMP_TO_BORDER));
-    reflectionMapDepthTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_T), static_cast<gl::GLenum>(GL_CLAMP_TO_BORDER));
-    reflectionMapDepthTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_R), static_cast<gl::GLenum>(GL_CLAMP_TO_BORDER));
-
-    reflectionMapDepthTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_BORDER_COLOR), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
-
-    reflectionMapDepthTexture->bind();
-
-    for (auto i = 0; i < 6; ++i)
-    {
-        ::glTexImage2D(
-            static_cast<::GLenum>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i),
-            0,
-            GL_DEPTH_COMPONENT,
-            reflectionMapSize,
-            reflectionMapSize,
-            0,
-            GL_DEPTH_COMPONENT,
-            GL_FLOAT,
-            nullptr);
-    }
-
-    reflectionMapDepthTexture->unbind();
-
     /*auto skybox = Skybox::fromCubemap(reflectionMapTexture.get())
         ->size(40.0f)
         ->build();*/
@@ -431,16 +354,20 @@ int main()
 
     std::cout << "done" << std::endl;
 
-    std::cout << "[DEBUG] Initializing reflection mapping frame buffer...";
+    std::cout << "[DEBUG] Initializing reflection probe...";
 
-    auto reflectionMappingFramebuffer = std::make_unique<globjects::Framebuffer>();
-    reflectionMappingFramebuffer->attachTexture(static_cast<gl::GLenum>(GL_COLOR_ATTACHMENT0), reflectionMapTexture.get());
-    reflectionMappingFramebuffer->attachTexture(static_cast<gl::GLenum>(GL_DEPTH_ATTACHMENT), reflectionMapDepthTexture.get());
+    // TODO: technically, this offset should be calculated as AABB / 2
+    auto reflectionProbe = std::make_unique<ReflectionProbe>(reflectiveModelPosition + glm::vec3(0.0f, 0.05f, 0.0f), 0.1f, 10.0f, 2048, 256);
 
-    // tell framebuffer it actually needs to render to **BOTH** textures, but does not have to output anywhere (last NONE argument, iirc)
-    reflectionMappingFramebuffer->setDrawBuffers({ static_cast<gl::GLenum>(GL_COLOR_ATTACHMENT0), static_cast<gl::GLenum>(GL_NONE) });
+    reflectionProbe->addCaster(houseModel.get());
+    reflectionProbe->addCaster(tableModel.get());
+    reflectionProbe->addCaster(lanternModel.get());
+    // scroll model needs culling to be disabled since this is a modified plane, so...
+    reflectionProbe->addCaster(scrollModel.get(), false);
+    reflectionProbe->addCaster(penModel.get());
 
-    reflectionMappingFramebuffer->printStatus(true);
+    // spread the refresh over several frames - two faces per frame
+    reflectionProbe->setFacesPerFrame(2);
 
     std::cout << "done" << std::endl;
 
@@ -560,77 +487,8 @@ int main()
             cameraPos + cameraForward,
             cameraUp);
 
-        const float nearPlane = 0.1f;
-        const float farPlane = 10.0f;
-
-        // this is a cubemap, hence aspect ratio **must** be 1:1
-        glm::mat4 reflectionProjection = glm::perspective(glm::radians(90.0f), 1.0f, nearPlane, farPlane);
-
-        // TODO: technically, this should be calculated as AABB / 2
-        const auto reflectionOffset = glm::vec3(0.0f, 0.05f, 0.0f);
-
-        reflectionMappingProgram->setUniform("projectionViewMatrices[0]", reflectionProjection * glm::lookAt(reflectiveModelPosition + reflectionOffset, reflectiveModelPosition + glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)));
-        reflectionMappingProgram->setUniform("projectionViewMatrices[1]", reflectionProjection * glm::lookAt(reflectiveModelPosition + reflectionOffset, reflectiveModelPosition + glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)));
-        reflectionMappingProgram->setUniform("projectionViewMatrices[2]", reflectionProjection * glm::lookAt(reflectiveModelPosition + reflectionOffset, reflectiveModelPosition + glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
-        reflectionMappingProgram->setUniform("projectionViewMatrices[3]", reflectionProjection * glm::lookAt(reflectiveModelPosition + reflectionOffset, reflectiveModelPosition + glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f)));
-        reflectionMappingProgram->setUniform("projectionViewMatrices[4]", reflectionProjection * glm::lookAt(reflectiveModelPosition + reflectionOffset, reflectiveModelPosition + glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, -1.0f, 0.0f)));
-        reflectionMappingProgram->setUniform("projectionViewMatrices[5]", reflectionProjection * glm::lookAt(reflectiveModelPosition + reflectionOffset, reflectiveModelPosition + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, -1.0f, 0.0f)));
-
-        // first render pass - shadow mapping
-        reflectionMappingFramebuffer->bind();
-
-        ::glViewport(0, 0, reflectionMapSize, reflectionMapSize);
-        ::glClearColor(static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(1.0f));
-        ::glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_CULL_FACE);
-
-        // cull front faces to prevent peter panning the generated shadow map
-        glCullFace(GL_BACK);
-
-        reflectionMappingProgram->use();
-
-        reflectionMappingProgram->setUniform("diffuseTexture", 1);
-
-        reflectionMappingModelTransformationUniform->set(houseModel->getTransformation());
-
-        houseModel->bind();
-        houseModel->draw();
-        houseModel->unbind();
-
-        reflectionMappingModelTransformationUniform->set(tableModel->getTransformation());
-
-        tableModel->bind();
-        tableModel->draw();
-        tableModel->unbind();
-
-        reflectionMappingModelTransformationUniform->set(lanternModel->getTransformation());
-
-        lanternModel->bind();
-        lanternModel->draw();
-        lanternModel->unbind();
-
-        reflectionMappingModelTransformationUniform->set(scrollModel->getTransformation());
-
-        // scroll model needs culling to be disabled since this is a modified plane, so...
-        glDisable(GL_CULL_FACE);
-
-        scrollModel->bind();
-        scrollModel->draw();
-        scrollModel->unbind();
-
-        glEnable(GL_CULL_FACE);
-
-        reflectionMappingModelTransformationUniform->set(penModel->getTransformation());
-
-        penModel->bind();
-        penModel->draw();
-        penModel->unbind();
-
-        reflectionMappingFramebuffer->unbind();
-
-        reflectionMappingProgram->release();
+        // first render pass - reflection mapping; only re-renders the cubemap faces affected by the changes in the scene
+        reflectionProbe->update(cameraPos, reflectionMappingProgram.get());
 
         glEnable(GL_CULL_FACE);
         glCullFace(GL_BACK);
@@ -650,7 +508,7 @@ int main()
         skyboxRenderingProgram->setUniform("view", glm::mat4(glm::mat3(cameraView)));
 
 #ifndef _DEBUG
-        reflectionMapTexture->bindActive(0);
+        reflectionProbe->getTexture()->bindActive(0);
         skyboxRenderingProgram->setUniform("cubeMap", 0);
 #else
         skyboxRenderingProgram->setUniform("cubeMap", 1);
@@ -660,7 +518,7 @@ int main()
         skybox->draw();
         skybox->unbind();
 
-        reflectionMapTexture->unbindActive(0);
+        reflectionProbe->getTexture()->unbindActive(0);
 
         skyboxRenderingProgram->release();
 
@@ -674,7 +532,7 @@ int main()
 
         reflectionRenderingProgram->setUniform("cameraPosition", cameraPos);
 
-        reflectionMapTexture->bindActive(0);
+        reflectionProbe->getTexture()->bindActive(0);
 
         reflectionRenderingProgram->setUniform("reflectionMap", 0);
         reflectionRenderingProgram->setUniform("diffuseTexture", 1);
@@ -683,7 +541,7 @@ int main()
         inkBottleModel->draw();
         inkBottleModel->unbind();
 
-        reflectionMapTexture->unbindActive(0);
+        reflectionProbe->getTexture()->unbindActive(0);
 
         reflectionRenderingProgram->release();
 
@@ -26,6 +26,15 @@ void main()
     {
         fsNormal = fsIn.normal;
     }
+    else
+    {
+        // cooked normal maps are BC5, which only keeps the red and green channels (blue reads as zero), so the blue one is
+        // rebuilt from the other two; for the uncompressed maps this gives back what is stored
+        vec2 normalXY = fsNormal.rg * 2.0 - 1.0;
+        float normalZ = sqrt(max(0.0, 1.0 - dot(normalXY, normalXY)));
+
+        fsNormal = vec3(fsNormal.rg, normalZ * 0.5 + 0.5);
+    }
 
     fsNormal = normalize(fsNormal.xyz) * 0.5 + 0.5;
 
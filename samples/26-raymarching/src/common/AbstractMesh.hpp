@@ -95,9 +95,14 @@ public:
 
     AbstractMeshBuilder* setUVAttributerIndex(unsigned int uvAttributeIndex);
 
+    // runs the MeshOptimizer pipeline over the mesh data on build()
+    AbstractMeshBuilder* optimize();
+
     std::unique_ptr<AbstractMesh> build();
 
 private:
+    void optimizeMesh();
+
     std::vector<glm::vec3> m_vertices;
     std::vector<glm::vec3> m_normals;
     std::vector<glm::vec3> m_tangents;
@@ -120,4 +125,6 @@ private:
     unsigned int m_tangentAttributeIndex;
     unsigned int m_bitangentAttributeIndex;
     unsigned int m_uvAttributeIndex;
+
+    bool m_isOptimized;
 };
@@ -1,11 +1,13 @@
 #include "AbstractMesh.hpp"
+#include "MeshOptimizer.hpp"
 
 AbstractMeshBuilder::AbstractMeshBuilder() :
     m_positionAttributeIndex(0),
     m_normalAttributeIndex(1),
     m_tangentAttributeIndex(3),
     m_bitangentAttributeIndex(4),
-    m_uvAttributeIndex(2)
+    m_uvAttributeIndex(2),
+    m_isOptimized(false)
 {
 }
 
@@ -114,8 +116,56 @@ AbstractMeshBuilder* AbstractMeshBuilder::setUVAttributerIndex(unsigned int uvAt
     return this;
 }
 
+AbstractMeshBuilder* AbstractMeshBuilder::optimize()
+{
+    m_isOptimized = true;
+
+    return this;
+}
+
+void AbstractMeshBuilder::optimizeMesh()
+{
+    const auto vertexCount = m_vertices.size();
+
+    // only the attributes present for every vertex take part in the deduplication
+    std::vector<MeshOptimizer::VertexStream> streams { { m_vertices.data(), sizeof(glm::vec3) } };
+
+    if (m_normals.size() == vertexCount)
+    {
+        streams.push_back({ m_normals.data(), sizeof(glm::vec3) });
+    }
+
+    if (m_uvs.size() == vertexCount)
+    {
+        streams.push_back({ m_uvs.data(), sizeof(glm::vec2) });
+    }
+
+    if (m_tangents.size() == vertexCount && m_bitangents.size() == vertexCount)
+    {
+        streams.push_back({ m_tangents.data(), sizeof(glm::vec3) });
+        streams.push_back({ m_bitangents.data(), sizeof(glm::vec3) });
+    }
+
+    const auto result = MeshOptimizer::optimize(m_indices, vertexCount, streams, m_vertices);
+
+    m_vertices = MeshOptimizer::remapVertices(m_vertices, result.remap, result.vertexCount);
+    m_normals = MeshOptimizer::remapVertices(m_normals, result.remap, result.vertexCount);
+    m_uvs = MeshOptimizer::remapVertices(m_uvs, result.remap, result.vertexCount);
+    m_tangents = MeshOptimizer::remapVertices(m_tangents, result.remap, result.vertexCount);
+    m_bitangents = MeshOptimizer::remapVertices(m_bitangents, result.remap, result.vertexCount);
+
+    std::cout << "[DEBUG] Mesh optimized: vertices " << vertexCount << " -> " << result.vertexCount
+              << "; ACMR " << result.before.acmr << " -> " << result.after.acmr
+              << "; ATVR " << result.before.atvr << " -> " << result.after.atvr << std::endl;
+}
+
 std::unique_ptr<AbstractMesh> AbstractMeshBuilder::build()
 {
+    if (m_isOptimized && !m_indices.empty())
+    {
+        optimizeMesh();
+    }
+
     m_vertexBuffer = std::make_unique<globjects::Buffer>();
 
     m_vertexBuffer->setData(m_vertices, static_cast<gl::GLenum>(GL_STATIC_DRAW));
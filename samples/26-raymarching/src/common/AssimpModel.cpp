@@ -189,5 +189,6 @@ std::unique_ptr<AbstractMesh> AssimpModel::fromAiMesh(const aiScene* scene, aiMe
         ->addTangentsBitangents(tangents, bitangents)
         ->addUVs(uvs)
         ->addTextures(textures)
+        ->optimize()
         ->build();
 }
@@ -0,0 +1,120 @@
+#include "DdsImage.hpp"
+
+namespace
+{
+    constexpr std::uint32_t makeFourCC(char a, char b, char c, char d)
+    {
+        return static_cast<std::uint32_t>(a) | (static_cast<std::uint32_t>(b) << 8) | (static_cast<std::uint32_t>(c) << 16) | (static_cast<std::uint32_t>(d) << 24);
+    }
+
+    // only the fields the loader needs; the header is 124 bytes, following the magic number
+    constexpr std::size_t HEADER_SIZE = 124;
+    constexpr std::size_t HEIGHT_OFFSET = 8;
+    constexpr std::size_t WIDTH_OFFSET = 12;
+    constexpr std::size_t MIP_MAP_COUNT_OFFSET = 24;
+    constexpr std::size_t FOUR_CC_OFFSET = 80;
+
+    std::uint32_t readUint32(const std::uint8_t* data)
+    {
+        return static_cast<std::uint32_t>(data[0]) | (static_cast<std::uint32_t>(data[1]) << 8) | (static_cast<std::uint32_t>(data[2]) << 16) | (static_cast<std::uint32_t>(data[3]) << 24);
+    }
+}
+
+DdsImage::DdsImage(gl::GLenum format, std::size_t blockSize, std::vector<MipLevel> mipLevels) :
+    m_format(format),
+    m_blockSize(blockSize),
+    m_mipLevels(std::move(mipLevels))
+{
+}
+
+std::unique_ptr<DdsImage> DdsImage::loadFromFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file)
+    {
+        return nullptr;
+    }
+
+    std::vector<std::uint8_t> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (contents.size() < 4 + HEADER_SIZE || readUint32(contents.data()) != makeFourCC('D', 'D', 'S', ' '))
+    {
+        std::cerr << "[ERROR] " << path << " is not a DDS file" << std::endl;
+        return nullptr;
+    }
+
+    const auto* header = contents.data() + 4;
+
+    const auto width = readUint32(header + WIDTH_OFFSET);
+    const auto height = readUint32(header + HEIGHT_OFFSET);
+    const auto mipMapCount = std::max<std::uint32_t>(readUint32(header + MIP_MAP_COUNT_OFFSET), 1);
+    const auto fourCC = readUint32(header + FOUR_CC_OFFSET);
+
+    gl::GLenum format;
+    std::size_t blockSize;
+
+    if (fourCC == makeFourCC('D', 'X', 'T', '1'))
+    {
+        format = static_cast<gl::GLenum>(GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+        blockSize = 8;
+    }
+    else if (fourCC == makeFourCC('D', 'X', 'T', '5'))
+    {
+        format = static_cast<gl::GLenum>(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+        blockSize = 16;
+    }
+    else if (fourCC == makeFourCC('A', 'T', 'I', '2'))
+    {
+        format = static_cast<gl::GLenum>(GL_COMPRESSED_RG_RGTC2);
+        blockSize = 16;
+    }
+    else
+    {
+        std::cerr << "[ERROR] " << path << " uses an unsupported DDS format" << std::endl;
+        return nullptr;
+    }
+
+    std::vector<MipLevel> mipLevels;
+
+    std::size_t offset = 4 + HEADER_SIZE;
+
+    auto size = glm::uvec2(width, height);
+
+    for (std::uint32_t level = 0; level < mipMapCount; ++level)
+    {
+        const std::size_t levelSize = ((size.x + 3) / 4) * ((size.y + 3) / 4) * blockSize;
+
+        if (offset + levelSize > contents.size())
+        {
+            std::cerr << "[ERROR] " << path << " is truncated" << std::endl;
+            return nullptr;
+        }
+
+        mipLevels.push_back({
+            .size = size,
+            .data = std::vector<std::uint8_t>(contents.begin() + offset, contents.begin() + offset + levelSize)
+        });
+
+        offset += levelSize;
+
+        size = glm::max(size / 2u, glm::uvec2(1));
+    }
+
+    return std::unique_ptr<DdsImage>(new DdsImage(format, blockSize, std::move(mipLevels)));
+}
+
+gl::GLenum DdsImage::getFormat() const
+{
+    return m_format;
+}
+
+std::size_t DdsImage::getBlockSize() const
+{
+    return m_blockSize;
+}
+
+std::vector<DdsImage::MipLevel>& DdsImage::getMipLevels()
+{
+    return m_mipLevels;
+}
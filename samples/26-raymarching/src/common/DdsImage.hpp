@@ -0,0 +1,34 @@
+#pragma once
+
+#include "stdafx.hpp"
+
+/**
+ * Block-compressed image with a full mip chain, as written by tools/texture-cooker.
+ *
+ * Only the legacy FourCC formats the cooker produces are supported: DXT1 (BC1), DXT5 (BC3) and ATI2 (BC5).
+ */
+class DdsImage
+{
+public:
+    struct MipLevel
+    {
+        glm::uvec2 size;
+        std::vector<std::uint8_t> data;
+    };
+
+    static std::unique_ptr<DdsImage> loadFromFile(const std::filesystem::path& path);
+
+    gl::GLenum getFormat() const;
+
+    // bytes per 4x4 block
+    std::size_t getBlockSize() const;
+
+    std::vector<MipLevel>& getMipLevels();
+
+protected:
+    DdsImage(gl::GLenum format, std::size_t blockSize, std::vector<MipLevel> mipLevels);
+
+    gl::GLenum m_format;
+    std::size_t m_blockSize;
+    std::vector<MipLevel> m_mipLevels;
+};
@@ -0,0 +1,496 @@
+#include "TextureStreamer.hpp"
+
+#include "DdsImage.hpp"
+
+StreamedTexture::StreamedTexture(std::filesystem::path path, sf::Color placeholderColor) :
+    m_path(std::move(path)),
+    m_texture(std::make_unique<globjects::Texture>(static_cast<gl::GLenum>(GL_TEXTURE_2D))),
+    m_internalFormat(static_cast<gl::GLenum>(GL_RGBA8)),
+    m_blockSize(0),
+    m_isFailed(false),
+    m_uploadLevel(-1),
+    m_uploadRow(0),
+    m_isComplete(false)
+{
+    const std::array<std::uint8_t, 4> placeholder = { placeholderColor.r, placeholderColor.g, placeholderColor.b, placeholderColor.a };
+
+    m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<GLint>(GL_LINEAR));
+    m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAG_FILTER), static_cast<GLint>(GL_LINEAR));
+
+    m_texture->image2D(
+        0,
+        static_cast<gl::GLenum>(GL_RGBA8),
+        glm::vec2(1, 1),
+        0,
+        static_cast<gl::GLenum>(GL_RGBA),
+        static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
+        reinterpret_cast<const gl::GLvoid*>(placeholder.data()));
+}
+
+globjects::Texture* StreamedTexture::getTexture() const
+{
+    return m_texture.get();
+}
+
+bool StreamedTexture::isComplete() const
+{
+    return m_isComplete;
+}
+
+bool StreamedTexture::isFailed() const
+{
+    return m_isFailed;
+}
+
+unsigned int StreamedTexture::getRowHeight() const
+{
+    return m_blockSize > 0 ? 4 : 1;
+}
+
+std::size_t StreamedTexture::getRowSize(int level) const
+{
+    const auto width = m_mipLevels[level].size.x;
+
+    return m_blockSize > 0 ? ((width + 3) / 4) * m_blockSize : width * 4;
+}
+
+unsigned int StreamedTexture::getRowCount(int level) const
+{
+    return (m_mipLevels[level].size.y + getRowHeight() - 1) / getRowHeight();
+}
+
+TextureStreamer::TextureStreamer(std::size_t uploadBudgetPerFrame, unsigned int workerCount, unsigned int stagingBufferCount) :
+    m_uploadBudgetPerFrame(uploadBudgetPerFrame),
+    // a single row of the largest texture supported must always fit
+    m_stagingBufferSize(std::max<std::size_t>(uploadBudgetPerFrame, 16384 * 4)),
+    m_isStopping(false),
+    m_decodingCount(0),
+    m_stagingFences(stagingBufferCount, nullptr),
+    m_stagingBufferIndex(0)
+{
+    for (unsigned int i = 0; i < stagingBufferCount; ++i)
+    {
+        auto buffer = std::make_unique<globjects::Buffer>();
+        buffer->setData(static_cast<gl::GLsizeiptr>(m_stagingBufferSize), nullptr, static_cast<gl::GLenum>(GL_STREAM_DRAW));
+
+        m_stagingBuffers.push_back(std::move(buffer));
+    }
+
+    for (unsigned int i = 0; i < workerCount; ++i)
+    {
+        m_workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+    }
+
+    m_hasWork.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+
+    for (auto& fence : m_stagingFences)
+    {
+        if (fence != nullptr)
+        {
+            ::glDeleteSync(fence);
+        }
+    }
+}
+
+std::shared_ptr<StreamedTexture> TextureStreamer::load(std::filesystem::path path, sf::Color placeholderColor)
+{
+    auto texture = std::make_shared<StreamedTexture>(std::move(path), placeholderColor);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_decodeQueue.push_back(texture);
+    }
+
+    m_hasWork.notify_one();
+
+    return texture;
+}
+
+void TextureStreamer::update()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        while (!m_decodedQueue.empty())
+        {
+            auto texture = std::move(m_decodedQueue.front());
+            m_decodedQueue.pop_front();
+
+            if (texture->m_isFailed)
+            {
+                std::cerr << "[ERROR] Can not load texture " << texture->m_path << std::endl;
+                continue;
+            }
+
+            m_uploadQueue.push_back(std::move(texture));
+        }
+    }
+
+    // allocation has to happen before the staging buffer gets bound, otherwise GL would read the (null) data from it
+    for (auto& texture : m_uploadQueue)
+    {
+        if (texture->m_uploadLevel < 0 && !texture->m_isComplete)
+        {
+            allocate(texture.get());
+        }
+    }
+
+    releaseCompleted();
+
+    if (m_uploadQueue.empty())
+    {
+        return;
+    }
+
+    auto& fence = m_stagingFences[m_stagingBufferIndex];
+
+    if (fence != nullptr)
+    {
+        // the GPU is still reading from this staging buffer - try again next frame instead of stalling
+        if (::glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED)
+        {
+            return;
+        }
+
+        ::glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    ::glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_stagingBuffers[m_stagingBufferIndex]->id());
+
+    // the whole buffer is free (see the fence), hence there is no need for driver to synchronize
+    auto* stagingData = static_cast<std::uint8_t*>(::glMapBufferRange(
+        GL_PIXEL_UNPACK_BUFFER,
+        0,
+        static_cast<GLsizeiptr>(m_stagingBufferSize),
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+
+    if (stagingData == nullptr)
+    {
+        std::cerr << "[ERROR] Can not map texture staging buffer" << std::endl;
+
+        ::glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        return;
+    }
+
+    std::vector<PendingCopy> copies;
+    std::size_t stagedBytes = 0;
+
+    for (auto& texture : m_uploadQueue)
+    {
+        while (texture->m_uploadLevel >= 0)
+        {
+            const auto bytes = stageRows(texture.get(), stagingData, stagedBytes, m_uploadBudgetPerFrame - std::min(stagedBytes, m_uploadBudgetPerFrame), copies);
+
+            if (bytes == 0)
+            {
+                break;
+            }
+
+            stagedBytes += bytes;
+        }
+
+        if (stagedBytes >= m_uploadBudgetPerFrame)
+        {
+            break;
+        }
+    }
+
+    ::glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    for (const auto& copy : copies)
+    {
+        const auto& mipLevel = copy.texture->m_mipLevels[copy.level];
+
+        const auto rowHeight = copy.texture->getRowHeight();
+        const auto y = copy.row * rowHeight;
+        const auto height = std::min(copy.rowCount * rowHeight, mipLevel.size.y - y);
+
+        // with the unpack buffer bound, the data pointer is an offset within that buffer
+        if (copy.texture->m_blockSize > 0)
+        {
+            copy.texture->m_texture->bind();
+
+            ::glCompressedTexSubImage2D(
+                GL_TEXTURE_2D,
+                copy.level,
+                0,
+                static_cast<GLint>(y),
+                static_cast<GLsizei>(mipLevel.size.x),
+                static_cast<GLsizei>(height),
+                static_cast<GLenum>(copy.texture->m_internalFormat),
+                static_cast<GLsizei>(copy.rowCount * copy.texture->getRowSize(copy.level)),
+                reinterpret_cast<const void*>(copy.stagingOffset));
+
+            copy.texture->m_texture->unbind();
+        }
+        else
+        {
+            copy.texture->m_texture->subImage2D(
+                copy.level,
+                glm::ivec2(0, y),
+                glm::ivec2(mipLevel.size.x, height),
+                static_cast<gl::GLenum>(GL_RGBA),
+                static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
+                reinterpret_cast<const gl::GLvoid*>(copy.stagingOffset));
+        }
+
+        if (copy.row + copy.rowCount < copy.texture->getRowCount(copy.level))
+        {
+            continue;
+        }
+
+        // the level is complete - let the sampler use it
+        copy.texture->m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_BASE_LEVEL), static_cast<GLint>(copy.level));
+
+        if (copy.level == 0)
+        {
+            copy.texture->m_isComplete = true;
+        }
+    }
+
+    ::glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    fence = ::glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    m_stagingBufferIndex = (m_stagingBufferIndex + 1) % m_stagingBuffers.size();
+
+    releaseCompleted();
+}
+
+bool TextureStreamer::isIdle() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_decodeQueue.empty() && m_decodedQueue.empty() && m_decodingCount == 0 && m_uploadQueue.empty();
+}
+
+void TextureStreamer::releaseCompleted()
+{
+    while (!m_uploadQueue.empty() && m_uploadQueue.front()->m_isComplete)
+    {
+        // the pixels are on the GPU now
+        m_uploadQueue.front()->m_mipLevels.clear();
+        m_uploadQueue.front()->m_mipLevels.shrink_to_fit();
+
+        m_uploadQueue.pop_front();
+    }
+}
+
+void TextureStreamer::workerLoop()
+{
+    while (true)
+    {
+        std::shared_ptr<StreamedTexture> texture;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            m_hasWork.wait(lock, [this]() { return m_isStopping || !m_decodeQueue.empty(); });
+
+            if (m_isStopping)
+            {
+                return;
+            }
+
+            texture = std::move(m_decodeQueue.front());
+            m_decodeQueue.pop_front();
+
+            ++m_decodingCount;
+        }
+
+        decode(texture.get());
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            --m_decodingCount;
+            m_decodedQueue.push_back(std::move(texture));
+        }
+    }
+}
+
+void TextureStreamer::decode(StreamedTexture* texture)
+{
+    auto cookedPath = texture->m_path;
+    cookedPath += ".dds";
+
+    std::error_code error;
+
+    if (std::filesystem::exists(cookedPath, error))
+    {
+        auto cookedImage = DdsImage::loadFromFile(cookedPath);
+
+        if (cookedImage)
+        {
+            texture->m_internalFormat = cookedImage->getFormat();
+            texture->m_blockSize = cookedImage->getBlockSize();
+
+            // the mip chain is precomputed and the rows are already flipped by the cooker
+            for (auto& mipLevel : cookedImage->getMipLevels())
+            {
+                texture->m_mipLevels.push_back({ .size = mipLevel.size, .pixels = std::move(mipLevel.data) });
+            }
+
+            return;
+        }
+    }
+
+    sf::Image image;
+
+    if (!image.loadFromFile(texture->m_path.string()))
+    {
+        texture->m_isFailed = true;
+        return;
+    }
+
+    image.flipVertically();
+
+    const auto size = glm::uvec2(image.getSize().x, image.getSize().y);
+
+    if (size.x == 0 || size.y == 0)
+    {
+        texture->m_isFailed = true;
+        return;
+    }
+
+    texture->m_mipLevels.push_back({
+        .size = size,
+        .pixels = std::vector<std::uint8_t>(image.getPixelsPtr(), image.getPixelsPtr() + size.x * size.y * 4)
+    });
+
+    // box-filtered mip chain, down to 1x1; odd dimensions clamp to the last column / row
+    while (texture->m_mipLevels.back().size.x > 1 || texture->m_mipLevels.back().size.y > 1)
+    {
+        const auto& source = texture->m_mipLevels.back();
+
+        StreamedTexture::MipLevel target {
+            .size = glm::max(source.size / 2u, glm::uvec2(1))
+        };
+
+        target.pixels.resize(target.size.x * target.size.y * 4);
+
+        for (unsigned int y = 0; y < target.size.y; ++y)
+        {
+            const auto y0 = std::min(y * 2, source.size.y - 1);
+            const auto y1 = std::min(y * 2 + 1, source.size.y - 1);
+
+            for (unsigned int x = 0; x < target.size.x; ++x)
+            {
+                const auto x0 = std::min(x * 2, source.size.x - 1);
+                const auto x1 = std::min(x * 2 + 1, source.size.x - 1);
+
+                for (unsigned int channel = 0; channel < 4; ++channel)
+                {
+                    const unsigned int sum =
+                        source.pixels[(y0 * source.size.x + x0) * 4 + channel] +
+                        source.pixels[(y0 * source.size.x + x1) * 4 + channel] +
+                        source.pixels[(y1 * source.size.x + x0) * 4 + channel] +
+                        source.pixels[(y1 * source.size.x + x1) * 4 + channel];
+
+                    target.pixels[(y * target.size.x + x) * 4 + channel] = static_cast<std::uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+
+        texture->m_mipLevels.push_back(std::move(target));
+    }
+}
+
+void TextureStreamer::allocate(StreamedTexture* texture)
+{
+    const auto lastLevel = static_cast<int>(texture->m_mipLevels.size()) - 1;
+
+    for (int level = 0; level <= lastLevel; ++level)
+    {
+        const auto& mipLevel = texture->m_mipLevels[level];
+
+        const auto* data = level == lastLevel ? reinterpret_cast<const gl::GLvoid*>(mipLevel.pixels.data()) : nullptr;
+
+        if (texture->m_blockSize > 0)
+        {
+            texture->m_texture->compressedImage2D(
+                level,
+                texture->m_internalFormat,
+                glm::ivec2(mipLevel.size.x, mipLevel.size.y),
+                0,
+                static_cast<gl::GLsizei>(texture->getRowCount(level) * texture->getRowSize(level)),
+                data);
+        }
+        else
+        {
+            texture->m_texture->image2D(
+                level,
+                static_cast<gl::GLenum>(GL_RGBA8),
+                glm::vec2(mipLevel.size.x, mipLevel.size.y),
+                0,
+                static_cast<gl::GLenum>(GL_RGBA),
+                static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
+                data);
+        }
+    }
+
+    // only the levels which are already uploaded are sampled from
+    texture->m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_BASE_LEVEL), static_cast<GLint>(lastLevel));
+    texture->m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAX_LEVEL), static_cast<GLint>(lastLevel));
+    texture->m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<GLint>(GL_LINEAR_MIPMAP_LINEAR));
+
+    texture->m_uploadLevel = lastLevel - 1;
+    texture->m_uploadRow = 0;
+    texture->m_isComplete = lastLevel == 0;
+}
+
+std::size_t TextureStreamer::stageRows(StreamedTexture* texture, std::uint8_t* stagingData, std::size_t stagingOffset, std::size_t bytesAvailable, std::vector<PendingCopy>& copies)
+{
+    const auto& mipLevel = texture->m_mipLevels[texture->m_uploadLevel];
+
+    const auto rowSize = texture->getRowSize(texture->m_uploadLevel);
+    const auto levelRowCount = texture->getRowCount(texture->m_uploadLevel);
+
+    auto rowCount = static_cast<unsigned int>(std::min<std::size_t>(levelRowCount - texture->m_uploadRow, bytesAvailable / rowSize));
+
+    if (rowCount == 0 && stagingOffset == 0)
+    {
+        // a row wider than the whole budget still has to make progress
+        rowCount = 1;
+    }
+
+    if (rowCount == 0)
+    {
+        return 0;
+    }
+
+    std::memcpy(stagingData + stagingOffset, mipLevel.pixels.data() + texture->m_uploadRow * rowSize, rowCount * rowSize);
+
+    copies.push_back({
+        .texture = texture,
+        .level = texture->m_uploadLevel,
+        .row = texture->m_uploadRow,
+        .rowCount = rowCount,
+        .stagingOffset = stagingOffset
+    });
+
+    texture->m_uploadRow += rowCount;
+
+    if (texture->m_uploadRow == levelRowCount)
+    {
+        --texture->m_uploadLevel;
+        texture->m_uploadRow = 0;
+    }
+
+    return rowCount * rowSize;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "stdafx.hpp"
+
+/**
+ * A texture which is filled in by the TextureStreamer.
+ *
+ * The texture object stays the same for its whole life, so it can be bound right away: it starts off as a 1x1 placeholder
+ * and gets the mip levels swapped in from the smallest to the largest one, as they are uploaded.
+ */
+class StreamedTexture
+{
+    friend class TextureStreamer;
+
+public:
+    StreamedTexture(std::filesystem::path path, sf::Color placeholderColor);
+
+    globjects::Texture* getTexture() const;
+
+    // true once all the mip levels are uploaded
+    bool isComplete() const;
+
+    // true when the image could not be loaded; the texture stays a placeholder
+    bool isFailed() const;
+
+protected:
+    struct MipLevel
+    {
+        glm::uvec2 size;
+        std::vector<std::uint8_t> pixels;
+    };
+
+    // compressed textures are uploaded by rows of 4x4 blocks rather than rows of texels
+    unsigned int getRowHeight() const;
+
+    std::size_t getRowSize(int level) const;
+
+    unsigned int getRowCount(int level) const;
+
+    std::filesystem::path m_path;
+    std::unique_ptr<globjects::Texture> m_texture;
+
+    // either GL_RGBA8 or one of the block-compressed formats, when a cooked DDS file is found next to the image
+    gl::GLenum m_internalFormat;
+    std::size_t m_blockSize;
+
+    // filled in by a worker thread, read by the main thread only after the texture is handed back through the queue
+    std::vector<MipLevel> m_mipLevels;
+
+    // set by a worker thread, but isFailed() can be asked at any time
+    std::atomic<bool> m_isFailed;
+
+    // upload progress: mip levels go from the last (smallest) to the first one, rows within a level go from the bottom up
+    int m_uploadLevel;
+    unsigned int m_uploadRow;
+    bool m_isComplete;
+};
+
+/**
+ * Decodes images (or reads their cooked, block-compressed versions - see tools/texture-cooker) on a pool of worker threads and uploads them through a ring of pixel unpack buffers,
+ * uploading at most a given number of bytes per frame.
+ */
+class TextureStreamer
+{
+public:
+    TextureStreamer(std::size_t uploadBudgetPerFrame, unsigned int workerCount = 2, unsigned int stagingBufferCount = 3);
+
+    ~TextureStreamer();
+
+    // the placeholder color is shown until the first mip level arrives, e.g. (128, 128, 255) is a flat normal
+    std::shared_ptr<StreamedTexture> load(std::filesystem::path path, sf::Color placeholderColor = sf::Color(128, 128, 128));
+
+    // uploads whatever fits the budget; has to be called on the thread owning the GL context, once per frame
+    void update();
+
+    // true when nothing is being decoded or uploaded
+    bool isIdle() const;
+
+protected:
+    void workerLoop();
+
+    void releaseCompleted();
+
+    static void decode(StreamedTexture* texture);
+
+    // allocates the whole mip chain and uploads the smallest level right away, replacing the placeholder
+    static void allocate(StreamedTexture* texture);
+
+    struct PendingCopy
+    {
+        StreamedTexture* texture;
+        int level;
+        unsigned int row;
+        unsigned int rowCount;
+        std::size_t stagingOffset;
+    };
+
+    // copies as many rows of the texture' current mip level to the staging memory as fit; returns the number of bytes used
+    std::size_t stageRows(StreamedTexture* texture, std::uint8_t* stagingData, std::size_t stagingOffset, std::size_t bytesAvailable, std::vector<PendingCopy>& copies);
+
+    std::size_t m_uploadBudgetPerFrame;
+    std::size_t m_stagingBufferSize;
+
+    std::vector<std::thread> m_workers;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_hasWork;
+    bool m_isStopping;
+
+    std::deque<std::shared_ptr<StreamedTexture>> m_decodeQueue;
+    std::deque<std::shared_ptr<StreamedTexture>> m_decodedQueue;
+    unsigned int m_decodingCount;
+
+    // main thread only
+    std::deque<std::shared_ptr<StreamedTexture>> m_uploadQueue;
+
+    std::vector<std::unique_ptr<globjects::Buffer>> m_stagingBuffers;
+    std::vector<GLsync> m_stagingFences;
+    unsigned int m_stagingBufferIndex;
+};
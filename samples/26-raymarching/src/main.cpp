@@ -2,6 +2,7 @@
 
 #include "common/AssimpModel.hpp"
 #include "common/Skybox.hpp"
+#include "common/TextureStreamer.hpp"
 
 struct alignas(16) PointLightDescriptor
 {
@@ -220,6 +221,9 @@ int main()
 
     std::cout << "done" << std::endl;
 
+    // textures are decoded in background and uploaded a bit every frame; until then, they are placeholders
+    TextureStreamer textureStreamer(2 * 1024 * 1024);
+
     std::cout << "[INFO] Loading 3D model...";
 
     Assimp::Importer importer;
@@ -278,79 +282,11 @@ int main()
         glm::scale(glm::vec3(0.5f))
     );
 
-    // TODO: extract this to material class
-    sf::Image lanternEmissionMapImage;
-
-    if (!lanternEmissionMapImage.loadFromFile("media/lantern_emission.png"))
-    {
-        std::cerr << "[ERROR] Can not load texture" << std::endl;
-        return 1;
-    }
-
-    lanternEmissionMapImage.flipVertically();
-
-    auto lanternEmissionMapTexture = std::make_unique<globjects::Texture>(static_cast<gl::GLenum>(GL_TEXTURE_2D));
-
-    lanternEmissionMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<GLint>(GL_LINEAR));
-    lanternEmissionMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAG_FILTER), static_cast<GLint>(GL_LINEAR));
-
-    lanternEmissionMapTexture->image2D(
-        0,
-        static_cast<gl::GLenum>(GL_RGBA8),
-        glm::vec2(lanternEmissionMapImage.getSize().x, lanternEmissionMapImage.getSize().y),
-        0,
-        static_cast<gl::GLenum>(GL_RGBA),
-        static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
-        reinterpret_cast<const gl::GLvoid*>(lanternEmissionMapImage.getPixelsPtr()));
-
-    // TODO: extract this to material class
-    sf::Image lanternSpecularMapImage;
-
-    if (!lanternSpecularMapImage.loadFromFile("media/lantern_specular.png"))
-    {
-        std::cerr << "[ERROR] Can not load texture" << std::endl;
-        return 1;
-    }
-
-    lanternSpecularMapImage.flipVertically();
-
-    auto lanternSpecularMapTexture = std::make_unique<globjects::Texture>(static_cast<gl::GLenum>(GL_TEXTURE_2D));
-
-    lanternSpecularMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<GLint>(GL_LINEAR));
-    lanternSpecularMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAG_FILTER), static_cast<GLint>(GL_LINEAR));
-
-    lanternSpecularMapTexture->image2D(
-        0,
-        static_cast<gl::GLenum>(GL_RGBA8),
-        glm::vec2(lanternSpecularMapImage.getSize().x, lanternSpecularMapImage.getSize().y),
-        0,
-        static_cast<gl::GLenum>(GL_RGBA),
-        static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
-        reinterpret_cast<const gl::GLvoid*>(lanternSpecularMapImage.getPixelsPtr()));
-
-    sf::Image penNormalMapImage;
-
-    if (!penNormalMapImage.loadFromFile("media/pen-normal.png"))
-    {
-        std::cerr << "[ERROR] Can not load texture" << std::endl;
-        return 1;
-    }
-
-    penNormalMapImage.flipVertically();
+    auto lanternEmissionMapTexture = textureStreamer.load("media/lantern_emission.png", sf::Color(0, 0, 0));
 
-    auto penNormalMapTexture = std::make_unique<globjects::Texture>(static_cast<gl::GLenum>(GL_TEXTURE_2D));
+    auto lanternSpecularMapTexture = textureStreamer.load("media/lantern_specular.png", sf::Color(0, 0, 0));
 
-    penNormalMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<GLint>(GL_LINEAR));
-    penNormalMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAG_FILTER), static_cast<GLint>(GL_LINEAR));
-
-    penNormalMapTexture->image2D(
-        0,
-        static_cast<gl::GLenum>(GL_RGBA8),
-        glm::vec2(penNormalMapImage.getSize().x, penNormalMapImage.getSize().y),
-        0,
-        static_cast<gl::GLenum>(GL_RGBA),
-        static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
-        reinterpret_cast<const gl::GLvoid*>(penNormalMapImage.getPixelsPtr()));
+    auto penNormalMapTexture = textureStreamer.load("media/pen-normal.png", sf::Color(128, 128, 255));
 
     auto penScene = importer.ReadFile("media/pen-lowpoly.obj", 0);
 
@@ -385,29 +321,7 @@ int main()
         glm::scale(glm::vec3(0.5f))
     );
 
-    sf::Image inkBottleNormalMapImage;
-
-    if (!inkBottleNormalMapImage.loadFromFile("media/ink-bottle-normal.png"))
-    {
-        std::cerr << "[ERROR] Can not load texture" << std::endl;
-        return 1;
-    }
-
-    inkBottleNormalMapImage.flipVertically();
-
-    auto inkBottleNormalMapTexture = std::make_unique<globjects::Texture>(static_cast<gl::GLenum>(GL_TEXTURE_2D));
-
-    inkBottleNormalMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<GLint>(GL_LINEAR));
-    inkBottleNormalMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAG_FILTER), static_cast<GLint>(GL_LINEAR));
-
-    inkBottleNormalMapTexture->image2D(
-        0,
-        static_cast<gl::GLenum>(GL_RGBA8),
-        glm::vec2(inkBottleNormalMapImage.getSize().x, inkBottleNormalMapImage.getSize().y),
-        0,
-        static_cast<gl::GLenum>(GL_RGBA),
-        static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
-        reinterpret_cast<const gl::GLvoid*>(inkBottleNormalMapImage.getPixelsPtr()));
+    auto inkBottleNormalMapTexture = textureStreamer.load("media/ink-bottle-normal.png", sf::Color(128, 128, 255));
 
     auto inkBottleScene = importer.ReadFile("media/ink-bottle.obj", 0);
 
@@ -641,6 +555,8 @@ int main()
         }
 #endif
 
+        textureStreamer.update();
+
         glm::vec2 currentMousePos = glm::vec2(sf::Mouse::getPosition(window).x, sf::Mouse::getPosition(window).y);
 
 #ifdef WIN32
@@ -768,23 +684,23 @@ int main()
             deferredRenderingPrePassProgram->setUniform("model", penModel->getTransformation());
             deferredRenderingPrePassProgram->setUniform("normalMapTexture", 2);
 
-            penNormalMapTexture->bindActive(2);
+            penNormalMapTexture->getTexture()->bindActive(2);
 
             penModel->bind();
             penModel->draw();
             penModel->unbind();
 
-            penNormalMapTexture->unbindActive(2);
+            penNormalMapTexture->getTexture()->unbindActive(2);
 
             deferredRenderingPrePassProgram->setUniform("model", inkBottleModel->getTransformation());
 
-            inkBottleNormalMapTexture->bindActive(2);
+            inkBottleNormalMapTexture->getTexture()->bindActive(2);
 
             inkBottleModel->bind();
             inkBottleModel->draw();
             inkBottleModel->unbind();
 
-            inkBottleNormalMapTexture->unbindActive(2);
+            inkBottleNormalMapTexture->getTexture()->unbindActive(2);
 
             deferredRenderingPrePassProgram->setUniform("model", scrollModel->getTransformation());
 
@@ -851,23 +767,23 @@ int main()
 
             shadowMappingProgram->setUniform("model", penModel->getTransformation());
 
-            // penNormalMapTexture->bindActive(2);
+            // penNormalMapTexture->getTexture()->bindActive(2);
 
             penModel->bind();
             penModel->draw();
             penModel->unbind();
 
-            // penNormalMapTexture->unbindActive(2);
+            // penNormalMapTexture->getTexture()->unbindActive(2);
 
             shadowMappingProgram->setUniform("model", inkBottleModel->getTransformation());
 
-            // inkBottleNormalMapTexture->bindActive(2);
+            // inkBottleNormalMapTexture->getTexture()->bindActive(2);
 
             inkBottleModel->bind();
             inkBottleModel->draw();
             inkBottleModel->unbind();
 
-            // inkBottleNormalMapTexture->unbindActive(2);
+            // inkBottleNormalMapTexture->getTexture()->unbindActive(2);
 
             shadowMappingProgram->setUniform("model", scrollModel->getTransformation());
 
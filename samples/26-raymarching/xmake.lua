@@ -8,6 +8,10 @@ target("26-raymarching")
   set_languages("cxx20")
   set_kind("binary")
 
+  set_pcxxheader("src/common/stdafx.hpp")
+
+  add_includedirs("src/")
+
   add_packages("sfml", "glm", "globjects", "glbinding", "assimp")
 
   if is_plat("macosx") then
@@ -18,7 +22,7 @@ target("26-raymarching")
     add_frameworks("Foundation", "OpenGL", "IOKit", "Cocoa", "Carbon")
   end
 
-  add_files("main.cpp")
+  add_files("src/main.cpp", "src/common/AbstractMesh.cpp", "src/common/AbstractMeshBuilder.cpp", "src/common/AbstractSkyboxBuilder.cpp", "src/common/AssimpModel.cpp", "src/common/CubemapSkyboxBuilder.cpp", "src/common/DdsImage.cpp", "src/common/MeshOptimizer.cpp", "src/common/MultimeshModel.cpp", "src/common/SimpleSkyboxBuilder.cpp", "src/common/SingleMeshModel.cpp", "src/common/Skybox.cpp", "src/common/TextureStreamer.cpp")
 
   after_build(function (target)
     os.cp("$(scriptdir)/../media", path.join(path.directory(target:targetfile()), "media"))
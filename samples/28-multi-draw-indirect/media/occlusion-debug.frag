@@ -0,0 +1,9 @@
+#version 460
+
+layout (location = 0) out vec4 fragmentColor;
+
+// the objects hidden by the occlusion culling, drawn over the scene
+void main()
+{
+    fragmentColor = vec4(1.0, 0.2, 0.2, 1.0);
+}
@@ -1,5 +1,10 @@
 #version 460
 
+#extension GL_ARB_bindless_texture : enable
+
+// replaced with 1 by the application when ARB_bindless_texture is supported
+#define BINDLESS_TEXTURES 0
+
 layout (location = 0) out vec4 fragmentColor;
 
 in VS_OUT {
@@ -10,12 +15,24 @@ in VS_OUT {
     flat uint instanceID;
 } fsIn;
 
+struct TextureReference
+{
+    uvec2 handle; // bindless texture handle
+    uint bucket; // texture array index, when bindless textures are not available
+    uint layer;
+    vec2 uvScale;
+    vec2 padding;
+};
+
 struct ObjectData
 {
-    vec2 albedoTextureSize;
-    vec2 normalTextureSize;
-    vec2 emissionTextureSize;
+    TextureReference albedoTexture;
+    TextureReference normalTexture;
+    TextureReference emissionTexture;
+    vec3 positionOffset;
     uint instanceDataOffset;
+    vec3 positionScale;
+    uint padding;
 };
 
 layout (std430, binding = 4) buffer StaticObjectData
@@ -23,17 +40,49 @@ layout (std430, binding = 4) buffer StaticObjectData
     ObjectData[] objectData;
 };
 
-uniform sampler2DArray albedoTextures;
-uniform sampler2DArray normalTextures;
-uniform sampler2DArray emissionTextures;
+#if BINDLESS_TEXTURES
 
-void main()
+vec4 sampleTexture(TextureReference reference, vec2 uv)
+{
+    if (reference.handle == uvec2(0))
+    {
+        return vec4(1.0);
+    }
+
+    return texture(sampler2D(reference.handle), uv);
+}
+
+#else
+
+// has to match StaticGeometryDrawable::MAX_TEXTURE_BUCKETS
+uniform sampler2DArray textureBuckets[8];
+
+vec4 sampleTexture(TextureReference reference, vec2 uv)
 {
-    vec2 maxTextureSize = textureSize(albedoTextures, 0).xy;
-    vec2 uvFactor = objectData[fsIn.objectID].albedoTextureSize / maxTextureSize;
-    vec2 uv = vec2(fsIn.textureCoord.x, fsIn.textureCoord.y) * uvFactor;
+    vec3 coord = vec3(uv * reference.uvScale, reference.layer);
 
-    vec4 albedo = texture(albedoTextures, vec3(uv.x, uv.y, fsIn.objectID));
+    // sampler arrays can only be indexed with dynamically uniform expressions, which the bucket is not guaranteed to be
+    switch (reference.bucket)
+    {
+        case 0: return texture(textureBuckets[0], coord);
+        case 1: return texture(textureBuckets[1], coord);
+        case 2: return texture(textureBuckets[2], coord);
+        case 3: return texture(textureBuckets[3], coord);
+        case 4: return texture(textureBuckets[4], coord);
+        case 5: return texture(textureBuckets[5], coord);
+        case 6: return texture(textureBuckets[6], coord);
+        case 7: return texture(textureBuckets[7], coord);
+    }
+
+    // no texture (StaticGeometryDrawable::NO_TEXTURE)
+    return vec4(1.0);
+}
+
+#endif
+
+void main()
+{
+    vec4 albedo = sampleTexture(objectData[fsIn.objectID].albedoTexture, fsIn.textureCoord);
 
     fragmentColor = albedo;
 }
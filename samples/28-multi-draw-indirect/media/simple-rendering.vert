@@ -1,7 +1,14 @@
 #version 460
 
-layout (location = 0) in vec3 vertexPosition;
+// replaced with 1 by the application when the vertex data is quantized (see VertexCompression)
+#define QUANTIZED_VERTICES 0
+
+layout (location = 0) in vec3 vertexPosition; // normalized to [0, 1] within the mesh bounds when quantized
+#if QUANTIZED_VERTICES
+layout (location = 1) in vec2 vertexNormal; // octahedral encoding
+#else
 layout (location = 1) in vec3 vertexNormal;
+#endif
 layout (location = 2) in vec2 vertexTextureCoord;
 
 out VS_OUT
@@ -13,12 +20,24 @@ out VS_OUT
     flat uint instanceID;
 } vsOut;
 
+struct TextureReference
+{
+    uvec2 handle;
+    uint bucket;
+    uint layer;
+    vec2 uvScale;
+    vec2 padding;
+};
+
 struct ObjectData
 {
-    vec2 albedoTextureSize;
-    vec2 normalTextureSize;
-    vec2 emissionTextureSize;
-    uint instanceDataOffset; // use this field to get instance data: StaticObjectInstanceData.transformation[StaticObjectData.objectData[gl_DrawID].instanceDataOffset + gl_InstanceID]
+    TextureReference albedoTexture;
+    TextureReference normalTexture;
+    TextureReference emissionTexture;
+    vec3 positionOffset;
+    uint instanceDataOffset; // use this field to get instance data: transformations[instanceIndices[objectData[gl_DrawID].instanceDataOffset + gl_InstanceID]]
+    vec3 positionScale;
+    uint padding;
 };
 
 layout (std430, binding = 4) buffer StaticObjectData
@@ -31,21 +50,47 @@ layout (std430, binding = 5) buffer StaticObjectInstanceData
     mat4[] transformations;
 };
 
+// instances of each draw command (grouped by LOD), indexing into the transformations
+layout (std430, binding = 6) buffer StaticInstanceIndices
+{
+    uint[] instanceIndices;
+};
+
 uniform mat4 projection;
 uniform mat4 view;
 
+vec3 octahedralDecode(vec2 encoded)
+{
+    vec3 normal = vec3(encoded.x, encoded.y, 1.0 - abs(encoded.x) - abs(encoded.y));
+
+    float t = max(-normal.z, 0.0);
+
+    normal.x += normal.x >= 0.0 ? -t : t;
+    normal.y += normal.y >= 0.0 ? -t : t;
+
+    return normalize(normal);
+}
+
 void main()
 {
-    vsOut.fragmentPosition = vertexPosition;
-    vsOut.normal = vertexNormal;
+#if QUANTIZED_VERTICES
+    vec3 position = objectData[gl_DrawID].positionOffset + vertexPosition * objectData[gl_DrawID].positionScale;
+    vec3 normal = octahedralDecode(vertexNormal);
+#else
+    vec3 position = vertexPosition;
+    vec3 normal = vertexNormal;
+#endif
+
+    vsOut.fragmentPosition = position;
+    vsOut.normal = normal;
     vsOut.textureCoord = vec2(vertexTextureCoord.x, vertexTextureCoord.y);
     vsOut.objectID = gl_DrawID;
 
-    uint objectInstanceIndex = objectData[gl_DrawID].instanceDataOffset + gl_InstanceID;
+    uint objectInstanceIndex = instanceIndices[objectData[gl_DrawID].instanceDataOffset + gl_InstanceID];
 
     vsOut.instanceID = objectInstanceIndex;
 
     mat4 model = transformations[objectInstanceIndex];
 
-    gl_Position = projection * view * model * vec4(vertexPosition, 1.0);
+    gl_Position = projection * view * model * vec4(position, 1.0);
 }
@@ -0,0 +1,256 @@
+#pragma once
+
+#include "common/stdafx.hpp"
+
+#include "common/MeshOptimizer.hpp"
+#include "common/MeshSimplifier.hpp"
+
+struct StaticMesh
+{
+    std::vector<glm::vec3> vertexPositions;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> uvs;
+    std::vector<unsigned int> indices;
+
+    // coarser levels of detail, referencing the same vertices
+    std::vector<MeshSimplifier::Lod> lods;
+};
+
+struct StaticScene
+{
+    std::vector<StaticMesh> meshes;
+    std::unique_ptr<sf::Image> albedoTexture;
+    std::unique_ptr<sf::Image> normalTexture;
+    std::unique_ptr<sf::Image> emissionTexture;
+};
+
+class AssimpStaticModelLoader
+{
+public:
+    AssimpStaticModelLoader()
+    {
+    }
+
+    static std::shared_ptr<StaticScene> fromFile(std::string filename, std::vector<std::filesystem::path> materialLookupPaths = {}, unsigned int assimpImportFlags = aiProcess_Triangulate)
+    {
+        static auto importer = std::make_unique<Assimp::Importer>();
+        auto scene = importer->ReadFile(filename, assimpImportFlags);
+
+        auto resultScene = std::make_shared<StaticScene>();
+
+        if (!scene)
+        {
+            std::cerr << "failed: " << importer->GetErrorString() << std::endl;
+            return resultScene;
+        }
+
+        fromAiNode(scene, scene->mRootNode, materialLookupPaths, resultScene);
+
+        return std::move(resultScene);
+    }
+
+protected:
+    static void fromAiNode(const aiScene* scene, aiNode* node, std::vector<std::filesystem::path> materialLookupPaths, std::shared_ptr<StaticScene> resultScene)
+    {
+        for (auto t = 0; t < node->mNumMeshes; ++t)
+        {
+            fromAiMesh(scene, scene->mMeshes[node->mMeshes[t]], materialLookupPaths, resultScene);
+        }
+
+        for (auto i = 0; i < node->mNumChildren; ++i)
+        {
+            auto child = node->mChildren[i];
+
+            fromAiNode(scene, child, materialLookupPaths, resultScene);
+        }
+    }
+
+    static std::unique_ptr<sf::Image> loadTexture(std::string& imagePath, std::vector<std::filesystem::path> materialLookupPaths)
+    {
+        for (auto path : materialLookupPaths)
+        {
+            std::cout << "[INFO] Looking up the DIFFUSE texture in " << path << "...";
+
+            const auto filePath = std::filesystem::path(path).append(imagePath);
+
+            if (std::filesystem::exists(filePath))
+            {
+                imagePath = filePath.string();
+                break;
+            }
+        }
+
+        std::cout << "[INFO] Loading DIFFUSE texture " << imagePath << "...";
+
+        auto textureImage = std::make_unique<sf::Image>();
+
+        if (!textureImage->loadFromFile(imagePath))
+        {
+            std::cerr << "[ERROR] Can not load texture" << std::endl;
+            return nullptr;
+        }
+
+        textureImage->flipVertically();
+
+        return std::move(textureImage);
+    }
+
+    // vertex cache / overdraw / vertex fetch optimization, see MeshOptimizer
+    static void optimizeMesh(std::vector<glm::vec3>& vertices, std::vector<glm::vec3>& normals, std::vector<glm::vec2>& uvs, std::vector<unsigned int>& indices)
+    {
+        const auto vertexCount = vertices.size();
+
+        std::vector<MeshOptimizer::VertexStream> streams { { vertices.data(), sizeof(glm::vec3) } };
+
+        if (normals.size() == vertexCount)
+        {
+            streams.push_back({ normals.data(), sizeof(glm::vec3) });
+        }
+
+        if (uvs.size() == vertexCount)
+        {
+            streams.push_back({ uvs.data(), sizeof(glm::vec2) });
+        }
+
+        const auto result = MeshOptimizer::optimize(indices, vertexCount, streams, vertices);
+
+        vertices = MeshOptimizer::remapVertices(vertices, result.remap, result.vertexCount);
+        normals = MeshOptimizer::remapVertices(normals, result.remap, result.vertexCount);
+        uvs = MeshOptimizer::remapVertices(uvs, result.remap, result.vertexCount);
+
+        std::cout << "[DEBUG] Mesh optimized: vertices " << vertexCount << " -> " << result.vertexCount
+                  << "; ACMR " << result.before.acmr << " -> " << result.after.acmr
+                  << "; ATVR " << result.before.atvr << " -> " << result.after.atvr << std::endl;
+    }
+
+    static void fromAiMesh(const aiScene* scene, aiMesh* mesh, std::vector<std::filesystem::path> materialLookupPaths, std::shared_ptr<StaticScene> resultScene)
+    {
+        std::cout << "[INFO] Creating buffer objects...";
+
+        std::vector<glm::vec3> vertices;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec2> uvs;
+
+        std::vector<GLuint> indices;
+
+        for (auto i = 0; i < mesh->mNumVertices; ++i)
+        {
+            glm::vec3 position(
+                mesh->mVertices[i].x,
+                mesh->mVertices[i].y,
+                mesh->mVertices[i].z);
+
+            vertices.push_back(position);
+
+            if (mesh->HasNormals())
+            {
+                glm::vec3 normal(
+                    mesh->mNormals[i].x,
+                    mesh->mNormals[i].y,
+                    mesh->mNormals[i].z);
+
+                normals.push_back(normal);
+            }
+
+            if (mesh->HasTextureCoords(0))
+            {
+                glm::vec3 uv(
+                    mesh->mTextureCoords[0][i].x,
+                    mesh->mTextureCoords[0][i].y,
+                    mesh->mTextureCoords[0][i].z);
+
+                uvs.push_back(uv);
+            }
+        }
+
+        for (auto i = 0; i < mesh->mNumFaces; ++i)
+        {
+            auto face = mesh->mFaces[i];
+
+            for (auto t = 0; t < face.mNumIndices; ++t)
+            {
+                indices.push_back(face.mIndices[t]);
+            }
+        }
+
+        std::cout << "done" << std::endl;
+
+        std::cout << "[INFO] Loading textures...";
+
+        std::vector<std::unique_ptr<globjects::Texture>> textures;
+
+        if (mesh->mMaterialIndex >= 0)
+        {
+            auto material = scene->mMaterials[mesh->mMaterialIndex];
+
+            auto numDiffuseTextures = material->GetTextureCount(aiTextureType_DIFFUSE);
+            auto numNormalTextures = material->GetTextureCount(aiTextureType_NORMALS);
+            auto numEmissionTextures = material->GetTextureCount(aiTextureType_EMISSIVE);
+
+            auto numEmissionColorTextures = material->GetTextureCount(aiTextureType_EMISSION_COLOR);
+            auto numSpecularTextures = material->GetTextureCount(aiTextureType_SPECULAR);
+
+            if (numDiffuseTextures > 0)
+            {
+                aiString str;
+                material->GetTexture(aiTextureType_DIFFUSE, 0, &str);
+
+                std::string imagePath { str.C_Str() };
+
+                auto texture = loadTexture(imagePath, materialLookupPaths);
+
+                resultScene->albedoTexture = std::move(texture);
+            }
+
+            if (numNormalTextures > 0)
+            {
+                aiString str;
+                material->GetTexture(aiTextureType_NORMALS, 0, &str);
+
+                std::string imagePath { str.C_Str() };
+
+                auto texture = loadTexture(imagePath, materialLookupPaths);
+
+                resultScene->normalTexture = std::move(texture);
+            }
+
+            if (numEmissionTextures > 0)
+            {
+                aiString str;
+                material->GetTexture(aiTextureType_EMISSIVE, 0, &str);
+
+                std::string imagePath { str.C_Str() };
+
+                auto texture = loadTexture(imagePath, materialLookupPaths);
+
+                resultScene->emissionTexture = std::move(texture);
+            }
+        }
+
+        std::cout << "done" << std::endl;
+
+        std::vector<MeshSimplifier::Lod> lods;
+
+        if (!indices.empty())
+        {
+            optimizeMesh(vertices, normals, uvs, indices);
+
+            std::cout << "[INFO] Generating LODs...";
+
+            lods = MeshSimplifier::generateLodChain(indices, vertices, normals, uvs);
+
+            for (auto& lod : lods)
+            {
+                lod.indices = MeshOptimizer::optimizeVertexCache(lod.indices, vertices.size());
+            }
+
+            std::cout << "done" << std::endl;
+        }
+
+        resultScene->meshes.push_back({ .vertexPositions = vertices,
+                                        .normals = normals,
+                                        .uvs = uvs,
+                                        .indices = indices,
+                                        .lods = std::move(lods) });
+    }
+};
@@ -0,0 +1,1270 @@
+#pragma once
+
+#include "common/stdafx.hpp"
+
+#include "common/MeshletBuilder.hpp"
+
+#include "AssimpStaticModelLoader.hpp"
+
+struct StaticGeometryDrawCommand
+{
+    unsigned int elementCount; // number of elements (triangles) to be rendered for this object
+    unsigned int instanceCount; // number of object instances
+    unsigned int firstIndex; // offset into GL_ELEMENT_ARRAY_BUFFER
+    unsigned int baseVertex; // offset of the first object' vertex in the uber-static-object-buffer
+    unsigned int baseInstance; // offset of the first instance' per-instance-vertex-attributes; attribute index is calculated as: (gl_InstanceID / glVertexAttribDivisor()) + baseInstance
+};
+
+struct alignas(16) StaticTextureReference
+{
+    glm::uvec2 handle; // 64-bit bindless texture handle (low, high), used with ARB_bindless_texture; zero when there is no texture
+    unsigned int bucket; // otherwise - texture array (size bucket) index; NO_TEXTURE when there is no texture
+    unsigned int layer; // layer within that texture array
+    glm::vec2 uvScale; // texture size relative to the bucket size
+    glm::vec2 padding;
+};
+
+struct alignas(16) StaticObjectData
+{
+    StaticTextureReference albedoTexture;
+    StaticTextureReference normalTexture;
+    StaticTextureReference emissionTexture;
+    glm::vec3 positionOffset; // quantized vertex positions (normalized to [0, 1]) are dequantized as `positionOffset + position * positionScale`
+    unsigned int instanceDataOffset;
+    glm::vec3 positionScale;
+    unsigned int padding; // keeps the std430 layout in sync with the shader
+};
+
+struct alignas(16) StaticObjectInstanceData
+{
+    glm::mat4 transformation;
+};
+
+enum class MeshletCulling
+{
+    // meshes are drawn as a whole
+    NONE,
+    // meshlets are culled on the CPU, visible runs of meshlets are merged into draw commands
+    CPU,
+    // meshlets are culled in a compute shader, which appends the draw commands to the indirect buffer
+    GPU
+};
+
+// mirrors the Meshlet struct of meshlet-culling.comp
+struct alignas(16) GpuMeshlet
+{
+    glm::vec4 sphere; // center, radius
+    glm::vec4 cone; // axis, cutoff
+    unsigned int firstIndex;
+    unsigned int elementCount;
+    unsigned int baseVertex;
+    unsigned int meshIndex;
+};
+
+enum class OcclusionCulling
+{
+    NONE,
+    // two passes against a hierarchical depth buffer: the instances visible in the last frame are drawn first, then the rest
+    // of them are tested against the depth pyramid built from that and the ones that turned visible are drawn
+    HZB
+};
+
+// has to match occlusion-culling.comp
+enum class OcclusionCullingPass
+{
+    EARLY = 1,
+    LATE = 2
+};
+
+// one mesh instance to be tested by the occlusion culling; mirrors the Candidate struct of occlusion-culling.comp
+struct alignas(16) OcclusionCandidate
+{
+    glm::vec4 sphere; // model space bounding sphere
+    unsigned int drawCommand;
+    unsigned int instance;
+    unsigned int visibilityIndex;
+    unsigned int padding;
+};
+
+enum class VertexCompression
+{
+    // 32-bit floats for everything, 48 bytes per vertex
+    NONE,
+    // 16-bit positions normalized to the mesh bounds, octahedral 2x16-bit snorm normals and half-float UVs, 16 bytes per vertex
+    QUANTIZED
+};
+
+// octahedral normal encoding: projects the unit vector onto an octahedron and unfolds its lower half onto the [-1, 1] square
+inline glm::vec2 encodeOctahedral(glm::vec3 normal)
+{
+    const auto projected = glm::vec2(normal.x, normal.y) / (std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z));
+
+    if (normal.z >= 0.0f)
+    {
+        return projected;
+    }
+
+    return glm::vec2(
+        (1.0f - std::abs(projected.y)) * (projected.x >= 0.0f ? 1.0f : -1.0f),
+        (1.0f - std::abs(projected.x)) * (projected.y >= 0.0f ? 1.0f : -1.0f));
+}
+
+// has to match octahedralDecode() in the vertex shader
+inline glm::vec3 decodeOctahedral(glm::vec2 encoded)
+{
+    auto normal = glm::vec3(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+
+    const float t = std::max(-normal.z, 0.0f);
+
+    normal.x += normal.x >= 0.0f ? -t : t;
+    normal.y += normal.y >= 0.0f ? -t : t;
+
+    return glm::normalize(normal);
+}
+
+struct QuantizedVertex
+{
+    glm::u16vec3 position; // unorm within the mesh bounds
+    std::uint16_t padding;
+    std::uint32_t normal; // octahedral, 2x16-bit snorm
+    std::uint32_t uv; // 2x16-bit half float
+};
+
+static_assert(sizeof(QuantizedVertex) == 16, "quantized vertex is expected to be 16 bytes");
+
+// the error bounds of the encoding are checked by tools/micro-benchmarks (StaticGeometryBenchmarks.cpp)
+inline QuantizedVertex quantizeVertex(glm::vec3 position, glm::vec3 normal, glm::vec2 uv, glm::vec3 boundsMin, glm::vec3 extent)
+{
+    const auto normalizedPosition = glm::clamp((position - boundsMin) / extent, glm::vec3(0.0f), glm::vec3(1.0f));
+
+    return QuantizedVertex {
+        .position = glm::u16vec3(glm::round(normalizedPosition * 65535.0f)),
+        .padding = 0,
+        .normal = glm::packSnorm2x16(encodeOctahedral(normal)),
+        .uv = glm::packHalf2x16(uv)
+    };
+}
+
+// has to match the position decoding in the vertex shader
+inline glm::vec3 dequantizePosition(glm::u16vec3 position, glm::vec3 boundsMin, glm::vec3 extent)
+{
+    return boundsMin + glm::vec3(position) / 65535.0f * extent;
+}
+
+/**
+ * Hierarchical depth buffer: a mip chain where every texel holds the farthest depth of the area it covers, so a couple
+ * of fetches at the right level tell whether a screen rectangle is entirely behind what has already been drawn.
+ */
+class DepthPyramid
+{
+public:
+    DepthPyramid(glm::ivec2 viewportSize) :
+        m_texture(std::make_unique<globjects::Texture>(static_cast<gl::GLenum>(GL_TEXTURE_2D)))
+    {
+        // the previous power of two, so that every level is exactly half of the previous one
+        m_size = glm::ivec2(previousPowerOfTwo(viewportSize.x), previousPowerOfTwo(viewportSize.y));
+        m_levels = 1;
+
+        while ((std::max(m_size.x, m_size.y) >> m_levels) > 0)
+        {
+            ++m_levels;
+        }
+
+        m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<gl::GLenum>(GL_NEAREST_MIPMAP_NEAREST));
+        m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAG_FILTER), static_cast<gl::GLenum>(GL_NEAREST));
+        m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_S), static_cast<gl::GLenum>(GL_CLAMP_TO_EDGE));
+        m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_T), static_cast<gl::GLenum>(GL_CLAMP_TO_EDGE));
+
+        m_texture->storage2D(m_levels, static_cast<gl::GLenum>(GL_R32F), m_size);
+    }
+
+    // `depthTexture` has to be sampled with GL_NEAREST, it has no mip levels of its own
+    void build(globjects::Program* reductionProgram, globjects::Texture* depthTexture, glm::ivec2 depthSize)
+    {
+        reductionProgram->use();
+
+        for (int level = 0; level < m_levels; ++level)
+        {
+            const auto source = level == 0 ? depthTexture : m_texture.get();
+            const auto sourceSize = level == 0 ? depthSize : getLevelSize(level - 1);
+            const auto targetSize = getLevelSize(level);
+
+            reductionProgram->setUniform("sourceLevel", level == 0 ? 0 : level - 1);
+            reductionProgram->setUniform("sourceSize", sourceSize);
+            reductionProgram->setUniform("targetSize", targetSize);
+
+            source->bindActive(0);
+
+            ::glBindImageTexture(1, m_texture->id(), level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+            ::glDispatchCompute(static_cast<GLuint>((targetSize.x + 7) / 8), static_cast<GLuint>((targetSize.y + 7) / 8), 1);
+
+            // the next level reads this one
+            ::glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+            source->unbindActive(0);
+        }
+
+        reductionProgram->release();
+    }
+
+    globjects::Texture* getTexture() const
+    {
+        return m_texture.get();
+    }
+
+    glm::ivec2 getSize() const
+    {
+        return m_size;
+    }
+
+    int getLevels() const
+    {
+        return m_levels;
+    }
+
+private:
+    static int previousPowerOfTwo(int value)
+    {
+        int result = 1;
+
+        while (result * 2 <= value)
+        {
+            result *= 2;
+        }
+
+        return result;
+    }
+
+    glm::ivec2 getLevelSize(int level) const
+    {
+        return glm::max(glm::ivec2(m_size.x >> level, m_size.y >> level), glm::ivec2(1));
+    }
+
+    std::unique_ptr<globjects::Texture> m_texture;
+    glm::ivec2 m_size;
+    int m_levels;
+};
+
+/**
+ * Textures are either referenced by bindless handles (each texture is its own GL_TEXTURE_2D, no wasted memory)
+ * or, when ARB_bindless_texture is not available, packed into texture arrays bucketed by size (rounded up to a power of two),
+ * so a small texture only shares an array with textures of similar size instead of paying for the largest one.
+ */
+class StaticGeometryDrawable
+{
+public:
+    // has to match the shader
+    static constexpr unsigned int MAX_TEXTURE_BUCKETS = 8;
+    static constexpr unsigned int NO_TEXTURE = 0xFFFFFFFF;
+
+    StaticGeometryDrawable(
+        bool useBindlessTextures,
+        VertexCompression vertexCompression = VertexCompression::NONE,
+        MeshletCulling meshletCulling = MeshletCulling::NONE,
+        OcclusionCulling occlusionCulling = OcclusionCulling::NONE) :
+        m_vao(std::make_unique<globjects::VertexArray>()),
+        m_drawCommandBuffer(std::make_unique<globjects::Buffer>()),
+        m_geometryDataBuffer(std::make_unique<globjects::Buffer>()),
+        m_elementBuffer(std::make_unique<globjects::Buffer>()),
+        m_objectDataBuffer(std::make_unique<globjects::Buffer>()),
+        m_objectInstanceDataBuffer(std::make_unique<globjects::Buffer>()),
+        m_instanceIndexBuffer(std::make_unique<globjects::Buffer>()),
+        m_meshletBuffer(std::make_unique<globjects::Buffer>()),
+        m_meshletJobBuffer(std::make_unique<globjects::Buffer>()),
+        m_meshObjectDataBuffer(std::make_unique<globjects::Buffer>()),
+        m_drawCountBuffer(std::make_unique<globjects::Buffer>()),
+        m_lateDrawCommandBuffer(std::make_unique<globjects::Buffer>()),
+        m_lateInstanceIndexBuffer(std::make_unique<globjects::Buffer>()),
+        m_culledDrawCommandBuffer(std::make_unique<globjects::Buffer>()),
+        m_culledInstanceIndexBuffer(std::make_unique<globjects::Buffer>()),
+        m_occlusionCandidateBuffer(std::make_unique<globjects::Buffer>()),
+        m_visibilityBuffer(std::make_unique<globjects::Buffer>()),
+        m_useBindlessTextures(useBindlessTextures),
+        m_vertexCompression(vertexCompression),
+        // the occlusion culling works on whole mesh instances, the meshlets are not split into commands it could fill in
+        m_meshletCulling(occlusionCulling == OcclusionCulling::HZB ? MeshletCulling::NONE : meshletCulling),
+        m_occlusionCulling(occlusionCulling)
+    {
+    }
+
+    ~StaticGeometryDrawable()
+    {
+        for (auto& texture : m_textures)
+        {
+            texture->textureHandle().makeNonResident();
+        }
+    }
+
+    void addScene(std::string sceneName, std::shared_ptr<StaticScene> scene)
+    {
+        StaticObjectData objectData {
+            .albedoTexture = NO_TEXTURE_REFERENCE,
+            .normalTexture = NO_TEXTURE_REFERENCE,
+            .emissionTexture = NO_TEXTURE_REFERENCE,
+            .positionOffset = glm::vec3(0.0f),
+            .instanceDataOffset = static_cast<unsigned int>(m_scenes.size()),
+            .positionScale = glm::vec3(1.0f),
+            .padding = 0
+        };
+
+        m_scenes[sceneName] = {
+            .scene = std::move(scene),
+            .objectData = objectData,
+            .instanceData = {}
+        };
+    }
+
+    /*StaticSceneDescriptor getSceneInstance(std::string sceneName)
+    {
+        return m_scenes[sceneName];
+    }*/
+
+    void addSceneInstance(std::string sceneName, StaticObjectInstanceData instanceData)
+    {
+        if (m_scenes.find(sceneName) == m_scenes.end())
+        {
+            return;
+        }
+
+        m_scenes[sceneName].instanceData.push_back(instanceData);
+    }
+
+    void build()
+    {
+        // textures go first, so that the object data already refers to them
+        if (m_useBindlessTextures)
+        {
+            buildBindlessTextures();
+        }
+        else
+        {
+            buildTextureBuckets();
+        }
+
+        buildGeometry();
+
+        // generate vertex data buffer
+        if (m_vertexCompression == VertexCompression::QUANTIZED)
+        {
+            m_geometryDataBuffer->setData(m_quantizedVertexData, static_cast<gl::GLenum>(GL_STATIC_DRAW));
+
+            m_vao->binding(0)->setAttribute(0);
+            m_vao->binding(0)->setBuffer(m_geometryDataBuffer.get(), 0, sizeof(QuantizedVertex));
+            m_vao->binding(0)->setFormat(3, static_cast<gl::GLenum>(GL_UNSIGNED_SHORT), static_cast<gl::GLboolean>(GL_TRUE)); // normalized to [0, 1], dequantized in the shader
+            m_vao->enable(0);
+
+            m_vao->binding(1)->setAttribute(1);
+            m_vao->binding(1)->setBuffer(m_geometryDataBuffer.get(), offsetof(QuantizedVertex, normal), sizeof(QuantizedVertex));
+            m_vao->binding(1)->setFormat(2, static_cast<gl::GLenum>(GL_SHORT), static_cast<gl::GLboolean>(GL_TRUE)); // octahedral encoding, normalized to [-1, 1]
+            m_vao->enable(1);
+
+            m_vao->binding(2)->setAttribute(2);
+            m_vao->binding(2)->setBuffer(m_geometryDataBuffer.get(), offsetof(QuantizedVertex, uv), sizeof(QuantizedVertex));
+            m_vao->binding(2)->setFormat(2, static_cast<gl::GLenum>(GL_HALF_FLOAT));
+            m_vao->enable(2);
+        }
+        else
+        {
+            m_geometryDataBuffer->setData(m_normalizedVertexData, static_cast<gl::GLenum>(GL_STATIC_DRAW));
+
+            m_vao->binding(0)->setAttribute(0);
+            m_vao->binding(0)->setBuffer(m_geometryDataBuffer.get(), 0, sizeof(NormalizedVertex)); // number of elements in buffer, stride, size of buffer element
+            m_vao->binding(0)->setFormat(3, static_cast<gl::GLenum>(GL_FLOAT)); // number of data elements per buffer element (vertex), type of data
+            m_vao->enable(0);
+
+            m_vao->binding(1)->setAttribute(1);
+            m_vao->binding(1)->setBuffer(m_geometryDataBuffer.get(), offsetof(NormalizedVertex, normal), sizeof(NormalizedVertex)); // number of elements in buffer, stride, size of buffer element
+            m_vao->binding(1)->setFormat(3, static_cast<gl::GLenum>(GL_FLOAT)); // number of data elements per buffer element (vertex), type of data
+            m_vao->enable(1);
+
+            m_vao->binding(2)->setAttribute(2);
+            m_vao->binding(2)->setBuffer(m_geometryDataBuffer.get(), offsetof(NormalizedVertex, uv), sizeof(NormalizedVertex)); // number of elements in buffer, stride, size of buffer element
+            m_vao->binding(2)->setFormat(2, static_cast<gl::GLenum>(GL_FLOAT)); // number of data elements per buffer element (vertex), type of data
+            m_vao->enable(2);
+        }
+
+        // generate element buffer
+        m_elementBuffer->setData(m_indices, static_cast<gl::GLenum>(GL_STATIC_DRAW));
+
+        std::cout << "[DEBUG] Index buffer elements: " << m_indices.size() << "\n";
+
+        m_vao->bindElementBuffer(m_elementBuffer.get());
+
+        std::cout << "[DEBUG] Instance data buffer elements: " << m_instanceTransformations.size() << "\n";
+
+        m_objectInstanceDataBuffer->setData(m_instanceTransformations, static_cast<gl::GLenum>(GL_DYNAMIC_COPY));
+
+        if (m_meshletCulling == MeshletCulling::GPU)
+        {
+            std::vector<StaticObjectData> meshObjectData;
+
+            for (auto& mesh : m_meshes)
+            {
+                meshObjectData.push_back(mesh.objectData);
+            }
+
+            m_meshletBuffer->setData(m_gpuMeshlets, static_cast<gl::GLenum>(GL_STATIC_DRAW));
+            m_meshObjectDataBuffer->setData(meshObjectData, static_cast<gl::GLenum>(GL_STATIC_DRAW));
+        }
+
+        if (m_occlusionCulling == OcclusionCulling::HZB)
+        {
+            unsigned int meshInstanceCount = 0;
+
+            for (auto& mesh : m_meshes)
+            {
+                meshInstanceCount += mesh.instanceCount;
+            }
+
+            // everything counts as visible in the first frame, the late pass sorts it out
+            m_visibilityBuffer->setData(std::vector<unsigned int>(meshInstanceCount, 1), static_cast<gl::GLenum>(GL_DYNAMIC_COPY));
+        }
+    }
+
+    /**
+     * The CPU side of build(): packs the vertices and indices of all the scenes into the contents of the shared buffers,
+     * splits the meshes into meshlets and lays out the instance data. Does not issue any GL calls, so it can be measured
+     * on its own (see tools/micro-benchmarks); the object data only refers to the textures built before it.
+     */
+    void buildGeometry()
+    {
+        m_indices.clear();
+        m_instanceTransformations.clear();
+
+        m_drawCommands.clear();
+        m_normalizedVertexData.clear();
+        m_quantizedVertexData.clear();
+
+        m_meshes.clear();
+        m_meshlets.clear();
+        m_meshletBounds = {};
+        m_gpuMeshlets.clear();
+
+        for (auto& sceneKV : m_scenes)
+        {
+            auto scene = sceneKV.second.scene;
+
+            for (auto& mesh : scene->meshes)
+            {
+                unsigned int baseVertex = static_cast<unsigned int>(m_vertexCompression == VertexCompression::QUANTIZED ? m_quantizedVertexData.size() : m_normalizedVertexData.size());
+
+                const auto numVertices = mesh.vertexPositions.size();
+
+                if (m_vertexCompression == VertexCompression::QUANTIZED)
+                {
+                    // positions are quantized within the mesh bounds, so the per-draw object data carries the range
+                    glm::vec3 boundsMin(std::numeric_limits<float>::max());
+                    glm::vec3 boundsMax(std::numeric_limits<float>::lowest());
+
+                    for (auto& position : mesh.vertexPositions)
+                    {
+                        boundsMin = glm::min(boundsMin, position);
+                        boundsMax = glm::max(boundsMax, position);
+                    }
+
+                    if (numVertices == 0)
+                    {
+                        boundsMin = boundsMax = glm::vec3(0.0f);
+                    }
+
+                    // flat meshes would have a zero extent along one of the axes
+                    const auto extent = glm::max(boundsMax - boundsMin, glm::vec3(std::numeric_limits<float>::epsilon()));
+
+                    sceneKV.second.objectData.positionOffset = boundsMin;
+                    sceneKV.second.objectData.positionScale = extent;
+
+                    for (size_t i = 0; i < numVertices; ++i)
+                    {
+                        m_quantizedVertexData.push_back(quantizeVertex(mesh.vertexPositions[i], mesh.normals[i], mesh.uvs[i], boundsMin, extent));
+                    }
+                }
+                else
+                {
+                    for (size_t i = 0; i < numVertices; ++i)
+                    {
+                        auto position = mesh.vertexPositions[i];
+                        auto normal = mesh.normals[i];
+                        auto uv = mesh.uvs[i];
+
+                        m_normalizedVertexData.push_back({ .position = position, .normal = normal, .uv = uv });
+                    }
+                }
+
+                // all the levels of detail share the vertices of the mesh, each of them only has its own range in the index buffer
+                StaticMeshDescriptor meshDescriptor {
+                    .objectData = sceneKV.second.objectData,
+                    .baseVertex = baseVertex,
+                    .instanceOffset = static_cast<unsigned int>(m_instanceTransformations.size()),
+                    .instanceCount = static_cast<unsigned int>(sceneKV.second.instanceData.size()),
+                    .boundingSphere = calculateBoundingSphere(mesh.vertexPositions),
+                    .lods = {},
+                    .firstMeshlet = static_cast<unsigned int>(m_meshlets.size()),
+                    .meshletCount = 0
+                };
+
+                meshDescriptor.lods.push_back({ .firstIndex = static_cast<unsigned int>(m_indices.size()), .elementCount = static_cast<unsigned int>(mesh.indices.size()), .error = 0.0f });
+
+                // only the full detail level is split into meshlets - the coarser ones are small enough to be drawn whole
+                if (m_meshletCulling != MeshletCulling::NONE)
+                {
+                    for (auto meshlet : MeshletBuilder::build(mesh.indices, mesh.vertexPositions))
+                    {
+                        meshlet.firstIndex += static_cast<unsigned int>(m_indices.size());
+
+                        m_meshletBounds.centerX.push_back(meshlet.center.x);
+                        m_meshletBounds.centerY.push_back(meshlet.center.y);
+                        m_meshletBounds.centerZ.push_back(meshlet.center.z);
+                        m_meshletBounds.radius.push_back(meshlet.radius);
+                        m_meshletBounds.axisX.push_back(meshlet.coneAxis.x);
+                        m_meshletBounds.axisY.push_back(meshlet.coneAxis.y);
+                        m_meshletBounds.axisZ.push_back(meshlet.coneAxis.z);
+                        m_meshletBounds.cutoff.push_back(meshlet.coneCutoff);
+
+                        m_gpuMeshlets.push_back({
+                            .sphere = glm::vec4(meshlet.center, meshlet.radius),
+                            .cone = glm::vec4(meshlet.coneAxis, meshlet.coneCutoff),
+                            .firstIndex = meshlet.firstIndex,
+                            .elementCount = meshlet.elementCount,
+                            .baseVertex = baseVertex,
+                            .meshIndex = static_cast<unsigned int>(m_meshes.size())
+                        });
+
+                        m_meshlets.push_back(meshlet);
+                    }
+
+                    meshDescriptor.meshletCount = static_cast<unsigned int>(m_meshlets.size()) - meshDescriptor.firstMeshlet;
+                }
+
+                m_indices.insert(m_indices.end(), mesh.indices.begin(), mesh.indices.end());
+
+                for (auto& lod : mesh.lods)
+                {
+                    meshDescriptor.lods.push_back({ .firstIndex = static_cast<unsigned int>(m_indices.size()), .elementCount = static_cast<unsigned int>(lod.indices.size()), .error = lod.error });
+
+                    m_indices.insert(m_indices.end(), lod.indices.begin(), lod.indices.end());
+                }
+
+                std::cout << "[DEBUG] Mesh " << m_meshes.size() << " of " << sceneKV.first << ": " << meshDescriptor.lods.size() << " LODs, " << mesh.indices.size() / 3 << " triangles, " << meshDescriptor.meshletCount << " meshlets\n";
+
+                m_meshes.push_back(meshDescriptor);
+            }
+
+            std::cout << "[DEBUG] End object " << sceneKV.first << "; instances to add: " << sceneKV.second.instanceData.size() << "\n";
+
+            m_instanceTransformations.insert(m_instanceTransformations.end(), sceneKV.second.instanceData.begin(), sceneKV.second.instanceData.end());
+        }
+
+        std::cout << "[DEBUG] Meshes: " << m_meshes.size() << "; instance data: " << m_instanceTransformations.size() << "\n";
+
+        if (m_vertexCompression == VertexCompression::QUANTIZED)
+        {
+            std::cout << "[DEBUG] Vertex data: " << m_quantizedVertexData.size() << " vertices, " << (m_quantizedVertexData.size() * sizeof(QuantizedVertex)) << " bytes (" << (m_quantizedVertexData.size() * sizeof(NormalizedVertex)) << " bytes uncompressed)\n";
+        }
+    }
+
+    /**
+     * Generates the draw commands for the frame: every instance gets the coarsest LOD whose error, projected onto the screen,
+     * stays below `maxPixelError` pixels; the instances of a mesh are then grouped into one draw command per LOD.
+     *
+     * Each draw command has its own object data entry, pointing at a range of the instance index buffer, which in turn
+     * points into the (static) instance transformation buffer.
+     *
+     * Instances drawn at full detail go through meshlet culling, when it is enabled: on the CPU right here, or as jobs
+     * for the compute shader (see dispatchMeshletCulling()), which appends the surviving meshlets after these commands.
+     *
+     * With the occlusion culling the commands only reserve a range of instance indices for all their instances and start
+     * with no instances at all - the culling passes (see dispatchOcclusionCulling()) fill them in.
+     */
+    void updateDrawCommands(const glm::mat4& viewProjection, glm::vec3 cameraPosition, float verticalFieldOfView, float viewportHeight, float maxPixelError = 1.0f)
+    {
+        m_drawCommands.clear();
+        m_drawObjectData.clear();
+        m_instanceIndices.clear();
+        m_meshletJobs.clear();
+        m_occlusionCandidates.clear();
+
+        m_frustumPlanes = extractFrustumPlanes(viewProjection);
+        m_cameraPosition = cameraPosition;
+
+        // projected size of one world unit at the distance of one world unit, in pixels
+        const float pixelsPerUnit = viewportHeight / (2.0f * std::tan(verticalFieldOfView / 2.0f));
+
+        // only needed for this frame; the lists are shared by all the meshes, so they only grow until the mesh with most instances
+        std::pmr::vector<std::pmr::vector<unsigned int>> lodInstances(&FrameArena::forThisThread());
+
+        // mesh instances are numbered in the visibility buffer in the order of the meshes
+        unsigned int visibilityOffset = 0;
+
+        for (auto& mesh : m_meshes)
+        {
+            lodInstances.resize(std::max(lodInstances.size(), mesh.lods.size()));
+
+            for (auto& instances : lodInstances)
+            {
+                instances.clear();
+            }
+
+            for (unsigned int instance = mesh.instanceOffset; instance < mesh.instanceOffset + mesh.instanceCount; ++instance)
+            {
+                const auto& transformation = m_instanceTransformations[instance].transformation;
+
+                const auto center = glm::vec3(transformation * glm::vec4(mesh.boundingSphere.center, 1.0f));
+
+                const float scale = std::max({ glm::length(glm::vec3(transformation[0])), glm::length(glm::vec3(transformation[1])), glm::length(glm::vec3(transformation[2])) });
+
+                // distance to the closest point of the bounding sphere; the camera could be inside it
+                const float distance = std::max(glm::length(center - cameraPosition) - mesh.boundingSphere.radius * scale, std::numeric_limits<float>::epsilon());
+
+                unsigned int lod = 0;
+
+                for (unsigned int i = static_cast<unsigned int>(mesh.lods.size()) - 1; i > 0; --i)
+                {
+                    if (mesh.lods[i].error * scale / distance * pixelsPerUnit <= maxPixelError)
+                    {
+                        lod = i;
+                        break;
+                    }
+                }
+
+                lodInstances[lod].push_back(instance);
+            }
+
+            for (unsigned int lod = 0; lod < mesh.lods.size(); ++lod)
+            {
+                if (lodInstances[lod].empty())
+                {
+                    continue;
+                }
+
+                if (lod == 0 && mesh.meshletCount > 0)
+                {
+                    for (auto instance : lodInstances[lod])
+                    {
+                        if (m_meshletCulling == MeshletCulling::CPU)
+                        {
+                            cullMeshlets(mesh, instance);
+                            continue;
+                        }
+
+                        for (unsigned int meshlet = mesh.firstMeshlet; meshlet < mesh.firstMeshlet + mesh.meshletCount; ++meshlet)
+                        {
+                            m_meshletJobs.push_back(glm::uvec2(meshlet, instance));
+                        }
+                    }
+
+                    continue;
+                }
+
+                auto objectData = mesh.objectData;
+                objectData.instanceDataOffset = static_cast<unsigned int>(m_instanceIndices.size());
+
+                m_instanceIndices.insert(m_instanceIndices.end(), lodInstances[lod].begin(), lodInstances[lod].end());
+
+                if (m_occlusionCulling == OcclusionCulling::HZB)
+                {
+                    for (auto instance : lodInstances[lod])
+                    {
+                        m_occlusionCandidates.push_back({
+                            .sphere = glm::vec4(mesh.boundingSphere.center, mesh.boundingSphere.radius),
+                            .drawCommand = static_cast<unsigned int>(m_drawCommands.size()),
+                            .instance = instance,
+                            .visibilityIndex = visibilityOffset + instance - mesh.instanceOffset,
+                            .padding = 0
+                        });
+                    }
+                }
+
+                m_drawCommands.push_back({
+                    .elementCount = mesh.lods[lod].elementCount,
+                    .instanceCount = m_occlusionCulling == OcclusionCulling::HZB ? 0 : static_cast<unsigned int>(lodInstances[lod].size()),
+                    .firstIndex = mesh.lods[lod].firstIndex,
+                    .baseVertex = mesh.baseVertex,
+                    .baseInstance = 0
+                });
+
+                m_drawObjectData.push_back(objectData);
+            }
+
+            visibilityOffset += mesh.instanceCount;
+        }
+
+        if (m_meshletCulling != MeshletCulling::GPU)
+        {
+            m_drawCommandBuffer->setData(m_drawCommands, static_cast<gl::GLenum>(GL_STREAM_DRAW));
+            m_objectDataBuffer->setData(m_drawObjectData, static_cast<gl::GLenum>(GL_STREAM_DRAW));
+            m_instanceIndexBuffer->setData(m_instanceIndices, static_cast<gl::GLenum>(GL_STREAM_DRAW));
+
+            if (m_occlusionCulling == OcclusionCulling::HZB)
+            {
+                // the late pass and the culled instances have the same commands, each with its own instance counts
+                m_lateDrawCommandBuffer->setData(m_drawCommands, static_cast<gl::GLenum>(GL_STREAM_DRAW));
+                m_lateInstanceIndexBuffer->setData(m_instanceIndices, static_cast<gl::GLenum>(GL_STREAM_DRAW));
+                m_culledDrawCommandBuffer->setData(m_drawCommands, static_cast<gl::GLenum>(GL_STREAM_DRAW));
+                m_culledInstanceIndexBuffer->setData(m_instanceIndices, static_cast<gl::GLenum>(GL_STREAM_DRAW));
+
+                m_occlusionCandidateBuffer->setData(m_occlusionCandidates, static_cast<gl::GLenum>(GL_STREAM_DRAW));
+            }
+
+            return;
+        }
+
+        // the compute shader writes up to one draw command per job right after the ones generated here
+        const auto maxDrawCount = m_drawCommands.size() + m_meshletJobs.size();
+
+        m_drawCommandBuffer->setData(static_cast<gl::GLsizeiptr>(maxDrawCount * sizeof(StaticGeometryDrawCommand)), nullptr, static_cast<gl::GLenum>(GL_STREAM_DRAW));
+        m_drawCommandBuffer->setSubData(m_drawCommands, 0);
+
+        m_objectDataBuffer->setData(static_cast<gl::GLsizeiptr>(maxDrawCount * sizeof(StaticObjectData)), nullptr, static_cast<gl::GLenum>(GL_STREAM_DRAW));
+        m_objectDataBuffer->setSubData(m_drawObjectData, 0);
+
+        m_instanceIndexBuffer->setData(static_cast<gl::GLsizeiptr>((m_instanceIndices.size() + m_meshletJobs.size()) * sizeof(unsigned int)), nullptr, static_cast<gl::GLenum>(GL_STREAM_DRAW));
+        m_instanceIndexBuffer->setSubData(m_instanceIndices, 0);
+
+        m_meshletJobBuffer->setData(m_meshletJobs, static_cast<gl::GLenum>(GL_STREAM_DRAW));
+
+        // the draw count starts at the CPU-generated commands, the compute shader increments it for every surviving meshlet
+        const auto drawCount = static_cast<unsigned int>(m_drawCommands.size());
+
+        m_drawCountBuffer->setData(sizeof(drawCount), &drawCount, static_cast<gl::GLenum>(GL_STREAM_DRAW));
+    }
+
+    void dispatchMeshletCulling(globjects::Program* cullingProgram)
+    {
+        if (m_meshletJobs.empty())
+        {
+            return;
+        }
+
+        cullingProgram->setUniform("jobCount", static_cast<unsigned int>(m_meshletJobs.size()));
+        cullingProgram->setUniform("instanceIndexBase", static_cast<unsigned int>(m_instanceIndices.size() - m_drawCommands.size()));
+        cullingProgram->setUniform("cameraPosition", m_cameraPosition);
+
+        for (unsigned int i = 0; i < m_frustumPlanes.size(); ++i)
+        {
+            cullingProgram->setUniform(frustumPlaneUniformName(i), m_frustumPlanes[i]);
+        }
+
+        m_objectDataBuffer->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 4);
+        m_objectInstanceDataBuffer->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 5);
+        m_instanceIndexBuffer->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 6);
+        m_meshletBuffer->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 7);
+        m_meshletJobBuffer->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 8);
+        m_meshObjectDataBuffer->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 9);
+        m_drawCountBuffer->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 10);
+        m_drawCommandBuffer->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 11);
+
+        cullingProgram->use();
+
+        ::glDispatchCompute(static_cast<GLuint>((m_meshletJobs.size() + 63) / 64), 1, 1);
+
+        cullingProgram->release();
+
+        // the draw commands and the draw count are read by the indirect draw, the object and instance data - by the vertex shader
+        ::glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+        for (unsigned int binding = 4; binding <= 11; ++binding)
+        {
+            ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, 0);
+        }
+    }
+
+    /**
+     * Fills in the instances of the draw commands for one of the occlusion culling passes: the early pass goes to
+     * m_drawCommandBuffer / m_instanceIndexBuffer, the late one - to m_lateDrawCommandBuffer / m_lateInstanceIndexBuffer.
+     *
+     * The late pass needs the depth pyramid built from the results of the early one; with `collectCulled` it also puts
+     * the occluded instances to m_culledDrawCommandBuffer / m_culledInstanceIndexBuffer for the debug view.
+     */
+    void dispatchOcclusionCulling(globjects::Program* cullingProgram, OcclusionCullingPass pass, const glm::mat4& view, const glm::mat4& projection, const DepthPyramid* depthPyramid, bool collectCulled)
+    {
+        if (m_occlusionCandidates.empty())
+        {
+            return;
+        }
+
+        cullingProgram->setUniform("pass", static_cast<int>(pass));
+        cullingProgram->setUniform("candidateCount", static_cast<unsigned int>(m_occlusionCandidates.size()));
+        cullingProgram->setUniform("collectCulled", collectCulled);
+        cullingProgram->setUniform("view", view);
+        cullingProgram->setUniform("projection", projection);
+        cullingProgram->setUniform("depthPyramidSize", depthPyramid->getSize());
+        cullingProgram->setUniform("depthPyramidLevels", depthPyramid->getLevels());
+
+        for (unsigned int i = 0; i < m_frustumPlanes.size(); ++i)
+        {
+            cullingProgram->setUniform(frustumPlaneUniformName(i), m_frustumPlanes[i]);
+        }
+
+        const bool isEarlyPass = pass == OcclusionCullingPass::EARLY;
+
+        m_objectDataBuffer->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 4);
+        m_objectInstanceDataBuffer->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 5);
+        (isEarlyPass ? m_instanceIndexBuffer : m_lateInstanceIndexBuffer)->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 6);
+        m_occlusionCandidateBuffer->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 7);
+        m_visibilityBuffer->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 8);
+        (isEarlyPass ? m_drawCommandBuffer : m_lateDrawCommandBuffer)->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 9);
+        m_culledDrawCommandBuffer->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 10);
+        m_culledInstanceIndexBuffer->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 11);
+
+        depthPyramid->getTexture()->bindActive(0);
+
+        cullingProgram->use();
+
+        ::glDispatchCompute(static_cast<GLuint>((m_occlusionCandidates.size() + 63) / 64), 1, 1);
+
+        cullingProgram->release();
+
+        depthPyramid->getTexture()->unbindActive(0);
+
+        ::glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+        for (unsigned int binding = 4; binding <= 11; ++binding)
+        {
+            ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, 0);
+        }
+    }
+
+    // upper bound of the draw commands in the indirect buffer; with the GPU culling the actual count is in m_drawCountBuffer
+    std::size_t getMaxDrawCount() const
+    {
+        return m_drawCommands.size() + m_meshletJobs.size();
+    }
+
+    // texture arrays have to be bound to the units [0, MAX_TEXTURE_BUCKETS); bindless textures need no binding
+    void bindTextures()
+    {
+        for (unsigned int i = 0; i < m_textureBuckets.size(); ++i)
+        {
+            m_textureBuckets[i]->bindActive(i);
+        }
+    }
+
+    void unbindTextures()
+    {
+        for (unsigned int i = 0; i < m_textureBuckets.size(); ++i)
+        {
+            m_textureBuckets[i]->unbindActive(i);
+        }
+    }
+
+private:
+    static inline const StaticTextureReference NO_TEXTURE_REFERENCE {
+        .handle = glm::uvec2(0),
+        .bucket = NO_TEXTURE,
+        .layer = 0,
+        .uvScale = glm::vec2(1.0f),
+        .padding = glm::vec2(0.0f)
+    };
+
+    void buildBindlessTextures()
+    {
+        const auto createTexture = [this](sf::Image* image) {
+            if (image == nullptr)
+            {
+                return NO_TEXTURE_REFERENCE;
+            }
+
+            auto texture = std::make_unique<globjects::Texture>(static_cast<gl::GLenum>(GL_TEXTURE_2D));
+
+            texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<GLint>(GL_LINEAR));
+            texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAG_FILTER), static_cast<GLint>(GL_LINEAR));
+
+            texture->image2D(
+                0,
+                static_cast<gl::GLenum>(GL_RGBA8),
+                glm::vec2(image->getSize().x, image->getSize().y),
+                0,
+                static_cast<gl::GLenum>(GL_RGBA),
+                static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
+                reinterpret_cast<const gl::GLvoid*>(image->getPixelsPtr()));
+
+            // the handle freezes the texture state, so it has to be taken after the texture is complete
+            const auto textureHandle = texture->textureHandle();
+            textureHandle.makeResident();
+
+            const auto handle = static_cast<std::uint64_t>(textureHandle.handle());
+
+            m_textures.push_back(std::move(texture));
+
+            auto reference = NO_TEXTURE_REFERENCE;
+            reference.handle = glm::uvec2(static_cast<unsigned int>(handle & 0xFFFFFFFF), static_cast<unsigned int>(handle >> 32));
+
+            return reference;
+        };
+
+        for (auto& sceneKV : m_scenes)
+        {
+            auto& scene = sceneKV.second.scene;
+            auto& objectData = sceneKV.second.objectData;
+
+            objectData.albedoTexture = createTexture(scene->albedoTexture.get());
+            objectData.normalTexture = createTexture(scene->normalTexture.get());
+            objectData.emissionTexture = createTexture(scene->emissionTexture.get());
+        }
+    }
+
+    void buildTextureBuckets()
+    {
+        const auto roundUp = [](unsigned int value) {
+            unsigned int result = 1;
+
+            while (result < value)
+            {
+                result <<= 1;
+            }
+
+            return result;
+        };
+
+        // first pass: figure out the bucket and the layer of each texture
+        std::map<std::pair<unsigned int, unsigned int>, unsigned int> bucketIndices;
+        std::vector<glm::uvec2> bucketSizes;
+        std::vector<std::vector<sf::Image*>> bucketImages;
+
+        const auto assignBucket = [&](sf::Image* image) {
+            if (image == nullptr)
+            {
+                return NO_TEXTURE_REFERENCE;
+            }
+
+            const auto bucketSize = glm::uvec2(roundUp(image->getSize().x), roundUp(image->getSize().y));
+            const auto key = std::make_pair(bucketSize.x, bucketSize.y);
+
+            if (bucketIndices.find(key) == bucketIndices.end())
+            {
+                if (bucketSizes.size() == MAX_TEXTURE_BUCKETS)
+                {
+                    std::cerr << "[ERROR] Too many texture sizes, " << bucketSize.x << "x" << bucketSize.y << " texture is skipped" << std::endl;
+                    return NO_TEXTURE_REFERENCE;
+                }
+
+                bucketIndices[key] = static_cast<unsigned int>(bucketSizes.size());
+                bucketSizes.push_back(bucketSize);
+                bucketImages.push_back({});
+            }
+
+            const auto bucket = bucketIndices[key];
+
+            auto reference = NO_TEXTURE_REFERENCE;
+            reference.bucket = bucket;
+            reference.layer = static_cast<unsigned int>(bucketImages[bucket].size());
+            reference.uvScale = glm::vec2(image->getSize().x, image->getSize().y) / glm::vec2(bucketSize);
+
+            bucketImages[bucket].push_back(image);
+
+            return reference;
+        };
+
+        for (auto& sceneKV : m_scenes)
+        {
+            auto& scene = sceneKV.second.scene;
+            auto& objectData = sceneKV.second.objectData;
+
+            objectData.albedoTexture = assignBucket(scene->albedoTexture.get());
+            objectData.normalTexture = assignBucket(scene->normalTexture.get());
+            objectData.emissionTexture = assignBucket(scene->emissionTexture.get());
+        }
+
+        // second pass: allocate each bucket and fill its layers
+        m_textureBuckets.clear();
+
+        for (unsigned int bucket = 0; bucket < bucketSizes.size(); ++bucket)
+        {
+            auto textureArray = std::make_unique<globjects::Texture>(static_cast<gl::GLenum>(GL_TEXTURE_2D_ARRAY));
+
+            textureArray->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<GLint>(GL_LINEAR));
+            textureArray->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAG_FILTER), static_cast<GLint>(GL_LINEAR));
+
+            textureArray->image3D(
+                0,
+                static_cast<gl::GLenum>(GL_RGBA8),
+                glm::vec3(bucketSizes[bucket].x, bucketSizes[bucket].y, bucketImages[bucket].size()),
+                0,
+                static_cast<gl::GLenum>(GL_RGBA),
+                static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
+                nullptr);
+
+            for (unsigned int layer = 0; layer < bucketImages[bucket].size(); ++layer)
+            {
+                auto image = bucketImages[bucket][layer];
+
+                textureArray->subImage3D(
+                    0,
+                    glm::vec3(0, 0, layer),
+                    glm::vec3(image->getSize().x, image->getSize().y, 1),
+                    static_cast<gl::GLenum>(GL_RGBA),
+                    static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
+                    reinterpret_cast<const gl::GLvoid*>(image->getPixelsPtr()));
+            }
+
+            std::cout << "[DEBUG] Texture bucket " << bucket << ": " << bucketSizes[bucket].x << "x" << bucketSizes[bucket].y << ", " << bucketImages[bucket].size() << " layers\n";
+
+            m_textureBuckets.push_back(std::move(textureArray));
+        }
+    }
+
+    struct BoundingSphere
+    {
+        glm::vec3 center;
+        float radius;
+    };
+
+    static BoundingSphere calculateBoundingSphere(const std::vector<glm::vec3>& positions)
+    {
+        if (positions.empty())
+        {
+            return { .center = glm::vec3(0.0f), .radius = 0.0f };
+        }
+
+        glm::vec3 boundsMin = positions[0];
+        glm::vec3 boundsMax = positions[0];
+
+        for (const auto& position : positions)
+        {
+            boundsMin = glm::min(boundsMin, position);
+            boundsMax = glm::max(boundsMax, position);
+        }
+
+        const auto center = (boundsMin + boundsMax) * 0.5f;
+
+        float radius = 0.0f;
+
+        for (const auto& position : positions)
+        {
+            radius = std::max(radius, glm::length(position - center));
+        }
+
+        return { .center = center, .radius = radius };
+    }
+
+    struct StaticMeshLodDescriptor
+    {
+        unsigned int firstIndex;
+        unsigned int elementCount;
+        float error; // model space units
+    };
+
+    struct StaticMeshDescriptor
+    {
+        StaticObjectData objectData;
+        unsigned int baseVertex;
+        unsigned int instanceOffset; // the mesh instances are the instances of its scene, [instanceOffset, instanceOffset + instanceCount) in the instance buffer
+        unsigned int instanceCount;
+        BoundingSphere boundingSphere;
+        std::vector<StaticMeshLodDescriptor> lods;
+        unsigned int firstMeshlet; // LOD0 meshlets, [firstMeshlet, firstMeshlet + meshletCount) in m_meshlets
+        unsigned int meshletCount;
+    };
+
+    // meshlet bounds as structure-of-arrays, for the CPU culling
+    struct MeshletBounds
+    {
+        std::vector<float> centerX, centerY, centerZ;
+        std::vector<float> radius;
+        std::vector<float> axisX, axisY, axisZ;
+        std::vector<float> cutoff;
+    };
+
+    // Gribb & Hartmann: left, right, bottom, top, near, far; normalized, pointing inwards
+    // built once - concatenating the names anew on every frame allocates them on the heap
+    static const std::string& frustumPlaneUniformName(unsigned int plane)
+    {
+        static const auto names = []() {
+            std::array<std::string, 6> names;
+
+            for (unsigned int i = 0; i < names.size(); ++i)
+            {
+                names[i] = "frustumPlanes[" + std::to_string(i) + "]";
+            }
+
+            return names;
+        }();
+
+        return names[plane];
+    }
+
+    static std::array<glm::vec4, 6> extractFrustumPlanes(const glm::mat4& viewProjection)
+    {
+        const auto row = [&](int i) {
+            return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+        };
+
+        std::array<glm::vec4, 6> planes {
+            row(3) + row(0),
+            row(3) - row(0),
+            row(3) + row(1),
+            row(3) - row(1),
+            row(3) + row(2),
+            row(3) - row(2)
+        };
+
+        for (auto& plane : planes)
+        {
+            plane /= glm::length(glm::vec3(plane));
+        }
+
+        return planes;
+    }
+
+    /**
+     * Frustum and normal cone test of all the meshlets of one mesh instance; runs of visible meshlets are contiguous
+     * in the index buffer, so each run becomes a single draw command.
+     *
+     * Everything is tested in the model space of the instance, so the bounds do not have to be transformed;
+     * the cone test assumes there is no non-uniform scale in the transformation.
+     */
+    void cullMeshlets(const StaticMeshDescriptor& mesh, unsigned int instance)
+    {
+        const auto& transformation = m_instanceTransformations[instance].transformation;
+
+        // planes transform with the inverse transposed matrix, so from world to model space - with the transposed one
+        float planeX[6], planeY[6], planeZ[6], planeW[6];
+
+        for (unsigned int i = 0; i < 6; ++i)
+        {
+            auto plane = glm::transpose(transformation) * m_frustumPlanes[i];
+            plane /= glm::length(glm::vec3(plane));
+
+            planeX[i] = plane.x;
+            planeY[i] = plane.y;
+            planeZ[i] = plane.z;
+            planeW[i] = plane.w;
+        }
+
+        const auto camera = glm::vec3(glm::inverse(transformation) * glm::vec4(m_cameraPosition, 1.0f));
+
+        const float* centerX = m_meshletBounds.centerX.data() + mesh.firstMeshlet;
+        const float* centerY = m_meshletBounds.centerY.data() + mesh.firstMeshlet;
+        const float* centerZ = m_meshletBounds.centerZ.data() + mesh.firstMeshlet;
+        const float* radius = m_meshletBounds.radius.data() + mesh.firstMeshlet;
+        const float* axisX = m_meshletBounds.axisX.data() + mesh.firstMeshlet;
+        const float* axisY = m_meshletBounds.axisY.data() + mesh.firstMeshlet;
+        const float* axisZ = m_meshletBounds.axisZ.data() + mesh.firstMeshlet;
+        const float* cutoff = m_meshletBounds.cutoff.data() + mesh.firstMeshlet;
+
+        m_meshletVisibility.resize(mesh.meshletCount);
+
+        std::uint8_t* visibility = m_meshletVisibility.data();
+
+        // branchless over the structure-of-arrays bounds, so the compiler can vectorize it (SSE / NEON, whatever the target has)
+        for (unsigned int i = 0; i < mesh.meshletCount; ++i)
+        {
+            std::uint8_t isVisible = 1;
+
+            for (unsigned int plane = 0; plane < 6; ++plane)
+            {
+                isVisible &= static_cast<std::uint8_t>(planeX[plane] * centerX[i] + planeY[plane] * centerY[i] + planeZ[plane] * centerZ[i] + planeW[plane] >= -radius[i]);
+            }
+
+            const float viewX = centerX[i] - camera.x;
+            const float viewY = centerY[i] - camera.y;
+            const float viewZ = centerZ[i] - camera.z;
+
+            const float viewDistance = std::sqrt(viewX * viewX + viewY * viewY + viewZ * viewZ);
+
+            const auto isBackFacing = static_cast<std::uint8_t>(viewX * axisX[i] + viewY * axisY[i] + viewZ * axisZ[i] >= cutoff[i] * viewDistance + radius[i]);
+
+            visibility[i] = isVisible & (1 - isBackFacing);
+        }
+
+        for (unsigned int i = 0; i < mesh.meshletCount;)
+        {
+            if (!visibility[i])
+            {
+                ++i;
+                continue;
+            }
+
+            const auto& first = m_meshlets[mesh.firstMeshlet + i];
+
+            unsigned int elementCount = 0;
+
+            for (; i < mesh.meshletCount && visibility[i]; ++i)
+            {
+                elementCount += m_meshlets[mesh.firstMeshlet + i].elementCount;
+            }
+
+            auto objectData = mesh.objectData;
+            objectData.instanceDataOffset = static_cast<unsigned int>(m_instanceIndices.size());
+
+            m_instanceIndices.push_back(instance);
+
+            m_drawCommands.push_back({
+                .elementCount = elementCount,
+                .instanceCount = 1,
+                .firstIndex = first.firstIndex,
+                .baseVertex = mesh.baseVertex,
+                .baseInstance = 0
+            });
+
+            m_drawObjectData.push_back(objectData);
+        }
+    }
+
+    struct StaticSceneDescriptor
+    {
+        std::shared_ptr<StaticScene> scene;
+        StaticObjectData objectData;
+        std::vector<StaticObjectInstanceData> instanceData;
+    };
+
+    struct alignas(16) NormalizedVertex
+    {
+        glm::vec3 position;
+        glm::vec3 normal;
+        glm::vec2 uv;
+    };
+
+    std::map<std::string, StaticSceneDescriptor> m_scenes;
+    std::vector<StaticMeshDescriptor> m_meshes;
+    std::vector<unsigned int> m_indices;
+    std::vector<StaticObjectInstanceData> m_instanceTransformations;
+
+    std::vector<StaticObjectData> m_drawObjectData;
+    std::vector<unsigned int> m_instanceIndices;
+    std::vector<NormalizedVertex> m_normalizedVertexData;
+    std::vector<QuantizedVertex> m_quantizedVertexData;
+
+    std::vector<Meshlet> m_meshlets;
+    MeshletBounds m_meshletBounds;
+    std::vector<GpuMeshlet> m_gpuMeshlets;
+    std::vector<std::uint8_t> m_meshletVisibility;
+    std::vector<glm::uvec2> m_meshletJobs; // meshlet, instance
+    std::vector<OcclusionCandidate> m_occlusionCandidates;
+    std::array<glm::vec4, 6> m_frustumPlanes;
+    glm::vec3 m_cameraPosition;
+
+public:
+    std::unique_ptr<globjects::VertexArray> m_vao;
+    std::unique_ptr<globjects::Buffer> m_drawCommandBuffer;
+    std::unique_ptr<globjects::Buffer> m_geometryDataBuffer;
+    std::unique_ptr<globjects::Buffer> m_elementBuffer;
+    std::unique_ptr<globjects::Buffer> m_objectDataBuffer;
+    std::unique_ptr<globjects::Buffer> m_objectInstanceDataBuffer;
+    std::unique_ptr<globjects::Buffer> m_instanceIndexBuffer;
+    std::unique_ptr<globjects::Buffer> m_meshletBuffer;
+    std::unique_ptr<globjects::Buffer> m_meshletJobBuffer;
+    std::unique_ptr<globjects::Buffer> m_meshObjectDataBuffer;
+    std::unique_ptr<globjects::Buffer> m_drawCountBuffer;
+    std::unique_ptr<globjects::Buffer> m_lateDrawCommandBuffer;
+    std::unique_ptr<globjects::Buffer> m_lateInstanceIndexBuffer;
+    std::unique_ptr<globjects::Buffer> m_culledDrawCommandBuffer;
+    std::unique_ptr<globjects::Buffer> m_culledInstanceIndexBuffer;
+    std::unique_ptr<globjects::Buffer> m_occlusionCandidateBuffer;
+    std::unique_ptr<globjects::Buffer> m_visibilityBuffer; // per mesh instance, persists between the frames
+
+    std::vector<StaticGeometryDrawCommand> m_drawCommands;
+
+private:
+    bool m_useBindlessTextures;
+    VertexCompression m_vertexCompression;
+    MeshletCulling m_meshletCulling;
+    OcclusionCulling m_occlusionCulling;
+
+    // bindless mode
+    std::vector<std::unique_ptr<globjects::Texture>> m_textures;
+
+    // texture array mode
+    std::vector<std::unique_ptr<globjects::Texture>> m_textureBuckets;
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "stdafx.hpp"
+
+/**
+ * Post-import optimization of indexed triangle meshes; CPU only, so it does not need a GL context.
+ *
+ * The full pipeline (`optimize()`) runs, in order:
+ *  1. vertex deduplication - vertices with bitwise identical attributes are merged
+ *  2. triangle reordering for the post-transform vertex cache (Tipsify, Sander et al. 2007)
+ *  3. overdraw-aware reordering of the triangle clusters produced by the previous step
+ *  4. vertex reordering in the order of first use, so the vertex fetch goes through memory linearly
+ *
+ * Steps 2 and 3 only ever reorder whole triangles, preserving their winding.
+ */
+class MeshOptimizer
+{
+public:
+    static constexpr unsigned int DEFAULT_CACHE_SIZE = 16;
+    static constexpr unsigned int INVALID_INDEX = ~0u;
+
+    // one vertex attribute stream, tightly packed: `vertexCount` elements `stride` bytes each
+    struct VertexStream
+    {
+        const void* data;
+        std::size_t stride;
+    };
+
+    struct Statistics
+    {
+        float acmr; // average cache miss ratio - vertex shader invocations per triangle; 0.5 is the theoretical best, 3 is the worst
+        float atvr; // average transformed vertex ratio - vertex shader invocations per vertex; 1 is the best
+    };
+
+    struct Result
+    {
+        // old vertex index -> new vertex index, INVALID_INDEX for the vertices which are gone (duplicates and unreferenced ones)
+        std::vector<unsigned int> remap;
+        std::size_t vertexCount;
+
+        Statistics before;
+        Statistics after;
+    };
+
+    // runs the whole pipeline; the indices are rewritten in place, the vertex streams have to be remapped with `remapVertices()`
+    static Result optimize(std::vector<unsigned int>& indices, std::size_t vertexCount, const std::vector<VertexStream>& streams, const std::vector<glm::vec3>& positions);
+
+    // returns a remap table, mapping each vertex onto the first vertex which has the same data in all the streams
+    static std::vector<unsigned int> deduplicateVertices(std::size_t vertexCount, const std::vector<VertexStream>& streams);
+
+    static std::vector<unsigned int> optimizeVertexCache(const std::vector<unsigned int>& indices, std::size_t vertexCount, unsigned int cacheSize = DEFAULT_CACHE_SIZE);
+
+    // expects the indices to be already optimized for the vertex cache; threshold is how much ACMR could degrade in exchange for smaller clusters
+    static std::vector<unsigned int> optimizeOverdraw(const std::vector<unsigned int>& indices, const std::vector<glm::vec3>& positions, float threshold = 1.05f, unsigned int cacheSize = DEFAULT_CACHE_SIZE);
+
+    // rewrites the indices in place and returns the remap table (see Result::remap)
+    static std::vector<unsigned int> optimizeVertexFetch(std::vector<unsigned int>& indices, std::size_t vertexCount, std::size_t& uniqueVertexCount);
+
+    // FIFO cache simulation
+    static Statistics analyzeVertexCache(const std::vector<unsigned int>& indices, std::size_t vertexCount, unsigned int cacheSize = DEFAULT_CACHE_SIZE);
+
+    template <typename T>
+    static std::vector<T> remapVertices(const std::vector<T>& vertices, const std::vector<unsigned int>& remap, std::size_t vertexCount)
+    {
+        if (vertices.empty())
+        {
+            return {};
+        }
+
+        std::vector<T> result(vertexCount);
+
+        for (std::size_t i = 0; i < remap.size() && i < vertices.size(); ++i)
+        {
+            if (remap[i] != INVALID_INDEX)
+            {
+                result[remap[i]] = vertices[i];
+            }
+        }
+
+        return result;
+    }
+};
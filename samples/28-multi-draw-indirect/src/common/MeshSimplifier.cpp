@@ -0,0 +1,389 @@
+#include "MeshSimplifier.hpp"
+
+namespace
+{
+    // symmetric 4x4 matrix of the plane equation products; error(p) = sum of squared distances from p to the accumulated planes
+    struct Quadric
+    {
+        double a2 = 0, ab = 0, ac = 0, ad = 0;
+        double b2 = 0, bc = 0, bd = 0;
+        double c2 = 0, cd = 0;
+        double d2 = 0;
+
+        static Quadric fromPlane(glm::dvec3 normal, double distance)
+        {
+            return Quadric {
+                .a2 = normal.x * normal.x, .ab = normal.x * normal.y, .ac = normal.x * normal.z, .ad = normal.x * distance,
+                .b2 = normal.y * normal.y, .bc = normal.y * normal.z, .bd = normal.y * distance,
+                .c2 = normal.z * normal.z, .cd = normal.z * distance,
+                .d2 = distance * distance
+            };
+        }
+
+        Quadric& operator+=(const Quadric& other)
+        {
+            a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+            b2 += other.b2; bc += other.bc; bd += other.bd;
+            c2 += other.c2; cd += other.cd;
+            d2 += other.d2;
+
+            return *this;
+        }
+
+        double evaluate(glm::dvec3 p) const
+        {
+            const double error =
+                a2 * p.x * p.x + 2 * ab * p.x * p.y + 2 * ac * p.x * p.z + 2 * ad * p.x +
+                b2 * p.y * p.y + 2 * bc * p.y * p.z + 2 * bd * p.y +
+                c2 * p.z * p.z + 2 * cd * p.z +
+                d2;
+
+            // rounding could make it slightly negative
+            return std::max(error, 0.0);
+        }
+    };
+
+    struct Collapse
+    {
+        unsigned int from;
+        unsigned int to;
+        double geometricError;
+        double cost;
+    };
+
+    std::pair<unsigned int, unsigned int> makeEdge(unsigned int a, unsigned int b)
+    {
+        return a < b ? std::make_pair(a, b) : std::make_pair(b, a);
+    }
+
+    // collapsing `from` onto `to` must not turn any of the remaining triangles around `from` over (or into a sliver)
+    bool isFlipping(unsigned int from, unsigned int to, const std::vector<unsigned int>& indices, const std::vector<unsigned int>& triangles, const std::vector<glm::vec3>& positions)
+    {
+        for (auto triangle : triangles)
+        {
+            const auto* corners = &indices[triangle * 3];
+
+            if (corners[0] == to || corners[1] == to || corners[2] == to)
+            {
+                // this one degenerates and goes away
+                continue;
+            }
+
+            glm::vec3 before[3];
+            glm::vec3 after[3];
+
+            for (unsigned int i = 0; i < 3; ++i)
+            {
+                before[i] = positions[corners[i]];
+                after[i] = positions[corners[i] == from ? to : corners[i]];
+            }
+
+            const auto normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+            const auto normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+
+            // also rejects the collapses which turn the triangle into a zero-area one
+            if (glm::dot(normalBefore, normalAfter) <= 0.25f * glm::length(normalBefore) * glm::length(normalAfter))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
+
+std::vector<unsigned int> MeshSimplifier::simplify(
+    const std::vector<unsigned int>& indices,
+    const std::vector<glm::vec3>& positions,
+    const std::vector<glm::vec3>& normals,
+    const std::vector<glm::vec2>& uvs,
+    std::size_t targetIndexCount,
+    float& error,
+    const Settings& settings)
+{
+    const auto vertexCount = positions.size();
+
+    error = 0.0f;
+
+    if (indices.size() <= targetIndexCount || vertexCount == 0)
+    {
+        return indices;
+    }
+
+    const bool hasNormals = normals.size() == vertexCount;
+    const bool hasUVs = uvs.size() == vertexCount;
+
+    glm::vec3 boundsMin = positions[0];
+    glm::vec3 boundsMax = positions[0];
+
+    for (const auto& position : positions)
+    {
+        boundsMin = glm::min(boundsMin, position);
+        boundsMax = glm::max(boundsMax, position);
+    }
+
+    const double meshSize = std::max(static_cast<double>(glm::length(boundsMax - boundsMin)), 1e-6);
+
+    // vertices sharing a position (different attributes) form a seam; collapsing them separately would tear the mesh apart
+    std::vector<unsigned int> welded(vertexCount);
+    std::vector<unsigned int> weldedCount(vertexCount, 0);
+
+    {
+        std::map<std::tuple<float, float, float>, unsigned int> uniquePositions;
+
+        for (unsigned int vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            const auto key = std::make_tuple(positions[vertex].x, positions[vertex].y, positions[vertex].z);
+            const auto [it, isInserted] = uniquePositions.emplace(key, vertex);
+
+            welded[vertex] = it->second;
+            ++weldedCount[it->second];
+        }
+    }
+
+    std::vector<bool> isLocked(vertexCount, false);
+
+    for (unsigned int vertex = 0; vertex < vertexCount; ++vertex)
+    {
+        if (weldedCount[welded[vertex]] > 1)
+        {
+            isLocked[vertex] = true;
+        }
+    }
+
+    if (settings.lockBorders)
+    {
+        // border edges are the ones used by a single triangle
+        std::map<std::pair<unsigned int, unsigned int>, unsigned int> edgeUsage;
+
+        for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            for (unsigned int e = 0; e < 3; ++e)
+            {
+                ++edgeUsage[makeEdge(welded[indices[i + e]], welded[indices[i + (e + 1) % 3]])];
+            }
+        }
+
+        std::vector<bool> isBorderPosition(vertexCount, false);
+
+        for (const auto& [edge, usage] : edgeUsage)
+        {
+            if (usage == 1)
+            {
+                isBorderPosition[edge.first] = true;
+                isBorderPosition[edge.second] = true;
+            }
+        }
+
+        for (unsigned int vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            if (isBorderPosition[welded[vertex]])
+            {
+                isLocked[vertex] = true;
+            }
+        }
+    }
+
+    // every vertex starts with the planes of its triangles
+    std::vector<Quadric> quadrics(vertexCount);
+
+    for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        const glm::dvec3 a(positions[indices[i + 0]]);
+        const glm::dvec3 b(positions[indices[i + 1]]);
+        const glm::dvec3 c(positions[indices[i + 2]]);
+
+        const auto normal = glm::cross(b - a, c - a);
+        const double length = glm::length(normal);
+
+        if (length <= 0.0)
+        {
+            continue;
+        }
+
+        const auto unitNormal = normal / length;
+        const auto quadric = Quadric::fromPlane(unitNormal, -glm::dot(unitNormal, a));
+
+        for (unsigned int corner = 0; corner < 3; ++corner)
+        {
+            quadrics[indices[i + corner]] += quadric;
+        }
+    }
+
+    std::vector<unsigned int> result = indices;
+
+    double maxGeometricError = 0.0;
+
+    while (result.size() > targetIndexCount)
+    {
+        const auto triangleCount = result.size() / 3;
+
+        // vertex -> triangles around it
+        std::vector<std::vector<unsigned int>> vertexTriangles(vertexCount);
+
+        for (unsigned int triangle = 0; triangle < triangleCount; ++triangle)
+        {
+            for (unsigned int corner = 0; corner < 3; ++corner)
+            {
+                vertexTriangles[result[triangle * 3 + corner]].push_back(triangle);
+            }
+        }
+
+        std::vector<Collapse> collapses;
+        collapses.reserve(result.size() * 2);
+
+        for (std::size_t i = 0; i < result.size(); i += 3)
+        {
+            for (unsigned int e = 0; e < 3; ++e)
+            {
+                const auto a = result[i + e];
+                const auto b = result[i + (e + 1) % 3];
+
+                for (const auto& [from, to] : { std::make_pair(a, b), std::make_pair(b, a) })
+                {
+                    if (isLocked[from] || from == to)
+                    {
+                        continue;
+                    }
+
+                    const double geometricError = quadrics[from].evaluate(glm::dvec3(positions[to]));
+
+                    double attributeError = 0.0;
+
+                    if (hasNormals)
+                    {
+                        attributeError += settings.normalWeight * settings.normalWeight * meshSize * meshSize * glm::dot(normals[from] - normals[to], normals[from] - normals[to]);
+                    }
+
+                    if (hasUVs)
+                    {
+                        attributeError += settings.uvWeight * settings.uvWeight * meshSize * meshSize * glm::dot(uvs[from] - uvs[to], uvs[from] - uvs[to]);
+                    }
+
+                    collapses.push_back({ .from = from, .to = to, .geometricError = geometricError, .cost = geometricError + attributeError });
+                }
+            }
+        }
+
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+        // independent collapses only: a vertex whose neighbourhood has changed in this pass waits for the next one
+        std::vector<unsigned int> remap(vertexCount);
+        std::iota(remap.begin(), remap.end(), 0);
+
+        std::vector<bool> isTouched(vertexCount, false);
+
+        const auto trianglesToRemove = (result.size() - targetIndexCount + 2) / 3;
+        std::size_t trianglesRemoved = 0;
+
+        for (const auto& collapse : collapses)
+        {
+            if (trianglesRemoved >= trianglesToRemove)
+            {
+                break;
+            }
+
+            if (isTouched[collapse.from] || isTouched[collapse.to])
+            {
+                continue;
+            }
+
+            if (isFlipping(collapse.from, collapse.to, result, vertexTriangles[collapse.from], positions))
+            {
+                continue;
+            }
+
+            remap[collapse.from] = collapse.to;
+
+            for (auto triangle : vertexTriangles[collapse.from])
+            {
+                bool isDegenerate = false;
+
+                for (unsigned int corner = 0; corner < 3; ++corner)
+                {
+                    isTouched[result[triangle * 3 + corner]] = true;
+                    isDegenerate |= result[triangle * 3 + corner] == collapse.to;
+                }
+
+                if (isDegenerate)
+                {
+                    ++trianglesRemoved;
+                }
+            }
+
+            quadrics[collapse.to] += quadrics[collapse.from];
+
+            maxGeometricError = std::max(maxGeometricError, collapse.geometricError);
+        }
+
+        if (trianglesRemoved == 0)
+        {
+            // nothing could be collapsed any further
+            break;
+        }
+
+        std::vector<unsigned int> simplified;
+        simplified.reserve(result.size());
+
+        for (std::size_t i = 0; i < result.size(); i += 3)
+        {
+            const auto a = remap[result[i + 0]];
+            const auto b = remap[result[i + 1]];
+            const auto c = remap[result[i + 2]];
+
+            if (a != b && b != c && a != c)
+            {
+                simplified.insert(simplified.end(), { a, b, c });
+            }
+        }
+
+        result = std::move(simplified);
+    }
+
+    error = static_cast<float>(std::sqrt(maxGeometricError));
+
+    return result;
+}
+
+std::vector<MeshSimplifier::Lod> MeshSimplifier::generateLodChain(
+    const std::vector<unsigned int>& indices,
+    const std::vector<glm::vec3>& positions,
+    const std::vector<glm::vec3>& normals,
+    const std::vector<glm::vec2>& uvs,
+    unsigned int maxLevels,
+    float ratio,
+    const Settings& settings)
+{
+    std::vector<Lod> lods;
+
+    auto previousIndexCount = indices.size();
+    float targetRatio = 1.0f;
+
+    for (unsigned int level = 1; level < maxLevels; ++level)
+    {
+        targetRatio *= ratio;
+
+        const auto targetIndexCount = static_cast<std::size_t>(static_cast<float>(indices.size() / 3) * targetRatio) * 3;
+
+        if (targetIndexCount < 3)
+        {
+            break;
+        }
+
+        // every level starts from the source mesh, so the errors do not pile up from one level to the next
+        Lod lod;
+        lod.indices = simplify(indices, positions, normals, uvs, targetIndexCount, lod.error, settings);
+
+        // locked borders and seams could stop the simplification way before the target
+        if (lod.indices.empty() || lod.indices.size() > previousIndexCount * 9 / 10)
+        {
+            break;
+        }
+
+        previousIndexCount = lod.indices.size();
+
+        lods.push_back(std::move(lod));
+    }
+
+    return lods;
+}
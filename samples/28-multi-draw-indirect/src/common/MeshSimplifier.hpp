@@ -0,0 +1,56 @@
+#pragma once
+
+#include "stdafx.hpp"
+
+struct MeshSimplifierSettings
+{
+    // attribute differences are weighted against the geometric error, relative to the mesh size
+    float normalWeight = 0.25f;
+    float uvWeight = 0.5f;
+
+    bool lockBorders = true;
+};
+
+/**
+ * Mesh simplification with quadric error metrics (Garland & Heckbert 1997).
+ *
+ * Edges are collapsed onto one of their end points rather than onto an optimal position, so the simplified meshes
+ * only ever reference the vertices of the source mesh - every level of detail shares one vertex buffer and only needs
+ * its own range in the index buffer.
+ *
+ * Vertices on open borders and on attribute seams (same position, different normal or UV) are locked, so the
+ * silhouette and the texture mapping do not tear apart.
+ */
+class MeshSimplifier
+{
+public:
+    using Settings = MeshSimplifierSettings;
+
+    struct Lod
+    {
+        std::vector<unsigned int> indices;
+
+        // how far (at most, roughly) the simplified surface deviates from the source one, in model space units
+        float error;
+    };
+
+    // simplifies the mesh down to (at most, if possible) `targetIndexCount` indices; `error` receives the deviation of the result
+    static std::vector<unsigned int> simplify(
+        const std::vector<unsigned int>& indices,
+        const std::vector<glm::vec3>& positions,
+        const std::vector<glm::vec3>& normals,
+        const std::vector<glm::vec2>& uvs,
+        std::size_t targetIndexCount,
+        float& error,
+        const Settings& settings = {});
+
+    // LODs 1 to `maxLevels - 1`, each with `ratio` of the triangles of the previous one; the chain stops as soon as the mesh does not simplify any further
+    static std::vector<Lod> generateLodChain(
+        const std::vector<unsigned int>& indices,
+        const std::vector<glm::vec3>& positions,
+        const std::vector<glm::vec3>& normals,
+        const std::vector<glm::vec2>& uvs,
+        unsigned int maxLevels = 4,
+        float ratio = 0.5f,
+        const Settings& settings = {});
+};
@@ -0,0 +1,127 @@
+#include "MeshletBuilder.hpp"
+
+std::vector<Meshlet> MeshletBuilder::build(const std::vector<unsigned int>& indices, const std::vector<glm::vec3>& positions, unsigned int maxVertices, unsigned int maxTriangles)
+{
+    std::vector<Meshlet> meshlets;
+
+    // vertex -> index of the last meshlet it was added to, to count the unique vertices of the current meshlet
+    std::vector<unsigned int> vertexMeshlet(positions.size(), ~0u);
+
+    Meshlet current { .firstIndex = 0, .elementCount = 0 };
+    unsigned int currentVertices = 0;
+
+    const auto finish = [&]() {
+        if (current.elementCount == 0)
+        {
+            return;
+        }
+
+        calculateBounds(current, indices, positions);
+
+        meshlets.push_back(current);
+
+        current = Meshlet { .firstIndex = current.firstIndex + current.elementCount, .elementCount = 0 };
+        currentVertices = 0;
+    };
+
+    for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        const auto meshletIndex = static_cast<unsigned int>(meshlets.size());
+
+        unsigned int newVertices = 0;
+
+        for (unsigned int corner = 0; corner < 3; ++corner)
+        {
+            newVertices += vertexMeshlet[indices[i + corner]] != meshletIndex ? 1 : 0;
+        }
+
+        if (currentVertices + newVertices > maxVertices || current.elementCount / 3 >= maxTriangles)
+        {
+            finish();
+        }
+
+        // the meshlet could have just been finished
+        const auto targetMeshlet = static_cast<unsigned int>(meshlets.size());
+
+        for (unsigned int corner = 0; corner < 3; ++corner)
+        {
+            if (vertexMeshlet[indices[i + corner]] != targetMeshlet)
+            {
+                vertexMeshlet[indices[i + corner]] = targetMeshlet;
+                ++currentVertices;
+            }
+        }
+
+        current.elementCount += 3;
+    }
+
+    finish();
+
+    return meshlets;
+}
+
+void MeshletBuilder::calculateBounds(Meshlet& meshlet, const std::vector<unsigned int>& indices, const std::vector<glm::vec3>& positions)
+{
+    const auto begin = indices.begin() + meshlet.firstIndex;
+    const auto end = begin + meshlet.elementCount;
+
+    glm::vec3 boundsMin = positions[*begin];
+    glm::vec3 boundsMax = positions[*begin];
+
+    for (auto it = begin; it != end; ++it)
+    {
+        boundsMin = glm::min(boundsMin, positions[*it]);
+        boundsMax = glm::max(boundsMax, positions[*it]);
+    }
+
+    meshlet.center = (boundsMin + boundsMax) * 0.5f;
+    meshlet.radius = 0.0f;
+
+    for (auto it = begin; it != end; ++it)
+    {
+        meshlet.radius = std::max(meshlet.radius, glm::length(positions[*it] - meshlet.center));
+    }
+
+    // the cone axis is the average triangle normal; the cone has to fit the normals of all the (non-degenerate) triangles
+    std::vector<glm::vec3> normals;
+    glm::vec3 axis(0.0f);
+
+    for (auto it = begin; it != end; it += 3)
+    {
+        const auto normal = glm::cross(positions[*(it + 1)] - positions[*it], positions[*(it + 2)] - positions[*it]);
+        const float length = glm::length(normal);
+
+        if (length <= 0.0f)
+        {
+            continue;
+        }
+
+        normals.push_back(normal / length);
+        axis += normal / length;
+    }
+
+    meshlet.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+    meshlet.coneCutoff = 1.0f;
+
+    if (normals.empty() || glm::length(axis) <= 0.0f)
+    {
+        return;
+    }
+
+    meshlet.coneAxis = glm::normalize(axis);
+
+    float minDot = 1.0f;
+
+    for (const auto& normal : normals)
+    {
+        minDot = std::min(minDot, glm::dot(normal, meshlet.coneAxis));
+    }
+
+    // a cone wider than a hemisphere always has some triangle facing the camera
+    if (minDot <= 0.0f)
+    {
+        return;
+    }
+
+    meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+}
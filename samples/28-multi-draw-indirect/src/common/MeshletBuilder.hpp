@@ -0,0 +1,40 @@
+#pragma once
+
+#include "stdafx.hpp"
+
+/**
+ * A small cluster of triangles, a contiguous range of the mesh index buffer, with the bounds to cull it by.
+ */
+struct Meshlet
+{
+    unsigned int firstIndex; // relative to the first index of the mesh
+    unsigned int elementCount;
+
+    glm::vec3 center;
+    float radius;
+
+    // normals of all the meshlet triangles are within the cone around `coneAxis`; the meshlet is entirely back-facing when
+    // dot(center - camera, coneAxis) >= coneCutoff * length(center - camera) + radius
+    glm::vec3 coneAxis;
+    float coneCutoff; // sine of the cone half-angle, 1 for the meshlets which could never be back-facing as a whole
+};
+
+/**
+ * Splits the triangle list into meshlets, keeping the triangle order - the index buffer is expected to be optimized
+ * for the vertex cache already, which keeps neighbouring triangles next to each other.
+ */
+class MeshletBuilder
+{
+public:
+    static constexpr unsigned int DEFAULT_MAX_VERTICES = 64;
+    static constexpr unsigned int DEFAULT_MAX_TRIANGLES = 124;
+
+    static std::vector<Meshlet> build(
+        const std::vector<unsigned int>& indices,
+        const std::vector<glm::vec3>& positions,
+        unsigned int maxVertices = DEFAULT_MAX_VERTICES,
+        unsigned int maxTriangles = DEFAULT_MAX_TRIANGLES);
+
+private:
+    static void calculateBounds(Meshlet& meshlet, const std::vector<unsigned int>& indices, const std::vector<glm::vec3>& positions);
+};
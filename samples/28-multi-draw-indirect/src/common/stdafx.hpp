@@ -1,10 +1,22 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <memory_resource>
+#include <numeric>
 #include <random>
 #include <sstream>
+#include <tuple>
+#include <unordered_map>
 
+#include <glbinding/gl/extension.h>
 #include <glbinding/gl/gl.h>
 
 #include <globjects/Buffer.h>
@@ -22,6 +34,7 @@
 #include <globjects/base/StaticStringSource.h>
 #include <globjects/globjects.h>
 
+#include <glm/common.hpp>
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/ext/matrix_transform.hpp>
 #include <glm/ext/quaternion_float.hpp>
@@ -29,9 +42,13 @@
 #include <glm/ext/quaternion_geometric.hpp>
 #include <glm/ext/quaternion_relational.hpp>
 #include <glm/ext/quaternion_transform.hpp>
+#include <glm/gtc/packing.hpp>
+#include <glm/gtc/type_precision.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/rotate_vector.hpp>
+#include <glm/geometric.hpp>
 #include <glm/mat4x4.hpp>
+#include <glm/trigonometric.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
@@ -43,6 +60,8 @@
 #include <SFML/OpenGL.hpp>
 #include <SFML/Window.hpp>
 
+#include <FrameArena.hpp>
+
 #ifdef WIN32
 using namespace gl;
 #endif
@@ -1,596 +1,198 @@
 #include "common/stdafx.hpp"
 
-struct StaticGeometryDrawCommand
-{
-    unsigned int elementCount; // number of elements (triangles) to be rendered for this object
-    unsigned int instanceCount; // number of object instances
-    unsigned int firstIndex; // offset into GL_ELEMENT_ARRAY_BUFFER
-    unsigned int baseVertex; // offset of the first object' vertex in the uber-static-object-buffer
-    unsigned int baseInstance; // offset of the first instance' per-instance-vertex-attributes; attribute index is calculated as: (gl_InstanceID / glVertexAttribDivisor()) + baseInstance
-};
-
-struct alignas(16) StaticObjectData
-{
-    glm::vec2 albedoTextureSize;
-    glm::vec2 normalTextureSize;
-    glm::vec2 emissionTextureSize;
-    unsigned int instanceDataOffset;
-};
+#include "AssimpStaticModelLoader.hpp"
+#include "StaticGeometryDrawable.hpp"
 
-struct alignas(16) StaticObjectInstanceData
+int main()
 {
-    glm::mat4 transformation;
-};
+    sf::ContextSettings settings;
+    settings.depthBits = 24;
+    settings.stencilBits = 8;
+    settings.antialiasingLevel = 4;
+    settings.majorVersion = 4;
+    settings.minorVersion = 6;
+    settings.attributeFlags = sf::ContextSettings::Attribute::Core;
 
-struct StaticMesh
-{
-    std::vector<glm::vec3> vertexPositions;
-    std::vector<glm::vec3> normals;
-    std::vector<glm::vec2> uvs;
-    std::vector<unsigned int> indices;
-};
+#if defined(SYSTEM_DARWIN) || defined(HIGH_DPI)
+    auto videoMode = sf::VideoMode(2048, 1536);
+#else
+    auto videoMode = sf::VideoMode(1024, 768);
+#endif
 
-struct StaticScene
-{
-    std::vector<StaticMesh> meshes;
-    std::unique_ptr<sf::Image> albedoTexture;
-    std::unique_ptr<sf::Image> normalTexture;
-    std::unique_ptr<sf::Image> emissionTexture;
-};
+    sf::Window window(videoMode, "Hello, Indirect drawing!", sf::Style::Default, settings);
 
-class AssimpStaticModelLoader
-{
-public:
-    AssimpStaticModelLoader()
-    {
-    }
+    globjects::init([](const char* name) {
+        return sf::Context::getFunction(name);
+    });
 
-    static std::shared_ptr<StaticScene> fromFile(std::string filename, std::vector<std::filesystem::path> materialLookupPaths = {}, unsigned int assimpImportFlags = aiProcess_Triangulate)
-    {
-        static auto importer = std::make_unique<Assimp::Importer>();
-        auto scene = importer->ReadFile(filename, assimpImportFlags);
+    globjects::DebugMessage::enable(); // enable automatic messages if KHR_debug is available
 
-        auto resultScene = std::make_shared<StaticScene>();
+    globjects::DebugMessage::setCallback([](const globjects::DebugMessage& message) {
+        std::cout << "[DEBUG] " << message.message() << std::endl;
+    });
 
-        if (!scene)
-        {
-            std::cerr << "failed: " << importer->GetErrorString() << std::endl;
-            return resultScene;
-        }
+    std::cout << "[INFO] Initializing..." << std::endl;
 
-        fromAiNode(scene, scene->mRootNode, materialLookupPaths, resultScene);
+    // per-object texture handles, unless the driver does not support them - then texture arrays bucketed by size are used
+    const bool useBindlessTextures = globjects::hasExtension(gl::GLextension::GL_ARB_bindless_texture);
 
-        return std::move(resultScene);
-    }
+    std::cout << "[INFO] Using " << (useBindlessTextures ? "bindless textures" : "texture arrays") << std::endl;
 
-protected:
-    static void fromAiNode(const aiScene* scene, aiNode* node, std::vector<std::filesystem::path> materialLookupPaths, std::shared_ptr<StaticScene> resultScene)
+    if (useBindlessTextures)
     {
-        for (auto t = 0; t < node->mNumMeshes; ++t)
-        {
-            fromAiMesh(scene, scene->mMeshes[node->mMeshes[t]], materialLookupPaths, resultScene);
-        }
-
-        for (auto i = 0; i < node->mNumChildren; ++i)
-        {
-            auto child = node->mChildren[i];
-
-            fromAiNode(scene, child, materialLookupPaths, resultScene);
-        }
+        globjects::Shader::globalReplace("#define BINDLESS_TEXTURES 0", "#define BINDLESS_TEXTURES 1");
     }
 
-    static std::unique_ptr<sf::Image> loadTexture(std::string& imagePath, std::vector<std::filesystem::path> materialLookupPaths)
-    {
-        for (auto path : materialLookupPaths)
-        {
-            std::cout << "[INFO] Looking up the DIFFUSE texture in " << path << "...";
-
-            const auto filePath = std::filesystem::path(path).append(imagePath);
-
-            if (std::filesystem::exists(filePath))
-            {
-                imagePath = filePath.string();
-                break;
-            }
-        }
-
-        std::cout << "[INFO] Loading DIFFUSE texture " << imagePath << "...";
-
-        auto textureImage = std::make_unique<sf::Image>();
+    // 16 bytes per vertex instead of 48; switch to VertexCompression::NONE to compare against the float vertex data
+    const auto vertexCompression = VertexCompression::QUANTIZED;
 
-        if (!textureImage->loadFromFile(imagePath))
-        {
-            std::cerr << "[ERROR] Can not load texture" << std::endl;
-            return nullptr;
-        }
-
-        textureImage->flipVertically();
-
-        return std::move(textureImage);
-    }
-
-    static void fromAiMesh(const aiScene* scene, aiMesh* mesh, std::vector<std::filesystem::path> materialLookupPaths, std::shared_ptr<StaticScene> resultScene)
+    if (vertexCompression == VertexCompression::QUANTIZED)
     {
-        std::cout << "[INFO] Creating buffer objects...";
-
-        std::vector<glm::vec3> vertices;
-        std::vector<glm::vec3> normals;
-        std::vector<glm::vec2> uvs;
-
-        std::vector<GLuint> indices;
-
-        for (auto i = 0; i < mesh->mNumVertices; ++i)
-        {
-            glm::vec3 position(
-                mesh->mVertices[i].x,
-                mesh->mVertices[i].y,
-                mesh->mVertices[i].z);
-
-            vertices.push_back(position);
-
-            if (mesh->HasNormals())
-            {
-                glm::vec3 normal(
-                    mesh->mNormals[i].x,
-                    mesh->mNormals[i].y,
-                    mesh->mNormals[i].z);
-
-                normals.push_back(normal);
-            }
-
-            if (mesh->HasTextureCoords(0))
-            {
-                glm::vec3 uv(
-                    mesh->mTextureCoords[0][i].x,
-                    mesh->mTextureCoords[0][i].y,
-                    mesh->mTextureCoords[0][i].z);
-
-                uvs.push_back(uv);
-            }
-        }
-
-        for (auto i = 0; i < mesh->mNumFaces; ++i)
-        {
-            auto face = mesh->mFaces[i];
-
-            for (auto t = 0; t < face.mNumIndices; ++t)
-            {
-                indices.push_back(face.mIndices[t]);
-            }
-        }
-
-        std::cout << "done" << std::endl;
-
-        std::cout << "[INFO] Loading textures...";
-
-        std::vector<std::unique_ptr<globjects::Texture>> textures;
-
-        if (mesh->mMaterialIndex >= 0)
-        {
-            auto material = scene->mMaterials[mesh->mMaterialIndex];
-
-            auto numDiffuseTextures = material->GetTextureCount(aiTextureType_DIFFUSE);
-            auto numNormalTextures = material->GetTextureCount(aiTextureType_NORMALS);
-            auto numEmissionTextures = material->GetTextureCount(aiTextureType_EMISSIVE);
-
-            auto numEmissionColorTextures = material->GetTextureCount(aiTextureType_EMISSION_COLOR);
-            auto numSpecularTextures = material->GetTextureCount(aiTextureType_SPECULAR);
-
-            if (numDiffuseTextures > 0)
-            {
-                aiString str;
-                material->GetTexture(aiTextureType_DIFFUSE, 0, &str);
-
-                std::string imagePath { str.C_Str() };
-
-                auto texture = loadTexture(imagePath, materialLookupPaths);
-
-                resultScene->albedoTexture = std::move(texture);
-            }
-
-            if (numNormalTextures > 0)
-            {
-                aiString str;
-                material->GetTexture(aiTextureType_NORMALS, 0, &str);
-
-                std::string imagePath { str.C_Str() };
-
-                auto texture = loadTexture(imagePath, materialLookupPaths);
-
-                resultScene->normalTexture = std::move(texture);
-            }
-
-            if (numEmissionTextures > 0)
-            {
-                aiString str;
-                material->GetTexture(aiTextureType_EMISSIVE, 0, &str);
-
-                std::string imagePath { str.C_Str() };
-
-                auto texture = loadTexture(imagePath, materialLookupPaths);
+        globjects::Shader::globalReplace("#define QUANTIZED_VERTICES 0", "#define QUANTIZED_VERTICES 1");
+    }
 
-                resultScene->emissionTexture = std::move(texture);
-            }
-        }
+    std::cout << "[INFO] Creating shaders..." << std::endl;
 
-        std::cout << "done" << std::endl;
+    std::cout << "[INFO] Compiling simple vertex shader...";
 
-        resultScene->meshes.push_back({ .vertexPositions = vertices,
-                                        .normals = normals,
-                                        .uvs = uvs,
-                                        .indices = indices });
-    }
-};
+    auto vertexSource = globjects::Shader::sourceFromFile("media/simple-rendering.vert");
+    auto vertexShaderTemplate = globjects::Shader::applyGlobalReplacements(vertexSource.get());
+    auto vertexShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_VERTEX_SHADER), vertexShaderTemplate.get());
 
-class StaticGeometryDrawable
-{
-public:
-    StaticGeometryDrawable() :
-        m_vao(std::make_unique<globjects::VertexArray>()),
-        m_drawCommandBuffer(std::make_unique<globjects::Buffer>()),
-        m_geometryDataBuffer(std::make_unique<globjects::Buffer>()),
-        m_elementBuffer(std::make_unique<globjects::Buffer>()),
-        m_objectDataBuffer(std::make_unique<globjects::Buffer>()),
-        m_objectInstanceDataBuffer(std::make_unique<globjects::Buffer>()),
-        albedoTextures(std::make_unique<globjects::Texture>(static_cast<gl::GLenum>(GL_TEXTURE_2D_ARRAY))),
-        normalTextures(std::make_unique<globjects::Texture>(static_cast<gl::GLenum>(GL_TEXTURE_2D_ARRAY))),
-        emissionTextures(std::make_unique<globjects::Texture>(static_cast<gl::GLenum>(GL_TEXTURE_2D_ARRAY)))
+    if (!vertexShader->compile())
     {
+        std::cerr << "[ERROR] Can not compile vertex shader '" << "media/simple-rendering.vert" << "'" << std::endl;
+        // return nullptr;
     }
 
-    ~StaticGeometryDrawable()
-    {
-        // albedoTextures->textureHandle().makeNonResident();
-        // normalTextures->textureHandle().makeNonResident();
-        // emissionTextures->textureHandle().makeNonResident();
-    }
+    auto fragmentSource = globjects::Shader::sourceFromFile("media/simple-rendering.frag");
+    auto fragmentShaderTemplate = globjects::Shader::applyGlobalReplacements(fragmentSource.get());
+    auto fragmentShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_FRAGMENT_SHADER), fragmentShaderTemplate.get());
 
-    void addScene(std::string sceneName, std::shared_ptr<StaticScene> scene)
+    if (!fragmentShader->compile())
     {
-        StaticObjectData objectData {
-            .albedoTextureSize = getTextureSize(scene->albedoTexture.get()),
-            .normalTextureSize = getTextureSize(scene->normalTexture.get()),
-            .emissionTextureSize = getTextureSize(scene->emissionTexture.get()),
-            .instanceDataOffset = static_cast<unsigned int>(m_scenes.size())
-        };
-
-        m_scenes[sceneName] = {
-            .scene = std::move(scene),
-            .objectData = objectData,
-            .instanceData = {}
-        };
+        std::cerr << "[ERROR] Can not compile fragment shader '" << "media/simple-rendering.frag" << "'" << std::endl;
+        // return nullptr;
     }
 
-    /*StaticSceneDescriptor getSceneInstance(std::string sceneName)
-    {
-        return m_scenes[sceneName];
-    }*/
-
-    void addSceneInstance(std::string sceneName, StaticObjectInstanceData instanceData)
-    {
-        if (m_scenes.find(sceneName) == m_scenes.end())
-        {
-            return;
-        }
+    auto simpleProgram = std::make_shared<globjects::Program>();
+    simpleProgram->attach(vertexShader.get(), fragmentShader.get());
 
-        m_scenes[sceneName].instanceData.push_back(instanceData);
-    }
+    simpleProgram->link();
 
-    void build()
+    if (!simpleProgram->isLinked())
     {
-        std::vector<unsigned int> m_indices;
-
-        m_drawCommands.clear();
-        m_normalizedVertexData.clear();
-
-        std::vector<StaticObjectData> m_objectData;
-        std::vector<StaticObjectInstanceData> m_objectInstanceData;
-
-        for (auto& sceneKV : m_scenes)
-        {
-            auto scene = sceneKV.second.scene;
-
-            for (auto& mesh : scene->meshes)
-            {
-                unsigned int firstIndex = static_cast<unsigned int>(m_indices.size());
-                unsigned int baseInstance = 0;
-                unsigned int baseVertex = static_cast<unsigned int>(m_normalizedVertexData.size());
-
-                unsigned int elementCount = 0;
-                unsigned int vertexCount = 0;
-
-                const auto numVertices = mesh.vertexPositions.size();
-
-                for (size_t i = 0; i < numVertices; ++i)
-                {
-                    auto position = mesh.vertexPositions[i];
-                    auto normal = mesh.normals[i];
-                    auto uv = mesh.uvs[i];
-
-                    m_normalizedVertexData.push_back({ .position = position, .normal = normal, .uv = uv });
-                }
-
-                m_indices.insert(m_indices.end(), mesh.indices.begin(), mesh.indices.end());
-
-                elementCount += mesh.indices.size();
-                vertexCount += numVertices;
-
-                // if a scene contains multiple meshes, each of them will have their indexes reset (e.g. start from 0), so to count for that have to issue more draw commands
-                StaticGeometryDrawCommand drawCommand {
-                    .elementCount = static_cast<unsigned int>(mesh.indices.size()), // the number of elements to draw (triangles in this case)
-                    .instanceCount = 1,
-                    .firstIndex = firstIndex, // this is the offset of the index data in the unified index data buffer
-                    .baseVertex = baseVertex, // this is the offset of vertex data sub-array within a big-big buffer of vertex data; essentially the first vertex' index of current object in unified vertex data buffer
-                    .baseInstance = baseInstance
-                };
-
-                std::cout << "[DEBUG] Draw command: { "
-                          << "elementCount: " << drawCommand.elementCount << "; "
-                          << "instanceCount: " << drawCommand.instanceCount << "; "
-                          << "firstIndex: " << drawCommand.firstIndex << "; "
-                          << "baseVertex: " << drawCommand.baseVertex << "; "
-                          << "baseInstance: " << drawCommand.baseInstance << " }"
-                          << "\n";
-
-                m_drawCommands.push_back(drawCommand);
-
-                sceneKV.second.objectData.instanceDataOffset = m_objectInstanceData.size();
-
-                // have to add redundant data to the objectDataBuffer and objectInstanceDataBuffer to count for multiple meshes within the same scene
-                m_objectData.push_back(sceneKV.second.objectData); // TODO: the offset for the object/instance data here is incorrect
-            }
-
-            std::cout << "[DEBUG] End object " << sceneKV.first << "; instances to add: " << sceneKV.second.instanceData.size() << "\n";
-
-            m_objectInstanceData.insert(m_objectInstanceData.end(), sceneKV.second.instanceData.begin(), sceneKV.second.instanceData.end());
-        }
-
-        std::cout << "[DEBUG] Object data: " << m_objectData.size() << "; instance data: " << m_objectInstanceData.size() << "\n";
-
-        // generate draw command buffer
-        m_drawCommandBuffer->setData(m_drawCommands, static_cast<gl::GLenum>(GL_DYNAMIC_DRAW)); // draw commands can technically be changed
-
-        // generate vertex data buffer
-        m_geometryDataBuffer->setData(m_normalizedVertexData, static_cast<gl::GLenum>(GL_STATIC_DRAW));
-
-        m_vao->binding(0)->setAttribute(0);
-        m_vao->binding(0)->setBuffer(m_geometryDataBuffer.get(), 0, sizeof(NormalizedVertex)); // number of elements in buffer, stride, size of buffer element
-        m_vao->binding(0)->setFormat(3, static_cast<gl::GLenum>(GL_FLOAT)); // number of data elements per buffer element (vertex), type of data
-        m_vao->enable(0);
-
-        m_vao->binding(1)->setAttribute(1);
-        m_vao->binding(1)->setBuffer(m_geometryDataBuffer.get(), offsetof(NormalizedVertex, normal), sizeof(NormalizedVertex)); // number of elements in buffer, stride, size of buffer element
-        m_vao->binding(1)->setFormat(3, static_cast<gl::GLenum>(GL_FLOAT)); // number of data elements per buffer element (vertex), type of data
-        m_vao->enable(1);
-
-        m_vao->binding(2)->setAttribute(2);
-        m_vao->binding(2)->setBuffer(m_geometryDataBuffer.get(), offsetof(NormalizedVertex, uv), sizeof(NormalizedVertex)); // number of elements in buffer, stride, size of buffer element
-        m_vao->binding(2)->setFormat(2, static_cast<gl::GLenum>(GL_FLOAT)); // number of data elements per buffer element (vertex), type of data
-        m_vao->enable(2);
-
-        // generate element buffer
-        m_elementBuffer->setData(m_indices, static_cast<gl::GLenum>(GL_STATIC_DRAW));
-
-        std::cout << "[DEBUG] Index buffer elements: " << m_indices.size() << "\n";
-
-        m_vao->bindElementBuffer(m_elementBuffer.get());
-
-        std::cout << "[DEBUG] Object data buffer elements: " << m_objectData.size() << "\n";
-
-        m_objectDataBuffer->setData(m_objectData, static_cast<gl::GLenum>(GL_DYNAMIC_COPY));
-
-        std::cout << "[DEBUG] Instance data buffer elements: " << m_objectInstanceData.size() << "\n";
-
-        m_objectInstanceDataBuffer->setData(m_objectInstanceData, static_cast<gl::GLenum>(GL_DYNAMIC_COPY));
-
-        // generate texture arrays
-        glm::vec2 maxAlbedoTextureSize(0, 0);
-        glm::vec2 maxNormalTextureSize(0, 0);
-        glm::vec2 maxEmissionTextureSize(0, 0);
-
-        for (auto& objectData : m_objectData)
-        {
-            maxAlbedoTextureSize.x = std::max(maxAlbedoTextureSize.x, objectData.albedoTextureSize.x);
-            maxAlbedoTextureSize.y = std::max(maxAlbedoTextureSize.y, objectData.albedoTextureSize.y);
-
-            maxNormalTextureSize.x = std::max(maxNormalTextureSize.x, objectData.normalTextureSize.x);
-            maxNormalTextureSize.y = std::max(maxNormalTextureSize.y, objectData.normalTextureSize.y);
-
-            maxEmissionTextureSize.x = std::max(maxEmissionTextureSize.x, objectData.emissionTextureSize.x);
-            maxEmissionTextureSize.y = std::max(maxEmissionTextureSize.y, objectData.emissionTextureSize.y);
-        }
-
-        albedoTextures->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<GLint>(GL_LINEAR));
-        albedoTextures->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAG_FILTER), static_cast<GLint>(GL_LINEAR));
-
-        albedoTextures->image3D(
-            0,
-            static_cast<gl::GLenum>(GL_RGBA8),
-            glm::vec3(maxAlbedoTextureSize.x, maxAlbedoTextureSize.y, m_scenes.size()),
-            0,
-            static_cast<gl::GLenum>(GL_RGBA),
-            static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
-            nullptr);
-
-        normalTextures->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<GLint>(GL_LINEAR));
-        normalTextures->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAG_FILTER), static_cast<GLint>(GL_LINEAR));
-
-        normalTextures->image3D(
-            0,
-            static_cast<gl::GLenum>(GL_RGBA8),
-            glm::vec3(maxNormalTextureSize.x, maxNormalTextureSize.y, m_scenes.size()),
-            0,
-            static_cast<gl::GLenum>(GL_RGBA),
-            static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
-            nullptr);
-
-        emissionTextures->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<GLint>(GL_LINEAR));
-        emissionTextures->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAG_FILTER), static_cast<GLint>(GL_LINEAR));
-
-        emissionTextures->image3D(
-            0,
-            static_cast<gl::GLenum>(GL_RGBA8),
-            glm::vec3(maxEmissionTextureSize.x, maxEmissionTextureSize.y, m_scenes.size()),
-            0,
-            static_cast<gl::GLenum>(GL_RGBA),
-            static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
-            nullptr);
-
-        unsigned int i = 0;
-
-        for (auto& sceneDescKV : m_scenes)
-        {
-            auto scene = sceneDescKV.second.scene;
+        std::cerr << "Failed to link program" << std::endl;
+        // return nullptr;
+    }
 
-            if (scene->albedoTexture != nullptr)
-            {
-                albedoTextures->subImage3D(
-                    0,
-                    glm::vec3(0, 0, i),
-                    glm::vec3(scene->albedoTexture->getSize().x, scene->albedoTexture->getSize().y, 1),
-                    static_cast<gl::GLenum>(GL_RGBA),
-                    static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
-                    reinterpret_cast<const gl::GLvoid*>(scene->albedoTexture->getPixelsPtr()));
-            }
+    // mesh instances hidden behind the others are culled against the depth pyramid; OcclusionCulling::NONE to compare
+    const auto occlusionCulling = OcclusionCulling::HZB;
 
-            if (scene->normalTexture != nullptr)
-            {
-                normalTextures->subImage3D(
-                    0,
-                    glm::vec3(0, 0, i),
-                    glm::vec3(scene->normalTexture->getSize().x, scene->normalTexture->getSize().y, 1),
-                    static_cast<gl::GLenum>(GL_RGBA),
-                    static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
-                    reinterpret_cast<const gl::GLvoid*>(scene->normalTexture->getPixelsPtr()));
-            }
+    // clusters of the full detail meshes are frustum and back-face culled in a compute shader; MeshletCulling::CPU does the same on the CPU;
+    // the occlusion culling takes over whole mesh instances, so the meshlets are only used without it
+    const auto meshletCulling = occlusionCulling == OcclusionCulling::HZB ? MeshletCulling::NONE : MeshletCulling::GPU;
 
-            if (scene->emissionTexture != nullptr)
-            {
-                emissionTextures->subImage3D(
-                    0,
-                    glm::vec3(0, 0, i),
-                    glm::vec3(scene->emissionTexture->getSize().x, scene->emissionTexture->getSize().y, 1),
-                    static_cast<gl::GLenum>(GL_RGBA),
-                    static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
-                    reinterpret_cast<const gl::GLvoid*>(scene->emissionTexture->getPixelsPtr()));
-            }
+    std::cout << "[INFO] Compiling meshlet culling compute shader...";
 
-            ++i;
-        }
+    auto meshletCullingSource = globjects::Shader::sourceFromFile("media/meshlet-culling.comp");
+    auto meshletCullingShaderTemplate = globjects::Shader::applyGlobalReplacements(meshletCullingSource.get());
+    auto meshletCullingShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_COMPUTE_SHADER), meshletCullingShaderTemplate.get());
 
-        // albedoTextures->textureHandle().makeResident();
-        // normalTextures->textureHandle().makeResident();
-        // emissionTextures->textureHandle().makeResident();
-    }
-
-private:
-    glm::vec2 getTextureSize(sf::Image* texture)
+    if (!meshletCullingShader->compile())
     {
-        if (texture == nullptr)
-        {
-            return glm::vec2();
-        }
-
-        return glm::vec2(texture->getSize().x, texture->getSize().y);
+        std::cerr << "[ERROR] Can not compile compute shader '" << "media/meshlet-culling.comp" << "'" << std::endl;
+        // return nullptr;
     }
 
-    struct StaticSceneDescriptor
-    {
-        std::shared_ptr<StaticScene> scene;
-        StaticObjectData objectData;
-        std::vector<StaticObjectInstanceData> instanceData;
-    };
+    auto meshletCullingProgram = std::make_shared<globjects::Program>();
+    meshletCullingProgram->attach(meshletCullingShader.get());
 
-    struct alignas(16) NormalizedVertex
-    {
-        glm::vec3 position;
-        glm::vec3 normal;
-        glm::vec2 uv;
-    };
+    meshletCullingProgram->link();
 
-    std::map<std::string, StaticSceneDescriptor> m_scenes;
-    std::vector<NormalizedVertex> m_normalizedVertexData;
+    if (!meshletCullingProgram->isLinked())
+    {
+        std::cerr << "Failed to link program" << std::endl;
+        // return nullptr;
+    }
 
-public:
-    std::unique_ptr<globjects::VertexArray> m_vao;
-    std::unique_ptr<globjects::Buffer> m_drawCommandBuffer;
-    std::unique_ptr<globjects::Buffer> m_geometryDataBuffer;
-    std::unique_ptr<globjects::Buffer> m_elementBuffer;
-    std::unique_ptr<globjects::Buffer> m_objectDataBuffer;
-    std::unique_ptr<globjects::Buffer> m_objectInstanceDataBuffer;
+    std::cout << "done" << std::endl;
 
-    std::vector<StaticGeometryDrawCommand> m_drawCommands;
+    std::cout << "[INFO] Compiling depth pyramid compute shader...";
 
-    std::unique_ptr<globjects::Texture> albedoTextures;
-    std::unique_ptr<globjects::Texture> normalTextures;
-    std::unique_ptr<globjects::Texture> emissionTextures;
-};
+    auto depthPyramidSource = globjects::Shader::sourceFromFile("media/depth-pyramid.comp");
+    auto depthPyramidShaderTemplate = globjects::Shader::applyGlobalReplacements(depthPyramidSource.get());
+    auto depthPyramidShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_COMPUTE_SHADER), depthPyramidShaderTemplate.get());
 
-int main()
-{
-    sf::ContextSettings settings;
-    settings.depthBits = 24;
-    settings.stencilBits = 8;
-    settings.antialiasingLevel = 4;
-    settings.majorVersion = 4;
-    settings.minorVersion = 6;
-    settings.attributeFlags = sf::ContextSettings::Attribute::Core;
+    if (!depthPyramidShader->compile())
+    {
+        std::cerr << "[ERROR] Can not compile compute shader '" << "media/depth-pyramid.comp" << "'" << std::endl;
+        // return nullptr;
+    }
 
-#if defined(SYSTEM_DARWIN) || defined(HIGH_DPI)
-    auto videoMode = sf::VideoMode(2048, 1536);
-#else
-    auto videoMode = sf::VideoMode(1024, 768);
-#endif
+    auto depthPyramidProgram = std::make_shared<globjects::Program>();
+    depthPyramidProgram->attach(depthPyramidShader.get());
 
-    sf::Window window(videoMode, "Hello, Indirect drawing!", sf::Style::Default, settings);
+    depthPyramidProgram->link();
 
-    globjects::init([](const char* name) {
-        return sf::Context::getFunction(name);
-    });
+    if (!depthPyramidProgram->isLinked())
+    {
+        std::cerr << "Failed to link program" << std::endl;
+        // return nullptr;
+    }
 
-    globjects::DebugMessage::enable(); // enable automatic messages if KHR_debug is available
+    std::cout << "done" << std::endl;
 
-    globjects::DebugMessage::setCallback([](const globjects::DebugMessage& message) {
-        std::cout << "[DEBUG] " << message.message() << std::endl;
-    });
+    std::cout << "[INFO] Compiling occlusion culling compute shader...";
 
-    std::cout << "[INFO] Initializing..." << std::endl;
+    auto occlusionCullingSource = globjects::Shader::sourceFromFile("media/occlusion-culling.comp");
+    auto occlusionCullingShaderTemplate = globjects::Shader::applyGlobalReplacements(occlusionCullingSource.get());
+    auto occlusionCullingShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_COMPUTE_SHADER), occlusionCullingShaderTemplate.get());
 
-    std::cout << "[INFO] Creating shaders..." << std::endl;
+    if (!occlusionCullingShader->compile())
+    {
+        std::cerr << "[ERROR] Can not compile compute shader '" << "media/occlusion-culling.comp" << "'" << std::endl;
+        // return nullptr;
+    }
 
-    std::cout << "[INFO] Compiling simple vertex shader...";
+    auto occlusionCullingProgram = std::make_shared<globjects::Program>();
+    occlusionCullingProgram->attach(occlusionCullingShader.get());
 
-    auto vertexSource = globjects::Shader::sourceFromFile("media/simple-rendering.vert");
-    auto vertexShaderTemplate = globjects::Shader::applyGlobalReplacements(vertexSource.get());
-    auto vertexShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_VERTEX_SHADER), vertexShaderTemplate.get());
+    occlusionCullingProgram->link();
 
-    if (!vertexShader->compile())
+    if (!occlusionCullingProgram->isLinked())
     {
-        std::cerr << "[ERROR] Can not compile vertex shader '" << "media/simple-rendering.vert" << "'" << std::endl;
+        std::cerr << "Failed to link program" << std::endl;
         // return nullptr;
     }
 
-    auto fragmentSource = globjects::Shader::sourceFromFile("media/simple-rendering.frag");
-    auto fragmentShaderTemplate = globjects::Shader::applyGlobalReplacements(fragmentSource.get());
-    auto fragmentShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_FRAGMENT_SHADER), fragmentShaderTemplate.get());
+    std::cout << "done" << std::endl;
 
-    if (!fragmentShader->compile())
+    std::cout << "[INFO] Compiling occlusion debug fragment shader...";
+
+    auto occlusionDebugFragmentSource = globjects::Shader::sourceFromFile("media/occlusion-debug.frag");
+    auto occlusionDebugFragmentShaderTemplate = globjects::Shader::applyGlobalReplacements(occlusionDebugFragmentSource.get());
+    auto occlusionDebugFragmentShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_FRAGMENT_SHADER), occlusionDebugFragmentShaderTemplate.get());
+
+    if (!occlusionDebugFragmentShader->compile())
     {
-        std::cerr << "[ERROR] Can not compile fragment shader '" << "media/simple-rendering.frag" << "'" << std::endl;
+        std::cerr << "[ERROR] Can not compile fragment shader '" << "media/occlusion-debug.frag" << "'" << std::endl;
         // return nullptr;
     }
 
-    auto simpleProgram = std::make_shared<globjects::Program>();
-    simpleProgram->attach(vertexShader.get(), fragmentShader.get());
+    auto occlusionDebugProgram = std::make_shared<globjects::Program>();
+    occlusionDebugProgram->attach(vertexShader.get(), occlusionDebugFragmentShader.get());
 
-    simpleProgram->link();
+    occlusionDebugProgram->link();
 
-    if (!simpleProgram->isLinked())
+    if (!occlusionDebugProgram->isLinked())
     {
         std::cerr << "Failed to link program" << std::endl;
         // return nullptr;
     }
 
+    std::cout << "done" << std::endl;
+
     auto projectionUniform = simpleProgram->getUniform<glm::mat4>("projection");
     auto viewUniform = simpleProgram->getUniform<glm::mat4>("view");
 
@@ -606,7 +208,7 @@ int main()
 
     std::cout << "[INFO] Convert 3D models to static data..." << std::endl;
 
-    auto staticDrawable = std::make_unique<StaticGeometryDrawable>();
+    auto staticDrawable = std::make_unique<StaticGeometryDrawable>(useBindlessTextures, vertexCompression, meshletCulling, occlusionCulling);
 
     staticDrawable->addScene("inkBottle", inkBottleScene);
     staticDrawable->addScene("lantern", lanternScene);
@@ -629,20 +231,65 @@ int main()
 
     staticDrawable->build();
 
-    // simpleProgram->setUniform("albedoTextures", staticDrawable->albedoTextures->textureHandle().handle());
-    // simpleProgram->setUniform("normalTextures", staticDrawable->normalTextures->textureHandle().handle());
-    // simpleProgram->setUniform("emissionTextures", staticDrawable->emissionTextures->textureHandle().handle());
+    if (!useBindlessTextures)
+    {
+        for (unsigned int i = 0; i < StaticGeometryDrawable::MAX_TEXTURE_BUCKETS; ++i)
+        {
+            simpleProgram->setUniform("textureBuckets[" + std::to_string(i) + "]", static_cast<int>(i));
+        }
+    }
+
+    staticDrawable->bindTextures();
+
+    std::cout << "done" << std::endl;
+
+    // the occlusion culling needs to read the depth back, so the scene goes to a framebuffer and is then blitted to the window
+    std::cout << "[INFO] Initializing scene framebuffer...";
+
+    const auto framebufferSize = glm::ivec2(window.getSize().x, window.getSize().y);
+
+    auto sceneColorTexture = std::make_unique<globjects::Texture>(static_cast<gl::GLenum>(GL_TEXTURE_2D));
+
+    sceneColorTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<gl::GLenum>(GL_NEAREST));
+    sceneColorTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAG_FILTER), static_cast<gl::GLenum>(GL_NEAREST));
+
+    sceneColorTexture->image2D(
+        0,
+        static_cast<gl::GLenum>(GL_RGBA8),
+        framebufferSize,
+        0,
+        static_cast<gl::GLenum>(GL_RGBA),
+        static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
+        nullptr);
+
+    auto sceneDepthTexture = std::make_unique<globjects::Texture>(static_cast<gl::GLenum>(GL_TEXTURE_2D));
+
+    sceneDepthTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<gl::GLenum>(GL_NEAREST));
+    sceneDepthTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAG_FILTER), static_cast<gl::GLenum>(GL_NEAREST));
+
+    sceneDepthTexture->image2D(
+        0,
+        static_cast<gl::GLenum>(GL_DEPTH_COMPONENT32F),
+        framebufferSize,
+        0,
+        static_cast<gl::GLenum>(GL_DEPTH_COMPONENT),
+        static_cast<gl::GLenum>(GL_FLOAT),
+        nullptr);
+
+    auto sceneFramebuffer = std::make_unique<globjects::Framebuffer>();
+    sceneFramebuffer->attachTexture(static_cast<gl::GLenum>(GL_COLOR_ATTACHMENT0), sceneColorTexture.get());
+    sceneFramebuffer->attachTexture(static_cast<gl::GLenum>(GL_DEPTH_ATTACHMENT), sceneDepthTexture.get());
+    sceneFramebuffer->setDrawBuffers({ static_cast<gl::GLenum>(GL_COLOR_ATTACHMENT0) });
 
-    staticDrawable->albedoTextures->bindActive(1);
-    staticDrawable->albedoTextures->bindActive(2);
-    staticDrawable->albedoTextures->bindActive(3);
+    sceneFramebuffer->printStatus(true);
 
-    simpleProgram->setUniform("albedoTextures", 1);
-    simpleProgram->setUniform("normalTextures", 2);
-    simpleProgram->setUniform("emissionTextures", 2);
+    auto depthPyramid = std::make_unique<DepthPyramid>(framebufferSize);
 
     std::cout << "done" << std::endl;
 
+    // F1 toggles drawing the occluded objects as a wireframe on top of the scene
+    bool showOccludedObjects = false;
+
     std::cout << "[INFO] Done initializing" << std::endl;
 
     const float fov = 45.0f;
@@ -680,6 +327,13 @@ int main()
                 window.close();
                 break;
             }
+
+            if (event.type == sf::Event::KeyReleased && event.key.code == sf::Keyboard::F1)
+            {
+                showOccludedObjects = !showOccludedObjects;
+
+                std::cout << "[INFO] Occluded objects are " << (showOccludedObjects ? "shown" : "hidden") << std::endl;
+            }
         }
 
 #ifdef WIN32
@@ -762,6 +416,20 @@ int main()
             cameraPos + cameraForward,
             cameraUp);
 
+        staticDrawable->updateDrawCommands(cameraProjection * cameraView, cameraPos, glm::radians(fov), static_cast<float>(window.getSize().y));
+
+        if (meshletCulling == MeshletCulling::GPU)
+        {
+            staticDrawable->dispatchMeshletCulling(meshletCullingProgram.get());
+        }
+
+        if (occlusionCulling == OcclusionCulling::HZB)
+        {
+            staticDrawable->dispatchOcclusionCulling(occlusionCullingProgram.get(), OcclusionCullingPass::EARLY, cameraView, cameraProjection, depthPyramid.get(), false);
+
+            sceneFramebuffer->bind();
+        }
+
         ::glViewport(0, 0, static_cast<GLsizei>(window.getSize().x), static_cast<GLsizei>(window.getSize().y));
         ::glClearColor(static_cast<gl::GLfloat>(0.3f), static_cast<gl::GLfloat>(0.3f), static_cast<gl::GLfloat>(0.3f), static_cast<gl::GLfloat>(1.0f));
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -771,32 +439,81 @@ int main()
         projectionUniform->set(cameraProjection);
         viewUniform->set(cameraView);
 
-        simpleProgram->use();
+        const auto drawStaticGeometry = [&](globjects::Program* program, globjects::Buffer* drawCommandBuffer, globjects::Buffer* instanceIndexBuffer) {
+            program->use();
+
+            drawCommandBuffer->bind(static_cast<gl::GLenum>(GL_DRAW_INDIRECT_BUFFER));
+            staticDrawable->m_objectDataBuffer->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 4);
+            staticDrawable->m_objectInstanceDataBuffer->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 5);
+            instanceIndexBuffer->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 6);
+
+            staticDrawable->m_vao->bind();
+
+            if (meshletCulling == MeshletCulling::GPU)
+            {
+                // the number of surviving meshlets is only known on the GPU
+                staticDrawable->m_drawCountBuffer->bind(static_cast<gl::GLenum>(GL_PARAMETER_BUFFER));
+
+                ::glMultiDrawElementsIndirectCount(static_cast<gl::GLenum>(GL_TRIANGLES), static_cast<gl::GLenum>(GL_UNSIGNED_INT), nullptr, 0, static_cast<GLsizei>(staticDrawable->getMaxDrawCount()), 0);
+
+                staticDrawable->m_drawCountBuffer->unbind(static_cast<gl::GLenum>(GL_PARAMETER_BUFFER));
+            }
+            else
+            {
+                ::glMultiDrawElementsIndirect(static_cast<gl::GLenum>(GL_TRIANGLES), static_cast<gl::GLenum>(GL_UNSIGNED_INT), nullptr, staticDrawable->m_drawCommands.size(), 0);
+            }
+
+            // staticDrawable->m_vao->multiDrawElementsIndirect(static_cast<gl::GLenum>(GL_TRIANGLES), static_cast<gl::GLenum>(GL_UNSIGNED_INT), 0, staticDrawable->m_drawCommands.size(), 0);
 
-        staticDrawable->m_drawCommandBuffer->bind(static_cast<gl::GLenum>(GL_DRAW_INDIRECT_BUFFER));
-        staticDrawable->m_objectDataBuffer->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 4);
-        staticDrawable->m_objectInstanceDataBuffer->bindBase(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 5);
+            program->release();
 
-        staticDrawable->m_vao->bind();
+            drawCommandBuffer->unbind(static_cast<gl::GLenum>(GL_DRAW_INDIRECT_BUFFER));
+            staticDrawable->m_objectDataBuffer->unbind(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 4);
+            staticDrawable->m_objectInstanceDataBuffer->unbind(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 5);
+            instanceIndexBuffer->unbind(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 6);
 
-        ::glMultiDrawElementsIndirect(static_cast<gl::GLenum>(GL_TRIANGLES), static_cast<gl::GLenum>(GL_UNSIGNED_INT), nullptr, staticDrawable->m_drawCommands.size(), 0);
+            staticDrawable->m_vao->unbind();
+        };
+
+        drawStaticGeometry(simpleProgram.get(), staticDrawable->m_drawCommandBuffer.get(), staticDrawable->m_instanceIndexBuffer.get());
 
-        // staticDrawable->m_vao->multiDrawElementsIndirect(static_cast<gl::GLenum>(GL_TRIANGLES), static_cast<gl::GLenum>(GL_UNSIGNED_INT), 0, staticDrawable->m_drawCommands.size(), 0);
+        if (occlusionCulling == OcclusionCulling::HZB)
+        {
+            sceneFramebuffer->unbind();
 
-        simpleProgram->release();
+            depthPyramid->build(depthPyramidProgram.get(), sceneDepthTexture.get(), framebufferSize);
 
-        staticDrawable->m_drawCommandBuffer->unbind(static_cast<gl::GLenum>(GL_DRAW_INDIRECT_BUFFER));
-        staticDrawable->m_objectDataBuffer->unbind(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 4);
-        staticDrawable->m_objectInstanceDataBuffer->unbind(static_cast<gl::GLenum>(GL_SHADER_STORAGE_BUFFER), 5);
+            staticDrawable->dispatchOcclusionCulling(occlusionCullingProgram.get(), OcclusionCullingPass::LATE, cameraView, cameraProjection, depthPyramid.get(), showOccludedObjects);
 
-        staticDrawable->m_vao->unbind();
+            sceneFramebuffer->bind();
+
+            drawStaticGeometry(simpleProgram.get(), staticDrawable->m_lateDrawCommandBuffer.get(), staticDrawable->m_lateInstanceIndexBuffer.get());
+
+            if (showOccludedObjects)
+            {
+                occlusionDebugProgram->setUniform("projection", cameraProjection);
+                occlusionDebugProgram->setUniform("view", cameraView);
+
+                glDisable(static_cast<gl::GLenum>(GL_DEPTH_TEST));
+                ::glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+
+                drawStaticGeometry(occlusionDebugProgram.get(), staticDrawable->m_culledDrawCommandBuffer.get(), staticDrawable->m_culledInstanceIndexBuffer.get());
+
+                ::glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+                glEnable(static_cast<gl::GLenum>(GL_DEPTH_TEST));
+            }
+
+            sceneFramebuffer->unbind();
+
+            ::glBlitNamedFramebuffer(sceneFramebuffer->id(), 0, 0, 0, framebufferSize.x, framebufferSize.y, 0, 0, framebufferSize.x, framebufferSize.y, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        }
 
         window.display();
+
+        FrameArena::resetAll();
     }
 
-    staticDrawable->albedoTextures->unbindActive(1);
-    staticDrawable->albedoTextures->unbindActive(2);
-    staticDrawable->albedoTextures->unbindActive(3);
+    staticDrawable->unbindTextures();
 
     return 0;
 }
@@ -5,10 +5,17 @@ add_requires("vcpkg::glbinding", { alias = "glbinding" })
 add_requires("assimp")
 
 target("28-multi-draw-indirect")
+  set_languages("cxx20")
   set_kind("binary")
 
+  set_pcxxheader("src/common/stdafx.hpp")
+
+  add_includedirs("src/")
+
   add_packages("sfml", "glm", "globjects", "glbinding", "assimp")
 
+  add_deps("frame-arena")
+
   if is_plat("macosx") then
     -- this prevents "-[SFOpenGLView enableKeyRepeat]: unrecognized selector sent to instance 0x7fa5c2507970" runtime exception
     add_ldflags("-ObjC")
@@ -21,7 +28,7 @@ target("28-multi-draw-indirect")
     add_ldflags("/LTCG")
   end
 
-  add_files("main.cpp")
+  add_files("src/main.cpp", "src/common/MeshOptimizer.cpp", "src/common/MeshSimplifier.cpp", "src/common/MeshletBuilder.cpp")
 
   after_build(function (target)
     os.cp("$(scriptdir)/../media", path.join(path.directory(target:targetfile()), "media"))
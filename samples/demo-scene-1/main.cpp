@@ -1,13 +1,26 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <map>
+#include <optional>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
+#include <glbinding/gl/extension.h>
 #include <glbinding/gl/gl.h>
 
 #include <globjects/Buffer.h>
 #include <globjects/Error.h>
 #include <globjects/Framebuffer.h>
 #include <globjects/Program.h>
+#include <globjects/ProgramBinary.h>
 #include <globjects/Renderbuffer.h>
 #include <globjects/Shader.h>
 #include <globjects/Texture.h>
@@ -38,6 +51,70 @@
 using namespace gl;
 #endif
 
+struct BoundingSphere
+{
+    glm::vec3 center;
+    float radius;
+
+    static BoundingSphere fromPoints(const std::vector<glm::vec3>& points)
+    {
+        if (points.empty())
+        {
+            return { glm::vec3(0.0f), 0.0f };
+        }
+
+        glm::vec3 min = points[0];
+        glm::vec3 max = points[0];
+
+        for (auto& point : points)
+        {
+            min = glm::min(min, point);
+            max = glm::max(max, point);
+        }
+
+        const auto center = (min + max) * 0.5f;
+
+        float radius = 0.0f;
+
+        for (auto& point : points)
+        {
+            radius = std::max(radius, glm::length(point - center));
+        }
+
+        return { center, radius };
+    }
+
+    static BoundingSphere merge(const BoundingSphere& a, const BoundingSphere& b)
+    {
+        const auto distance = glm::length(b.center - a.center);
+
+        if (distance + b.radius <= a.radius)
+        {
+            return a;
+        }
+
+        if (distance + a.radius <= b.radius)
+        {
+            return b;
+        }
+
+        const auto radius = (distance + a.radius + b.radius) * 0.5f;
+
+        return { a.center + (b.center - a.center) * ((radius - a.radius) / distance), radius };
+    }
+
+    BoundingSphere transform(const glm::mat4& transformation) const
+    {
+        // non-uniform scale is accounted for by taking the largest of the three axis scales
+        const auto scale = std::max({
+            glm::length(glm::vec3(transformation[0])),
+            glm::length(glm::vec3(transformation[1])),
+            glm::length(glm::vec3(transformation[2])) });
+
+        return { glm::vec3(transformation * glm::vec4(center, 1.0f)), radius * scale };
+    }
+};
+
 class AbstractDrawable
 {
 public:
@@ -85,7 +162,8 @@ public:
         m_indexBuffer(std::move(indexBuffer)),
         m_normalBuffer(std::move(normalBuffer)),
         m_uvBuffer(std::move(uvBuffer)),
-        m_transformation(1.0f)
+        m_transformation(1.0f),
+        m_boundingSphere(BoundingSphere::fromPoints(m_vertices))
     {
     }
 
@@ -99,6 +177,27 @@ public:
         return m_transformation;
     }
 
+    // bounding sphere in the mesh' local space
+    BoundingSphere getBoundingSphere() const
+    {
+        return m_boundingSphere;
+    }
+
+    globjects::VertexArray* getVertexArray() const
+    {
+        return m_vao.get();
+    }
+
+    const std::vector<globjects::Texture*>& getTextures() const
+    {
+        return m_textures;
+    }
+
+    unsigned int getIndexCount() const
+    {
+        return static_cast<unsigned int>(m_indices.size());
+    }
+
     void draw() override
     {
         // number of values passed = number of elements * number of vertices per element
@@ -156,6 +255,8 @@ protected:
     std::vector<glm::vec2> m_uvs;
 
     glm::mat4 m_transformation;
+
+    BoundingSphere m_boundingSphere;
 };
 
 class AbstractMeshBuilder
@@ -364,6 +465,11 @@ public:
         return m_transformation;
     }
 
+    AbstractMesh* getMesh() const
+    {
+        return m_mesh.get();
+    }
+
 protected:
     std::unique_ptr<AbstractMesh> m_mesh;
     glm::mat4 m_transformation;
@@ -372,8 +478,17 @@ protected:
 class MultiMeshModel : public AbstractDrawable
 {
 public:
-    MultiMeshModel(std::vector<std::unique_ptr<AbstractMesh>> meshes) : m_meshes(std::move(meshes)), m_transformation(1.0f)
+    MultiMeshModel(std::vector<std::unique_ptr<AbstractMesh>> meshes) : m_meshes(std::move(meshes)), m_transformation(1.0f), m_boundingSphere({ glm::vec3(0.0f), 0.0f })
     {
+        if (!m_meshes.empty())
+        {
+            m_boundingSphere = m_meshes[0]->getBoundingSphere();
+        }
+
+        for (auto& mesh : m_meshes)
+        {
+            m_boundingSphere = BoundingSphere::merge(m_boundingSphere, mesh->getBoundingSphere());
+        }
     }
 
     void draw() override
@@ -419,9 +534,21 @@ public:
         return m_transformation;
     }
 
+    // bounding sphere in the model' local space, enclosing all of its meshes
+    BoundingSphere getBoundingSphere() const
+    {
+        return m_boundingSphere;
+    }
+
+    const std::vector<std::unique_ptr<AbstractMesh>>& getMeshes() const
+    {
+        return m_meshes;
+    }
+
 protected:
     std::vector<std::unique_ptr<AbstractMesh>> m_meshes;
     glm::mat4 m_transformation;
+    BoundingSphere m_boundingSphere;
 };
 
 class AssimpModel : public MultiMeshModel
@@ -877,267 +1004,1704 @@ public:
     }
 };
 
-struct alignas(16) PointLightData
+// per-view (main camera, reflection probe face) shader constants; mirrors the FrameConstants block of the shaders in media/ (std140 layout)
+struct alignas(16) FrameConstants
 {
-    glm::vec3 lightPosition;
-    float farPlane;
-    std::array<glm::mat4, 6> projectionViewMatrices;
+    glm::mat4 projection;
+    glm::mat4 view;
+    glm::mat4 projectionView;
+    glm::vec4 cameraPosition;
 };
 
-int main()
+// per-draw shader constants; mirrors the DrawConstants block of the shaders in media/ (std140 layout)
+struct alignas(16) DrawConstants
 {
-    sf::ContextSettings settings;
-    settings.depthBits = 24;
-    settings.stencilBits = 8;
-    settings.antialiasingLevel = 4;
-    settings.majorVersion = 3;
-    settings.minorVersion = 2;
-    settings.attributeFlags = sf::ContextSettings::Attribute::Core;
-
-#ifdef SYSTEM_DARWIN
-    auto videoMode = sf::VideoMode(2048, 1536);
-#else
-    auto videoMode = sf::VideoMode(1024, 768);
-#endif
-
-    sf::Window window(videoMode, "Hello, Demo scene #1!", sf::Style::Default, settings);
+    // the model transformations of the instances drawn are instanceTransforms[firstInstance + gl_InstanceID]
+    std::uint32_t firstInstance;
+};
 
-    globjects::init([](const char* name) {
-        return sf::Context::getFunction(name);
-    });
+// uniform buffer split into per-frame regions; the data for a frame is staged on the CPU and written with as few
+// buffer mappings as possible, while the regions of the previous frames (which the GPU might still be reading) stay intact;
+// a frame which does not fit into its region moves the whole ring into a bigger buffer
+class UniformRingBuffer
+{
+public:
+    static constexpr unsigned int FRAME_CONSTANTS_BINDING = 0;
+    static constexpr unsigned int DRAW_CONSTANTS_BINDING = 1;
 
-    globjects::DebugMessage::enable(); // enable automatic messages if KHR_debug is available
+    // shader storage binding point, separate from the uniform block ones
+    static constexpr unsigned int INSTANCE_TRANSFORMS_BINDING = 0;
 
-    globjects::DebugMessage::setCallback([](const globjects::DebugMessage& message) {
-        std::cout << "[DEBUG] " << message.message() << std::endl;
-    });
+    UniformRingBuffer(std::size_t frameCapacity, unsigned int framesInFlight = 3) :
+        m_framesInFlight(framesInFlight),
+        m_frame(0),
+        m_cursor(0),
+        m_uploadedCursor(0),
+        m_buffer(std::make_unique<globjects::Buffer>()),
+        m_fences(framesInFlight, nullptr),
+        m_retiredBuffers(framesInFlight)
+    {
+        GLint alignment = 0;
+        ::glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
 
-    std::cout << "[INFO] Initializing..." << std::endl;
+        // the blocks are bound as shader storage, too
+        GLint storageAlignment = 0;
+        ::glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
 
-    std::cout << "[INFO] Creating shaders..." << std::endl;
+        m_alignment = std::max<std::size_t>({ static_cast<std::size_t>(alignment), static_cast<std::size_t>(storageAlignment), 16 });
+        m_frameCapacity = align(frameCapacity);
 
-    std::cout << "[INFO] Compiling reflection mapping vertex shader...";
+        m_staging.resize(m_frameCapacity);
 
-    auto reflectionMappingVertexSource = globjects::Shader::sourceFromFile("media/reflection-mapping.vert");
-    auto reflectionMappingVertexShaderTemplate = globjects::Shader::applyGlobalReplacements(reflectionMappingVertexSource.get());
-    auto reflectionMappingVertexShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_VERTEX_SHADER), reflectionMappingVertexShaderTemplate.get());
+        m_buffer->setData(static_cast<gl::GLsizeiptr>(m_frameCapacity * m_framesInFlight), nullptr, static_cast<gl::GLenum>(GL_STREAM_DRAW));
+    }
 
-    if (!reflectionMappingVertexShader->compile())
+    ~UniformRingBuffer()
     {
-        std::cerr << "[ERROR] Can not compile reflection mapping vertex shader" << std::endl;
-        return 1;
+        for (auto& fence : m_fences)
+        {
+            if (fence != nullptr)
+            {
+                ::glDeleteSync(fence);
+            }
+        }
     }
 
-    std::cout << "done" << std::endl;
+    // moves on to the next region, waiting for the GPU to finish reading it if needed
+    void beginFrame()
+    {
+        m_frame = (m_frame + 1) % m_framesInFlight;
+
+        if (m_fences[m_frame] != nullptr)
+        {
+            // one second is way past any sane frame time
+            ::glClientWaitSync(m_fences[m_frame], GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000);
+            ::glDeleteSync(m_fences[m_frame]);
 
-    std::cout << "[INFO] Compiling reflection mapping geometry shader...";
+            m_fences[m_frame] = nullptr;
+        }
 
-    auto reflectionMappingGeometrySource = globjects::Shader::sourceFromFile("media/reflection-mapping.geom");
-    auto reflectionMappingGeometryShaderTemplate = globjects::Shader::applyGlobalReplacements(reflectionMappingGeometrySource.get());
-    auto reflectionMappingGeometryShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_GEOMETRY_SHADER), reflectionMappingGeometryShaderTemplate.get());
+        // the GPU is done with the frame which retired these
+        m_retiredBuffers[m_frame].clear();
 
-    if (!reflectionMappingGeometryShader->compile())
-    {
-        std::cerr << "[ERROR] Can not compile reflection mapping fragment shader" << std::endl;
-        return 1;
+        m_cursor = 0;
+        m_uploadedCursor = 0;
+
+        m_boundOffsets.fill(std::nullopt);
     }
 
-    std::cout << "done" << std::endl;
+    void endFrame()
+    {
+        upload();
 
-    std::cout << "[INFO] Compiling reflection mapping fragment shader...";
+        m_fences[m_frame] = ::glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
 
-    auto reflectionMappingFragmentSource = globjects::Shader::sourceFromFile("media/reflection-mapping.frag");
-    auto reflectionMappingFragmentShaderTemplate = globjects::Shader::applyGlobalReplacements(reflectionMappingFragmentSource.get());
-    auto reflectionMappingFragmentShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_FRAGMENT_SHADER), reflectionMappingFragmentShaderTemplate.get());
+    // stages a block of data for the current frame; returns its offset within the frame region
+    template <typename T>
+    std::size_t push(const T& data)
+    {
+        return push(&data, sizeof(T));
+    }
 
-    if (!reflectionMappingFragmentShader->compile())
+    // makes room for `blockCount` blocks of `size` bytes in total up front, so that pushing them grows the buffer once at most
+    void reserve(std::size_t size, std::size_t blockCount)
     {
-        std::cerr << "[ERROR] Can not compile reflection mapping fragment shader" << std::endl;
-        return 1;
+        // every block may be padded by up to an alignment
+        const auto requiredCapacity = m_cursor + size + blockCount * m_alignment;
+
+        if (requiredCapacity > m_frameCapacity)
+        {
+            grow(requiredCapacity);
+        }
     }
 
-    std::cout << "done" << std::endl;
+    // stages an array as one block, for the shader storage blocks with an unsized array
+    template <typename T>
+    std::size_t pushArray(const std::vector<T>& data)
+    {
+        return push(data.data(), data.size() * sizeof(T));
+    }
 
-    std::cout << "[DEBUG] Linking reflection mapping shaders..." << std::endl;
+    // writes everything staged since the last upload to the buffer, with a single mapping
+    void upload()
+    {
+        if (m_cursor <= m_uploadedCursor)
+        {
+            return;
+        }
 
-    auto reflectionMappingProgram = std::make_unique<globjects::Program>();
-    reflectionMappingProgram->attach(reflectionMappingVertexShader.get(), reflectionMappingGeometryShader.get(), reflectionMappingFragmentShader.get());
+        ::glBindBuffer(GL_UNIFORM_BUFFER, m_buffer->id());
 
-    auto reflectionMappingModelTransformationUniform = reflectionMappingProgram->getUniform<glm::mat4>("modelTransformation");
+        // the range is not used by the GPU (see the fences), hence there is no need for driver to synchronize
+        void* data = ::glMapBufferRange(
+            GL_UNIFORM_BUFFER,
+            static_cast<GLintptr>(regionOffset() + m_uploadedCursor),
+            static_cast<GLsizeiptr>(m_cursor - m_uploadedCursor),
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
 
-    std::cout << "done" << std::endl;
+        if (data == nullptr)
+        {
+            std::cerr << "[ERROR] Can not map uniform ring buffer" << std::endl;
+        }
+        else
+        {
+            std::memcpy(data, m_staging.data() + m_uploadedCursor, m_cursor - m_uploadedCursor);
+            ::glUnmapBuffer(GL_UNIFORM_BUFFER);
+        }
 
-    std::cout << "[INFO] Compiling simple rendering vertex shader...";
+        ::glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
-    auto simpleRenderingVertexSource = globjects::Shader::sourceFromFile("media/simple-rendering.vert");
-    auto simpleRenderingVertexShaderTemplate = globjects::Shader::applyGlobalReplacements(simpleRenderingVertexSource.get());
-    auto simpleRenderingVertexShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_VERTEX_SHADER), simpleRenderingVertexShaderTemplate.get());
+        m_uploadedCursor = m_cursor;
+    }
 
-    if (!simpleRenderingVertexShader->compile())
+    // binds a block previously returned by pushArray() to one of the shader storage binding points
+    void bindStorage(unsigned int binding, std::size_t offset, std::size_t size)
     {
-        std::cerr << "[ERROR] Can not compile simple rendering mapping vertex shader" << std::endl;
-        return 1;
+        ::glBindBufferRange(
+            GL_SHADER_STORAGE_BUFFER,
+            binding,
+            m_buffer->id(),
+            static_cast<GLintptr>(regionOffset() + offset),
+            static_cast<GLsizeiptr>(size));
     }
 
-    std::cout << "done" << std::endl;
+    // binds a block previously returned by push() to one of the uniform block binding points
+    void bind(unsigned int binding, std::size_t offset, std::size_t size)
+    {
+        if (m_boundOffsets[binding] == offset)
+        {
+            return;
+        }
 
-    std::cout << "[INFO] Compiling simple rendering fragment shader...";
+        ::glBindBufferRange(
+            GL_UNIFORM_BUFFER,
+            binding,
+            m_buffer->id(),
+            static_cast<GLintptr>(regionOffset() + offset),
+            static_cast<GLsizeiptr>(size));
 
-    auto simpleRenderingFragmentSource = globjects::Shader::sourceFromFile("media/simple-rendering.frag");
-    auto simpleRenderingFragmentShaderTemplate = globjects::Shader::applyGlobalReplacements(simpleRenderingFragmentSource.get());
-    auto simpleRenderingFragmentShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_FRAGMENT_SHADER), simpleRenderingFragmentShaderTemplate.get());
+        m_boundOffsets[binding] = offset;
+    }
 
-    if (!simpleRenderingFragmentShader->compile())
+protected:
+    std::size_t push(const void* data, std::size_t size)
     {
-        std::cerr << "[ERROR] Can not compile simple rendering fragment shader" << std::endl;
-        return 1;
-    }
+        if (m_cursor + align(size) > m_frameCapacity)
+        {
+            grow(m_cursor + align(size));
+        }
 
-    std::cout << "done" << std::endl;
+        const auto offset = m_cursor;
 
-    std::cout << "[DEBUG] Linking simple rendering shaders..." << std::endl;
+        std::memcpy(m_staging.data() + offset, data, size);
 
-    auto simpleRenderingProgram = std::make_unique<globjects::Program>();
-    simpleRenderingProgram->attach(simpleRenderingVertexShader.get(), simpleRenderingFragmentShader.get());
+        m_cursor += align(size);
 
-    auto simpleRenderingModelTransformationUniform = simpleRenderingProgram->getUniform<glm::mat4>("model");
+        return offset;
+    }
 
-    std::cout << "done" << std::endl;
+    // the blocks pushed earlier in the frame may already be bound for draws which are yet to execute, so the old buffer keeps
+    // them (and stays alive until the GPU is done with the frame), while the new one gets a copy of them for the binds to come
+    void grow(std::size_t requiredCapacity)
+    {
+        upload();
 
-    std::cout << "[INFO] Compiling skybox rendering vertex shader...";
+        m_frameCapacity = align(std::max(m_frameCapacity * 2, requiredCapacity));
 
-    auto skyboxRenderingVertexSource = globjects::Shader::sourceFromFile("media/skybox.vert");
-    auto skyboxRenderingVertexShaderTemplate = globjects::Shader::applyGlobalReplacements(skyboxRenderingVertexSource.get());
-    auto skyboxRenderingVertexShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_VERTEX_SHADER), skyboxRenderingVertexShaderTemplate.get());
+        std::cout << "[INFO] Uniform ring buffer grows to " << m_frameCapacity << " bytes per frame" << std::endl;
 
-    if (!skyboxRenderingVertexShader->compile())
-    {
-        std::cerr << "[ERROR] Can not compile point skybox rendering vertex shader" << std::endl;
-        return 1;
-    }
+        m_retiredBuffers[m_frame].push_back(std::move(m_buffer));
 
-    std::cout << "done" << std::endl;
+        m_buffer = std::make_unique<globjects::Buffer>();
+        m_buffer->setData(static_cast<gl::GLsizeiptr>(m_frameCapacity * m_framesInFlight), nullptr, static_cast<gl::GLenum>(GL_STREAM_DRAW));
 
-    std::cout << "[INFO] Compiling point skybox rendering fragment shader...";
+        m_staging.resize(m_frameCapacity);
 
-    auto skyboxRenderingFragmentSource = globjects::Shader::sourceFromFile("media/skybox.frag");
-    auto skyboxRenderingFragmentShaderTemplate = globjects::Shader::applyGlobalReplacements(skyboxRenderingFragmentSource.get());
-    auto skyboxRenderingFragmentShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_FRAGMENT_SHADER), skyboxRenderingFragmentShaderTemplate.get());
+        // the next upload() writes the whole frame so far into the new buffer
+        m_uploadedCursor = 0;
 
-    if (!skyboxRenderingFragmentShader->compile())
+        m_boundOffsets.fill(std::nullopt);
+    }
+
+    std::size_t align(std::size_t size) const
     {
-        std::cerr << "[ERROR] Can not compile point skybox rendering fragment shader" << std::endl;
-        return 1;
+        return (size + m_alignment - 1) / m_alignment * m_alignment;
     }
 
-    std::cout << "done" << std::endl;
+    std::size_t regionOffset() const
+    {
+        return m_frame * m_frameCapacity;
+    }
 
-    std::cout << "[DEBUG] Linking point skybox rendering shaders..." << std::endl;
+    std::size_t m_alignment;
+    std::size_t m_frameCapacity;
+    unsigned int m_framesInFlight;
+    unsigned int m_frame;
 
-    auto skyboxRenderingProgram = std::make_unique<globjects::Program>();
-    skyboxRenderingProgram->attach(skyboxRenderingVertexShader.get(), skyboxRenderingFragmentShader.get());
+    std::size_t m_cursor;
+    std::size_t m_uploadedCursor;
 
-    auto skyboxRenderingModelTransformationUniform = skyboxRenderingProgram->getUniform<glm::mat4>("modelTransformation");
+    std::vector<std::byte> m_staging;
+    std::unique_ptr<globjects::Buffer> m_buffer;
+    std::vector<GLsync> m_fences;
 
-    std::cout << "done" << std::endl;
+    // buffers replaced by grow(), per frame region; released once that region comes around again
+    std::vector<std::vector<std::unique_ptr<globjects::Buffer>>> m_retiredBuffers;
 
-    std::cout << "[INFO] Compiling reflection rendering vertex shader...";
+    std::array<std::optional<std::size_t>, 2> m_boundOffsets;
+};
 
-    auto reflectionRenderingVertexShaderSource = globjects::Shader::sourceFromFile("media/reflection-rendering.vert");
-    auto reflectionRenderingVertexShaderTemplate = globjects::Shader::applyGlobalReplacements(reflectionRenderingVertexShaderSource.get());
-    auto reflectionRenderingVertexShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_VERTEX_SHADER), reflectionRenderingVertexShaderTemplate.get());
+// shadow copy of the GL state the render queue touches; GL calls are only issued when the state actually changes
+class RenderStateCache
+{
+public:
+    static constexpr unsigned int MAX_TEXTURE_UNITS = 4;
 
-    if (!reflectionRenderingVertexShader->compile())
+    struct Statistics
     {
-        std::cerr << "[ERROR] Can not compile reflection rendering vertex shader" << std::endl;
-        return 1;
+        unsigned int issuedStateChanges;
+        unsigned int skippedStateChanges;
+        unsigned int drawCalls;
+    };
+
+    RenderStateCache() : m_statistics({ 0, 0, 0 })
+    {
+        invalidate();
     }
 
-    std::cout << "done" << std::endl;
+    // forget everything known about the GL state; must be called whenever the state was changed bypassing the cache
+    void invalidate()
+    {
+        m_program = nullptr;
+        m_vertexArray = nullptr;
+        m_textures.fill(std::nullopt);
+        m_cullFaces.reset();
+    }
 
-    std::cout << "[INFO] Compiling reflection rendering fragment shader...";
+    void useProgram(globjects::Program* program)
+    {
+        if (!track(program == m_program))
+        {
+            return;
+        }
 
-    auto reflectionRenderingFragmentShaderSource = globjects::Shader::sourceFromFile("media/reflection-rendering.frag");
-    auto reflectionRenderingFragmentShaderTemplate = globjects::Shader::applyGlobalReplacements(reflectionRenderingFragmentShaderSource.get());
-    auto reflectionRenderingFragmentShader = std::make_unique<globjects::Shader>(static_cast<gl::GLenum>(GL_FRAGMENT_SHADER), reflectionRenderingFragmentShaderTemplate.get());
+        program->use();
+        m_program = program;
+    }
 
-    if (!reflectionRenderingFragmentShader->compile())
+    void bindVertexArray(globjects::VertexArray* vertexArray)
     {
-        std::cerr << "[ERROR] Can not compile reflection rendering fragment shader" << std::endl;
-        return 1;
-    }
+        if (!track(vertexArray == m_vertexArray))
+        {
+            return;
+        }
 
-    std::cout << "done" << std::endl;
+        vertexArray->bind();
+        m_vertexArray = vertexArray;
+    }
 
-    std::cout << "[INFO] Linking reflection rendering shader...";
+    // nullptr unbinds the texture unit
+    void bindTexture(unsigned int unit, globjects::Texture* texture)
+    {
+        if (!track(m_textures[unit].has_value() && *m_textures[unit] == texture))
+        {
+            return;
+        }
 
-    auto reflectionRenderingProgram = std::make_unique<globjects::Program>();
-    reflectionRenderingProgram->attach(reflectionRenderingVertexShader.get(), reflectionRenderingFragmentShader.get());
+        if (texture != nullptr)
+        {
+            texture->bindActive(unit);
+        }
+        else if (m_textures[unit].has_value())
+        {
+            (*m_textures[unit])->unbindActive(unit);
+        }
+        else
+        {
+            // nothing is known about the unit - assume a regular 2D texture is bound
+            ::glActiveTexture(static_cast<::GLenum>(GL_TEXTURE0 + unit));
+            ::glBindTexture(GL_TEXTURE_2D, 0);
+        }
 
-    auto reflectionRenderingModelTransformationUniform = reflectionRenderingProgram->getUniform<glm::mat4>("model");
-    auto reflectionRenderingViewTransformationUniform = reflectionRenderingProgram->getUniform<glm::mat4>("view");
-    auto reflectionRenderingProjectionTransformationUniform = reflectionRenderingProgram->getUniform<glm::mat4>("projection");
+        m_textures[unit] = texture;
+    }
 
-    // auto reflectionRenderingLightColorUniform = reflectionRenderingProgram->getUniform<glm::vec3>("lightColor");
-    auto reflectionRenderingCameraPositionUniform = reflectionRenderingProgram->getUniform<glm::vec3>("cameraPosition");
+    void setCullFaces(bool cullFaces)
+    {
+        if (!track(m_cullFaces.has_value() && *m_cullFaces == cullFaces))
+        {
+            return;
+        }
 
-    std::cout << "done" << std::endl;
+        if (cullFaces)
+        {
+            glEnable(GL_CULL_FACE);
+        }
+        else
+        {
+            glDisable(GL_CULL_FACE);
+        }
 
-    std::cout << "[INFO] Loading 3D model...";
+        m_cullFaces = cullFaces;
+    }
 
-    Assimp::Importer importer;
+    void drawElements(unsigned int indexCount)
+    {
+        // globjects::VertexArray::drawElements() re-binds the VAO on every call, hence the raw call
+        ::glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT, nullptr);
 
-    auto houseScene = importer.ReadFile("media/house1.obj", 0);
+        ++m_statistics.drawCalls;
+    }
 
-    if (!houseScene)
+    void drawElementsInstanced(unsigned int indexCount, unsigned int instanceCount)
     {
-        std::cerr << "failed: " << importer.GetErrorString() << std::endl;
-        return 1;
+        ::glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(instanceCount));
+
+        ++m_statistics.drawCalls;
     }
 
-    auto houseModel = AssimpModel::fromAiNode(houseScene, houseScene->mRootNode, { "media" });
+    // unbinds everything which was bound through the cache, so that the code outside of it finds GL in its default state
+    void reset()
+    {
+        for (unsigned int unit = 0; unit < MAX_TEXTURE_UNITS; ++unit)
+        {
+            if (m_textures[unit].has_value() && *m_textures[unit] != nullptr)
+            {
+                (*m_textures[unit])->unbindActive(unit);
+            }
+        }
 
-    // INFO: this transformation is hard-coded specifically for Chicken.3ds model
-    houseModel->setTransformation(glm::translate(glm::scale(glm::mat4(1.0f), glm::vec3(2.0f)), glm::vec3(0.0f, 0.75f, 0.0f)));
+        if (m_vertexArray != nullptr)
+        {
+            m_vertexArray->unbind();
+        }
 
-    auto tableScene = importer.ReadFile("media/table.obj", 0);
+        if (m_program != nullptr)
+        {
+            m_program->release();
+        }
 
-    if (!tableScene)
-    {
-        std::cerr << "failed: " << importer.GetErrorString() << std::endl;
-        return 1;
+        invalidate();
     }
 
-    auto tableModel = AssimpModel::fromAiNode(tableScene, tableScene->mRootNode, { "media" });
-
-    tableModel->setTransformation(glm::rotate(glm::scale(glm::mat4(1.0f), glm::vec3(1.0f)), glm::radians(-90.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+    Statistics getStatistics() const
+    {
+        return m_statistics;
+    }
 
-    auto lanternScene = importer.ReadFile("media/lantern.obj", 0);
+    void resetStatistics()
+    {
+        m_statistics = { 0, 0, 0 };
+    }
 
-    if (!lanternScene)
+protected:
+    // returns true if the state change has to be issued
+    bool track(bool isRedundant)
     {
-        std::cerr << "failed: " << importer.GetErrorString() << std::endl;
-        return 1;
+        if (isRedundant)
+        {
+            ++m_statistics.skippedStateChanges;
+            return false;
+        }
+
+        ++m_statistics.issuedStateChanges;
+        return true;
     }
 
-    auto lanternModel = AssimpModel::fromAiNode(lanternScene, lanternScene->mRootNode, { "media" });
+    globjects::Program* m_program;
+    globjects::VertexArray* m_vertexArray;
+    // std::nullopt stands for an unknown state
+    std::array<std::optional<globjects::Texture*>, MAX_TEXTURE_UNITS> m_textures;
+    std::optional<bool> m_cullFaces;
 
-    lanternModel->setTransformation(
-        glm::translate(glm::vec3(-1.75f, 3.85f, -0.75f)) *
-        glm::scale(glm::vec3(0.5f))
-    );
+    Statistics m_statistics;
+};
 
-    // TODO: encapsulate position and rotation in model class instead of just exposing transformation
-    // this constant here is taken from ink bottle position
-    glm::vec3 reflectiveModelPosition = glm::vec3(-1.75f, 3.95f, -0.75f);
+// everything, except for the geometry, which is needed to issue a draw call
+struct RenderMaterial
+{
+    globjects::Program* program;
 
-    // TODO: extract this to material class
-    sf::Image lanternEmissionMapImage;
+    // textures bound on top of the mesh' own (diffuse) texture, indexed by the texture unit; the units left empty are unbound
+    std::array<globjects::Texture*, RenderStateCache::MAX_TEXTURE_UNITS> textures = {};
 
-    if (!lanternEmissionMapImage.loadFromFile("media/lantern_emission.png"))
+    bool cullFaces = true;
+};
+
+// collects the draw items of a frame (or a pass), sorts them by a 64-bit key and renders them with as few state changes as possible;
+// the items drawing the same mesh with the same state are merged into a single instanced draw call
+class RenderQueue
+{
+public:
+    // texture unit the meshes bind their own textures to (see AbstractMesh::bind())
+    static constexpr unsigned int MESH_TEXTURE_UNIT = 1;
+
+    struct Statistics
+    {
+        // what the draw calls would have been without the instancing
+        unsigned int submittedDraws;
+        unsigned int drawCalls;
+    };
+
+    RenderQueue() : m_viewPosition(0.0f), m_farPlane(1.0f), m_isInstancingEnabled(true), m_statistics({ 0, 0 })
     {
-        std::cerr << "[ERROR] Can not load texture" << std::endl;
-        return 1;
+    }
+
+    // drops the items of the previous frame; depth in the sort keys is measured from the view position and normalized by the far plane
+    void begin(glm::vec3 viewPosition, float farPlane)
+    {
+        m_viewPosition = viewPosition;
+        m_farPlane = farPlane;
+
+        m_items.clear();
+    }
+
+    void submit(unsigned int pass, const RenderMaterial& material, AbstractMesh* mesh, const glm::mat4& transformation)
+    {
+        const auto center = glm::vec3(transformation * glm::vec4(mesh->getBoundingSphere().center, 1.0f));
+
+        auto textures = material.textures;
+
+        // only the last texture of a mesh ends up being bound by AbstractMesh::bind(), so the same goes here
+        if (textures[MESH_TEXTURE_UNIT] == nullptr && !mesh->getTextures().empty())
+        {
+            textures[MESH_TEXTURE_UNIT] = mesh->getTextures().back();
+        }
+
+        m_items.push_back({
+            .key = makeKey(pass, material.program, textures, material.cullFaces, glm::length(center - m_viewPosition)),
+            .program = material.program,
+            .textures = textures,
+            .cullFaces = material.cullFaces,
+            .mesh = mesh,
+            .transformation = transformation });
+    }
+
+    void submit(unsigned int pass, const RenderMaterial& material, MultiMeshModel* model)
+    {
+        for (auto& mesh : model->getMeshes())
+        {
+            submit(pass, material, mesh.get(), model->getTransformation());
+        }
+    }
+
+    void submit(unsigned int pass, const RenderMaterial& material, SingleMeshModel* model)
+    {
+        submit(pass, material, model->getMesh(), model->getTransformation());
+    }
+
+    // sorts the submitted items, merges them into batches and renders those in order; the items stay in the queue until the next begin()
+    void flush(RenderStateCache& stateCache, UniformRingBuffer& uniformBuffer)
+    {
+        if (m_items.empty())
+        {
+            return;
+        }
+
+        sort();
+        batch();
+
+        // per-draw data goes to the uniform buffer in one go, before any of the draw calls: the transformations of all the
+        // instances as one shader storage block, plus the index of the first instance of every batch
+        const auto instanceTransformsSize = m_instanceTransforms.size() * sizeof(glm::mat4);
+
+        uniformBuffer.reserve(instanceTransformsSize + m_batches.size() * sizeof(DrawConstants), m_batches.size() + 1);
+
+        const auto instanceTransformsOffset = uniformBuffer.pushArray(m_instanceTransforms);
+
+        for (auto& batch : m_batches)
+        {
+            batch.drawConstantsOffset = uniformBuffer.push(DrawConstants { .firstInstance = batch.firstInstance });
+        }
+
+        uniformBuffer.upload();
+
+        uniformBuffer.bindStorage(UniformRingBuffer::INSTANCE_TRANSFORMS_BINDING, instanceTransformsOffset, instanceTransformsSize);
+
+        for (const auto& batch : m_batches)
+        {
+            const auto& item = m_items[batch.item];
+
+            stateCache.useProgram(item.program);
+            stateCache.setCullFaces(item.cullFaces);
+
+            for (unsigned int unit = 0; unit < RenderStateCache::MAX_TEXTURE_UNITS; ++unit)
+            {
+                stateCache.bindTexture(unit, item.textures[unit]);
+            }
+
+            stateCache.bindVertexArray(item.mesh->getVertexArray());
+
+            uniformBuffer.bind(UniformRingBuffer::DRAW_CONSTANTS_BINDING, batch.drawConstantsOffset, sizeof(DrawConstants));
+
+            if (batch.instanceCount == 1)
+            {
+                stateCache.drawElements(item.mesh->getIndexCount());
+            }
+            else
+            {
+                stateCache.drawElementsInstanced(item.mesh->getIndexCount(), batch.instanceCount);
+            }
+        }
+
+        m_statistics.submittedDraws += static_cast<unsigned int>(m_items.size());
+        m_statistics.drawCalls += static_cast<unsigned int>(m_batches.size());
+    }
+
+    // with the instancing disabled every item is drawn with a draw call of its own, for comparison
+    void setInstancingEnabled(bool isEnabled)
+    {
+        m_isInstancingEnabled = isEnabled;
+    }
+
+    bool isInstancingEnabled() const
+    {
+        return m_isInstancingEnabled;
+    }
+
+    Statistics getStatistics() const
+    {
+        return m_statistics;
+    }
+
+    void resetStatistics()
+    {
+        m_statistics = { 0, 0 };
+    }
+
+    std::size_t size() const
+    {
+        return m_items.size();
+    }
+
+protected:
+    struct RenderItem
+    {
+        std::uint64_t key;
+
+        globjects::Program* program;
+        std::array<globjects::Texture*, RenderStateCache::MAX_TEXTURE_UNITS> textures;
+        bool cullFaces;
+
+        AbstractMesh* mesh;
+        glm::mat4 transformation;
+    };
+
+    struct SortEntry
+    {
+        std::uint64_t key;
+        std::uint32_t index;
+    };
+
+    // items drawn with a single draw call
+    struct Batch
+    {
+        // the first item of the batch, which the state and the mesh are taken from
+        std::uint32_t item;
+        std::uint32_t firstInstance;
+        std::uint32_t instanceCount;
+        std::size_t drawConstantsOffset;
+    };
+
+    // key layout, from the most significant bits: pass (4 bits), program (12 bits), material (16 bits), cull state (1 bit), depth (24 bits);
+    // the lowest 7 bits are unused
+    std::uint64_t makeKey(unsigned int pass, globjects::Program* program, const std::array<globjects::Texture*, RenderStateCache::MAX_TEXTURE_UNITS>& textures, bool cullFaces, float depth)
+    {
+        // ids are handed out in the order programs and materials are first seen and are kept between frames
+        const auto programId = m_programIds.try_emplace(program, static_cast<std::uint64_t>(m_programIds.size())).first->second;
+        const auto materialId = m_materialIds.try_emplace(textures, static_cast<std::uint64_t>(m_materialIds.size())).first->second;
+
+        // front-to-back within the same state, so that early depth test rejects the most fragments
+        const auto quantizedDepth = static_cast<std::uint64_t>(std::clamp(depth / m_farPlane, 0.0f, 1.0f) * static_cast<float>(0xFFFFFF));
+
+        return (static_cast<std::uint64_t>(pass & 0xF) << 60) |
+            ((programId & 0xFFF) << 48) |
+            ((materialId & 0xFFFF) << 32) |
+            (static_cast<std::uint64_t>(cullFaces ? 1 : 0) << 31) |
+            (quantizedDepth << 7);
+    }
+
+    // groups the sorted items into batches and lays out their transformations, batch after batch. Only the items with the same
+    // state (all the bits of the key but the depth) and the same mesh are merged; a batch takes the place of its nearest item and
+    // its instances stay front-to-back
+    void batch()
+    {
+        m_batches.clear();
+        m_itemBatches.resize(m_sortedEntries.size());
+        m_instanceTransforms.resize(m_sortedEntries.size());
+
+        std::uint32_t instanceCount = 0;
+
+        for (std::size_t runBegin = 0; runBegin < m_sortedEntries.size();)
+        {
+            const auto state = m_sortedEntries[runBegin].key >> 31;
+
+            auto runEnd = runBegin + 1;
+
+            while (runEnd < m_sortedEntries.size() && (m_sortedEntries[runEnd].key >> 31) == state)
+            {
+                ++runEnd;
+            }
+
+            const auto firstBatch = m_batches.size();
+
+            m_meshBatches.clear();
+
+            for (auto i = runBegin; i < runEnd; ++i)
+            {
+                const auto itemIndex = m_sortedEntries[i].index;
+
+                auto batchIndex = m_batches.size();
+
+                if (m_isInstancingEnabled)
+                {
+                    batchIndex = m_meshBatches.try_emplace(m_items[itemIndex].mesh, batchIndex).first->second;
+                }
+
+                if (batchIndex == m_batches.size())
+                {
+                    m_batches.push_back({ .item = itemIndex, .firstInstance = 0, .instanceCount = 0, .drawConstantsOffset = 0 });
+                }
+
+                ++m_batches[batchIndex].instanceCount;
+
+                m_itemBatches[i] = batchIndex;
+            }
+
+            // the instance counts become the write cursors for the transformations
+            for (auto batchIndex = firstBatch; batchIndex < m_batches.size(); ++batchIndex)
+            {
+                m_batches[batchIndex].firstInstance = instanceCount;
+                instanceCount += m_batches[batchIndex].instanceCount;
+                m_batches[batchIndex].instanceCount = 0;
+            }
+
+            for (auto i = runBegin; i < runEnd; ++i)
+            {
+                auto& batch = m_batches[m_itemBatches[i]];
+
+                m_instanceTransforms[batch.firstInstance + batch.instanceCount++] = m_items[m_sortedEntries[i].index].transformation;
+            }
+
+            runBegin = runEnd;
+        }
+    }
+
+    // LSD radix sort, one byte per pass; bytes shared by all the keys (most of them, usually) are skipped entirely
+    void sort()
+    {
+        m_sortedEntries.resize(m_items.size());
+        m_scratchEntries.resize(m_items.size());
+
+        for (std::uint32_t i = 0; i < m_items.size(); ++i)
+        {
+            m_sortedEntries[i] = { m_items[i].key, i };
+        }
+
+        if (m_sortedEntries.size() < 2)
+        {
+            return;
+        }
+
+        for (unsigned int shift = 0; shift < 64; shift += 8)
+        {
+            std::array<std::size_t, 256> offsets {};
+
+            for (auto& entry : m_sortedEntries)
+            {
+                ++offsets[(entry.key >> shift) & 0xFF];
+            }
+
+            if (offsets[(m_sortedEntries[0].key >> shift) & 0xFF] == m_sortedEntries.size())
+            {
+                continue;
+            }
+
+            std::size_t offset = 0;
+
+            for (auto& count : offsets)
+            {
+                const auto bucketSize = count;
+                count = offset;
+                offset += bucketSize;
+            }
+
+            for (auto& entry : m_sortedEntries)
+            {
+                m_scratchEntries[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+            }
+
+            std::swap(m_sortedEntries, m_scratchEntries);
+        }
+    }
+
+    glm::vec3 m_viewPosition;
+    float m_farPlane;
+
+    std::vector<RenderItem> m_items;
+    std::vector<SortEntry> m_sortedEntries;
+    std::vector<SortEntry> m_scratchEntries;
+
+    bool m_isInstancingEnabled;
+
+    std::vector<Batch> m_batches;
+    // batch of every sorted item
+    std::vector<std::size_t> m_itemBatches;
+    std::vector<glm::mat4> m_instanceTransforms;
+    std::unordered_map<AbstractMesh*, std::size_t> m_meshBatches;
+
+    Statistics m_statistics;
+
+    std::unordered_map<globjects::Program*, std::uint64_t> m_programIds;
+    std::map<std::array<globjects::Texture*, RenderStateCache::MAX_TEXTURE_UNITS>, std::uint64_t> m_materialIds;
+};
+
+class ReflectionProbe
+{
+public:
+    ReflectionProbe(glm::vec3 position, float nearPlane, float farPlane, unsigned int maxResolution = 2048, unsigned int minResolution = 256) :
+        m_position(position),
+        m_nearPlane(nearPlane),
+        m_farPlane(farPlane),
+        m_maxResolution(maxResolution),
+        m_minResolution(minResolution),
+        m_resolution(0),
+        m_facesPerFrame(2),
+        m_resolutionFalloffDistance(farPlane),
+        m_nextFace(0),
+        m_texture(std::make_unique<globjects::Texture>(static_cast<gl::GLenum>(GL_TEXTURE_CUBE_MAP))),
+        m_depthRenderbuffer(std::make_unique<globjects::Renderbuffer>())
+    {
+        m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<gl::GLenum>(GL_LINEAR));
+        m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAG_FILTER), static_cast<gl::GLenum>(GL_LINEAR));
+
+        m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_S), static_cast<gl::GLenum>(GL_CLAMP_TO_EDGE));
+        m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_T), static_cast<gl::GLenum>(GL_CLAMP_TO_EDGE));
+        m_texture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_R), static_cast<gl::GLenum>(GL_CLAMP_TO_EDGE));
+
+        for (auto& framebuffer : m_framebuffers)
+        {
+            framebuffer = std::make_unique<globjects::Framebuffer>();
+        }
+
+        m_dirtyFaces.fill(true);
+
+        updateFaceMatrices();
+
+        // no storage until the first update(): it takes the resize path, at the resolution the camera distance calls for,
+        // and fills all six faces at once
+    }
+
+    // casters are only referenced - the probe does not own the models
+    void addCaster(MultiMeshModel* model, bool cullFaces = true)
+    {
+        m_casters.push_back({
+            .model = model,
+            .cullFaces = cullFaces,
+            .transformation = model->getTransformation(),
+            .worldBoundingSphere = model->getBoundingSphere().transform(model->getTransformation()) });
+
+        markDirty(m_casters.back().worldBoundingSphere);
+    }
+
+    void setPosition(glm::vec3 position)
+    {
+        if (position == m_position)
+        {
+            return;
+        }
+
+        m_position = position;
+
+        updateFaceMatrices();
+        invalidate();
+    }
+
+    glm::vec3 getPosition() const
+    {
+        return m_position;
+    }
+
+    // how many cubemap faces are allowed to be re-rendered within a single update() call (2 by default);
+    // an update() which changes the resolution renders all six regardless
+    void setFacesPerFrame(unsigned int facesPerFrame)
+    {
+        m_facesPerFrame = std::clamp(facesPerFrame, 1u, 6u);
+    }
+
+    // the probe renders at full resolution while the camera is closer than this distance;
+    // every time the distance doubles, the resolution is halved (down to the minimal resolution)
+    void setResolutionFalloffDistance(float distance)
+    {
+        m_resolutionFalloffDistance = distance;
+    }
+
+    void invalidate()
+    {
+        m_dirtyFaces.fill(true);
+    }
+
+    bool isDirty() const
+    {
+        return std::any_of(m_dirtyFaces.begin(), m_dirtyFaces.end(), [](bool dirty) { return dirty; });
+    }
+
+    unsigned int getResolution() const
+    {
+        return m_resolution;
+    }
+
+    globjects::Texture* getTexture() const
+    {
+        return m_texture.get();
+    }
+
+    // the queue the faces are rendered with
+    RenderQueue& getRenderQueue()
+    {
+        return m_renderQueue;
+    }
+
+    // re-renders (some of) the faces affected by the changes since the last update;
+    // returns the number of faces actually rendered this call
+    unsigned int update(glm::vec3 cameraPosition, globjects::Program* program, RenderStateCache& stateCache, UniformRingBuffer& uniformBuffer)
+    {
+        const auto resolution = selectResolution(cameraPosition);
+
+        // resizing throws away the contents of all the faces, so all of them have to be rendered this very frame
+        const auto isResized = resolution != m_resolution;
+
+        if (isResized)
+        {
+            resize(resolution);
+            invalidate();
+        }
+
+        detectChanges();
+
+        if (!isDirty())
+        {
+            return 0;
+        }
+
+        glEnable(GL_DEPTH_TEST);
+        glCullFace(GL_BACK);
+
+        ::glViewport(0, 0, m_resolution, m_resolution);
+        ::glClearColor(static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(1.0f));
+
+        const auto maxFaces = isResized ? 6u : m_facesPerFrame;
+
+        unsigned int renderedFaces = 0;
+
+        for (unsigned int i = 0; i < 6 && renderedFaces < maxFaces; ++i)
+        {
+            const auto face = (m_nextFace + i) % 6;
+
+            if (!m_dirtyFaces[face])
+            {
+                continue;
+            }
+
+            renderFace(face, program, stateCache, uniformBuffer);
+
+            m_dirtyFaces[face] = false;
+            ++renderedFaces;
+        }
+
+        // continue from where we stopped next frame, so that all the faces get their turn
+        m_nextFace = (m_nextFace + renderedFaces) % 6;
+
+        return renderedFaces;
+    }
+
+protected:
+    struct Caster
+    {
+        MultiMeshModel* model;
+        bool cullFaces;
+        glm::mat4 transformation;
+        BoundingSphere worldBoundingSphere;
+    };
+
+    void renderFace(unsigned int face, globjects::Program* program, RenderStateCache& stateCache, UniformRingBuffer& uniformBuffer)
+    {
+        m_framebuffers[face]->bind();
+
+        ::glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        const auto frameConstantsOffset = uniformBuffer.push(FrameConstants {
+            .projection = m_projection,
+            .view = m_viewMatrices[face],
+            .projectionView = m_projectionViewMatrices[face],
+            .cameraPosition = glm::vec4(m_position, 1.0f) });
+
+        uniformBuffer.bind(UniformRingBuffer::FRAME_CONSTANTS_BINDING, frameConstantsOffset, sizeof(FrameConstants));
+
+        m_renderQueue.begin(m_position, m_farPlane);
+
+        for (auto& caster : m_casters)
+        {
+            // per-face culling instead of amplifying every triangle six times in the geometry shader
+            if (!isVisible(face, caster.worldBoundingSphere))
+            {
+                continue;
+            }
+
+            // some models (like the scroll, which is a modified plane) need culling to be disabled
+            m_renderQueue.submit(0, { .program = program, .cullFaces = caster.cullFaces }, caster.model);
+        }
+
+        m_renderQueue.flush(stateCache, uniformBuffer);
+
+        m_framebuffers[face]->unbind();
+    }
+
+    void detectChanges()
+    {
+        for (auto& caster : m_casters)
+        {
+            const auto transformation = caster.model->getTransformation();
+
+            if (transformation == caster.transformation)
+            {
+                continue;
+            }
+
+            // both the old and the new position of an object need to be re-rendered
+            markDirty(caster.worldBoundingSphere);
+
+            caster.transformation = transformation;
+            caster.worldBoundingSphere = caster.model->getBoundingSphere().transform(transformation);
+
+            markDirty(caster.worldBoundingSphere);
+        }
+    }
+
+    void markDirty(const BoundingSphere& sphere)
+    {
+        for (unsigned int face = 0; face < 6; ++face)
+        {
+            if (isVisible(face, sphere))
+            {
+                m_dirtyFaces[face] = true;
+            }
+        }
+    }
+
+    bool isVisible(unsigned int face, const BoundingSphere& sphere) const
+    {
+        for (auto& plane : m_frustumPlanes[face])
+        {
+            if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    unsigned int selectResolution(glm::vec3 cameraPosition) const
+    {
+        const auto distance = glm::length(cameraPosition - m_position);
+
+        auto resolution = m_maxResolution;
+
+        for (auto threshold = m_resolutionFalloffDistance; distance > threshold && resolution > m_minResolution; threshold *= 2.0f)
+        {
+            resolution /= 2;
+        }
+
+        return std::max(resolution, m_minResolution);
+    }
+
+    void resize(unsigned int resolution)
+    {
+        m_resolution = resolution;
+
+        m_texture->bind();
+
+        for (auto i = 0; i < 6; ++i)
+        {
+            ::glTexImage2D(
+                static_cast<::GLenum>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i),
+                0,
+                GL_RGBA8,
+                m_resolution,
+                m_resolution,
+                0,
+                GL_RGBA,
+                GL_UNSIGNED_BYTE,
+                nullptr);
+        }
+
+        m_texture->unbind();
+
+        // faces are rendered one at a time, so they all can share one depth buffer
+        m_depthRenderbuffer->storage(static_cast<gl::GLenum>(GL_DEPTH_COMPONENT24), m_resolution, m_resolution);
+
+        for (auto i = 0; i < 6; ++i)
+        {
+            m_framebuffers[i]->bind();
+
+            ::glFramebufferTexture2D(
+                GL_FRAMEBUFFER,
+                GL_COLOR_ATTACHMENT0,
+                static_cast<::GLenum>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i),
+                m_texture->id(),
+                0);
+
+            m_framebuffers[i]->attachRenderBuffer(static_cast<gl::GLenum>(GL_DEPTH_ATTACHMENT), m_depthRenderbuffer.get());
+            m_framebuffers[i]->setDrawBuffer(static_cast<gl::GLenum>(GL_COLOR_ATTACHMENT0));
+
+            m_framebuffers[i]->unbind();
+        }
+    }
+
+    void updateFaceMatrices()
+    {
+        // this is a cubemap, hence aspect ratio **must** be 1:1
+        m_projection = glm::perspective(glm::radians(90.0f), 1.0f, m_nearPlane, m_farPlane);
+
+        const std::array<std::pair<glm::vec3, glm::vec3>, 6> directions {
+            std::make_pair(glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)),
+            std::make_pair(glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)),
+            std::make_pair(glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)),
+            std::make_pair(glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f)),
+            std::make_pair(glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, -1.0f, 0.0f)),
+            std::make_pair(glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, -1.0f, 0.0f)),
+        };
+
+        for (auto face = 0; face < 6; ++face)
+        {
+            const auto& [direction, up] = directions[face];
+
+            m_viewMatrices[face] = glm::lookAt(m_position, m_position + direction, up);
+            m_projectionViewMatrices[face] = m_projection * m_viewMatrices[face];
+
+            // extract the frustum planes from the projection-view matrix (Gribb-Hartmann)
+            const auto m = glm::transpose(m_projectionViewMatrices[face]);
+
+            m_frustumPlanes[face] = {
+                m[3] + m[0],
+                m[3] - m[0],
+                m[3] + m[1],
+                m[3] - m[1],
+                m[3] + m[2],
+                m[3] - m[2],
+            };
+
+            for (auto& plane : m_frustumPlanes[face])
+            {
+                plane /= glm::length(glm::vec3(plane));
+            }
+        }
+    }
+
+    glm::vec3 m_position;
+    float m_nearPlane;
+    float m_farPlane;
+
+    unsigned int m_maxResolution;
+    unsigned int m_minResolution;
+    unsigned int m_resolution;
+    unsigned int m_facesPerFrame;
+    float m_resolutionFalloffDistance;
+    unsigned int m_nextFace;
+
+    std::vector<Caster> m_casters;
+
+    RenderQueue m_renderQueue;
+
+    std::array<bool, 6> m_dirtyFaces;
+    glm::mat4 m_projection;
+    std::array<glm::mat4, 6> m_viewMatrices;
+    std::array<glm::mat4, 6> m_projectionViewMatrices;
+    std::array<std::array<glm::vec4, 6>, 6> m_frustumPlanes;
+
+    std::unique_ptr<globjects::Texture> m_texture;
+    std::unique_ptr<globjects::Renderbuffer> m_depthRenderbuffer;
+    std::array<std::unique_ptr<globjects::Framebuffer>, 6> m_framebuffers;
+};
+
+class ProgramCache
+{
+public:
+    ProgramCache(std::filesystem::path cacheDirectory) :
+        m_cacheDirectory(std::move(cacheDirectory)),
+        m_isBinarySupported(false)
+    {
+        const auto driverString = [](GLenum name) {
+            const auto* value = ::glGetString(name);
+
+            return value ? std::string(reinterpret_cast<const char*>(value)) : std::string();
+        };
+
+        // binaries are only valid for the exact driver that produced them
+        m_driverIdentifier = driverString(GL_VENDOR) + "\n" + driverString(GL_RENDERER) + "\n" + driverString(GL_VERSION);
+
+        GLint binaryFormatCount = 0;
+        ::glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+
+        m_isBinarySupported = binaryFormatCount > 0;
+
+        std::error_code error;
+        std::filesystem::create_directories(m_cacheDirectory, error);
+
+        if (error)
+        {
+            std::cerr << "[ERROR] Can not create program cache directory " << m_cacheDirectory << ": " << error.message() << std::endl;
+            m_isBinarySupported = false;
+        }
+    }
+
+    bool isBinarySupported() const
+    {
+        return m_isBinarySupported;
+    }
+
+    std::uint64_t hash(const std::vector<std::pair<gl::GLenum, std::string>>& sources) const
+    {
+        std::uint64_t hash = fnv1a(m_driverIdentifier, FNV_OFFSET_BASIS);
+
+        for (const auto& [type, source] : sources)
+        {
+            hash = fnv1a(std::to_string(static_cast<unsigned int>(type)), hash);
+            hash = fnv1a(source, hash);
+        }
+
+        return hash;
+    }
+
+    std::unique_ptr<globjects::Program> load(std::uint64_t key)
+    {
+        if (!m_isBinarySupported)
+        {
+            return nullptr;
+        }
+
+        const auto binaryPath = getBinaryPath(key);
+
+        std::ifstream file(binaryPath, std::ios::binary);
+
+        if (!file)
+        {
+            return nullptr;
+        }
+
+        std::uint32_t format = 0;
+        file.read(reinterpret_cast<char*>(&format), sizeof(format));
+
+        std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        file.close();
+
+        if (data.empty())
+        {
+            return nullptr;
+        }
+
+        auto program = createFromBinary(static_cast<gl::GLenum>(format), data);
+
+        if (!program)
+        {
+            // some drivers reject binaries after an update without changing the version string
+            std::cout << "[INFO] Cached program binary " << binaryPath << " was rejected, recompiling" << std::endl;
+
+            std::error_code error;
+            std::filesystem::remove(binaryPath, error);
+        }
+
+        return program;
+    }
+
+    void store(std::uint64_t key, gl::GLenum format, const std::vector<unsigned char>& data)
+    {
+        if (!m_isBinarySupported || data.empty())
+        {
+            return;
+        }
+
+        const auto binaryPath = getBinaryPath(key);
+
+        // write to a temporary file first, so an interrupted write never leaves a truncated binary behind
+        auto temporaryPath = binaryPath;
+        temporaryPath += ".tmp";
+
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+
+            const auto binaryFormat = static_cast<std::uint32_t>(format);
+
+            file.write(reinterpret_cast<const char*>(&binaryFormat), sizeof(binaryFormat));
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+            if (!file)
+            {
+                std::cerr << "[ERROR] Can not write program binary " << temporaryPath << std::endl;
+                return;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporaryPath, binaryPath, error);
+    }
+
+    static std::unique_ptr<globjects::Program> createFromBinary(gl::GLenum format, const std::vector<unsigned char>& data)
+    {
+        auto program = std::make_unique<globjects::Program>();
+        program->setBinary(globjects::ProgramBinary::create(format, data));
+        program->link();
+
+        if (!program->isLinked())
+        {
+            return nullptr;
+        }
+
+        return program;
+    }
+
+private:
+    static constexpr std::uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ull;
+    static constexpr std::uint64_t FNV_PRIME = 0x100000001b3ull;
+
+    static std::uint64_t fnv1a(const std::string& data, std::uint64_t hash)
+    {
+        for (auto c : data)
+        {
+            hash ^= static_cast<std::uint8_t>(c);
+            hash *= FNV_PRIME;
+        }
+
+        // separator, so that {"ab", "c"} and {"a", "bc"} do not collide
+        hash ^= 0xff;
+        hash *= FNV_PRIME;
+
+        return hash;
+    }
+
+    std::filesystem::path getBinaryPath(std::uint64_t key) const
+    {
+        std::ostringstream fileName;
+        fileName << std::hex << key << ".bin";
+
+        return m_cacheDirectory / fileName.str();
+    }
+
+    std::filesystem::path m_cacheDirectory;
+    std::string m_driverIdentifier;
+    bool m_isBinarySupported;
+};
+
+/**
+ * Kicks off all the compiles and links up front and lets the driver run them on its own threads
+ * (GL_KHR_parallel_shader_compile), so the total stall is close to the longest single program rather than the sum of all of them.
+ *
+ * Programs are compiled through raw GL handles, since globjects queries the compile and link status right away, which
+ * blocks until the driver is done. Once linked, the binary is handed over to a globjects::Program (and to the on-disk cache).
+ */
+class AsyncProgramBuilder
+{
+public:
+    struct ShaderFile
+    {
+        gl::GLenum type;
+        std::filesystem::path path;
+    };
+
+    AsyncProgramBuilder(ProgramCache& cache) :
+        m_cache(cache),
+        m_isParallelCompileSupported(globjects::hasExtension(gl::GLextension::GL_KHR_parallel_shader_compile))
+    {
+        if (m_isParallelCompileSupported)
+        {
+            // let the driver pick the number of compiler threads
+            ::glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        }
+    }
+
+    ~AsyncProgramBuilder()
+    {
+        for (auto& pending : m_pending)
+        {
+            deleteObjects(pending);
+            pending.promise.set_value(nullptr);
+        }
+    }
+
+    std::shared_future<globjects::Program*> build(const std::string& name, const std::vector<ShaderFile>& shaderFiles)
+    {
+        std::vector<std::pair<gl::GLenum, std::string>> sources;
+
+        for (const auto& shaderFile : shaderFiles)
+        {
+            auto source = globjects::Shader::sourceFromFile(shaderFile.path.string());
+            auto shaderTemplate = globjects::Shader::applyGlobalReplacements(source.get());
+
+            sources.emplace_back(shaderFile.type, shaderTemplate->string());
+        }
+
+        PendingProgram pending {
+            .name = name,
+            .key = m_cache.hash(sources),
+            .sources = sources
+        };
+
+        auto future = pending.promise.get_future().share();
+
+        auto cachedProgram = m_cache.load(pending.key);
+
+        if (cachedProgram)
+        {
+            std::cout << "[INFO] Loaded " << name << " program from cache" << std::endl;
+
+            pending.promise.set_value(cachedProgram.get());
+            m_programs.push_back(std::move(cachedProgram));
+
+            return future;
+        }
+
+        if (!m_cache.isBinarySupported())
+        {
+            // there is no way to hand a raw program over to globjects without a binary, so fall back to the blocking path
+            pending.promise.set_value(compileSynchronously(name, sources));
+
+            return future;
+        }
+
+        std::cout << "[INFO] Compiling " << name << " program in background" << std::endl;
+
+        pending.program = ::glCreateProgram();
+
+        for (const auto& [type, source] : sources)
+        {
+            const auto shader = ::glCreateShader(type);
+            const auto* sourceString = source.c_str();
+
+            ::glShaderSource(shader, 1, &sourceString, nullptr);
+            ::glCompileShader(shader);
+            ::glAttachShader(pending.program, shader);
+
+            pending.shaders.push_back(shader);
+        }
+
+        ::glProgramParameteri(pending.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+        // no need to wait for the compiles - the link is queued behind them
+        ::glLinkProgram(pending.program);
+
+        m_pending.push_back(std::move(pending));
+
+        return future;
+    }
+
+    // never blocks when GL_KHR_parallel_shader_compile is available
+    void poll()
+    {
+        for (auto it = m_pending.begin(); it != m_pending.end();)
+        {
+            if (m_isParallelCompileSupported)
+            {
+                GLint isComplete = 0;
+                ::glGetProgramiv(it->program, GL_COMPLETION_STATUS_KHR, &isComplete);
+
+                if (!isComplete)
+                {
+                    ++it;
+                    continue;
+                }
+            }
+
+            it->promise.set_value(finish(*it));
+            it = m_pending.erase(it);
+
+            // without the extension every status query blocks, so only finish one program per call
+            if (!m_isParallelCompileSupported)
+            {
+                break;
+            }
+        }
+    }
+
+    bool isIdle() const
+    {
+        return m_pending.empty();
+    }
+
+private:
+    struct PendingProgram
+    {
+        std::string name;
+        std::uint64_t key;
+        // kept for the fallback in finish()
+        std::vector<std::pair<gl::GLenum, std::string>> sources;
+        GLuint program = 0;
+        std::vector<GLuint> shaders;
+        std::promise<globjects::Program*> promise;
+    };
+
+    globjects::Program* finish(PendingProgram& pending)
+    {
+        GLint isLinked = 0;
+        ::glGetProgramiv(pending.program, GL_LINK_STATUS, &isLinked);
+
+        if (!isLinked)
+        {
+            for (auto shader : pending.shaders)
+            {
+                GLint isCompiled = 0;
+                ::glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
+
+                if (!isCompiled)
+                {
+                    std::cerr << "[ERROR] Can not compile " << pending.name << " shader: " << getShaderInfoLog(shader) << std::endl;
+                }
+            }
+
+            std::cerr << "[ERROR] Can not link " << pending.name << " program: " << getProgramInfoLog(pending.program) << std::endl;
+
+            deleteObjects(pending);
+
+            return nullptr;
+        }
+
+        GLint binaryLength = 0;
+        ::glGetProgramiv(pending.program, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+
+        std::vector<unsigned char> binary(static_cast<std::size_t>(std::max(binaryLength, 0)));
+        GLenum binaryFormat = 0;
+
+        if (!binary.empty())
+        {
+            ::glGetProgramBinary(pending.program, binaryLength, nullptr, &binaryFormat, binary.data());
+        }
+
+        deleteObjects(pending);
+
+        auto program = binary.empty() ? nullptr : ProgramCache::createFromBinary(static_cast<gl::GLenum>(binaryFormat), binary);
+
+        if (!program)
+        {
+            // the program did link, the driver just would not hand it over as a binary - recompile it through globjects
+            // (the raw program can not be wrapped into a globjects::Program) and keep it out of the cache
+            std::cout << "[INFO] No usable binary of " << pending.name << " program, falling back to blocking compile" << std::endl;
+
+            return compileSynchronously(pending.name, pending.sources);
+        }
+
+        m_cache.store(pending.key, static_cast<gl::GLenum>(binaryFormat), binary);
+
+        std::cout << "[INFO] Compiled " << pending.name << " program" << std::endl;
+
+        m_programs.push_back(std::move(program));
+
+        return m_programs.back().get();
+    }
+
+    globjects::Program* compileSynchronously(const std::string& name, const std::vector<std::pair<gl::GLenum, std::string>>& sources)
+    {
+        std::cout << "[INFO] Compiling " << name << " program...";
+
+        auto program = std::make_unique<globjects::Program>();
+
+        for (const auto& [type, source] : sources)
+        {
+            auto shaderSource = globjects::Shader::sourceFromString(source);
+            auto shader = std::make_unique<globjects::Shader>(type, shaderSource.get());
+
+            if (!shader->compile())
+            {
+                std::cerr << "[ERROR] Can not compile " << name << " shader" << std::endl;
+                return nullptr;
+            }
+
+            program->attach(shader.get());
+
+            m_sources.push_back(std::move(shaderSource));
+            m_shaders.push_back(std::move(shader));
+        }
+
+        program->link();
+
+        if (!program->isLinked())
+        {
+            std::cerr << "[ERROR] Can not link " << name << " program" << std::endl;
+            return nullptr;
+        }
+
+        std::cout << "done" << std::endl;
+
+        m_programs.push_back(std::move(program));
+
+        return m_programs.back().get();
+    }
+
+    static std::string getShaderInfoLog(GLuint shader)
+    {
+        GLint length = 0;
+        ::glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+
+        std::string log(static_cast<std::size_t>(std::max(length, 1)), '\0');
+        ::glGetShaderInfoLog(shader, static_cast<GLsizei>(log.size()), nullptr, log.data());
+
+        return log;
+    }
+
+    static std::string getProgramInfoLog(GLuint program)
+    {
+        GLint length = 0;
+        ::glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+
+        std::string log(static_cast<std::size_t>(std::max(length, 1)), '\0');
+        ::glGetProgramInfoLog(program, static_cast<GLsizei>(log.size()), nullptr, log.data());
+
+        return log;
+    }
+
+    static void deleteObjects(PendingProgram& pending)
+    {
+        for (auto shader : pending.shaders)
+        {
+            ::glDeleteShader(shader);
+        }
+
+        ::glDeleteProgram(pending.program);
+
+        pending.shaders.clear();
+        pending.program = 0;
+    }
+
+    ProgramCache& m_cache;
+    bool m_isParallelCompileSupported;
+
+    std::vector<PendingProgram> m_pending;
+    std::vector<std::unique_ptr<globjects::Program>> m_programs;
+
+    // the blocking path keeps the globjects shaders around, since they only reference their sources
+    std::vector<std::unique_ptr<globjects::AbstractStringSource>> m_sources;
+    std::vector<std::unique_ptr<globjects::Shader>> m_shaders;
+};
+
+struct alignas(16) PointLightData
+{
+    glm::vec3 lightPosition;
+    float farPlane;
+    std::array<glm::mat4, 6> projectionViewMatrices;
+};
+
+int main()
+{
+    sf::ContextSettings settings;
+    settings.depthBits = 24;
+    settings.stencilBits = 8;
+    settings.antialiasingLevel = 4;
+    settings.majorVersion = 3;
+    settings.minorVersion = 2;
+    settings.attributeFlags = sf::ContextSettings::Attribute::Core;
+
+#ifdef SYSTEM_DARWIN
+    auto videoMode = sf::VideoMode(2048, 1536);
+#else
+    auto videoMode = sf::VideoMode(1024, 768);
+#endif
+
+    sf::Window window(videoMode, "Hello, Demo scene #1!", sf::Style::Default, settings);
+
+    globjects::init([](const char* name) {
+        return sf::Context::getFunction(name);
+    });
+
+    globjects::DebugMessage::enable(); // enable automatic messages if KHR_debug is available
+
+    globjects::DebugMessage::setCallback([](const globjects::DebugMessage& message) {
+        std::cout << "[DEBUG] " << message.message() << std::endl;
+    });
+
+    std::cout << "[INFO] Initializing..." << std::endl;
+
+    std::cout << "[INFO] Creating shaders..." << std::endl;
+
+    ProgramCache programCache("shader-cache");
+    AsyncProgramBuilder programBuilder(programCache);
+
+    // all the programs are compiled in background while the models and textures are loaded
+    auto reflectionMappingProgramFuture = programBuilder.build("reflection mapping", {
+        { static_cast<gl::GLenum>(GL_VERTEX_SHADER), "media/reflection-mapping.vert" },
+        { static_cast<gl::GLenum>(GL_FRAGMENT_SHADER), "media/reflection-mapping.frag" }
+    });
+
+    auto simpleRenderingProgramFuture = programBuilder.build("simple rendering", {
+        { static_cast<gl::GLenum>(GL_VERTEX_SHADER), "media/simple-rendering.vert" },
+        { static_cast<gl::GLenum>(GL_FRAGMENT_SHADER), "media/simple-rendering.frag" }
+    });
+
+    auto skyboxRenderingProgramFuture = programBuilder.build("skybox rendering", {
+        { static_cast<gl::GLenum>(GL_VERTEX_SHADER), "media/skybox.vert" },
+        { static_cast<gl::GLenum>(GL_FRAGMENT_SHADER), "media/skybox.frag" }
+    });
+
+    auto reflectionRenderingProgramFuture = programBuilder.build("reflection rendering", {
+        { static_cast<gl::GLenum>(GL_VERTEX_SHADER), "media/reflection-rendering.vert" },
+        { static_cast<gl::GLenum>(GL_FRAGMENT_SHADER), "media/reflection-rendering.frag" }
+    });
+
+    std::cout << "[INFO] Loading 3D model...";
+
+    Assimp::Importer importer;
+
+    auto houseScene = importer.ReadFile("media/house1.obj", 0);
+
+    if (!houseScene)
+    {
+        std::cerr << "failed: " << importer.GetErrorString() << std::endl;
+        return 1;
+    }
+
+    auto houseModel = AssimpModel::fromAiNode(houseScene, houseScene->mRootNode, { "media" });
+
+    // INFO: this transformation is hard-coded specifically for Chicken.3ds model
+    houseModel->setTransformation(glm::translate(glm::scale(glm::mat4(1.0f), glm::vec3(2.0f)), glm::vec3(0.0f, 0.75f, 0.0f)));
+
+    auto tableScene = importer.ReadFile("media/table.obj", 0);
+
+    if (!tableScene)
+    {
+        std::cerr << "failed: " << importer.GetErrorString() << std::endl;
+        return 1;
+    }
+
+    auto tableModel = AssimpModel::fromAiNode(tableScene, tableScene->mRootNode, { "media" });
+
+    tableModel->setTransformation(glm::rotate(glm::scale(glm::mat4(1.0f), glm::vec3(1.0f)), glm::radians(-90.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+
+    auto lanternScene = importer.ReadFile("media/lantern.obj", 0);
+
+    if (!lanternScene)
+    {
+        std::cerr << "failed: " << importer.GetErrorString() << std::endl;
+        return 1;
+    }
+
+    auto lanternModel = AssimpModel::fromAiNode(lanternScene, lanternScene->mRootNode, { "media" });
+
+    lanternModel->setTransformation(
+        glm::translate(glm::vec3(-1.75f, 3.85f, -0.75f)) *
+        glm::scale(glm::vec3(0.5f))
+    );
+
+    // TODO: encapsulate position and rotation in model class instead of just exposing transformation
+    // this constant here is taken from ink bottle position
+    glm::vec3 reflectiveModelPosition = glm::vec3(-1.75f, 3.95f, -0.75f);
+
+    // TODO: extract this to material class
+    sf::Image lanternEmissionMapImage;
+
+    if (!lanternEmissionMapImage.loadFromFile("media/lantern_emission.png"))
+    {
+        std::cerr << "[ERROR] Can not load texture" << std::endl;
+        return 1;
     }
 
     lanternEmissionMapImage.flipVertically();
@@ -1230,94 +2794,123 @@ int main()
 
     std::cout << "[DEBUG] Initializing framebuffers...";
 
-    std::cout << "[DEBUG] Initializing reflectionMapTexture...";
+    /*auto skybox = Skybox::fromCubemap(reflectionMapTexture.get())
+        ->size(40.0f)
+        ->build();*/
+
+    auto skybox = Skybox::builder()
+        ->top("media/skybox-top.png")
+        ->bottom("media/skybox-bottom.png")
+        ->left("media/skybox-left.png")
+        ->right("media/skybox-right.png")
+        ->front("media/skybox-front.png")
+        ->back("media/skybox-back.png")
+        ->size(40.0f)
+        ->build();
+
+    std::cout << "done" << std::endl;
 
-    auto reflectionMapTexture = std::make_unique<globjects::Texture>(static_cast<gl::GLenum>(GL_TEXTURE_CUBE_MAP));
+    std::cout << "[DEBUG] Initializing reflection probe...";
 
-    reflectionMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<gl::GLenum>(GL_LINEAR));
-    reflectionMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAG_FILTER), static_cast<gl::GLenum>(GL_LINEAR));
+    // TODO: technically, this offset should be calculated as AABB / 2
+    auto reflectionProbe = std::make_unique<ReflectionProbe>(reflectiveModelPosition + glm::vec3(0.0f, 0.05f, 0.0f), 0.1f, 10.0f, 2048, 256);
 
-    reflectionMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_S), static_cast<gl::GLenum>(GL_CLAMP_TO_BORDER));
-    reflectionMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_T), static_cast<gl::GLenum>(GL_CLAMP_TO_BORDER));
-    reflectionMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_R), static_cast<gl::GLenum>(GL_CLAMP_TO_BORDER));
+    reflectionProbe->addCaster(houseModel.get());
+    reflectionProbe->addCaster(tableModel.get());
+    reflectionProbe->addCaster(inkBottleModel.get());
+    // scroll model needs culling to be disabled since this is a modified plane, so...
+    reflectionProbe->addCaster(scrollModel.get(), false);
+    reflectionProbe->addCaster(penModel.get());
 
-    reflectionMapTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_BORDER_COLOR), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
+    // spread the refresh over several frames - two faces per frame
+    reflectionProbe->setFacesPerFrame(2);
 
-    reflectionMapTexture->bind();
+    std::cout << "done" << std::endl;
 
-    const auto reflectionMapSize = 2048;
+    std::cout << "[INFO] Waiting for shaders...";
 
-    for (auto i = 0; i < 6; ++i)
+    // keep the window responsive with a plain loading screen until the driver is done with the programs
+    while (!programBuilder.isIdle())
     {
-        ::glTexImage2D(
-            static_cast<::GLenum>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i),
-            0,
-            GL_RGBA8,
-            reflectionMapSize,
-            reflectionMapSize,
-            0,
-            GL_RGBA,
-            GL_UNSIGNED_INT,
-            nullptr);
-    }
-
-    reflectionMapTexture->unbind();
+        programBuilder.poll();
 
-    auto reflectionMapDepthTexture = std::make_unique<globjects::Texture>(static_cast<gl::GLenum>(GL_TEXTURE_CUBE_MAP));
+        sf::Event event{};
 
-    reflectionMapDepthTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MIN_FILTER), static_cast<gl::GLenum>(GL_LINEAR));
-    reflectionMapDepthTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_MAG_FILTER), static_cast<gl::GLenum>(GL_LINEAR));
+        while (window.pollEvent(event))
+        {
+            if (event.type == sf::Event::Closed)
+            {
+                return 0;
+            }
+        }
 
-    reflectionMapDepthTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_S), static_cast<gl::GLenum>(GL_CLAMP_TO_BORDER));
-    reflectionMapDepthTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_T), static_cast<gl::GLenum>(GL_CLAMP_TO_BORDER));
-    reflectionMapDepthTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_WRAP_R), static_cast<gl::GLenum>(GL_CLAMP_TO_BORDER));
+        ::glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        ::glClear(GL_COLOR_BUFFER_BIT);
 
-    reflectionMapDepthTexture->setParameter(static_cast<gl::GLenum>(GL_TEXTURE_BORDER_COLOR), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+        window.display();
+    }
 
-    reflectionMapDepthTexture->bind();
+    auto reflectionMappingProgram = reflectionMappingProgramFuture.get();
+    auto simpleRenderingProgram = simpleRenderingProgramFuture.get();
+    auto skyboxRenderingProgram = skyboxRenderingProgramFuture.get();
+    auto reflectionRenderingProgram = reflectionRenderingProgramFuture.get();
 
-    for (auto i = 0; i < 6; ++i)
+    if (!reflectionMappingProgram || !simpleRenderingProgram || !skyboxRenderingProgram || !reflectionRenderingProgram)
     {
-        ::glTexImage2D(
-            static_cast<::GLenum>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i),
-            0,
-            GL_DEPTH_COMPONENT,
-            reflectionMapSize,
-            reflectionMapSize,
-            0,
-            GL_DEPTH_COMPONENT,
-            GL_FLOAT,
-            nullptr);
+        return 1;
     }
 
-    reflectionMapDepthTexture->unbind();
+    std::cout << "done" << std::endl;
 
-    /*auto skybox = Skybox::fromCubemap(reflectionMapTexture.get())
-        ->size(40.0f)
-        ->build();*/
+    std::cout << "[DEBUG] Initializing render queue...";
 
-    auto skybox = Skybox::builder()
-        ->top("media/skybox-top.png")
-        ->bottom("media/skybox-bottom.png")
-        ->left("media/skybox-left.png")
-        ->right("media/skybox-right.png")
-        ->front("media/skybox-front.png")
-        ->back("media/skybox-back.png")
-        ->size(40.0f)
-        ->build();
+    // passes are rendered in the order of their indices
+    const unsigned int SKYBOX_PASS = 0;
+    const unsigned int REFLECTIVE_PASS = 1;
+    const unsigned int OPAQUE_PASS = 2;
 
-    std::cout << "done" << std::endl;
+    // matrices and camera position are shared by all the programs through the uniform blocks (see UniformRingBuffer),
+    // so the only plain uniforms left are the samplers
+    reflectionMappingProgram->setUniform("diffuseTexture", 1);
+
+    skyboxRenderingProgram->setUniform("cubeMap", 0);
+
+    reflectionRenderingProgram->setUniform("reflectionMap", 0);
+    reflectionRenderingProgram->setUniform("diffuseTexture", 1);
+    reflectionRenderingProgram->setUniform("reflectionMapTexture", 2);
+
+    simpleRenderingProgram->setUniform("diffuseTexture", 1);
+
+    RenderMaterial skyboxMaterial {
+        .program = skyboxRenderingProgram,
+        .textures = { reflectionProbe->getTexture(), nullptr, nullptr, nullptr },
+        .cullFaces = false
+    };
+
+#ifdef _DEBUG
+    // show the skybox' own texture instead of the reflection map
+    skyboxRenderingProgram->setUniform("cubeMap", 1);
+    skyboxMaterial.textures[0] = nullptr;
+#endif
 
-    std::cout << "[DEBUG] Initializing reflection mapping frame buffer...";
+    RenderMaterial reflectiveMaterial {
+        .program = reflectionRenderingProgram,
+        .textures = { reflectionProbe->getTexture(), nullptr, lanternEmissionMapTexture.get(), nullptr }
+    };
 
-    auto reflectionMappingFramebuffer = std::make_unique<globjects::Framebuffer>();
-    reflectionMappingFramebuffer->attachTexture(static_cast<gl::GLenum>(GL_COLOR_ATTACHMENT0), reflectionMapTexture.get());
-    reflectionMappingFramebuffer->attachTexture(static_cast<gl::GLenum>(GL_DEPTH_ATTACHMENT), reflectionMapDepthTexture.get());
+    RenderMaterial opaqueMaterial {
+        .program = simpleRenderingProgram
+    };
 
-    // tell framebuffer it actually needs to render to **BOTH** textures, but does not have to output anywhere (last NONE argument, iirc)
-    reflectionMappingFramebuffer->setDrawBuffers({ static_cast<gl::GLenum>(GL_COLOR_ATTACHMENT0), static_cast<gl::GLenum>(GL_NONE) });
+    // scroll model needs culling to be disabled since this is a modified plane
+    RenderMaterial unculledOpaqueMaterial = opaqueMaterial;
+    unculledOpaqueMaterial.cullFaces = false;
 
-    reflectionMappingFramebuffer->printStatus(true);
+    RenderQueue renderQueue;
+    RenderStateCache renderStateCache;
+
+    // a handful of views (main camera and up to six cubemap faces), a few dozen draws and their instance transformations per frame
+    UniformRingBuffer uniformBuffer(128 * 1024);
 
     std::cout << "done" << std::endl;
 
@@ -1355,6 +2948,22 @@ int main()
                 window.close();
                 break;
             }
+
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::I)
+            {
+                const auto isInstancingEnabled = !renderQueue.isInstancingEnabled();
+
+                renderQueue.setInstancingEnabled(isInstancingEnabled);
+                reflectionProbe->getRenderQueue().setInstancingEnabled(isInstancingEnabled);
+
+                // the numbers of the last frame, rendered with the previous setting
+                const auto mainStatistics = renderQueue.getStatistics();
+                const auto probeStatistics = reflectionProbe->getRenderQueue().getStatistics();
+
+                std::cout << "[INFO] Instancing " << (isInstancingEnabled ? "enabled" : "disabled")
+                    << "; last frame: " << (mainStatistics.submittedDraws + probeStatistics.submittedDraws) << " draws submitted, "
+                    << (mainStatistics.drawCalls + probeStatistics.drawCalls) << " draw calls issued" << std::endl;
+            }
         }
 
 #ifdef WIN32
@@ -1437,79 +3046,15 @@ int main()
             cameraPos + cameraForward,
             cameraUp);
 
-        const float nearPlane = 0.1f;
-        const float farPlane = 10.0f;
-
-        // this is a cubemap, hence aspect ratio **must** be 1:1
-        glm::mat4 reflectionProjection = glm::perspective(glm::radians(90.0f), 1.0f, nearPlane, farPlane);
-
-        // TODO: technically, this should be calculated as AABB / 2
-        const auto reflectionOffset = glm::vec3(0.0f, 0.05f, 0.0f);
-
-        reflectionMappingProgram->setUniform("projectionViewMatrices[0]", reflectionProjection * glm::lookAt(reflectiveModelPosition + reflectionOffset, reflectiveModelPosition + glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)));
-        reflectionMappingProgram->setUniform("projectionViewMatrices[1]", reflectionProjection * glm::lookAt(reflectiveModelPosition + reflectionOffset, reflectiveModelPosition + glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)));
-        reflectionMappingProgram->setUniform("projectionViewMatrices[2]", reflectionProjection * glm::lookAt(reflectiveModelPosition + reflectionOffset, reflectiveModelPosition + glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
-        reflectionMappingProgram->setUniform("projectionViewMatrices[3]", reflectionProjection * glm::lookAt(reflectiveModelPosition + reflectionOffset, reflectiveModelPosition + glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f)));
-        reflectionMappingProgram->setUniform("projectionViewMatrices[4]", reflectionProjection * glm::lookAt(reflectiveModelPosition + reflectionOffset, reflectiveModelPosition + glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, -1.0f, 0.0f)));
-        reflectionMappingProgram->setUniform("projectionViewMatrices[5]", reflectionProjection * glm::lookAt(reflectiveModelPosition + reflectionOffset, reflectiveModelPosition + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, -1.0f, 0.0f)));
-
-        // first render pass - shadow mapping
-        reflectionMappingFramebuffer->bind();
-
-        ::glViewport(0, 0, reflectionMapSize, reflectionMapSize);
-        ::glClearColor(static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(1.0f));
-        ::glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_CULL_FACE);
-
-        // cull front faces to prevent peter panning the generated shadow map
-        glCullFace(GL_BACK);
-
-        reflectionMappingProgram->use();
-
-        reflectionMappingProgram->setUniform("diffuseTexture", 1);
-
-        reflectionMappingModelTransformationUniform->set(houseModel->getTransformation());
-
-        houseModel->bind();
-        houseModel->draw();
-        houseModel->unbind();
-
-        reflectionMappingModelTransformationUniform->set(tableModel->getTransformation());
+        renderStateCache.resetStatistics();
+        renderQueue.resetStatistics();
+        reflectionProbe->getRenderQueue().resetStatistics();
 
-        tableModel->bind();
-        tableModel->draw();
-        tableModel->unbind();
+        uniformBuffer.beginFrame();
 
-        reflectionMappingModelTransformationUniform->set(inkBottleModel->getTransformation());
+        // first render pass - reflection mapping; only re-renders the cubemap faces affected by the changes in the scene
+        reflectionProbe->update(cameraPos, reflectionMappingProgram, renderStateCache, uniformBuffer);
 
-        inkBottleModel->bind();
-        inkBottleModel->draw();
-        inkBottleModel->unbind();
-
-        reflectionMappingModelTransformationUniform->set(scrollModel->getTransformation());
-
-        // scroll model needs culling to be disabled since this is a modified plane, so...
-        glDisable(GL_CULL_FACE);
-
-        scrollModel->bind();
-        scrollModel->draw();
-        scrollModel->unbind();
-
-        glEnable(GL_CULL_FACE);
-
-        reflectionMappingModelTransformationUniform->set(penModel->getTransformation());
-
-        penModel->bind();
-        penModel->draw();
-        penModel->unbind();
-
-        reflectionMappingFramebuffer->unbind();
-
-        reflectionMappingProgram->release();
-
-        glEnable(GL_CULL_FACE);
         glCullFace(GL_BACK);
 
         // second pass - switch to normal shader and render picture with depth information to the viewport
@@ -1520,99 +3065,39 @@ int main()
 
         glEnable(static_cast<gl::GLenum>(GL_DEPTH_TEST));
         glDepthFunc(GL_LEQUAL);
-        glDisable(GL_CULL_FACE);
-
-        skyboxRenderingProgram->use();
-        skyboxRenderingProgram->setUniform("projection", cameraProjection);
-        skyboxRenderingProgram->setUniform("view", glm::mat4(glm::mat3(cameraView)));
 
-#ifndef _DEBUG
-        reflectionMapTexture->bindActive(0);
-        skyboxRenderingProgram->setUniform("cubeMap", 0);
-#else
-        skyboxRenderingProgram->setUniform("cubeMap", 1);
-#endif
+        // per-view constants, shared by all the programs; per-draw ones are written by the render queue
+        const auto frameConstantsOffset = uniformBuffer.push(FrameConstants {
+            .projection = cameraProjection,
+            .view = cameraView,
+            .projectionView = cameraProjection * cameraView,
+            .cameraPosition = glm::vec4(cameraPos, 1.0f) });
 
-        skybox->bind();
-        skybox->draw();
-        skybox->unbind();
+        uniformBuffer.bind(UniformRingBuffer::FRAME_CONSTANTS_BINDING, frameConstantsOffset, sizeof(FrameConstants));
 
-        reflectionMapTexture->unbindActive(0);
+        renderQueue.begin(cameraPos, 100.0f);
 
-        skyboxRenderingProgram->release();
+        renderQueue.submit(SKYBOX_PASS, skyboxMaterial, skybox.get());
 
         // render object with reflective material
-
-        reflectionRenderingProgram->use();
-
-        reflectionRenderingProgram->setUniform("projection", cameraProjection);
-        reflectionRenderingProgram->setUniform("view", cameraView);
-        reflectionRenderingProgram->setUniform("model", lanternModel->getTransformation());
-
-        reflectionRenderingProgram->setUniform("cameraPosition", cameraPos);
-
-        reflectionMapTexture->bindActive(0);
-        lanternEmissionMapTexture->bindActive(2);
-
-        reflectionRenderingProgram->setUniform("reflectionMap", 0);
-        reflectionRenderingProgram->setUniform("diffuseTexture", 1);
-        reflectionRenderingProgram->setUniform("reflectionMapTexture", 2);
-
-        lanternModel->bind();
-        lanternModel->draw();
-        lanternModel->unbind();
-
-        reflectionMapTexture->unbindActive(0);
-        lanternEmissionMapTexture->unbindActive(2);
-
-        reflectionRenderingProgram->release();
+        renderQueue.submit(REFLECTIVE_PASS, reflectiveMaterial, lanternModel.get());
 
         // draw the scene
-
-        simpleRenderingProgram->use();
-
-        simpleRenderingProgram->setUniform("projection", cameraProjection);
-        simpleRenderingProgram->setUniform("view", cameraView);
-
-        simpleRenderingProgram->setUniform("diffuseTexture", 1);
-
-        simpleRenderingModelTransformationUniform->set(houseModel->getTransformation());
-
 #ifdef _DEBUG
-        houseModel->bind();
-        houseModel->draw();
-        houseModel->unbind();
+        renderQueue.submit(OPAQUE_PASS, opaqueMaterial, houseModel.get());
 #endif
 
-        simpleRenderingModelTransformationUniform->set(tableModel->getTransformation());
-
-        tableModel->bind();
-        tableModel->draw();
-        tableModel->unbind();
-
-        simpleRenderingModelTransformationUniform->set(inkBottleModel->getTransformation());
-
-        inkBottleModel->bind();
-        inkBottleModel->draw();
-        inkBottleModel->unbind();
-
-        simpleRenderingModelTransformationUniform->set(penModel->getTransformation());
-
-        penModel->bind();
-        penModel->draw();
-        penModel->unbind();
-
-        simpleRenderingModelTransformationUniform->set(scrollModel->getTransformation());
-
-        glDisable(GL_CULL_FACE);
+        renderQueue.submit(OPAQUE_PASS, opaqueMaterial, tableModel.get());
+        renderQueue.submit(OPAQUE_PASS, opaqueMaterial, inkBottleModel.get());
+        renderQueue.submit(OPAQUE_PASS, opaqueMaterial, penModel.get());
+        renderQueue.submit(OPAQUE_PASS, unculledOpaqueMaterial, scrollModel.get());
 
-        scrollModel->bind();
-        scrollModel->draw();
-        scrollModel->unbind();
+        renderQueue.flush(renderStateCache, uniformBuffer);
 
-        glEnable(GL_CULL_FACE);
+        // hand the GL state over to the next frame in its default form
+        renderStateCache.reset();
 
-        simpleRenderingProgram->release();
+        uniformBuffer.endFrame();
 
         // done rendering the frame
 
@@ -6,7 +6,6 @@ layout (location = 2) in vec2 vertexTextureCoords;
 
 out VS_OUT
 {
-    vec4 vertexPosition;
     vec3 fragmentPosition;
     vec3 normal;
     vec2 textureCoords;
@@ -16,14 +15,37 @@ out gl_PerVertex {
     vec4 gl_Position;
 };
 
-uniform mat4 modelTransformation;
+// per-view constants, shared by all the programs (see FrameConstants in main.cpp);
+// here these are the ones of the cubemap face currently being rendered
+layout (std140, binding = 0) uniform FrameConstants
+{
+    mat4 projection;
+    mat4 view;
+    mat4 projectionView;
+    vec4 cameraPosition;
+} frameConstants;
+
+// per-draw constants (see DrawConstants in main.cpp)
+layout (std140, binding = 1) uniform DrawConstants
+{
+    uint firstInstance;
+} drawConstants;
+
+// model transformations of all the instances drawn by the render queue
+layout (std430, binding = 0) readonly buffer InstanceTransforms
+{
+    mat4 transforms[];
+} instanceTransforms;
 
 void main()
 {
-    vsOut.vertexPosition = modelTransformation * vec4(vertexPosition, 1.0);
-    vsOut.fragmentPosition = vec3(modelTransformation * vec4(vertexPosition, 1.0));
+    mat4 model = instanceTransforms.transforms[drawConstants.firstInstance + gl_InstanceID];
+
+    vec4 worldPosition = model * vec4(vertexPosition, 1.0);
+
+    vsOut.fragmentPosition = vec3(worldPosition);
     vsOut.normal = vertexNormal;
     vsOut.textureCoords = vertexTextureCoords;
 
-    gl_Position = vsOut.vertexPosition;
+    gl_Position = frameConstants.projectionView * worldPosition;
 }
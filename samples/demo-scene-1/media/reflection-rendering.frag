@@ -13,13 +13,19 @@ uniform samplerCube reflectionMap;
 uniform sampler2D reflectionMapTexture;
 uniform sampler2D diffuseTexture;
 
-uniform vec3 cameraPosition;
+// per-view constants, shared by all the programs (see FrameConstants in main.cpp)
+layout (std140, binding = 0) uniform FrameConstants
+{
+    mat4 projection;
+    mat4 view;
+    mat4 projectionView;
+    vec4 cameraPosition;
+} frameConstants;
 
-uniform mat4 model;
 
 void main()
 {
-    vec3 reflectedDirection = reflect(normalize(fsIn.fragmentPosition - cameraPosition), fsIn.normal);
+    vec3 reflectedDirection = reflect(normalize(fsIn.fragmentPosition - vec3(frameConstants.cameraPosition)), fsIn.normal);
     vec4 reflectionColor = texture(reflectionMap, reflectedDirection);
 
     vec4 albedoColor = texture(diffuseTexture, fsIn.textureCoords);
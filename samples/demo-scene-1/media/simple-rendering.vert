@@ -1,4 +1,4 @@
-#version 410
+#version 430
 
 layout (location = 0) in vec3 vertexPosition;
 layout (location = 1) in vec3 vertexNormal;
@@ -15,15 +15,36 @@ out gl_PerVertex {
     vec4 gl_Position;
 };
 
-uniform mat4 projection;
-uniform mat4 view;
-uniform mat4 model;
+// per-view constants, shared by all the programs (see FrameConstants in main.cpp)
+layout (std140, binding = 0) uniform FrameConstants
+{
+    mat4 projection;
+    mat4 view;
+    mat4 projectionView;
+    vec4 cameraPosition;
+} frameConstants;
+
+// per-draw constants (see DrawConstants in main.cpp)
+layout (std140, binding = 1) uniform DrawConstants
+{
+    uint firstInstance;
+} drawConstants;
+
+// model transformations of all the instances drawn by the render queue
+layout (std430, binding = 0) readonly buffer InstanceTransforms
+{
+    mat4 transforms[];
+} instanceTransforms;
 
 void main()
 {
-    vsOut.fragmentPosition = vec3(model * vec4(vertexPosition, 1.0));
+    mat4 model = instanceTransforms.transforms[drawConstants.firstInstance + gl_InstanceID];
+
+    vec4 worldPosition = model * vec4(vertexPosition, 1.0);
+
+    vsOut.fragmentPosition = vec3(worldPosition);
     vsOut.normal = vertexNormal;
     vsOut.textureCoord = vertexTextureCoord;
 
-    gl_Position = projection * view * model * vec4(vertexPosition, 1.0);
+    gl_Position = frameConstants.projectionView * worldPosition;
 }
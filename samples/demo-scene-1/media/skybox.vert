@@ -1,4 +1,4 @@
-#version 410
+#version 430
 
 layout (location = 0) in vec3 vertexPosition;
 layout (location = 1) in vec3 vertexNormal;
@@ -13,12 +13,20 @@ out gl_PerVertex {
     vec4 gl_Position;
 };
 
-uniform mat4 projection;
-uniform mat4 view;
+// per-view constants, shared by all the programs (see FrameConstants in main.cpp)
+layout (std140, binding = 0) uniform FrameConstants
+{
+    mat4 projection;
+    mat4 view;
+    mat4 projectionView;
+    vec4 cameraPosition;
+} frameConstants;
+
 
 void main()
 {
-    vec4 pos = projection * view * vec4(vertexPosition, 1.0);
+    // skybox follows the camera, so only the rotation part of the view matrix is used
+    vec4 pos = frameConstants.projection * mat4(mat3(frameConstants.view)) * vec4(vertexPosition, 1.0);
     gl_Position = pos.xyww;
     vsOut.textureCoords = vertexPosition;
 }
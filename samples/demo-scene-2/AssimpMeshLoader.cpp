@@ -2,17 +2,19 @@
 
 AssimpModelLoader::AssimpModelLoader() {}
 
-std::unique_ptr<MultiMeshModel> AssimpModelLoader::fromAiNode(const aiScene* scene, aiNode* node, std::vector<std::filesystem::path> materialLookupPaths)
+std::unique_ptr<MultiMeshModel> AssimpModelLoader::fromAiNode(const aiScene* scene, aiNode* node, std::vector<std::filesystem::path> materialLookupPaths, GeometryArena* geometryArena)
 {
     std::vector<std::unique_ptr<AbstractMesh>> meshes;
 
-    processAiNode(scene, node, materialLookupPaths, meshes);
+    processAiNode(scene, node, materialLookupPaths, geometryArena, meshes);
 
     return std::make_unique<MultiMeshModel>(std::move(meshes));
 }
 
-std::unique_ptr<MultiMeshModel> AssimpModelLoader::fromFile(std::string filename, std::vector<std::filesystem::path> materialLookupPaths, unsigned int assimpImportFlags)
+std::unique_ptr<MultiMeshModel> AssimpModelLoader::fromFile(std::string filename, std::vector<std::filesystem::path> materialLookupPaths, unsigned int assimpImportFlags, GeometryArena* geometryArena)
 {
+    PROFILE_FUNCTION();
+
     static auto importer = std::make_unique<Assimp::Importer>();
     auto scene = importer->ReadFile(filename, assimpImportFlags);
 
@@ -22,16 +24,56 @@ std::unique_ptr<MultiMeshModel> AssimpModelLoader::fromFile(std::string filename
         return nullptr;
     }
 
-    auto model = fromAiNode(scene, scene->mRootNode, materialLookupPaths);
+    auto model = fromAiNode(scene, scene->mRootNode, materialLookupPaths, geometryArena);
 
     return std::move(model);
 }
 
-void AssimpModelLoader::processAiNode(const aiScene* scene, aiNode* node, std::vector<std::filesystem::path> materialLookupPaths, std::vector<std::unique_ptr<AbstractMesh>>& meshes)
+bool AssimpModelLoader::geometryFromFile(std::string filename, std::vector<glm::vec3>& positions, std::vector<unsigned int>& indices, unsigned int assimpImportFlags)
+{
+    Assimp::Importer importer;
+    auto scene = importer.ReadFile(filename, assimpImportFlags);
+
+    if (!scene)
+    {
+        std::cerr << "[ERROR] Can not load geometry from " << filename << ": " << importer.GetErrorString() << std::endl;
+        return false;
+    }
+
+    for (auto meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
+    {
+        auto mesh = scene->mMeshes[meshIndex];
+
+        const auto baseVertex = static_cast<unsigned int>(positions.size());
+
+        for (auto i = 0; i < mesh->mNumVertices; ++i)
+        {
+            positions.push_back(glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z));
+        }
+
+        for (auto i = 0; i < mesh->mNumFaces; ++i)
+        {
+            // points and lines do not occlude anything
+            if (mesh->mFaces[i].mNumIndices != 3)
+            {
+                continue;
+            }
+
+            for (auto t = 0; t < 3; ++t)
+            {
+                indices.push_back(baseVertex + mesh->mFaces[i].mIndices[t]);
+            }
+        }
+    }
+
+    return true;
+}
+
+void AssimpModelLoader::processAiNode(const aiScene* scene, aiNode* node, std::vector<std::filesystem::path> materialLookupPaths, GeometryArena* geometryArena, std::vector<std::unique_ptr<AbstractMesh>>& meshes)
 {
     for (auto t = 0; t < node->mNumMeshes; ++t)
     {
-        auto mesh = fromAiMesh(scene, scene->mMeshes[node->mMeshes[t]], materialLookupPaths);
+        auto mesh = fromAiMesh(scene, scene->mMeshes[node->mMeshes[t]], materialLookupPaths, geometryArena);
         meshes.push_back(std::move(mesh));
     }
 
@@ -40,12 +82,14 @@ void AssimpModelLoader::processAiNode(const aiScene* scene, aiNode* node, std::v
         auto child = node->mChildren[i];
         // auto childTransformation = parentTransformation + assimpMatrixToGlm(child->mTransformation);
 
-        processAiNode(scene, child, materialLookupPaths, meshes);
+        processAiNode(scene, child, materialLookupPaths, geometryArena, meshes);
     }
 }
 
-std::unique_ptr<AbstractMesh> AssimpModelLoader::fromAiMesh(const aiScene* scene, aiMesh* mesh, std::vector<std::filesystem::path> materialLookupPaths)
+std::unique_ptr<AbstractMesh> AssimpModelLoader::fromAiMesh(const aiScene* scene, aiMesh* mesh, std::vector<std::filesystem::path> materialLookupPaths, GeometryArena* geometryArena)
 {
+    PROFILE_FUNCTION();
+
     std::cout << "[INFO] Creating buffer objects...";
 
     std::vector<glm::vec3> vertices;
@@ -176,6 +220,8 @@ std::unique_ptr<AbstractMesh> AssimpModelLoader::fromAiMesh(const aiScene* scene
                 static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
                 reinterpret_cast<const gl::GLvoid*>(textureImage->getPixelsPtr()));
 
+            PROFILE_GPU_ALLOC(texture, textureImage->getSize().x * textureImage->getSize().y * 4, "textures");
+
             textures.push_back(texture);
         }
 
@@ -191,5 +237,7 @@ std::unique_ptr<AbstractMesh> AssimpModelLoader::fromAiMesh(const aiScene* scene
         ->addTangentsBitangents(tangents, bitangents)
         ->addUVs(uvs)
         ->addTextures(textures)
+        ->optimize()
+        ->setGeometryArena(geometryArena)
         ->build();
 }
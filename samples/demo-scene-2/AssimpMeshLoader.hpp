@@ -9,12 +9,16 @@ class AssimpModelLoader
 public:
     AssimpModelLoader();
 
-    static std::unique_ptr<MultiMeshModel> fromAiNode(const aiScene* scene, aiNode* node, std::vector<std::filesystem::path> materialLookupPaths = {});
+    // the meshes go into the geometry arena if one is given, into buffers of their own otherwise
+    static std::unique_ptr<MultiMeshModel> fromAiNode(const aiScene* scene, aiNode* node, std::vector<std::filesystem::path> materialLookupPaths = {}, GeometryArena* geometryArena = nullptr);
 
-    static std::unique_ptr<MultiMeshModel> fromFile(std::string filename, std::vector<std::filesystem::path> materialLookupPaths = {}, unsigned int assimpImportFlags = 0);
+    static std::unique_ptr<MultiMeshModel> fromFile(std::string filename, std::vector<std::filesystem::path> materialLookupPaths = {}, unsigned int assimpImportFlags = 0, GeometryArena* geometryArena = nullptr);
+
+    // positions and indices of all the meshes in the file merged together, for the CPU side (e.g. occluders); no GL objects are created
+    static bool geometryFromFile(std::string filename, std::vector<glm::vec3>& positions, std::vector<unsigned int>& indices, unsigned int assimpImportFlags = aiProcess_Triangulate);
 
 protected:
-    static void processAiNode(const aiScene* scene, aiNode* node, std::vector<std::filesystem::path> materialLookupPaths, std::vector<std::unique_ptr<AbstractMesh>>& meshes);
+    static void processAiNode(const aiScene* scene, aiNode* node, std::vector<std::filesystem::path> materialLookupPaths, GeometryArena* geometryArena, std::vector<std::unique_ptr<AbstractMesh>>& meshes);
 
-    static std::unique_ptr<AbstractMesh> fromAiMesh(const aiScene* scene, aiMesh* mesh, std::vector<std::filesystem::path> materialLookupPaths = {});
+    static std::unique_ptr<AbstractMesh> fromAiMesh(const aiScene* scene, aiMesh* mesh, std::vector<std::filesystem::path> materialLookupPaths = {}, GeometryArena* geometryArena = nullptr);
 };
@@ -0,0 +1,253 @@
+#include "GeometryArena.hpp"
+
+#include <bit>
+
+namespace
+{
+    std::unique_ptr<globjects::Buffer> createBuffer(std::size_t size)
+    {
+        auto buffer = std::make_unique<globjects::Buffer>();
+
+        buffer->setData(static_cast<gl::GLsizeiptr>(size), nullptr, static_cast<gl::GLenum>(GL_STATIC_DRAW));
+
+        PROFILE_GPU_ALLOC(buffer.get(), size, "buffers");
+
+        return buffer;
+    }
+}
+
+GeometryArena::GeometryArena(VertexLayout vertexLayout, unsigned int vertexCapacity, unsigned int indexCapacity) :
+    m_vertexLayout(std::move(vertexLayout)),
+    m_vao(std::make_unique<globjects::VertexArray>()),
+    m_vertexAllocator(vertexCapacity),
+    m_indexAllocator(indexCapacity)
+{
+    createBuffers(vertexCapacity, indexCapacity);
+    bindBuffers();
+}
+
+GeometryArena::~GeometryArena()
+{
+    for (auto& vertexBuffer : m_vertexBuffers)
+    {
+        PROFILE_GPU_FREE(vertexBuffer.get(), "buffers");
+    }
+
+    PROFILE_GPU_FREE(m_indexBuffer.get(), "buffers");
+}
+
+GeometryArena::Handle GeometryArena::allocate(const Geometry& geometry)
+{
+    PROFILE_FUNCTION();
+
+    const auto vertexCount = static_cast<unsigned int>(geometry.vertices.positions.size());
+    const auto indexCount = static_cast<unsigned int>(geometry.indices.size());
+
+    if (vertexCount == 0 || indexCount == 0)
+    {
+        std::cerr << "[ERROR] Can not put empty geometry into the geometry arena" << std::endl;
+        return INVALID_HANDLE;
+    }
+
+    auto vertices = m_vertexAllocator.allocate(vertexCount);
+    auto indices = m_indexAllocator.allocate(indexCount);
+
+    if (vertices.offset == OffsetAllocator::NO_SPACE || indices.offset == OffsetAllocator::NO_SPACE)
+    {
+        m_vertexAllocator.free(vertices);
+        m_indexAllocator.free(indices);
+
+        // packing the ranges together is enough if the free space is only fragmented; otherwise the buffers grow, twice at a time
+        const auto requiredVertexCapacity = m_vertexAllocator.getSize() - m_vertexAllocator.getFreeSpace() + vertexCount;
+        const auto requiredIndexCapacity = m_indexAllocator.getSize() - m_indexAllocator.getFreeSpace() + indexCount;
+
+        relocate(
+            std::max(m_vertexAllocator.getSize(), std::bit_ceil(requiredVertexCapacity)),
+            std::max(m_indexAllocator.getSize(), std::bit_ceil(requiredIndexCapacity)));
+
+        vertices = m_vertexAllocator.allocate(vertexCount);
+        indices = m_indexAllocator.allocate(indexCount);
+    }
+
+    const auto& streams = m_vertexLayout.getStreams();
+
+    for (std::size_t streamIndex = 0; streamIndex < streams.size(); ++streamIndex)
+    {
+        const auto data = m_vertexLayout.pack(streamIndex, geometry.vertices);
+
+        m_vertexBuffers[streamIndex]->setSubData(
+            static_cast<gl::GLintptr>(vertices.offset) * streams[streamIndex].stride,
+            static_cast<gl::GLsizeiptr>(data.size()),
+            data.data());
+    }
+
+    m_indexBuffer->setSubData(
+        static_cast<gl::GLintptr>(indices.offset * sizeof(unsigned int)),
+        static_cast<gl::GLsizeiptr>(indexCount * sizeof(unsigned int)),
+        geometry.indices.data());
+
+    const Entry entry {
+        .vertices = vertices,
+        .indices = indices,
+        .vertexCount = vertexCount,
+        .range = { .firstIndex = indices.offset, .indexCount = indexCount, .baseVertex = static_cast<int>(vertices.offset) },
+        .isLive = true
+    };
+
+    if (m_freeHandles.empty())
+    {
+        m_entries.push_back(entry);
+
+        return static_cast<Handle>(m_entries.size() - 1);
+    }
+
+    const auto handle = m_freeHandles.back();
+    m_freeHandles.pop_back();
+
+    m_entries[handle] = entry;
+
+    return handle;
+}
+
+void GeometryArena::free(Handle handle)
+{
+    if (handle == INVALID_HANDLE || !m_entries[handle].isLive)
+    {
+        return;
+    }
+
+    m_vertexAllocator.free(m_entries[handle].vertices);
+    m_indexAllocator.free(m_entries[handle].indices);
+
+    m_entries[handle].isLive = false;
+
+    m_freeHandles.push_back(handle);
+}
+
+GeometryRange GeometryArena::getRange(Handle handle) const
+{
+    return m_entries[handle].range;
+}
+
+globjects::VertexArray* GeometryArena::getVertexArray() const
+{
+    return m_vao.get();
+}
+
+const VertexLayout& GeometryArena::getVertexLayout() const
+{
+    return m_vertexLayout;
+}
+
+void GeometryArena::defragment()
+{
+    relocate(m_vertexAllocator.getSize(), m_indexAllocator.getSize());
+}
+
+GeometryArena::Statistics GeometryArena::getStatistics() const
+{
+    return {
+        .vertexCapacity = m_vertexAllocator.getSize(),
+        .freeVertices = m_vertexAllocator.getFreeSpace(),
+        .indexCapacity = m_indexAllocator.getSize(),
+        .freeIndices = m_indexAllocator.getFreeSpace(),
+        .liveRanges = static_cast<unsigned int>(m_entries.size() - m_freeHandles.size())
+    };
+}
+
+void GeometryArena::relocate(unsigned int vertexCapacity, unsigned int indexCapacity)
+{
+    PROFILE_FUNCTION();
+
+    auto previousVertexBuffers = std::move(m_vertexBuffers);
+    auto previousIndexBuffer = std::move(m_indexBuffer);
+
+    createBuffers(vertexCapacity, indexCapacity);
+
+    m_vertexAllocator.reset(vertexCapacity);
+    m_indexAllocator.reset(indexCapacity);
+
+    // in the order they were in before, so that the meshes loaded together stay together
+    std::vector<Handle> liveHandles;
+
+    for (Handle handle = 0; handle < m_entries.size(); ++handle)
+    {
+        if (m_entries[handle].isLive)
+        {
+            liveHandles.push_back(handle);
+        }
+    }
+
+    std::sort(liveHandles.begin(), liveHandles.end(), [&](Handle a, Handle b) {
+        return m_entries[a].vertices.offset < m_entries[b].vertices.offset;
+    });
+
+    for (auto handle : liveHandles)
+    {
+        auto& entry = m_entries[handle];
+
+        // the buffers are at least as big as everything which lives in them, so these can not fail
+        const auto vertices = m_vertexAllocator.allocate(entry.vertexCount);
+        const auto indices = m_indexAllocator.allocate(entry.range.indexCount);
+
+        const auto& streams = m_vertexLayout.getStreams();
+
+        for (std::size_t streamIndex = 0; streamIndex < streams.size(); ++streamIndex)
+        {
+            const auto stride = streams[streamIndex].stride;
+
+            previousVertexBuffers[streamIndex]->copySubData(
+                m_vertexBuffers[streamIndex].get(),
+                static_cast<gl::GLintptr>(entry.vertices.offset) * stride,
+                static_cast<gl::GLintptr>(vertices.offset) * stride,
+                static_cast<gl::GLsizeiptr>(entry.vertexCount) * stride);
+        }
+
+        // the index values are relative to the base vertex and stay the same
+        previousIndexBuffer->copySubData(
+            m_indexBuffer.get(),
+            static_cast<gl::GLintptr>(entry.indices.offset * sizeof(unsigned int)),
+            static_cast<gl::GLintptr>(indices.offset * sizeof(unsigned int)),
+            static_cast<gl::GLsizeiptr>(entry.range.indexCount * sizeof(unsigned int)));
+
+        entry.vertices = vertices;
+        entry.indices = indices;
+        entry.range.firstIndex = indices.offset;
+        entry.range.baseVertex = static_cast<int>(vertices.offset);
+    }
+
+    for (auto& vertexBuffer : previousVertexBuffers)
+    {
+        PROFILE_GPU_FREE(vertexBuffer.get(), "buffers");
+    }
+
+    PROFILE_GPU_FREE(previousIndexBuffer.get(), "buffers");
+
+    bindBuffers();
+}
+
+void GeometryArena::createBuffers(unsigned int vertexCapacity, unsigned int indexCapacity)
+{
+    m_vertexBuffers.clear();
+
+    for (const auto& stream : m_vertexLayout.getStreams())
+    {
+        m_vertexBuffers.push_back(createBuffer(static_cast<std::size_t>(vertexCapacity) * stream.stride));
+    }
+
+    m_indexBuffer = createBuffer(static_cast<std::size_t>(indexCapacity) * sizeof(unsigned int));
+}
+
+void GeometryArena::bindBuffers()
+{
+    std::vector<globjects::Buffer*> vertexBuffers;
+
+    for (auto& vertexBuffer : m_vertexBuffers)
+    {
+        vertexBuffers.push_back(vertexBuffer.get());
+    }
+
+    m_vertexLayout.bind(m_vao.get(), vertexBuffers);
+
+    m_vao->bindElementBuffer(m_indexBuffer.get());
+}
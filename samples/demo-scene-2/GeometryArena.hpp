@@ -0,0 +1,108 @@
+#pragma once
+
+#include "stdafx.hpp"
+
+#include "OffsetAllocator.hpp"
+#include "VertexLayout.hpp"
+
+// where the geometry of a mesh lives in the arena buffers; the index values themselves are relative to baseVertex
+struct GeometryRange
+{
+    unsigned int firstIndex;
+    unsigned int indexCount;
+    int baseVertex;
+};
+
+/**
+ * Geometry of all the meshes in a handful of big buffers - one per vertex stream plus one for the indices - behind a single
+ * VAO. Meshes only own ranges of these buffers, so switching between them costs no VAO or buffer binding and any
+ * number of them can be drawn with one glMultiDrawElementsBaseVertex / glMultiDrawElementsIndirect call.
+ *
+ * The ranges are handed out by two OffsetAllocator instances, in vertices and in indices. A range is referred to with a
+ * handle rather than with its offsets, since defragment() moves the ranges around; the handles stay valid until free().
+ *
+ * All the meshes share the vertex layout of the arena, with the default attribute indices of AbstractMeshBuilder: interleaved
+ * by default, with the positions in a stream of their own for the depth-only passes. The attributes a mesh does not have are
+ * filled with zeros, which is what a disabled attribute reads as anyway.
+ */
+class GeometryArena
+{
+public:
+    using Handle = std::uint32_t;
+
+    static constexpr Handle INVALID_HANDLE = std::numeric_limits<Handle>::max();
+
+    static constexpr unsigned int DEFAULT_VERTEX_CAPACITY = 1 << 20;
+    static constexpr unsigned int DEFAULT_INDEX_CAPACITY = 1 << 22;
+
+    struct Geometry
+    {
+        VertexData vertices;
+        const std::vector<unsigned int>& indices;
+    };
+
+    struct Statistics
+    {
+        unsigned int vertexCapacity;
+        unsigned int freeVertices;
+        unsigned int indexCapacity;
+        unsigned int freeIndices;
+        unsigned int liveRanges;
+    };
+
+    // needs a GL context; the capacities are in vertices and indices, the buffers grow when they run out of space
+    GeometryArena(VertexLayout vertexLayout = VertexLayout::interleaved(), unsigned int vertexCapacity = DEFAULT_VERTEX_CAPACITY, unsigned int indexCapacity = DEFAULT_INDEX_CAPACITY);
+
+    ~GeometryArena();
+
+    GeometryArena(const GeometryArena&) = delete;
+
+    GeometryArena& operator=(const GeometryArena&) = delete;
+
+    // uploads the geometry into a free range
+    Handle allocate(const Geometry& geometry);
+
+    void free(Handle handle);
+
+    GeometryRange getRange(Handle handle) const;
+
+    globjects::VertexArray* getVertexArray() const;
+
+    const VertexLayout& getVertexLayout() const;
+
+    // packs all the live ranges together at the start of the buffers, so that the whole free space is one region again
+    void defragment();
+
+    Statistics getStatistics() const;
+
+protected:
+    struct Entry
+    {
+        OffsetAllocator::Allocation vertices;
+        OffsetAllocator::Allocation indices;
+        unsigned int vertexCount;
+        GeometryRange range;
+        bool isLive;
+    };
+
+    // copies the live ranges, packed, into new buffers of the given capacities and re-points the VAO at them
+    void relocate(unsigned int vertexCapacity, unsigned int indexCapacity);
+
+    void createBuffers(unsigned int vertexCapacity, unsigned int indexCapacity);
+
+    void bindBuffers();
+
+    VertexLayout m_vertexLayout;
+
+    std::unique_ptr<globjects::VertexArray> m_vao;
+
+    // one per stream of the vertex layout
+    std::vector<std::unique_ptr<globjects::Buffer>> m_vertexBuffers;
+    std::unique_ptr<globjects::Buffer> m_indexBuffer;
+
+    OffsetAllocator m_vertexAllocator;
+    OffsetAllocator m_indexAllocator;
+
+    std::vector<Entry> m_entries;
+    std::vector<Handle> m_freeHandles;
+};
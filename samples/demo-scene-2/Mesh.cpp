@@ -1,4 +1,5 @@
 #include "Mesh.hpp"
+#include "MeshOptimizer.hpp"
 
 #pragma once
 
@@ -13,26 +14,53 @@ AbstractMesh::AbstractMesh(
     unsigned int numIndices,
     std::vector<globjects::Texture*> textures,
     std::unique_ptr<globjects::VertexArray> vao,
-    std::unique_ptr<globjects::Buffer> vertexBuffer,
+    std::vector<std::unique_ptr<globjects::Buffer>> vertexBuffers,
     std::unique_ptr<globjects::Buffer> indexBuffer,
-    std::unique_ptr<globjects::Buffer> normalBuffer,
-    std::unique_ptr<globjects::Buffer> tangentBuffer,
-    std::unique_ptr<globjects::Buffer> bitangentBuffer,
-    std::unique_ptr<globjects::Buffer> uvBuffer
+    BoundingBox boundingBox
 ) :
     m_numIndices(numIndices),
     m_textures(textures),
     m_vao(std::move(vao)),
-    m_vertexBuffer(std::move(vertexBuffer)),
+    m_vertexBuffers(std::move(vertexBuffers)),
     m_indexBuffer(std::move(indexBuffer)),
-    m_normalBuffer(std::move(normalBuffer)),
-    m_tangentBuffer(std::move(tangentBuffer)),
-    m_bitangentBuffer(std::move(bitangentBuffer)),
-    m_uvBuffer(std::move(uvBuffer)),
-    m_transformation(1.0f)
+    m_geometryArena(nullptr),
+    m_geometry(GeometryArena::INVALID_HANDLE),
+    m_transformation(1.0f),
+    m_boundingBox(boundingBox)
 {
 }
 
+AbstractMesh::AbstractMesh(
+    std::vector<globjects::Texture*> textures,
+    GeometryArena* geometryArena,
+    GeometryArena::Handle geometry,
+    BoundingBox boundingBox
+) :
+    m_numIndices(geometryArena->getRange(geometry).indexCount),
+    m_textures(textures),
+    m_geometryArena(geometryArena),
+    m_geometry(geometry),
+    m_transformation(1.0f),
+    m_boundingBox(boundingBox)
+{
+}
+
+AbstractMesh::~AbstractMesh()
+{
+    if (m_geometryArena != nullptr)
+    {
+        m_geometryArena->free(m_geometry);
+        return;
+    }
+
+    for (auto& vertexBuffer : m_vertexBuffers)
+    {
+        PROFILE_GPU_FREE(vertexBuffer.get(), "buffers");
+    }
+
+    PROFILE_GPU_FREE(m_indexBuffer.get(), "buffers");
+}
+
 void AbstractMesh::setTransformation(glm::mat4 transformation)
 {
     m_transformation = transformation;
@@ -43,30 +71,67 @@ glm::mat4 AbstractMesh::getTransformation() const
     return m_transformation;
 }
 
+globjects::VertexArray* AbstractMesh::getVertexArray() const
+{
+    return m_geometryArena != nullptr ? m_geometryArena->getVertexArray() : m_vao.get();
+}
+
+const std::vector<globjects::Texture*>& AbstractMesh::getTextures() const
+{
+    return m_textures;
+}
+
+unsigned int AbstractMesh::getIndexCount() const
+{
+    return m_numIndices;
+}
+
+GeometryRange AbstractMesh::getGeometryRange() const
+{
+    if (m_geometryArena != nullptr)
+    {
+        // moves when the arena is defragmented
+        return m_geometryArena->getRange(m_geometry);
+    }
+
+    return { .firstIndex = 0, .indexCount = m_numIndices, .baseVertex = 0 };
+}
+
+BoundingBox AbstractMesh::getBoundingBox() const
+{
+    return m_boundingBox;
+}
+
 void AbstractMesh::draw()
 {
+    const auto range = getGeometryRange();
+
     // number of values passed = number of elements * number of vertices per element
     // in this case: 2 triangles, 3 vertex indexes per triangle
-    m_vao->drawElements(
+    getVertexArray()->drawElementsBaseVertex(
         static_cast<gl::GLenum>(GL_TRIANGLES),
-        m_numIndices,
+        range.indexCount,
         static_cast<gl::GLenum>(GL_UNSIGNED_INT),
-        nullptr);
+        reinterpret_cast<const void*>(range.firstIndex * sizeof(unsigned int)),
+        range.baseVertex);
 }
 
 void AbstractMesh::drawInstanced(unsigned int instances)
 {
-    m_vao->drawElementsInstanced(
+    const auto range = getGeometryRange();
+
+    getVertexArray()->drawElementsInstancedBaseVertex(
         static_cast<gl::GLenum>(GL_TRIANGLES),
-        m_numIndices,
+        range.indexCount,
         static_cast<gl::GLenum>(GL_UNSIGNED_INT),
-        nullptr,
-        instances);
+        reinterpret_cast<const void*>(range.firstIndex * sizeof(unsigned int)),
+        instances,
+        range.baseVertex);
 }
 
 void AbstractMesh::bind()
 {
-    m_vao->bind();
+    getVertexArray()->bind();
 
     for (auto& texture : m_textures)
     {
@@ -81,7 +146,7 @@ void AbstractMesh::unbind()
         texture->unbindActive(1);
     }
 
-    m_vao->unbind();
+    getVertexArray()->unbind();
 }
 
 AbstractMeshBuilder::AbstractMeshBuilder() :
@@ -89,7 +154,10 @@ AbstractMeshBuilder::AbstractMeshBuilder() :
     m_normalAttributeIndex(1),
     m_tangentAttributeIndex(3),
     m_bitangentAttributeIndex(4),
-    m_uvAttributeIndex(2)
+    m_uvAttributeIndex(2),
+    m_vertexLayout(VertexLayout::separateStreams()),
+    m_geometryArena(nullptr),
+    m_isOptimized(false)
 {
 }
 
@@ -198,91 +266,173 @@ AbstractMeshBuilder* AbstractMeshBuilder::setUVAttributerIndex(unsigned int uvAt
     return this;
 }
 
-std::unique_ptr<AbstractMesh> AbstractMeshBuilder::build()
+AbstractMeshBuilder* AbstractMeshBuilder::optimize()
 {
-    m_vertexBuffer = std::make_unique<globjects::Buffer>();
+    m_isOptimized = true;
 
-    m_vertexBuffer->setData(m_vertices, static_cast<gl::GLenum>(GL_STATIC_DRAW));
+    return this;
+}
 
-    m_indexBuffer = std::make_unique<globjects::Buffer>();
+AbstractMeshBuilder* AbstractMeshBuilder::setVertexLayout(VertexLayout vertexLayout)
+{
+    m_vertexLayout = std::move(vertexLayout);
 
-    m_indexBuffer->setData(m_indices, static_cast<gl::GLenum>(GL_STATIC_DRAW));
+    return this;
+}
 
-    m_vao = std::make_unique<globjects::VertexArray>();
+AbstractMeshBuilder* AbstractMeshBuilder::setGeometryArena(GeometryArena* geometryArena)
+{
+    m_geometryArena = geometryArena;
 
-    m_vao->bindElementBuffer(m_indexBuffer.get());
+    return this;
+}
 
-    m_vao->binding(m_positionAttributeIndex)->setAttribute(m_positionAttributeIndex);
-    m_vao->binding(m_positionAttributeIndex)->setBuffer(m_vertexBuffer.get(), 0, sizeof(glm::vec3)); // number of elements in buffer, stride, size of buffer element
-    m_vao->binding(m_positionAttributeIndex)->setFormat(3, static_cast<gl::GLenum>(GL_FLOAT)); // number of data elements per buffer element (vertex), type of data
-    m_vao->enable(m_positionAttributeIndex);
+void AbstractMeshBuilder::optimizeMesh()
+{
+    const auto vertexCount = m_vertices.size();
 
-    m_normalBuffer = std::make_unique<globjects::Buffer>();
+    // only the attributes present for every vertex take part in the deduplication
+    std::vector<MeshOptimizer::VertexStream> streams { { m_vertices.data(), sizeof(glm::vec3) } };
 
-    if (!m_normals.empty())
+    if (m_normals.size() == vertexCount)
     {
-        m_normalBuffer->setData(m_normals, static_cast<gl::GLenum>(GL_STATIC_DRAW));
+        streams.push_back({ m_normals.data(), sizeof(glm::vec3) });
+    }
 
-        m_vao->binding(m_normalAttributeIndex)->setAttribute(m_normalAttributeIndex);
-        m_vao->binding(m_normalAttributeIndex)->setBuffer(m_normalBuffer.get(), 0, sizeof(glm::vec3)); // number of elements in buffer, stride, size of buffer element
-        m_vao->binding(m_normalAttributeIndex)->setFormat(3, static_cast<gl::GLenum>(GL_FLOAT)); // number of data elements per buffer element (vertex), type of data
-        m_vao->enable(m_normalAttributeIndex);
+    if (m_uvs.size() == vertexCount)
+    {
+        streams.push_back({ m_uvs.data(), sizeof(glm::vec2) });
+    }
 
-        // TODO: enable the corresponding shader sections (those which require normal data)
+    if (m_tangents.size() == vertexCount && m_bitangents.size() == vertexCount)
+    {
+        streams.push_back({ m_tangents.data(), sizeof(glm::vec3) });
+        streams.push_back({ m_bitangents.data(), sizeof(glm::vec3) });
     }
 
-    m_uvBuffer = std::make_unique<globjects::Buffer>();
+    const auto result = MeshOptimizer::optimize(m_indices, vertexCount, streams, m_vertices);
 
-    if (!m_uvs.empty())
-    {
-        m_uvBuffer->setData(m_uvs, static_cast<gl::GLenum>(GL_STATIC_DRAW));
+    m_vertices = MeshOptimizer::remapVertices(m_vertices, result.remap, result.vertexCount);
+    m_normals = MeshOptimizer::remapVertices(m_normals, result.remap, result.vertexCount);
+    m_uvs = MeshOptimizer::remapVertices(m_uvs, result.remap, result.vertexCount);
+    m_tangents = MeshOptimizer::remapVertices(m_tangents, result.remap, result.vertexCount);
+    m_bitangents = MeshOptimizer::remapVertices(m_bitangents, result.remap, result.vertexCount);
 
-        m_vao->binding(m_uvAttributeIndex)->setAttribute(m_uvAttributeIndex);
-        m_vao->binding(m_uvAttributeIndex)->setBuffer(m_uvBuffer.get(), 0, sizeof(glm::vec2)); // number of elements in buffer, stride, size of buffer element
-        m_vao->binding(m_uvAttributeIndex)->setFormat(2, static_cast<gl::GLenum>(GL_FLOAT)); // number of data elements per buffer element (vertex), type of data
-        m_vao->enable(m_uvAttributeIndex);
+    std::cout << "[DEBUG] Mesh optimized: vertices " << vertexCount << " -> " << result.vertexCount
+              << "; ACMR " << result.before.acmr << " -> " << result.after.acmr
+              << "; ATVR " << result.before.atvr << " -> " << result.after.atvr << std::endl;
+}
+
+std::unique_ptr<AbstractMesh> AbstractMeshBuilder::build()
+{
+    PROFILE_FUNCTION();
 
-        // TODO: enable the corresponding shader sections (those which require UV data)
+    if (m_isOptimized && !m_indices.empty())
+    {
+        optimizeMesh();
     }
 
-    m_tangentBuffer = std::make_unique<globjects::Buffer>();
+    BoundingBox boundingBox { .min = glm::vec3(0.0f), .max = glm::vec3(0.0f) };
 
-    if (!m_tangents.empty())
+    if (!m_vertices.empty())
     {
-        m_tangentBuffer->setData(m_tangents, static_cast<gl::GLenum>(GL_STATIC_DRAW));
+        boundingBox = { .min = m_vertices.front(), .max = m_vertices.front() };
 
-        m_vao->binding(m_tangentAttributeIndex)->setAttribute(m_tangentAttributeIndex);
-        m_vao->binding(m_tangentAttributeIndex)->setBuffer(m_tangentBuffer.get(), 0, sizeof(glm::vec3)); // number of elements in buffer, stride, size of buffer element
-        m_vao->binding(m_tangentAttributeIndex)->setFormat(3, static_cast<gl::GLenum>(GL_FLOAT)); // number of data elements per buffer element (vertex), type of data
-        m_vao->enable(m_tangentAttributeIndex);
+        for (const auto& vertex : m_vertices)
+        {
+            boundingBox.min = glm::min(boundingBox.min, vertex);
+            boundingBox.max = glm::max(boundingBox.max, vertex);
+        }
+    }
 
-        // TODO: enable the corresponding shader sections (those which require tangent data)
+    const VertexLayout::AttributeIndices attributeIndices = {
+        m_positionAttributeIndex,
+        m_normalAttributeIndex,
+        m_uvAttributeIndex,
+        m_tangentAttributeIndex,
+        m_bitangentAttributeIndex,
+        m_tangentAttributeIndex
+    };
+
+    const VertexData vertices {
+        .positions = m_vertices,
+        .normals = m_normals,
+        .uvs = m_uvs,
+        .tangents = m_tangents,
+        .bitangents = m_bitangents
+    };
+
+    if (m_geometryArena != nullptr && attributeIndices == VertexLayout::DEFAULT_ATTRIBUTE_INDICES && !m_vertices.empty() && !m_indices.empty())
+    {
+        const auto geometry = m_geometryArena->allocate({ .vertices = vertices, .indices = m_indices });
+
+        return std::make_unique<AbstractMesh>(std::move(m_textures), m_geometryArena, geometry, boundingBox);
     }
 
-    m_bitangentBuffer = std::make_unique<globjects::Buffer>();
+    const auto hasAttribute = [&](VertexLayout::Attribute attribute) {
+        switch (attribute)
+        {
+        case VertexLayout::Attribute::NORMAL:
+        case VertexLayout::Attribute::TANGENT_FRAME:
+            return !m_normals.empty();
+
+        case VertexLayout::Attribute::UV:
+            return !m_uvs.empty();
+
+        case VertexLayout::Attribute::TANGENT:
+        case VertexLayout::Attribute::BITANGENT:
+            return !m_tangents.empty();
+
+        default:
+            return true;
+        }
+    };
 
-    if (!m_bitangents.empty())
+    // the streams with none of their attributes present are not created at all, their attributes stay disabled
+    std::vector<globjects::Buffer*> vertexBuffers;
+
+    for (std::size_t streamIndex = 0; streamIndex < m_vertexLayout.getStreams().size(); ++streamIndex)
     {
-        m_bitangentBuffer->setData(m_bitangents, static_cast<gl::GLenum>(GL_STATIC_DRAW));
+        const auto& elements = m_vertexLayout.getStreams()[streamIndex].elements;
+
+        if (std::none_of(elements.begin(), elements.end(), [&](const auto& element) { return hasAttribute(element.attribute); }))
+        {
+            vertexBuffers.push_back(nullptr);
+            continue;
+        }
+
+        const auto data = m_vertexLayout.pack(streamIndex, vertices);
 
-        m_vao->binding(m_bitangentAttributeIndex)->setAttribute(m_bitangentAttributeIndex);
-        m_vao->binding(m_bitangentAttributeIndex)->setBuffer(m_bitangentBuffer.get(), 0, sizeof(glm::vec3)); // number of elements in buffer, stride, size of buffer element
-        m_vao->binding(m_bitangentAttributeIndex)->setFormat(3, static_cast<gl::GLenum>(GL_FLOAT)); // number of data elements per buffer element (vertex), type of data
-        m_vao->enable(m_bitangentAttributeIndex);
+        auto vertexBuffer = std::make_unique<globjects::Buffer>();
 
-        // TODO: enable the corresponding shader sections (those which require bitangent data)
+        vertexBuffer->setData(data, static_cast<gl::GLenum>(GL_STATIC_DRAW));
+
+        PROFILE_GPU_ALLOC(vertexBuffer.get(), data.size(), "buffers");
+
+        vertexBuffers.push_back(vertexBuffer.get());
+        m_vertexBuffers.push_back(std::move(vertexBuffer));
     }
 
+    m_indexBuffer = std::make_unique<globjects::Buffer>();
+
+    m_indexBuffer->setData(m_indices, static_cast<gl::GLenum>(GL_STATIC_DRAW));
+
+    PROFILE_GPU_ALLOC(m_indexBuffer.get(), m_indices.size() * sizeof(unsigned int), "buffers");
+
+    m_vao = std::make_unique<globjects::VertexArray>();
+
+    m_vao->bindElementBuffer(m_indexBuffer.get());
+
+    // sets the strides and the offsets of all the attributes
+    m_vertexLayout.bind(m_vao.get(), vertexBuffers, attributeIndices);
+
     return std::make_unique<AbstractMesh>(
         m_indices.size(),
         std::move(m_textures),
         std::move(m_vao),
-        std::move(m_vertexBuffer),
+        std::move(m_vertexBuffers),
         std::move(m_indexBuffer),
-        std::move(m_normalBuffer),
-        std::move(m_tangentBuffer),
-        std::move(m_bitangentBuffer),
-        std::move(m_uvBuffer));
+        boundingBox);
 }
 
 SingleMeshModel::SingleMeshModel(std::unique_ptr<AbstractMesh> mesh) : m_mesh(std::move(mesh)), m_transformation(1.0f)
@@ -319,6 +469,11 @@ glm::mat4 SingleMeshModel::getTransformation() const
     return m_transformation;
 }
 
+AbstractMesh* SingleMeshModel::getMesh() const
+{
+    return m_mesh.get();
+}
+
 MultiMeshModel::MultiMeshModel(std::vector<std::unique_ptr<AbstractMesh>> meshes) : m_meshes(std::move(meshes)), m_transformation(1.0f)
 {
 }
@@ -365,3 +520,8 @@ glm::mat4 MultiMeshModel::getTransformation() const
 {
     return m_transformation;
 }
+
+const std::vector<std::unique_ptr<AbstractMesh>>& MultiMeshModel::getMeshes() const
+{
+    return m_meshes;
+}
@@ -3,9 +3,16 @@
 #include "stdafx.hpp"
 
 #include "AbstractDrawable.hpp"
+#include "GeometryArena.hpp"
 
 class AbstractMeshBuilder;
 
+struct BoundingBox
+{
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
 class AbstractMesh : public AbstractDrawable
 {
     friend class AbstractMeshBuilder;
@@ -17,18 +24,37 @@ public:
         unsigned int numIndices,
         std::vector<globjects::Texture*> textures,
         std::unique_ptr<globjects::VertexArray> vao,
-        std::unique_ptr<globjects::Buffer> vertexBuffer,
+        std::vector<std::unique_ptr<globjects::Buffer>> vertexBuffers,
         std::unique_ptr<globjects::Buffer> indexBuffer,
-        std::unique_ptr<globjects::Buffer> normalBuffer,
-        std::unique_ptr<globjects::Buffer> tangentBuffer,
-        std::unique_ptr<globjects::Buffer> bitangentBuffer,
-        std::unique_ptr<globjects::Buffer> uvBuffer
+        BoundingBox boundingBox
+    );
+
+    // geometry in a range of the arena buffers, freed together with the mesh
+    AbstractMesh(
+        std::vector<globjects::Texture*> textures,
+        GeometryArena* geometryArena,
+        GeometryArena::Handle geometry,
+        BoundingBox boundingBox
     );
 
+    ~AbstractMesh();
+
     void setTransformation(glm::mat4 transformation);
 
     glm::mat4 getTransformation() const;
 
+    globjects::VertexArray* getVertexArray() const;
+
+    const std::vector<globjects::Texture*>& getTextures() const;
+
+    unsigned int getIndexCount() const;
+
+    // what to draw out of the buffers bound to getVertexArray(); the whole index buffer for the meshes with buffers of their own
+    GeometryRange getGeometryRange() const;
+
+    // model space
+    BoundingBox getBoundingBox() const;
+
     void draw() override;
 
     void drawInstanced(unsigned int instances) override;
@@ -40,18 +66,21 @@ public:
 protected:
     std::unique_ptr<globjects::VertexArray> m_vao;
 
-    std::unique_ptr<globjects::Buffer> m_vertexBuffer;
+    // one per stream of the vertex layout
+    std::vector<std::unique_ptr<globjects::Buffer>> m_vertexBuffers;
     std::unique_ptr<globjects::Buffer> m_indexBuffer;
-    std::unique_ptr<globjects::Buffer> m_normalBuffer;
-    std::unique_ptr<globjects::Buffer> m_tangentBuffer;
-    std::unique_ptr<globjects::Buffer> m_bitangentBuffer;
-    std::unique_ptr<globjects::Buffer> m_uvBuffer;
+
+    // nullptr if the mesh has the buffers above
+    GeometryArena* m_geometryArena;
+    GeometryArena::Handle m_geometry;
 
     std::vector<globjects::Texture*> m_textures;
 
     unsigned int m_numIndices;
 
     glm::mat4 m_transformation;
+
+    BoundingBox m_boundingBox;
 };
 
 class AbstractMeshBuilder
@@ -87,9 +116,20 @@ public:
 
     AbstractMeshBuilder* setUVAttributerIndex(unsigned int uvAttributeIndex);
 
+    // runs the MeshOptimizer pipeline over the mesh data on build()
+    AbstractMeshBuilder* optimize();
+
+    // separate streams, one per attribute, by default
+    AbstractMeshBuilder* setVertexLayout(VertexLayout vertexLayout);
+
+    // puts the geometry into the arena, in the vertex layout of the arena, instead of buffers of its own; only works with the default attribute indices
+    AbstractMeshBuilder* setGeometryArena(GeometryArena* geometryArena);
+
     std::unique_ptr<AbstractMesh> build();
 
 private:
+    void optimizeMesh();
+
     std::vector<glm::vec3> m_vertices;
     std::vector<glm::vec3> m_normals;
     std::vector<glm::vec3> m_tangents;
@@ -99,19 +139,20 @@ private:
     std::vector<globjects::Texture*> m_textures;
 
     std::unique_ptr<globjects::VertexArray> m_vao;
-    std::unique_ptr<globjects::Buffer> m_vertexBuffer;
+    std::vector<std::unique_ptr<globjects::Buffer>> m_vertexBuffers;
     std::unique_ptr<globjects::Buffer> m_indexBuffer;
 
-    std::unique_ptr<globjects::Buffer> m_normalBuffer;
-    std::unique_ptr<globjects::Buffer> m_tangentBuffer;
-    std::unique_ptr<globjects::Buffer> m_bitangentBuffer;
-    std::unique_ptr<globjects::Buffer> m_uvBuffer;
-
     unsigned int m_positionAttributeIndex;
     unsigned int m_normalAttributeIndex;
     unsigned int m_tangentAttributeIndex;
     unsigned int m_bitangentAttributeIndex;
     unsigned int m_uvAttributeIndex;
+
+    VertexLayout m_vertexLayout;
+
+    GeometryArena* m_geometryArena;
+
+    bool m_isOptimized;
 };
 
 class SingleMeshModel : public AbstractDrawable
@@ -131,6 +172,8 @@ public:
 
     glm::mat4 getTransformation() const;
 
+    AbstractMesh* getMesh() const;
+
 protected:
     std::unique_ptr<AbstractMesh> m_mesh;
     glm::mat4 m_transformation;
@@ -153,6 +196,8 @@ public:
 
     glm::mat4 getTransformation() const;
 
+    const std::vector<std::unique_ptr<AbstractMesh>>& getMeshes() const;
+
 protected:
     std::vector<std::unique_ptr<AbstractMesh>> m_meshes;
     glm::mat4 m_transformation;
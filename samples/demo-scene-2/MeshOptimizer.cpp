@@ -0,0 +1,434 @@
+#include "MeshOptimizer.hpp"
+
+namespace
+{
+    std::uint64_t hashVertex(std::size_t vertex, const std::vector<MeshOptimizer::VertexStream>& streams)
+    {
+        // FNV-1a over all the attributes of the vertex
+        std::uint64_t hash = 14695981039346656037ull;
+
+        for (const auto& stream : streams)
+        {
+            const auto* data = static_cast<const std::uint8_t*>(stream.data) + vertex * stream.stride;
+
+            for (std::size_t i = 0; i < stream.stride; ++i)
+            {
+                hash = (hash ^ data[i]) * 1099511628211ull;
+            }
+        }
+
+        return hash;
+    }
+
+    bool isSameVertex(std::size_t a, std::size_t b, const std::vector<MeshOptimizer::VertexStream>& streams)
+    {
+        for (const auto& stream : streams)
+        {
+            const auto* data = static_cast<const std::uint8_t*>(stream.data);
+
+            if (std::memcmp(data + a * stream.stride, data + b * stream.stride, stream.stride) != 0)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // number of cache misses the triangle causes, updating the FIFO cache (timestamps are in "misses so far" units)
+    unsigned int simulateTriangle(const unsigned int* triangle, std::vector<unsigned int>& cacheTimestamps, unsigned int& time, unsigned int cacheSize)
+    {
+        unsigned int misses = 0;
+
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            const auto vertex = triangle[i];
+
+            if (time - cacheTimestamps[vertex] > cacheSize)
+            {
+                cacheTimestamps[vertex] = time++;
+                ++misses;
+            }
+        }
+
+        return misses;
+    }
+}
+
+MeshOptimizer::Result MeshOptimizer::optimize(std::vector<unsigned int>& indices, std::size_t vertexCount, const std::vector<VertexStream>& streams, const std::vector<glm::vec3>& positions)
+{
+    Result result;
+
+    result.before = analyzeVertexCache(indices, vertexCount);
+
+    // duplicates are redirected onto the first vertex with the same data; the vertex fetch pass drops them afterwards
+    const auto duplicates = deduplicateVertices(vertexCount, streams);
+
+    for (auto& index : indices)
+    {
+        index = duplicates[index];
+    }
+
+    indices = optimizeVertexCache(indices, vertexCount);
+    indices = optimizeOverdraw(indices, positions);
+
+    result.remap = optimizeVertexFetch(indices, vertexCount, result.vertexCount);
+
+    result.after = analyzeVertexCache(indices, result.vertexCount);
+
+    return result;
+}
+
+std::vector<unsigned int> MeshOptimizer::deduplicateVertices(std::size_t vertexCount, const std::vector<VertexStream>& streams)
+{
+    std::vector<unsigned int> remap(vertexCount);
+    std::unordered_multimap<std::uint64_t, unsigned int> uniqueVertices;
+
+    uniqueVertices.reserve(vertexCount);
+
+    for (std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+    {
+        const auto hash = hashVertex(vertex, streams);
+        const auto [first, last] = uniqueVertices.equal_range(hash);
+
+        const auto match = std::find_if(first, last, [&](const auto& candidate) { return isSameVertex(candidate.second, vertex, streams); });
+
+        if (match != last)
+        {
+            remap[vertex] = match->second;
+        }
+        else
+        {
+            remap[vertex] = static_cast<unsigned int>(vertex);
+            uniqueVertices.emplace(hash, static_cast<unsigned int>(vertex));
+        }
+    }
+
+    return remap;
+}
+
+std::vector<unsigned int> MeshOptimizer::optimizeVertexCache(const std::vector<unsigned int>& indices, std::size_t vertexCount, unsigned int cacheSize)
+{
+    const auto triangleCount = indices.size() / 3;
+
+    // vertex -> adjacent triangles, as offsets into one flat array
+    std::vector<unsigned int> liveTriangles(vertexCount, 0);
+
+    for (auto index : indices)
+    {
+        ++liveTriangles[index];
+    }
+
+    std::vector<unsigned int> adjacencyOffsets(vertexCount + 1, 0);
+
+    for (std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+    {
+        adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + liveTriangles[vertex];
+    }
+
+    std::vector<unsigned int> adjacency(indices.size());
+    std::vector<unsigned int> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+
+    for (std::size_t triangle = 0; triangle < triangleCount; ++triangle)
+    {
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            adjacency[adjacencyFill[indices[triangle * 3 + i]]++] = static_cast<unsigned int>(triangle);
+        }
+    }
+
+    std::vector<unsigned int> cacheTimestamps(vertexCount, 0);
+    std::vector<bool> isEmitted(triangleCount, false);
+    std::vector<unsigned int> deadEndStack;
+    std::vector<unsigned int> candidates;
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+
+    unsigned int time = cacheSize + 1;
+    std::size_t inputCursor = 0;
+
+    // the first vertex of the first triangle, or nothing at all for an empty mesh
+    auto fanningVertex = triangleCount > 0 ? static_cast<int>(indices[0]) : -1;
+
+    while (fanningVertex >= 0)
+    {
+        candidates.clear();
+
+        // emit all the remaining triangles around the fanning vertex
+        for (auto offset = adjacencyOffsets[fanningVertex]; offset < adjacencyOffsets[fanningVertex + 1]; ++offset)
+        {
+            const auto triangle = adjacency[offset];
+
+            if (isEmitted[triangle])
+            {
+                continue;
+            }
+
+            for (unsigned int i = 0; i < 3; ++i)
+            {
+                const auto vertex = indices[triangle * 3 + i];
+
+                result.push_back(vertex);
+                deadEndStack.push_back(vertex);
+                candidates.push_back(vertex);
+
+                --liveTriangles[vertex];
+
+                if (time - cacheTimestamps[vertex] > cacheSize)
+                {
+                    cacheTimestamps[vertex] = time++;
+                }
+            }
+
+            isEmitted[triangle] = true;
+        }
+
+        // pick the next fanning vertex: the one which will still be in the cache after all its triangles are emitted, the older the better
+        fanningVertex = -1;
+        int bestPriority = -1;
+
+        for (auto vertex : candidates)
+        {
+            if (liveTriangles[vertex] == 0)
+            {
+                continue;
+            }
+
+            int priority = 0;
+
+            if (time - cacheTimestamps[vertex] + 2 * liveTriangles[vertex] <= cacheSize)
+            {
+                priority = static_cast<int>(time - cacheTimestamps[vertex]);
+            }
+
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                fanningVertex = static_cast<int>(vertex);
+            }
+        }
+
+        if (fanningVertex >= 0)
+        {
+            continue;
+        }
+
+        // dead end - go back through the recently emitted vertices, then through the input in order
+        while (!deadEndStack.empty())
+        {
+            const auto vertex = deadEndStack.back();
+            deadEndStack.pop_back();
+
+            if (liveTriangles[vertex] > 0)
+            {
+                fanningVertex = static_cast<int>(vertex);
+                break;
+            }
+        }
+
+        while (fanningVertex < 0 && inputCursor < indices.size())
+        {
+            const auto vertex = indices[inputCursor++];
+
+            if (liveTriangles[vertex] > 0)
+            {
+                fanningVertex = static_cast<int>(vertex);
+            }
+        }
+    }
+
+    return result;
+}
+
+std::vector<unsigned int> MeshOptimizer::optimizeOverdraw(const std::vector<unsigned int>& indices, const std::vector<glm::vec3>& positions, float threshold, unsigned int cacheSize)
+{
+    const auto triangleCount = indices.size() / 3;
+
+    if (triangleCount == 0 || positions.empty())
+    {
+        return indices;
+    }
+
+    // hard cluster boundaries - triangles which miss the cache on all three vertices, i.e. where the cache optimizer hit a dead end
+    std::vector<std::size_t> clusters;
+
+    {
+        std::vector<unsigned int> cacheTimestamps(positions.size(), 0);
+        unsigned int time = cacheSize + 1;
+
+        for (std::size_t triangle = 0; triangle < triangleCount; ++triangle)
+        {
+            if (simulateTriangle(&indices[triangle * 3], cacheTimestamps, time, cacheSize) == 3)
+            {
+                clusters.push_back(triangle);
+            }
+        }
+
+        if (clusters.empty() || clusters.front() != 0)
+        {
+            clusters.insert(clusters.begin(), 0);
+        }
+    }
+
+    // soft boundaries - split the hard clusters further wherever the local ACMR is already close to the ACMR of the whole cluster
+    {
+        std::vector<std::size_t> softClusters;
+        std::vector<unsigned int> cacheTimestamps(positions.size(), 0);
+        unsigned int time = cacheSize + 1;
+
+        for (std::size_t cluster = 0; cluster < clusters.size(); ++cluster)
+        {
+            const auto begin = clusters[cluster];
+            const auto end = cluster + 1 < clusters.size() ? clusters[cluster + 1] : triangleCount;
+
+            // cluster ACMR, assuming an empty cache at the start of the cluster
+            std::vector<unsigned int> clusterTimestamps(positions.size(), 0);
+            unsigned int clusterTime = cacheSize + 1;
+            unsigned int clusterMisses = 0;
+
+            for (auto triangle = begin; triangle < end; ++triangle)
+            {
+                clusterMisses += simulateTriangle(&indices[triangle * 3], clusterTimestamps, clusterTime, cacheSize);
+            }
+
+            const float clusterAcmr = static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+            softClusters.push_back(begin);
+
+            std::size_t softBegin = begin;
+            unsigned int softMisses = 0;
+
+            time += cacheSize + 1; // flush
+
+            for (auto triangle = begin; triangle < end; ++triangle)
+            {
+                softMisses += simulateTriangle(&indices[triangle * 3], cacheTimestamps, time, cacheSize);
+
+                const float softAcmr = static_cast<float>(softMisses) / static_cast<float>(triangle + 1 - softBegin);
+
+                if (triangle + 1 < end && softAcmr <= clusterAcmr * threshold)
+                {
+                    softBegin = triangle + 1;
+                    softMisses = 0;
+
+                    softClusters.push_back(softBegin);
+
+                    time += cacheSize + 1; // flush, a new cluster could end up anywhere after sorting
+                }
+            }
+        }
+
+        clusters = std::move(softClusters);
+    }
+
+    // sort the clusters so that the ones facing outwards go first - those are the most likely occluders
+    glm::vec3 meshCentroid(0.0f);
+
+    for (auto index : indices)
+    {
+        meshCentroid += positions[index];
+    }
+
+    meshCentroid /= static_cast<float>(indices.size());
+
+    std::vector<std::pair<float, std::size_t>> clusterOrder;
+
+    for (std::size_t cluster = 0; cluster < clusters.size(); ++cluster)
+    {
+        const auto begin = clusters[cluster];
+        const auto end = cluster + 1 < clusters.size() ? clusters[cluster + 1] : triangleCount;
+
+        glm::vec3 centroid(0.0f);
+        glm::vec3 normal(0.0f);
+        float area = 0.0f;
+
+        for (auto triangle = begin; triangle < end; ++triangle)
+        {
+            const auto& a = positions[indices[triangle * 3 + 0]];
+            const auto& b = positions[indices[triangle * 3 + 1]];
+            const auto& c = positions[indices[triangle * 3 + 2]];
+
+            // length of the cross product is twice the triangle area, so it weighs both the normal and the centroid
+            const auto areaNormal = glm::cross(b - a, c - a);
+            const float triangleArea = glm::length(areaNormal);
+
+            centroid += (a + b + c) * (triangleArea / 3.0f);
+            normal += areaNormal;
+            area += triangleArea;
+        }
+
+        float sortKey = 0.0f;
+
+        if (area > 0.0f && glm::length(normal) > 0.0f)
+        {
+            sortKey = glm::dot(centroid / area - meshCentroid, glm::normalize(normal));
+        }
+
+        clusterOrder.push_back({ sortKey, cluster });
+    }
+
+    std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+
+    for (const auto& [sortKey, cluster] : clusterOrder)
+    {
+        const auto begin = clusters[cluster];
+        const auto end = cluster + 1 < clusters.size() ? clusters[cluster + 1] : triangleCount;
+
+        result.insert(result.end(), indices.begin() + begin * 3, indices.begin() + end * 3);
+    }
+
+    return result;
+}
+
+std::vector<unsigned int> MeshOptimizer::optimizeVertexFetch(std::vector<unsigned int>& indices, std::size_t vertexCount, std::size_t& uniqueVertexCount)
+{
+    std::vector<unsigned int> remap(vertexCount, INVALID_INDEX);
+
+    unsigned int nextVertex = 0;
+
+    for (auto& index : indices)
+    {
+        if (remap[index] == INVALID_INDEX)
+        {
+            remap[index] = nextVertex++;
+        }
+
+        index = remap[index];
+    }
+
+    uniqueVertexCount = nextVertex;
+
+    return remap;
+}
+
+MeshOptimizer::Statistics MeshOptimizer::analyzeVertexCache(const std::vector<unsigned int>& indices, std::size_t vertexCount, unsigned int cacheSize)
+{
+    const auto triangleCount = indices.size() / 3;
+
+    std::vector<unsigned int> cacheTimestamps(vertexCount, 0);
+    std::vector<bool> isReferenced(vertexCount, false);
+
+    unsigned int time = cacheSize + 1;
+    unsigned int misses = 0;
+
+    for (std::size_t triangle = 0; triangle < triangleCount; ++triangle)
+    {
+        misses += simulateTriangle(&indices[triangle * 3], cacheTimestamps, time, cacheSize);
+    }
+
+    for (auto index : indices)
+    {
+        isReferenced[index] = true;
+    }
+
+    const auto referencedVertices = std::count(isReferenced.begin(), isReferenced.end(), true);
+
+    return Statistics {
+        .acmr = triangleCount > 0 ? static_cast<float>(misses) / static_cast<float>(triangleCount) : 0.0f,
+        .atvr = referencedVertices > 0 ? static_cast<float>(misses) / static_cast<float>(referencedVertices) : 0.0f
+    };
+}
@@ -0,0 +1,326 @@
+#include "OffsetAllocator.hpp"
+
+#include <bit>
+
+namespace
+{
+    constexpr std::uint32_t MANTISSA_BITS = 3;
+    constexpr std::uint32_t MANTISSA_VALUE = 1 << MANTISSA_BITS;
+    constexpr std::uint32_t MANTISSA_MASK = MANTISSA_VALUE - 1;
+
+    // size classes are tiny floating point numbers: the exponent picks the top-level bin, three bits of mantissa the bin within it;
+    // sizes below 8 get a class of their own each
+    std::uint32_t sizeToBin(std::uint32_t size, bool roundUp)
+    {
+        if (size < MANTISSA_VALUE)
+        {
+            return size;
+        }
+
+        const std::uint32_t highestBit = 31 - std::countl_zero(size);
+        const std::uint32_t mantissaStartBit = highestBit - MANTISSA_BITS;
+        const std::uint32_t exponent = mantissaStartBit + 1;
+        std::uint32_t mantissa = (size >> mantissaStartBit) & MANTISSA_MASK;
+
+        // the mantissa overflowing into the exponent is the right thing to happen here
+        if (roundUp && (size & ((1u << mantissaStartBit) - 1)) != 0)
+        {
+            ++mantissa;
+        }
+
+        return (exponent << MANTISSA_BITS) + mantissa;
+    }
+
+    // index of the lowest bit set at or after the given one; 32 if there is none
+    std::uint32_t findLowestSetBitAfter(std::uint32_t mask, std::uint32_t startBit)
+    {
+        if (startBit >= 32)
+        {
+            return 32;
+        }
+
+        return std::countr_zero(mask & ~((1u << startBit) - 1));
+    }
+}
+
+OffsetAllocator::OffsetAllocator(std::uint32_t size)
+{
+    reset(size);
+}
+
+void OffsetAllocator::reset(std::uint32_t size)
+{
+    m_size = size;
+    m_freeSpace = 0;
+
+    m_usedTopBins = 0;
+    m_usedBins.fill(0);
+    m_binHeads.fill(NO_NODE);
+
+    m_nodes.clear();
+    m_freeNodes.clear();
+
+    if (size > 0)
+    {
+        insertIntoBin(size, 0);
+    }
+}
+
+OffsetAllocator::Allocation OffsetAllocator::allocate(std::uint32_t size)
+{
+    if (size == 0)
+    {
+        return {};
+    }
+
+    // any region in this bin or above is big enough
+    const auto minBin = sizeToBin(size, true);
+
+    auto topBin = minBin / BINS_PER_TOP_BIN;
+    auto bin = findLowestSetBitAfter(m_usedBins[topBin], minBin % BINS_PER_TOP_BIN);
+
+    if (bin >= BINS_PER_TOP_BIN)
+    {
+        topBin = findLowestSetBitAfter(m_usedTopBins, topBin + 1);
+
+        // any region of a bigger top-level bin will do
+        bin = topBin < TOP_BIN_COUNT ? std::countr_zero(static_cast<std::uint32_t>(m_usedBins[topBin])) : 0;
+    }
+
+    auto nodeIndex = topBin < TOP_BIN_COUNT ? m_binHeads[topBin * BINS_PER_TOP_BIN + bin] : NO_NODE;
+
+    if (nodeIndex == NO_NODE)
+    {
+        // the regions of the bin the size itself falls into are not all big enough, but some might be
+        for (auto candidate = m_binHeads[sizeToBin(size, false)]; candidate != NO_NODE; candidate = m_nodes[candidate].binNext)
+        {
+            if (m_nodes[candidate].size >= size)
+            {
+                nodeIndex = candidate;
+                break;
+            }
+        }
+
+        if (nodeIndex == NO_NODE)
+        {
+            return {};
+        }
+    }
+
+    const auto regionSize = m_nodes[nodeIndex].size;
+
+    unlinkFromBin(nodeIndex);
+
+    m_nodes[nodeIndex].size = size;
+    m_nodes[nodeIndex].isUsed = true;
+
+    m_freeSpace -= regionSize;
+
+    // the rest of the region goes back to the bins
+    if (regionSize > size)
+    {
+        const auto remainderIndex = insertIntoBin(regionSize - size, m_nodes[nodeIndex].offset + size);
+        const auto neighbourNext = m_nodes[nodeIndex].neighbourNext;
+
+        if (neighbourNext != NO_NODE)
+        {
+            m_nodes[neighbourNext].neighbourPrevious = remainderIndex;
+        }
+
+        m_nodes[remainderIndex].neighbourPrevious = nodeIndex;
+        m_nodes[remainderIndex].neighbourNext = neighbourNext;
+        m_nodes[nodeIndex].neighbourNext = remainderIndex;
+    }
+
+    return { .offset = m_nodes[nodeIndex].offset, .node = nodeIndex };
+}
+
+void OffsetAllocator::free(Allocation allocation)
+{
+    if (allocation.node == NO_NODE)
+    {
+        return;
+    }
+
+    const auto nodeIndex = allocation.node;
+
+    auto offset = m_nodes[nodeIndex].offset;
+    auto size = m_nodes[nodeIndex].size;
+    auto neighbourPrevious = m_nodes[nodeIndex].neighbourPrevious;
+    auto neighbourNext = m_nodes[nodeIndex].neighbourNext;
+
+    // merged with the free neighbours on both sides into a single region
+    if (neighbourPrevious != NO_NODE && !m_nodes[neighbourPrevious].isUsed)
+    {
+        offset = m_nodes[neighbourPrevious].offset;
+        size += m_nodes[neighbourPrevious].size;
+
+        const auto previous = neighbourPrevious;
+        neighbourPrevious = m_nodes[previous].neighbourPrevious;
+
+        removeFromBin(previous);
+    }
+
+    if (neighbourNext != NO_NODE && !m_nodes[neighbourNext].isUsed)
+    {
+        size += m_nodes[neighbourNext].size;
+
+        const auto next = neighbourNext;
+        neighbourNext = m_nodes[next].neighbourNext;
+
+        removeFromBin(next);
+    }
+
+    m_nodes[nodeIndex].isUsed = false;
+    m_freeNodes.push_back(nodeIndex);
+
+    const auto mergedIndex = insertIntoBin(size, offset);
+
+    m_nodes[mergedIndex].neighbourPrevious = neighbourPrevious;
+    m_nodes[mergedIndex].neighbourNext = neighbourNext;
+
+    if (neighbourPrevious != NO_NODE)
+    {
+        m_nodes[neighbourPrevious].neighbourNext = mergedIndex;
+    }
+
+    if (neighbourNext != NO_NODE)
+    {
+        m_nodes[neighbourNext].neighbourPrevious = mergedIndex;
+    }
+}
+
+std::uint32_t OffsetAllocator::getAllocationSize(Allocation allocation) const
+{
+    return allocation.node == NO_NODE ? 0 : m_nodes[allocation.node].size;
+}
+
+std::uint32_t OffsetAllocator::getSize() const
+{
+    return m_size;
+}
+
+std::uint32_t OffsetAllocator::getFreeSpace() const
+{
+    return m_freeSpace;
+}
+
+std::uint32_t OffsetAllocator::getLargestFreeRegion() const
+{
+    if (m_usedTopBins == 0)
+    {
+        return 0;
+    }
+
+    const auto topBin = 31 - std::countl_zero(m_usedTopBins);
+    const auto bin = 31 - std::countl_zero(static_cast<std::uint32_t>(m_usedBins[topBin]));
+
+    // the regions of one bin differ in size; the bin only tells the lower bound
+    std::uint32_t largestSize = 0;
+
+    for (auto nodeIndex = m_binHeads[topBin * BINS_PER_TOP_BIN + bin]; nodeIndex != NO_NODE; nodeIndex = m_nodes[nodeIndex].binNext)
+    {
+        largestSize = std::max(largestSize, m_nodes[nodeIndex].size);
+    }
+
+    return largestSize;
+}
+
+std::uint32_t OffsetAllocator::insertIntoBin(std::uint32_t size, std::uint32_t offset)
+{
+    // rounded down, so that every region in a bin is at least as big as the bin size
+    const auto binIndex = sizeToBin(size, false);
+    const auto topBin = binIndex / BINS_PER_TOP_BIN;
+    const auto bin = binIndex % BINS_PER_TOP_BIN;
+
+    if (m_binHeads[binIndex] == NO_NODE)
+    {
+        m_usedBins[topBin] |= 1 << bin;
+        m_usedTopBins |= 1u << topBin;
+    }
+
+    const auto head = m_binHeads[binIndex];
+    const auto nodeIndex = acquireNode();
+
+    m_nodes[nodeIndex] = {
+        .offset = offset,
+        .size = size,
+        .binPrevious = NO_NODE,
+        .binNext = head,
+        .neighbourPrevious = NO_NODE,
+        .neighbourNext = NO_NODE,
+        .isUsed = false
+    };
+
+    if (head != NO_NODE)
+    {
+        m_nodes[head].binPrevious = nodeIndex;
+    }
+
+    m_binHeads[binIndex] = nodeIndex;
+
+    m_freeSpace += size;
+
+    return nodeIndex;
+}
+
+void OffsetAllocator::removeFromBin(std::uint32_t nodeIndex)
+{
+    unlinkFromBin(nodeIndex);
+
+    m_freeSpace -= m_nodes[nodeIndex].size;
+
+    m_freeNodes.push_back(nodeIndex);
+}
+
+void OffsetAllocator::unlinkFromBin(std::uint32_t nodeIndex)
+{
+    auto& node = m_nodes[nodeIndex];
+
+    if (node.binPrevious != NO_NODE)
+    {
+        m_nodes[node.binPrevious].binNext = node.binNext;
+    }
+    else
+    {
+        // the head of its bin
+        const auto binIndex = sizeToBin(node.size, false);
+        const auto topBin = binIndex / BINS_PER_TOP_BIN;
+        const auto bin = binIndex % BINS_PER_TOP_BIN;
+
+        m_binHeads[binIndex] = node.binNext;
+
+        if (node.binNext == NO_NODE)
+        {
+            m_usedBins[topBin] &= ~(1 << bin);
+
+            if (m_usedBins[topBin] == 0)
+            {
+                m_usedTopBins &= ~(1u << topBin);
+            }
+        }
+    }
+
+    if (node.binNext != NO_NODE)
+    {
+        m_nodes[node.binNext].binPrevious = node.binPrevious;
+    }
+
+    node.binPrevious = NO_NODE;
+    node.binNext = NO_NODE;
+}
+
+std::uint32_t OffsetAllocator::acquireNode()
+{
+    if (m_freeNodes.empty())
+    {
+        m_nodes.push_back({});
+
+        return static_cast<std::uint32_t>(m_nodes.size() - 1);
+    }
+
+    const auto nodeIndex = m_freeNodes.back();
+    m_freeNodes.pop_back();
+
+    return nodeIndex;
+}
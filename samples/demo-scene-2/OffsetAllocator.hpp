@@ -0,0 +1,87 @@
+#pragma once
+
+#include "stdafx.hpp"
+
+/**
+ * Hands out ranges of a linear address space - offsets into a big GPU buffer - without touching the memory itself.
+ *
+ * Two-level segregated fit (TLSF): the free regions are kept in 256 size classes, eight linearly spaced classes per power
+ * of two, with a bit per class telling whether it has any free regions at all. Finding a region big enough is two bit scans,
+ * freeing one merges it with its free neighbours right away, so both are O(1) and the address space never ends up cut into
+ * pieces which are free but next to each other.
+ *
+ * The units are whatever the caller counts in - vertices, indices, bytes.
+ */
+class OffsetAllocator
+{
+public:
+    static constexpr std::uint32_t NO_SPACE = std::numeric_limits<std::uint32_t>::max();
+
+    struct Allocation
+    {
+        std::uint32_t offset = NO_SPACE;
+        // identifies the allocation for free()
+        std::uint32_t node = NO_SPACE;
+    };
+
+    explicit OffsetAllocator(std::uint32_t size);
+
+    // forgets all the allocations; the address space is one free region of the given size again
+    void reset(std::uint32_t size);
+
+    // offset is NO_SPACE if there is no free region big enough; zero-sized allocations are not allowed
+    Allocation allocate(std::uint32_t size);
+
+    void free(Allocation allocation);
+
+    std::uint32_t getAllocationSize(Allocation allocation) const;
+
+    std::uint32_t getSize() const;
+
+    std::uint32_t getFreeSpace() const;
+
+    // the biggest allocation which would succeed right now; less than getFreeSpace() when the free space is fragmented
+    std::uint32_t getLargestFreeRegion() const;
+
+protected:
+    static constexpr std::uint32_t NO_NODE = std::numeric_limits<std::uint32_t>::max();
+
+    static constexpr std::uint32_t TOP_BIN_COUNT = 32;
+    static constexpr std::uint32_t BINS_PER_TOP_BIN = 8;
+    static constexpr std::uint32_t BIN_COUNT = TOP_BIN_COUNT * BINS_PER_TOP_BIN;
+
+    // a region of the address space, either allocated or free; the free ones are also linked into the list of their size class
+    struct Node
+    {
+        std::uint32_t offset;
+        std::uint32_t size;
+
+        std::uint32_t binPrevious;
+        std::uint32_t binNext;
+
+        // the regions right before and after this one in the address space
+        std::uint32_t neighbourPrevious;
+        std::uint32_t neighbourNext;
+
+        bool isUsed;
+    };
+
+    std::uint32_t insertIntoBin(std::uint32_t size, std::uint32_t offset);
+
+    // also releases the node
+    void removeFromBin(std::uint32_t nodeIndex);
+
+    void unlinkFromBin(std::uint32_t nodeIndex);
+
+    std::uint32_t acquireNode();
+
+    std::uint32_t m_size;
+    std::uint32_t m_freeSpace;
+
+    std::uint32_t m_usedTopBins;
+    std::array<std::uint8_t, TOP_BIN_COUNT> m_usedBins;
+    std::array<std::uint32_t, BIN_COUNT> m_binHeads;
+
+    std::vector<Node> m_nodes;
+    std::vector<std::uint32_t> m_freeNodes;
+};
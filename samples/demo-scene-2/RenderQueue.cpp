@@ -0,0 +1,341 @@
+#include "RenderQueue.hpp"
+
+RenderStateCache::RenderStateCache() :
+    m_statistics({ 0, 0, 0 })
+{
+    invalidate();
+}
+
+void RenderStateCache::invalidate()
+{
+    invalidateProgram();
+
+    m_vertexArray = nullptr;
+    m_textures.fill(std::nullopt);
+    m_cullFaces.reset();
+}
+
+void RenderStateCache::invalidateProgram()
+{
+    m_program = nullptr;
+    m_transformationUniform = nullptr;
+}
+
+void RenderStateCache::useProgram(globjects::Program* program)
+{
+    if (!track(program == m_program))
+    {
+        return;
+    }
+
+    program->use();
+    m_program = program;
+
+    // uniform values are stored per-program
+    m_transformationUniform = nullptr;
+}
+
+void RenderStateCache::bindVertexArray(globjects::VertexArray* vertexArray)
+{
+    if (!track(vertexArray == m_vertexArray))
+    {
+        return;
+    }
+
+    vertexArray->bind();
+    m_vertexArray = vertexArray;
+}
+
+void RenderStateCache::bindTexture(unsigned int unit, globjects::Texture* texture)
+{
+    if (!track(m_textures[unit].has_value() && *m_textures[unit] == texture))
+    {
+        return;
+    }
+
+    if (texture != nullptr)
+    {
+        texture->bindActive(unit);
+    }
+    else if (m_textures[unit].has_value())
+    {
+        (*m_textures[unit])->unbindActive(unit);
+    }
+    else
+    {
+        // nothing is known about the unit - assume a regular 2D texture is bound
+        ::glActiveTexture(static_cast<::GLenum>(GL_TEXTURE0 + unit));
+        ::glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    m_textures[unit] = texture;
+}
+
+void RenderStateCache::setCullFaces(bool cullFaces)
+{
+    if (!track(m_cullFaces.has_value() && *m_cullFaces == cullFaces))
+    {
+        return;
+    }
+
+    if (cullFaces)
+    {
+        glEnable(GL_CULL_FACE);
+    }
+    else
+    {
+        glDisable(GL_CULL_FACE);
+    }
+
+    m_cullFaces = cullFaces;
+}
+
+void RenderStateCache::setTransformation(globjects::Uniform<glm::mat4>* uniform, const glm::mat4& transformation)
+{
+    if (!track(uniform == m_transformationUniform && transformation == m_transformation))
+    {
+        return;
+    }
+
+    uniform->set(transformation);
+
+    m_transformationUniform = uniform;
+    m_transformation = transformation;
+}
+
+void RenderStateCache::drawElements(const GeometryRange& range)
+{
+    // globjects::VertexArray::drawElementsBaseVertex() re-binds the VAO on every call, hence the raw call
+    gl::glDrawElementsBaseVertex(
+        static_cast<gl::GLenum>(GL_TRIANGLES),
+        static_cast<gl::GLsizei>(range.indexCount),
+        static_cast<gl::GLenum>(GL_UNSIGNED_INT),
+        reinterpret_cast<const void*>(range.firstIndex * sizeof(unsigned int)),
+        range.baseVertex);
+
+    ++m_statistics.drawCalls;
+}
+
+void RenderStateCache::reset()
+{
+    for (unsigned int unit = 0; unit < MAX_TEXTURE_UNITS; ++unit)
+    {
+        if (m_textures[unit].has_value() && *m_textures[unit] != nullptr)
+        {
+            (*m_textures[unit])->unbindActive(unit);
+        }
+    }
+
+    if (m_vertexArray != nullptr)
+    {
+        m_vertexArray->unbind();
+    }
+
+    if (m_program != nullptr)
+    {
+        m_program->release();
+    }
+
+    invalidate();
+}
+
+RenderStateCache::Statistics RenderStateCache::getStatistics() const
+{
+    return m_statistics;
+}
+
+void RenderStateCache::resetStatistics()
+{
+    m_statistics = { 0, 0, 0 };
+}
+
+bool RenderStateCache::track(bool isRedundant)
+{
+    if (isRedundant)
+    {
+        ++m_statistics.skippedStateChanges;
+        return false;
+    }
+
+    ++m_statistics.issuedStateChanges;
+    return true;
+}
+
+RenderQueue::RenderQueue() :
+    m_viewPosition(0.0f),
+    m_farPlane(1.0f),
+    m_isSorted(true)
+{
+}
+
+void RenderQueue::begin(glm::vec3 viewPosition, float farPlane)
+{
+    m_viewPosition = viewPosition;
+    m_farPlane = farPlane;
+
+    m_items.clear();
+    m_isSorted = false;
+}
+
+void RenderQueue::submit(unsigned int pass, const RenderMaterial& material, AbstractMesh* mesh, const glm::mat4& transformation)
+{
+    // meshes do not carry their bounds here, so the depth is measured to the model origin
+    const auto origin = glm::vec3(transformation[3]);
+
+    auto textures = material.textures;
+
+    // only the last texture of a mesh ends up being bound by AbstractMesh::bind(), so the same goes here
+    if (textures[MESH_TEXTURE_UNIT] == nullptr && !mesh->getTextures().empty())
+    {
+        textures[MESH_TEXTURE_UNIT] = mesh->getTextures().back();
+    }
+
+    m_items.push_back({
+        .key = makeKey(pass, material.program, textures, material.cullFaces, glm::length(origin - m_viewPosition)),
+        .program = material.program,
+        .transformationUniform = material.transformationUniform,
+        .textures = textures,
+        .cullFaces = material.cullFaces,
+        .mesh = mesh,
+        .transformation = transformation });
+
+    m_isSorted = false;
+}
+
+void RenderQueue::submit(unsigned int pass, const RenderMaterial& material, MultiMeshModel* model)
+{
+    for (auto& mesh : model->getMeshes())
+    {
+        submit(pass, material, mesh.get(), model->getTransformation());
+    }
+}
+
+void RenderQueue::submit(unsigned int pass, const RenderMaterial& material, SingleMeshModel* model)
+{
+    submit(pass, material, model->getMesh(), model->getTransformation());
+}
+
+void RenderQueue::flush(RenderStateCache& stateCache)
+{
+    sort();
+
+    render(m_sortedEntries.cbegin(), m_sortedEntries.cend(), stateCache);
+}
+
+void RenderQueue::flush(unsigned int pass, RenderStateCache& stateCache)
+{
+    PROFILE_FUNCTION();
+
+    sort();
+
+    // pass occupies the topmost bits of the key, so the items of a pass form a contiguous range
+    const auto begin = std::partition_point(m_sortedEntries.cbegin(), m_sortedEntries.cend(), [pass](const SortEntry& entry) { return (entry.key >> 60) < pass; });
+    const auto end = std::partition_point(begin, m_sortedEntries.cend(), [pass](const SortEntry& entry) { return (entry.key >> 60) == pass; });
+
+    render(begin, end, stateCache);
+}
+
+std::size_t RenderQueue::size() const
+{
+    return m_items.size();
+}
+
+std::uint64_t RenderQueue::makeKey(unsigned int pass, globjects::Program* program, const TextureSet& textures, bool cullFaces, float depth)
+{
+    // ids are handed out in the order programs and materials are first seen and are kept between frames
+    const auto programId = m_programIds.try_emplace(program, static_cast<std::uint64_t>(m_programIds.size())).first->second;
+    const auto materialId = m_materialIds.try_emplace(textures, static_cast<std::uint64_t>(m_materialIds.size())).first->second;
+
+    // front-to-back within the same state, so that early depth test rejects the most fragments
+    const auto quantizedDepth = static_cast<std::uint64_t>(std::clamp(depth / m_farPlane, 0.0f, 1.0f) * static_cast<float>(0xFFFFFF));
+
+    return (static_cast<std::uint64_t>(pass & 0xF) << 60) |
+        ((programId & 0xFFF) << 48) |
+        ((materialId & 0xFFFF) << 32) |
+        (static_cast<std::uint64_t>(cullFaces ? 1 : 0) << 31) |
+        (quantizedDepth << 7);
+}
+
+void RenderQueue::sort()
+{
+    PROFILE_FUNCTION();
+
+    if (m_isSorted)
+    {
+        return;
+    }
+
+    m_isSorted = true;
+
+    m_sortedEntries.resize(m_items.size());
+    m_scratchEntries.resize(m_items.size());
+
+    for (std::uint32_t i = 0; i < m_items.size(); ++i)
+    {
+        m_sortedEntries[i] = { m_items[i].key, i };
+    }
+
+    if (m_sortedEntries.size() < 2)
+    {
+        return;
+    }
+
+    for (unsigned int shift = 0; shift < 64; shift += 8)
+    {
+        std::array<std::size_t, 256> offsets {};
+
+        for (auto& entry : m_sortedEntries)
+        {
+            ++offsets[(entry.key >> shift) & 0xFF];
+        }
+
+        if (offsets[(m_sortedEntries[0].key >> shift) & 0xFF] == m_sortedEntries.size())
+        {
+            continue;
+        }
+
+        std::size_t offset = 0;
+
+        for (auto& count : offsets)
+        {
+            const auto bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+
+        for (auto& entry : m_sortedEntries)
+        {
+            m_scratchEntries[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+        }
+
+        std::swap(m_sortedEntries, m_scratchEntries);
+    }
+}
+
+void RenderQueue::render(std::vector<SortEntry>::const_iterator begin, std::vector<SortEntry>::const_iterator end, RenderStateCache& stateCache)
+{
+    // per-pass uniforms are set on the programs right before the flush
+    stateCache.invalidateProgram();
+
+    for (auto it = begin; it != end; ++it)
+    {
+        const auto& item = m_items[it->index];
+
+        stateCache.useProgram(item.program);
+        stateCache.setCullFaces(item.cullFaces);
+
+        for (unsigned int unit = 0; unit < RenderStateCache::MAX_TEXTURE_UNITS; ++unit)
+        {
+            stateCache.bindTexture(unit, item.textures[unit]);
+        }
+
+        stateCache.bindVertexArray(item.mesh->getVertexArray());
+
+        if (item.transformationUniform != nullptr)
+        {
+            stateCache.setTransformation(item.transformationUniform, item.transformation);
+        }
+
+        stateCache.drawElements(item.mesh->getGeometryRange());
+    }
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "stdafx.hpp"
+
+#include "Mesh.hpp"
+
+// shadow copy of the GL state the render queue touches; GL calls are only issued when the state actually changes
+class RenderStateCache
+{
+public:
+    static constexpr unsigned int MAX_TEXTURE_UNITS = 4;
+
+    struct Statistics
+    {
+        unsigned int issuedStateChanges;
+        unsigned int skippedStateChanges;
+        unsigned int drawCalls;
+    };
+
+    RenderStateCache();
+
+    // forget everything known about the GL state; must be called whenever the state was changed bypassing the cache
+    void invalidate();
+
+    // globjects binds the program itself when setting uniforms on contexts without ARB_separate_shader_objects
+    void invalidateProgram();
+
+    void useProgram(globjects::Program* program);
+
+    void bindVertexArray(globjects::VertexArray* vertexArray);
+
+    // nullptr unbinds the texture unit
+    void bindTexture(unsigned int unit, globjects::Texture* texture);
+
+    void setCullFaces(bool cullFaces);
+
+    void setTransformation(globjects::Uniform<glm::mat4>* uniform, const glm::mat4& transformation);
+
+    void drawElements(const GeometryRange& range);
+
+    // unbinds everything which was bound through the cache, so that the code outside of it finds GL in its default state
+    void reset();
+
+    Statistics getStatistics() const;
+
+    void resetStatistics();
+
+protected:
+    // returns true if the state change has to be issued
+    bool track(bool isRedundant);
+
+    globjects::Program* m_program;
+    globjects::VertexArray* m_vertexArray;
+    // std::nullopt stands for an unknown state
+    std::array<std::optional<globjects::Texture*>, MAX_TEXTURE_UNITS> m_textures;
+    std::optional<bool> m_cullFaces;
+
+    globjects::Uniform<glm::mat4>* m_transformationUniform;
+    glm::mat4 m_transformation;
+
+    Statistics m_statistics;
+};
+
+// everything, except for the geometry, which is needed to issue a draw call
+struct RenderMaterial
+{
+    globjects::Program* program;
+
+    // model transformation uniform of the program above; nullptr if the program does not have one
+    globjects::Uniform<glm::mat4>* transformationUniform = nullptr;
+
+    // textures bound on top of the mesh' own (diffuse) texture, indexed by the texture unit; the units left empty are unbound
+    std::array<globjects::Texture*, RenderStateCache::MAX_TEXTURE_UNITS> textures = {};
+
+    bool cullFaces = true;
+};
+
+// collects the draw items of a frame (or a pass), sorts them by a 64-bit key and renders them with as few state changes as possible
+class RenderQueue
+{
+public:
+    // texture unit the meshes bind their own textures to (see AbstractMesh::bind())
+    static constexpr unsigned int MESH_TEXTURE_UNIT = 1;
+
+    RenderQueue();
+
+    // drops the items of the previous frame; depth in the sort keys is measured from the view position and normalized by the far plane
+    void begin(glm::vec3 viewPosition, float farPlane);
+
+    void submit(unsigned int pass, const RenderMaterial& material, AbstractMesh* mesh, const glm::mat4& transformation);
+
+    void submit(unsigned int pass, const RenderMaterial& material, MultiMeshModel* model);
+
+    void submit(unsigned int pass, const RenderMaterial& material, SingleMeshModel* model);
+
+    // sorts the submitted items and renders all of them in order; the items stay in the queue until the next begin()
+    void flush(RenderStateCache& stateCache);
+
+    // same as above, but only renders the items of a single pass - for passes rendering to different framebuffers
+    void flush(unsigned int pass, RenderStateCache& stateCache);
+
+    std::size_t size() const;
+
+protected:
+    using TextureSet = std::array<globjects::Texture*, RenderStateCache::MAX_TEXTURE_UNITS>;
+
+    struct RenderItem
+    {
+        std::uint64_t key;
+
+        globjects::Program* program;
+        globjects::Uniform<glm::mat4>* transformationUniform;
+        TextureSet textures;
+        bool cullFaces;
+
+        AbstractMesh* mesh;
+        glm::mat4 transformation;
+    };
+
+    struct SortEntry
+    {
+        std::uint64_t key;
+        std::uint32_t index;
+    };
+
+    // key layout, from the most significant bits: pass (4 bits), program (12 bits), material (16 bits), cull state (1 bit), depth (24 bits);
+    // the lowest 7 bits are unused
+    std::uint64_t makeKey(unsigned int pass, globjects::Program* program, const TextureSet& textures, bool cullFaces, float depth);
+
+    // LSD radix sort, one byte per pass; bytes shared by all the keys (most of them, usually) are skipped entirely
+    void sort();
+
+    void render(std::vector<SortEntry>::const_iterator begin, std::vector<SortEntry>::const_iterator end, RenderStateCache& stateCache);
+
+    glm::vec3 m_viewPosition;
+    float m_farPlane;
+
+    std::vector<RenderItem> m_items;
+    std::vector<SortEntry> m_sortedEntries;
+    std::vector<SortEntry> m_scratchEntries;
+    bool m_isSorted;
+
+    std::unordered_map<globjects::Program*, std::uint64_t> m_programIds;
+    std::map<TextureSet, std::uint64_t> m_materialIds;
+};
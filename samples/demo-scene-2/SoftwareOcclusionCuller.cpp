@@ -0,0 +1,496 @@
+#include "SoftwareOcclusionCuller.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    float millisecondsSince(std::chrono::high_resolution_clock::time_point start)
+    {
+        return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+}
+
+SoftwareOcclusionCuller::SoftwareOcclusionCuller(int width, int height, unsigned int workerCount) :
+    m_width(((width + TILE_WIDTH - 1) / TILE_WIDTH) * TILE_WIDTH),
+    m_height(((height + TILE_HEIGHT - 1) / TILE_HEIGHT) * TILE_HEIGHT),
+    m_tilesX(m_width / TILE_WIDTH),
+    m_tilesY(m_height / TILE_HEIGHT),
+    m_blocksX(m_width / BLOCK_WIDTH),
+    m_blocksY(m_height / BLOCK_HEIGHT),
+    m_viewProjection(1.0f),
+    m_depthBuffer(m_width * m_height, 1.0f),
+    m_blockMaxDepth(m_blocksX * m_blocksY, 1.0f),
+    m_tileBins(m_tilesX * m_tilesY),
+    m_isStopping(false),
+    m_generation(0),
+    m_finishedWorkers(0),
+    m_nextTile(0)
+{
+    resetStatistics();
+
+    for (unsigned int i = 0; i < workerCount; ++i)
+    {
+        m_workers.emplace_back(&SoftwareOcclusionCuller::workerLoop, this);
+    }
+}
+
+SoftwareOcclusionCuller::~SoftwareOcclusionCuller()
+{
+    {
+        std::lock_guard<PROFILE_LOCK_TYPE(std::mutex)> lock(m_mutex);
+        m_isStopping = true;
+    }
+
+    m_hasWork.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+void SoftwareOcclusionCuller::addOccluder(std::vector<glm::vec3> positions, std::vector<unsigned int> indices, const glm::mat4& transformation)
+{
+    m_occluders.push_back({ .positions = std::move(positions), .indices = std::move(indices), .transformation = transformation });
+}
+
+void SoftwareOcclusionCuller::clearOccluders()
+{
+    m_occluders.clear();
+}
+
+void SoftwareOcclusionCuller::render(const glm::mat4& viewProjection)
+{
+    PROFILE_FUNCTION();
+
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    m_viewProjection = viewProjection;
+
+    m_triangles.clear();
+
+    for (auto& bin : m_tileBins)
+    {
+        bin.clear();
+    }
+
+    std::vector<glm::vec4> clipPositions;
+
+    for (const auto& occluder : m_occluders)
+    {
+        const auto transformation = viewProjection * occluder.transformation;
+
+        clipPositions.resize(occluder.positions.size());
+
+        for (std::size_t i = 0; i < occluder.positions.size(); ++i)
+        {
+            clipPositions[i] = transformation * glm::vec4(occluder.positions[i], 1.0f);
+        }
+
+        for (std::size_t i = 0; i + 2 < occluder.indices.size(); i += 3)
+        {
+            setupTriangle(clipPositions[occluder.indices[i]], clipPositions[occluder.indices[i + 1]], clipPositions[occluder.indices[i + 2]]);
+        }
+
+        m_statistics.occluderTriangles += static_cast<unsigned int>(occluder.indices.size() / 3);
+    }
+
+    m_statistics.rasterizedTriangles += static_cast<unsigned int>(m_triangles.size());
+
+    // binning goes in the submission order, so every tile sees its triangles in the same order, whichever thread gets it
+    for (unsigned int triangleIndex = 0; triangleIndex < m_triangles.size(); ++triangleIndex)
+    {
+        const auto& triangle = m_triangles[triangleIndex];
+
+        for (int tileY = triangle.boundsMin.y / TILE_HEIGHT; tileY <= triangle.boundsMax.y / TILE_HEIGHT; ++tileY)
+        {
+            for (int tileX = triangle.boundsMin.x / TILE_WIDTH; tileX <= triangle.boundsMax.x / TILE_WIDTH; ++tileX)
+            {
+                m_tileBins[tileY * m_tilesX + tileX].push_back(triangleIndex);
+            }
+        }
+    }
+
+    {
+        std::lock_guard<PROFILE_LOCK_TYPE(std::mutex)> lock(m_mutex);
+
+        m_nextTile = 0;
+        m_finishedWorkers = 0;
+        ++m_generation;
+    }
+
+    m_hasWork.notify_all();
+
+    // the calling thread takes its share of the tiles too
+    rasterizeTiles();
+
+    {
+        std::unique_lock<PROFILE_LOCK_TYPE(std::mutex)> lock(m_mutex);
+
+        m_isWorkDone.wait(lock, [this]() { return m_finishedWorkers == m_workers.size(); });
+    }
+
+    m_statistics.rasterizationTime += millisecondsSince(start);
+}
+
+bool SoftwareOcclusionCuller::isVisible(glm::vec3 boundsMin, glm::vec3 boundsMax, const glm::mat4& transformation)
+{
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    ++m_statistics.testedObjects;
+
+    const auto finish = [&](bool isVisible) {
+        m_statistics.culledObjects += isVisible ? 0 : 1;
+        m_statistics.testTime += millisecondsSince(start);
+
+        return isVisible;
+    };
+
+    const auto clipTransformation = m_viewProjection * transformation;
+
+    glm::vec2 screenMin(std::numeric_limits<float>::max());
+    glm::vec2 screenMax(std::numeric_limits<float>::lowest());
+    float closestDepth = std::numeric_limits<float>::max();
+
+    for (int i = 0; i < 8; ++i)
+    {
+        const glm::vec3 corner((i & 1) ? boundsMax.x : boundsMin.x, (i & 2) ? boundsMax.y : boundsMin.y, (i & 4) ? boundsMax.z : boundsMin.z);
+        const auto clip = clipTransformation * glm::vec4(corner, 1.0f);
+
+        // the box crosses the near plane, the camera is (almost) inside it
+        if (clip.z < -clip.w || clip.w <= 0.0f)
+        {
+            return finish(true);
+        }
+
+        const auto ndc = glm::vec3(clip) / clip.w;
+
+        screenMin = glm::min(screenMin, glm::vec2(ndc));
+        screenMax = glm::max(screenMax, glm::vec2(ndc));
+        closestDepth = std::min(closestDepth, ndc.z * 0.5f + 0.5f);
+    }
+
+    if (screenMax.x < -1.0f || screenMax.y < -1.0f || screenMin.x > 1.0f || screenMin.y > 1.0f)
+    {
+        return finish(false);
+    }
+
+    // every pixel the box touches, even partially
+    const glm::ivec2 pixelMin = glm::clamp(glm::ivec2(glm::floor((screenMin * 0.5f + 0.5f) * glm::vec2(m_width, m_height))), glm::ivec2(0), glm::ivec2(m_width - 1, m_height - 1));
+    const glm::ivec2 pixelMax = glm::clamp(glm::ivec2(glm::floor((screenMax * 0.5f + 0.5f) * glm::vec2(m_width, m_height))), glm::ivec2(0), glm::ivec2(m_width - 1, m_height - 1));
+
+    for (int blockY = pixelMin.y / BLOCK_HEIGHT; blockY <= pixelMax.y / BLOCK_HEIGHT; ++blockY)
+    {
+        for (int blockX = pixelMin.x / BLOCK_WIDTH; blockX <= pixelMax.x / BLOCK_WIDTH; ++blockX)
+        {
+            // the whole block is in front of the box
+            if (m_blockMaxDepth[blockY * m_blocksX + blockX] < closestDepth)
+            {
+                continue;
+            }
+
+            const int x0 = std::max(pixelMin.x, blockX * BLOCK_WIDTH);
+            const int x1 = std::min(pixelMax.x, blockX * BLOCK_WIDTH + BLOCK_WIDTH - 1);
+            const int y0 = std::max(pixelMin.y, blockY * BLOCK_HEIGHT);
+            const int y1 = std::min(pixelMax.y, blockY * BLOCK_HEIGHT + BLOCK_HEIGHT - 1);
+
+            for (int y = y0; y <= y1; ++y)
+            {
+                for (int x = x0; x <= x1; ++x)
+                {
+                    if (m_depthBuffer[y * m_width + x] >= closestDepth)
+                    {
+                        return finish(true);
+                    }
+                }
+            }
+        }
+    }
+
+    return finish(false);
+}
+
+int SoftwareOcclusionCuller::getWidth() const
+{
+    return m_width;
+}
+
+int SoftwareOcclusionCuller::getHeight() const
+{
+    return m_height;
+}
+
+const std::vector<float>& SoftwareOcclusionCuller::getDepthBuffer() const
+{
+    return m_depthBuffer;
+}
+
+SoftwareOcclusionCuller::Statistics SoftwareOcclusionCuller::getStatistics() const
+{
+    return m_statistics;
+}
+
+void SoftwareOcclusionCuller::resetStatistics()
+{
+    m_statistics = { 0, 0, 0, 0, 0.0f, 0.0f };
+}
+
+void SoftwareOcclusionCuller::setupTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c)
+{
+    // distances to the near plane (z = -w in the OpenGL clip space), positive in front of it
+    const std::array<glm::vec4, 3> vertices = { a, b, c };
+    const std::array<float, 3> distances = { a.z + a.w, b.z + b.w, c.z + c.w };
+
+    if (distances[0] >= 0.0f && distances[1] >= 0.0f && distances[2] >= 0.0f)
+    {
+        setupClippedTriangle(a, b, c);
+        return;
+    }
+
+    // Sutherland-Hodgman against a single plane: a triangle turns into at most a quad
+    std::array<glm::vec4, 4> polygon;
+    int polygonSize = 0;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        const int next = (i + 1) % 3;
+
+        if (distances[i] >= 0.0f)
+        {
+            polygon[polygonSize++] = vertices[i];
+        }
+
+        if ((distances[i] >= 0.0f) != (distances[next] >= 0.0f))
+        {
+            const float t = distances[i] / (distances[i] - distances[next]);
+
+            polygon[polygonSize++] = glm::mix(vertices[i], vertices[next], t);
+        }
+    }
+
+    for (int i = 1; i + 1 < polygonSize; ++i)
+    {
+        setupClippedTriangle(polygon[0], polygon[i], polygon[i + 1]);
+    }
+}
+
+void SoftwareOcclusionCuller::setupClippedTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c)
+{
+    const auto toScreen = [this](const glm::vec4& clip) {
+        const auto ndc = glm::vec3(clip) / clip.w;
+
+        return glm::vec3((ndc.x * 0.5f + 0.5f) * static_cast<float>(m_width), (ndc.y * 0.5f + 0.5f) * static_cast<float>(m_height), ndc.z * 0.5f + 0.5f);
+    };
+
+    std::array<glm::vec3, 3> vertices = { toScreen(a), toScreen(b), toScreen(c) };
+
+    const auto edgeFunction = [](const glm::vec3& from, const glm::vec3& to) {
+        return glm::vec3(from.y - to.y, to.x - from.x, from.x * to.y - from.y * to.x);
+    };
+
+    float area = glm::dot(edgeFunction(vertices[0], vertices[1]), glm::vec3(vertices[2].x, vertices[2].y, 1.0f));
+
+    // occluders are drawn double-sided; the edge functions are set up for the counter-clockwise order
+    if (area < 0.0f)
+    {
+        std::swap(vertices[1], vertices[2]);
+        area = -area;
+    }
+
+    if (area <= 0.0f)
+    {
+        return;
+    }
+
+    // pixel centers are at +0.5, so the pixels possibly covered are the ones whose centers are within the bounds
+    const glm::vec2 minimum = glm::min(glm::min(glm::vec2(vertices[0]), glm::vec2(vertices[1])), glm::vec2(vertices[2]));
+    const glm::vec2 maximum = glm::max(glm::max(glm::vec2(vertices[0]), glm::vec2(vertices[1])), glm::vec2(vertices[2]));
+
+    Triangle triangle;
+
+    triangle.boundsMin = glm::max(glm::ivec2(glm::ceil(minimum - 0.5f)), glm::ivec2(0));
+    triangle.boundsMax = glm::min(glm::ivec2(glm::floor(maximum - 0.5f)), glm::ivec2(m_width - 1, m_height - 1));
+
+    if (triangle.boundsMin.x > triangle.boundsMax.x || triangle.boundsMin.y > triangle.boundsMax.y)
+    {
+        return;
+    }
+
+    glm::vec3 depth(0.0f);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        const auto& from = vertices[(i + 1) % 3];
+        const auto& to = vertices[(i + 2) % 3];
+
+        // edge i is the one opposite to vertex i, so it weights the depth of vertex i
+        triangle.edges[i] = edgeFunction(from, to);
+
+        // with Y pointing up, the left edges go down and the top ones go left
+        const bool isTopLeft = (to.y < from.y) || (to.y == from.y && to.x < from.x);
+
+        triangle.edgeBias[i] = isTopLeft ? 0.0f : std::numeric_limits<float>::min();
+
+        depth += triangle.edges[i] * vertices[i].z;
+    }
+
+    triangle.depth = depth / area;
+
+    m_triangles.push_back(triangle);
+}
+
+void SoftwareOcclusionCuller::rasterizeTiles()
+{
+    PROFILE_FUNCTION();
+
+    const int tileCount = m_tilesX * m_tilesY;
+
+    for (int tile = m_nextTile.fetch_add(1); tile < tileCount; tile = m_nextTile.fetch_add(1))
+    {
+        rasterizeTile(tile);
+    }
+}
+
+void SoftwareOcclusionCuller::rasterizeTile(int tile)
+{
+    const glm::ivec2 tileMin((tile % m_tilesX) * TILE_WIDTH, (tile / m_tilesX) * TILE_HEIGHT);
+    const glm::ivec2 tileMax = tileMin + glm::ivec2(TILE_WIDTH - 1, TILE_HEIGHT - 1);
+
+    for (int y = tileMin.y; y <= tileMax.y; ++y)
+    {
+        std::fill_n(m_depthBuffer.begin() + y * m_width + tileMin.x, TILE_WIDTH, 1.0f);
+    }
+
+    for (auto triangleIndex : m_tileBins[tile])
+    {
+        const auto& triangle = m_triangles[triangleIndex];
+
+        const auto boundsMin = glm::max(triangle.boundsMin, tileMin);
+        const auto boundsMax = glm::min(triangle.boundsMax, tileMax);
+
+        // eight pixels at a time; the tile width is a multiple of eight, so the groups never cross the tile edge
+        const int groupStart = tileMin.x + ((boundsMin.x - tileMin.x) / 8) * 8;
+
+        for (int y = boundsMin.y; y <= boundsMax.y; ++y)
+        {
+            const float pixelY = static_cast<float>(y) + 0.5f;
+
+            float* row = m_depthBuffer.data() + y * m_width;
+
+#if defined(__AVX2__)
+            const __m256 laneOffsets = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+
+            // the part of each plane equation which is constant along the row
+            std::array<__m256, 3> edgeA, edgeRow, edgeBias;
+
+            for (int i = 0; i < 3; ++i)
+            {
+                edgeA[i] = _mm256_set1_ps(triangle.edges[i].x);
+                edgeRow[i] = _mm256_set1_ps(triangle.edges[i].y * pixelY + triangle.edges[i].z);
+                edgeBias[i] = _mm256_set1_ps(triangle.edgeBias[i]);
+            }
+
+            const __m256 depthA = _mm256_set1_ps(triangle.depth.x);
+            const __m256 depthRow = _mm256_set1_ps(triangle.depth.y * pixelY + triangle.depth.z);
+
+            for (int x = groupStart; x <= boundsMax.x; x += 8)
+            {
+                const __m256 pixelX = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), laneOffsets);
+
+                __m256 mask = _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(edgeA[0], pixelX), edgeRow[0]), edgeBias[0], _CMP_GE_OQ);
+                mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(edgeA[1], pixelX), edgeRow[1]), edgeBias[1], _CMP_GE_OQ));
+                mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(edgeA[2], pixelX), edgeRow[2]), edgeBias[2], _CMP_GE_OQ));
+
+                if (_mm256_movemask_ps(mask) == 0)
+                {
+                    continue;
+                }
+
+                const __m256 depth = _mm256_add_ps(_mm256_mul_ps(depthA, pixelX), depthRow);
+                const __m256 previousDepth = _mm256_loadu_ps(row + x);
+
+                _mm256_storeu_ps(row + x, _mm256_blendv_ps(previousDepth, _mm256_min_ps(previousDepth, depth), mask));
+            }
+#else
+            std::array<float, 3> edgeRow;
+
+            for (int i = 0; i < 3; ++i)
+            {
+                edgeRow[i] = triangle.edges[i].y * pixelY + triangle.edges[i].z;
+            }
+
+            const float depthRow = triangle.depth.y * pixelY + triangle.depth.z;
+
+            for (int x = groupStart; x <= boundsMax.x; x += 8)
+            {
+                // same eight lanes as the AVX2 version, left for the compiler to vectorize
+                for (int lane = 0; lane < 8; ++lane)
+                {
+                    const float pixelX = static_cast<float>(x + lane) + 0.5f;
+
+                    const bool isInside =
+                        triangle.edges[0].x * pixelX + edgeRow[0] >= triangle.edgeBias[0] &&
+                        triangle.edges[1].x * pixelX + edgeRow[1] >= triangle.edgeBias[1] &&
+                        triangle.edges[2].x * pixelX + edgeRow[2] >= triangle.edgeBias[2];
+
+                    const float depth = triangle.depth.x * pixelX + depthRow;
+
+                    row[x + lane] = isInside ? std::min(row[x + lane], depth) : row[x + lane];
+                }
+            }
+#endif
+        }
+    }
+
+    // the farthest depth of every block within the tile
+    for (int blockY = tileMin.y / BLOCK_HEIGHT; blockY <= tileMax.y / BLOCK_HEIGHT; ++blockY)
+    {
+        for (int blockX = tileMin.x / BLOCK_WIDTH; blockX <= tileMax.x / BLOCK_WIDTH; ++blockX)
+        {
+            float maxDepth = 0.0f;
+
+            for (int y = blockY * BLOCK_HEIGHT; y < (blockY + 1) * BLOCK_HEIGHT; ++y)
+            {
+                for (int x = blockX * BLOCK_WIDTH; x < (blockX + 1) * BLOCK_WIDTH; ++x)
+                {
+                    maxDepth = std::max(maxDepth, m_depthBuffer[y * m_width + x]);
+                }
+            }
+
+            m_blockMaxDepth[blockY * m_blocksX + blockX] = maxDepth;
+        }
+    }
+}
+
+void SoftwareOcclusionCuller::workerLoop()
+{
+    unsigned int generation = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<PROFILE_LOCK_TYPE(std::mutex)> lock(m_mutex);
+
+            m_hasWork.wait(lock, [this, generation]() { return m_isStopping || m_generation != generation; });
+
+            if (m_isStopping)
+            {
+                return;
+            }
+
+            generation = m_generation;
+        }
+
+        rasterizeTiles();
+
+        {
+            std::lock_guard<PROFILE_LOCK_TYPE(std::mutex)> lock(m_mutex);
+
+            ++m_finishedWorkers;
+        }
+
+        m_isWorkDone.notify_one();
+    }
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "stdafx.hpp"
+
+/**
+ * Occlusion culling on the CPU: a handful of occluder meshes is rasterized into a small depth buffer, then the bounding
+ * boxes of the objects are tested against it before they are even submitted for rendering.
+ *
+ * The depth buffer is split into tiles, rasterized in parallel by a pool of worker threads (each tile by a single thread,
+ * so the result does not depend on the number of threads); pixels are processed eight at a time with half-space edge
+ * functions - with AVX2 when the compiler targets it, with plain scalar code otherwise.
+ *
+ * On top of the depth buffer there is a conservative hierarchy: the farthest depth of every 8x4 pixel block, so most of
+ * the box tests never look at the individual pixels.
+ *
+ * Does not issue any GL calls, so it works without a GL context - tools/micro-benchmarks checks and measures it that way.
+ */
+class SoftwareOcclusionCuller
+{
+public:
+    static constexpr int DEFAULT_WIDTH = 256;
+    static constexpr int DEFAULT_HEIGHT = 128;
+
+    static constexpr int TILE_WIDTH = 64;
+    static constexpr int TILE_HEIGHT = 16;
+
+    static constexpr int BLOCK_WIDTH = 8;
+    static constexpr int BLOCK_HEIGHT = 4;
+
+    struct Statistics
+    {
+        unsigned int occluderTriangles;
+        // the ones which ended up on the screen, after the near plane clipping
+        unsigned int rasterizedTriangles;
+        unsigned int testedObjects;
+        unsigned int culledObjects;
+        // milliseconds
+        float rasterizationTime;
+        float testTime;
+    };
+
+    // the size is rounded up to whole tiles
+    SoftwareOcclusionCuller(int width = DEFAULT_WIDTH, int height = DEFAULT_HEIGHT, unsigned int workerCount = 3);
+
+    ~SoftwareOcclusionCuller();
+
+    void addOccluder(std::vector<glm::vec3> positions, std::vector<unsigned int> indices, const glm::mat4& transformation);
+
+    void clearOccluders();
+
+    // rasterizes all the occluders as seen through `viewProjection` (OpenGL clip space) and builds the depth hierarchy
+    void render(const glm::mat4& viewProjection);
+
+    // false if the box (in model space, `transformation` takes it to the world space) is hidden behind the occluders or is off the screen
+    bool isVisible(glm::vec3 boundsMin, glm::vec3 boundsMax, const glm::mat4& transformation);
+
+    int getWidth() const;
+
+    int getHeight() const;
+
+    // window space depth of the occluders, row by row from the bottom one; 1 where there are no occluders
+    const std::vector<float>& getDepthBuffer() const;
+
+    Statistics getStatistics() const;
+
+    void resetStatistics();
+
+protected:
+    struct Occluder
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<unsigned int> indices;
+        glm::mat4 transformation;
+    };
+
+    // a screen space triangle set up for the rasterization: inside is where all the edge functions are at least their bias
+    struct Triangle
+    {
+        std::array<glm::vec3, 3> edges; // a * x + b * y + c
+        std::array<float, 3> edgeBias; // 0 for the top-left edges, smallest positive float for the rest - so shared edges are drawn once
+        glm::vec3 depth; // depth plane, a * x + b * y + c
+        glm::ivec2 boundsMin;
+        glm::ivec2 boundsMax; // inclusive
+    };
+
+    // clips the triangle by the near plane and sets up the (up to two) resulting triangles
+    void setupTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+
+    void setupClippedTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+
+    void rasterizeTiles();
+
+    void rasterizeTile(int tile);
+
+    void workerLoop();
+
+    int m_width;
+    int m_height;
+    int m_tilesX;
+    int m_tilesY;
+    int m_blocksX;
+    int m_blocksY;
+
+    std::vector<Occluder> m_occluders;
+
+    glm::mat4 m_viewProjection;
+
+    std::vector<float> m_depthBuffer;
+    std::vector<float> m_blockMaxDepth;
+
+    std::vector<Triangle> m_triangles;
+    std::vector<std::vector<unsigned int>> m_tileBins;
+
+    std::vector<std::thread> m_workers;
+
+    PROFILE_LOCKABLE(std::mutex, m_mutex, "SoftwareOcclusionCuller::m_mutex");
+    profiling::ConditionVariable m_hasWork;
+    profiling::ConditionVariable m_isWorkDone;
+    bool m_isStopping;
+    unsigned int m_generation;
+    unsigned int m_finishedWorkers;
+    std::atomic<int> m_nextTile;
+
+    Statistics m_statistics;
+};
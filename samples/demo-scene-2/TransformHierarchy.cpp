@@ -0,0 +1,260 @@
+#include "TransformHierarchy.hpp"
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+    // same as glm::translate(translation) * glm::mat4_cast(rotation) * glm::scale(scale), without the two matrix products
+    glm::mat4 composeMatrix(const Transform& transform)
+    {
+        const auto rotation = glm::mat3_cast(transform.rotation);
+
+        return glm::mat4(
+            glm::vec4(rotation[0] * transform.scale.x, 0.0f),
+            glm::vec4(rotation[1] * transform.scale.y, 0.0f),
+            glm::vec4(rotation[2] * transform.scale.z, 0.0f),
+            glm::vec4(transform.translation, 1.0f));
+    }
+
+    // result = a * b; every column of the result is a linear combination of the columns of `a`
+    void multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& result)
+    {
+#if defined(__SSE__) || defined(_M_X64)
+        const __m128 a0 = _mm_loadu_ps(&a[0][0]);
+        const __m128 a1 = _mm_loadu_ps(&a[1][0]);
+        const __m128 a2 = _mm_loadu_ps(&a[2][0]);
+        const __m128 a3 = _mm_loadu_ps(&a[3][0]);
+
+        for (int column = 0; column < 4; ++column)
+        {
+            __m128 sum = _mm_mul_ps(a0, _mm_set1_ps(b[column][0]));
+            sum = _mm_add_ps(sum, _mm_mul_ps(a1, _mm_set1_ps(b[column][1])));
+            sum = _mm_add_ps(sum, _mm_mul_ps(a2, _mm_set1_ps(b[column][2])));
+            sum = _mm_add_ps(sum, _mm_mul_ps(a3, _mm_set1_ps(b[column][3])));
+
+            _mm_storeu_ps(&result[column][0], sum);
+        }
+#else
+        result = a * b;
+#endif
+    }
+}
+
+TransformHierarchy::TransformHierarchy() :
+    m_levelStarts({ 0 }),
+    m_firstDirtyLevel(0),
+    m_lastDirtyLevel(0),
+    m_isDirty(false),
+    m_updateGeneration(0),
+    m_updatedNodeCount(0)
+{
+}
+
+TransformHierarchy::Node TransformHierarchy::createNode(const Transform& localTransform, Node parent)
+{
+    const std::uint32_t parentIndex = parent == NO_PARENT ? NO_PARENT : m_nodeIndices[parent];
+    const std::uint32_t level = parent == NO_PARENT ? 0 : getLevel(parentIndex) + 1;
+
+    if (level + 1 == m_levelStarts.size())
+    {
+        m_levelStarts.push_back(m_levelStarts.back());
+    }
+
+    // at the end of its level; everything after it moves one position further
+    const std::uint32_t index = m_levelStarts[level + 1];
+
+    for (auto& nodeIndex : m_nodeIndices)
+    {
+        if (nodeIndex >= index)
+        {
+            ++nodeIndex;
+        }
+    }
+
+    for (auto& otherParentIndex : m_parentIndices)
+    {
+        if (otherParentIndex != NO_PARENT && otherParentIndex >= index)
+        {
+            ++otherParentIndex;
+        }
+    }
+
+    for (auto i = level + 1; i < m_levelStarts.size(); ++i)
+    {
+        ++m_levelStarts[i];
+    }
+
+    const auto node = static_cast<Node>(m_nodeIndices.size());
+
+    m_nodeIndices.push_back(index);
+
+    m_nodes.insert(m_nodes.begin() + index, node);
+    m_parentIndices.insert(m_parentIndices.begin() + index, parentIndex);
+    m_localTransforms.insert(m_localTransforms.begin() + index, localTransform);
+    m_worldMatrices.insert(m_worldMatrices.begin() + index, glm::mat4(1.0f));
+    m_isLocalTransformDirty.insert(m_isLocalTransformDirty.begin() + index, 0);
+    m_updateGenerations.insert(m_updateGenerations.begin() + index, 0);
+
+    markDirty(index);
+
+    return node;
+}
+
+void TransformHierarchy::setLocalTransform(Node node, const Transform& localTransform)
+{
+    const auto index = m_nodeIndices[node];
+
+    m_localTransforms[index] = localTransform;
+
+    markDirty(index);
+}
+
+void TransformHierarchy::setTranslation(Node node, glm::vec3 translation)
+{
+    const auto index = m_nodeIndices[node];
+
+    m_localTransforms[index].translation = translation;
+
+    markDirty(index);
+}
+
+void TransformHierarchy::setRotation(Node node, glm::quat rotation)
+{
+    const auto index = m_nodeIndices[node];
+
+    m_localTransforms[index].rotation = rotation;
+
+    markDirty(index);
+}
+
+void TransformHierarchy::setScale(Node node, glm::vec3 scale)
+{
+    const auto index = m_nodeIndices[node];
+
+    m_localTransforms[index].scale = scale;
+
+    markDirty(index);
+}
+
+const Transform& TransformHierarchy::getLocalTransform(Node node) const
+{
+    return m_localTransforms[m_nodeIndices[node]];
+}
+
+TransformHierarchy::Node TransformHierarchy::getParent(Node node) const
+{
+    const auto parentIndex = m_parentIndices[m_nodeIndices[node]];
+
+    return parentIndex == NO_PARENT ? NO_PARENT : m_nodes[parentIndex];
+}
+
+const glm::mat4& TransformHierarchy::getWorldMatrix(Node node) const
+{
+    return m_worldMatrices[m_nodeIndices[node]];
+}
+
+bool TransformHierarchy::isUpdated(Node node) const
+{
+    return m_updateGenerations[m_nodeIndices[node]] == m_updateGeneration;
+}
+
+void TransformHierarchy::update()
+{
+    ++m_updateGeneration;
+    m_updatedNodeCount = 0;
+
+    if (!m_isDirty)
+    {
+        return;
+    }
+
+    PROFILE_FUNCTION();
+
+    for (auto level = m_firstDirtyLevel; level + 1 < m_levelStarts.size(); ++level)
+    {
+        // a node is updated if it was changed itself or if its parent was just updated
+        m_batch.clear();
+
+        for (auto index = m_levelStarts[level]; index < m_levelStarts[level + 1]; ++index)
+        {
+            const auto parentIndex = m_parentIndices[index];
+
+            if (m_isLocalTransformDirty[index] || (parentIndex != NO_PARENT && m_updateGenerations[parentIndex] == m_updateGeneration))
+            {
+                m_batch.push_back(index);
+            }
+        }
+
+        if (m_batch.empty())
+        {
+            // nothing changed on this level, so nothing below it changes either - unless it was changed itself
+            if (level >= m_lastDirtyLevel)
+            {
+                break;
+            }
+
+            continue;
+        }
+
+        m_batchLocalMatrices.resize(m_batch.size());
+
+        for (std::size_t i = 0; i < m_batch.size(); ++i)
+        {
+            m_batchLocalMatrices[i] = composeMatrix(m_localTransforms[m_batch[i]]);
+        }
+
+        // the parents are on the level above, already up to date
+        for (std::size_t i = 0; i < m_batch.size(); ++i)
+        {
+            const auto index = m_batch[i];
+            const auto parentIndex = m_parentIndices[index];
+
+            if (parentIndex == NO_PARENT)
+            {
+                m_worldMatrices[index] = m_batchLocalMatrices[i];
+            }
+            else
+            {
+                multiply(m_worldMatrices[parentIndex], m_batchLocalMatrices[i], m_worldMatrices[index]);
+            }
+
+            m_isLocalTransformDirty[index] = 0;
+            m_updateGenerations[index] = m_updateGeneration;
+        }
+
+        m_updatedNodeCount += static_cast<unsigned int>(m_batch.size());
+    }
+
+    m_isDirty = false;
+
+    PROFILE_COUNTER("transform hierarchy updated nodes", static_cast<std::int64_t>(m_updatedNodeCount));
+}
+
+unsigned int TransformHierarchy::getUpdatedNodeCount() const
+{
+    return m_updatedNodeCount;
+}
+
+std::size_t TransformHierarchy::size() const
+{
+    return m_nodes.size();
+}
+
+void TransformHierarchy::markDirty(std::uint32_t index)
+{
+    const auto level = getLevel(index);
+
+    m_isLocalTransformDirty[index] = 1;
+
+    m_firstDirtyLevel = m_isDirty ? std::min(m_firstDirtyLevel, level) : level;
+    m_lastDirtyLevel = m_isDirty ? std::max(m_lastDirtyLevel, level) : level;
+    m_isDirty = true;
+}
+
+std::uint32_t TransformHierarchy::getLevel(std::uint32_t index) const
+{
+    // the last level starting at or before the index
+    return static_cast<std::uint32_t>(std::upper_bound(m_levelStarts.begin(), m_levelStarts.end(), index) - m_levelStarts.begin()) - 1;
+}
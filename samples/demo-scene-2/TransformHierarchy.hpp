@@ -0,0 +1,95 @@
+#pragma once
+
+#include "stdafx.hpp"
+
+// local transformation of a scene node; applied in the order: scale, rotation, translation
+struct Transform
+{
+    glm::vec3 translation = glm::vec3(0.0f);
+    glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    glm::vec3 scale = glm::vec3(1.0f);
+};
+
+/**
+ * Scene graph transformations: every node has a local transformation (translation, rotation, scale) relative to its parent
+ * and a world matrix, the product of the local matrices all the way up to the root.
+ *
+ * The nodes live in flat arrays sorted by depth - the roots first, then their children, then the grandchildren - so a parent
+ * always comes before its children and the nodes of one level do not depend on each other. Changing a node only marks it
+ * dirty; update() walks the levels top to bottom and recomputes the world matrices of the dirty nodes and of everything
+ * below them, in one batch per level. The rest of the scene is not touched. The matrix products are done a column at a time
+ * with SSE when the compiler targets it, with plain scalar code otherwise.
+ *
+ * Does not issue any GL calls.
+ */
+class TransformHierarchy
+{
+public:
+    // stays the same for the lifetime of the node, unlike its position in the arrays
+    using Node = std::uint32_t;
+
+    static constexpr Node NO_PARENT = std::numeric_limits<Node>::max();
+
+    TransformHierarchy();
+
+    // the parent has to exist already; the world matrix of the new node is only valid after the next update()
+    Node createNode(const Transform& localTransform = {}, Node parent = NO_PARENT);
+
+    void setLocalTransform(Node node, const Transform& localTransform);
+
+    void setTranslation(Node node, glm::vec3 translation);
+
+    void setRotation(Node node, glm::quat rotation);
+
+    void setScale(Node node, glm::vec3 scale);
+
+    const Transform& getLocalTransform(Node node) const;
+
+    Node getParent(Node node) const;
+
+    // as of the last update()
+    const glm::mat4& getWorldMatrix(Node node) const;
+
+    // true if the world matrix of the node was recomputed by the last update()
+    bool isUpdated(Node node) const;
+
+    // recomputes the world matrices of the changed subtrees; does nothing if nothing has changed since the last call
+    void update();
+
+    // number of the world matrices recomputed by the last update()
+    unsigned int getUpdatedNodeCount() const;
+
+    std::size_t size() const;
+
+protected:
+    void markDirty(std::uint32_t index);
+
+    std::uint32_t getLevel(std::uint32_t index) const;
+
+    // node -> position in the arrays below
+    std::vector<std::uint32_t> m_nodeIndices;
+
+    // sorted by depth
+    std::vector<Node> m_nodes;
+    std::vector<std::uint32_t> m_parentIndices;
+    std::vector<Transform> m_localTransforms;
+    std::vector<glm::mat4> m_worldMatrices;
+    std::vector<std::uint8_t> m_isLocalTransformDirty;
+    // the update() which last recomputed the world matrix; saves clearing the flags of the whole scene on every update
+    std::vector<std::uint32_t> m_updateGenerations;
+
+    // position of the first node of every level, plus one past the last node
+    std::vector<std::uint32_t> m_levelStarts;
+
+    // range of the levels with dirty nodes; the levels above the first one are skipped entirely
+    std::uint32_t m_firstDirtyLevel;
+    std::uint32_t m_lastDirtyLevel;
+    bool m_isDirty;
+
+    std::uint32_t m_updateGeneration;
+    unsigned int m_updatedNodeCount;
+
+    // reused between the updates
+    std::vector<std::uint32_t> m_batch;
+    std::vector<glm::mat4> m_batchLocalMatrices;
+};
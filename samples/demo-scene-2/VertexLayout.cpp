@@ -0,0 +1,284 @@
+#include "VertexLayout.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+namespace
+{
+    unsigned int getFormatSize(VertexLayout::Format format)
+    {
+        switch (format)
+        {
+        case VertexLayout::Format::FLOAT2:
+            return sizeof(glm::vec2);
+
+        case VertexLayout::Format::FLOAT3:
+            return sizeof(glm::vec3);
+
+        case VertexLayout::Format::PACKED_SNORM_3x10:
+            return sizeof(std::uint32_t);
+
+        case VertexLayout::Format::SNORM_4x16:
+            return sizeof(std::uint64_t);
+        }
+
+        return 0;
+    }
+
+    template <typename T>
+    T valueOrZero(const std::vector<T>& values, std::size_t vertexIndex)
+    {
+        return vertexIndex < values.size() ? values[vertexIndex] : T(0.0f);
+    }
+
+    // quaternion rotating the Z axis onto the normal and the X axis onto the tangent; its sign is the handedness of the frame
+    glm::vec4 encodeTangentFrame(glm::vec3 normal, glm::vec3 tangent, glm::vec3 bitangent)
+    {
+        if (glm::dot(normal, normal) < 1e-12f)
+        {
+            return glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        }
+
+        normal = glm::normalize(normal);
+        tangent = tangent - normal * glm::dot(normal, tangent);
+
+        if (glm::dot(tangent, tangent) < 1e-12f)
+        {
+            // no tangent (or a broken one) - any direction perpendicular to the normal will do
+            tangent = glm::cross(normal, std::abs(normal.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f));
+        }
+
+        tangent = glm::normalize(tangent);
+
+        // the bitangent of the mirrored UVs points against cross(normal, tangent), which a rotation can not express
+        const auto isMirrored = glm::dot(glm::cross(normal, tangent), bitangent) < 0.0f;
+
+        const auto rotation = glm::quat_cast(glm::mat3(tangent, glm::cross(normal, tangent), normal));
+
+        auto frame = glm::normalize(glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w));
+
+        if (frame.w < 0.0f)
+        {
+            frame = -frame;
+        }
+
+        // w has to stay non-zero after the quantization, or the handedness is lost
+        constexpr float minW = 1.0f / 32767.0f;
+
+        if (frame.w < minW)
+        {
+            const auto xyzScale = std::sqrt((1.0f - minW * minW) / (1.0f - frame.w * frame.w));
+
+            frame = glm::vec4(glm::vec3(frame) * xyzScale, minW);
+        }
+
+        return isMirrored ? -frame : frame;
+    }
+
+    glm::vec4 getAttribute(VertexLayout::Attribute attribute, const VertexData& vertices, std::size_t vertexIndex)
+    {
+        switch (attribute)
+        {
+        case VertexLayout::Attribute::POSITION:
+            return glm::vec4(vertices.positions[vertexIndex], 0.0f);
+
+        case VertexLayout::Attribute::NORMAL:
+            return glm::vec4(valueOrZero(vertices.normals, vertexIndex), 0.0f);
+
+        case VertexLayout::Attribute::UV:
+            return glm::vec4(valueOrZero(vertices.uvs, vertexIndex), 0.0f, 0.0f);
+
+        case VertexLayout::Attribute::TANGENT:
+            return glm::vec4(valueOrZero(vertices.tangents, vertexIndex), 0.0f);
+
+        case VertexLayout::Attribute::BITANGENT:
+            return glm::vec4(valueOrZero(vertices.bitangents, vertexIndex), 0.0f);
+
+        case VertexLayout::Attribute::TANGENT_FRAME:
+            return encodeTangentFrame(
+                valueOrZero(vertices.normals, vertexIndex),
+                valueOrZero(vertices.tangents, vertexIndex),
+                valueOrZero(vertices.bitangents, vertexIndex));
+        }
+
+        return glm::vec4(0.0f);
+    }
+
+    void writeElement(std::byte* destination, VertexLayout::Format format, glm::vec4 value)
+    {
+        switch (format)
+        {
+        case VertexLayout::Format::FLOAT2:
+        {
+            const auto data = glm::vec2(value);
+            std::memcpy(destination, &data, sizeof(data));
+            break;
+        }
+
+        case VertexLayout::Format::FLOAT3:
+        {
+            const auto data = glm::vec3(value);
+            std::memcpy(destination, &data, sizeof(data));
+            break;
+        }
+
+        case VertexLayout::Format::PACKED_SNORM_3x10:
+        {
+            const auto data = glm::packSnorm3x10_1x2(glm::vec4(glm::vec3(value), 0.0f));
+            std::memcpy(destination, &data, sizeof(data));
+            break;
+        }
+
+        case VertexLayout::Format::SNORM_4x16:
+        {
+            const auto data = glm::packSnorm4x16(value);
+            std::memcpy(destination, &data, sizeof(data));
+            break;
+        }
+        }
+    }
+}
+
+VertexLayout VertexLayout::separateStreams()
+{
+    VertexLayout layout;
+
+    layout.addStream({ { Attribute::POSITION, Format::FLOAT3 } });
+    layout.addStream({ { Attribute::NORMAL, Format::FLOAT3 } });
+    layout.addStream({ { Attribute::UV, Format::FLOAT2 } });
+    layout.addStream({ { Attribute::TANGENT, Format::FLOAT3 } });
+    layout.addStream({ { Attribute::BITANGENT, Format::FLOAT3 } });
+
+    return layout;
+}
+
+VertexLayout VertexLayout::interleaved(TangentFrame tangentFrame)
+{
+    VertexLayout layout;
+
+    // position-only stream for the depth-only passes
+    layout.addStream({ { Attribute::POSITION, Format::FLOAT3 } });
+
+    switch (tangentFrame)
+    {
+    case TangentFrame::FLOAT_VECTORS:
+        layout.addStream({
+            { Attribute::NORMAL, Format::FLOAT3 },
+            { Attribute::UV, Format::FLOAT2 },
+            { Attribute::TANGENT, Format::FLOAT3 },
+            { Attribute::BITANGENT, Format::FLOAT3 }
+        });
+        break;
+
+    case TangentFrame::PACKED_VECTORS:
+        layout.addStream({
+            { Attribute::NORMAL, Format::PACKED_SNORM_3x10 },
+            { Attribute::UV, Format::FLOAT2 },
+            { Attribute::TANGENT, Format::PACKED_SNORM_3x10 },
+            { Attribute::BITANGENT, Format::PACKED_SNORM_3x10 }
+        });
+        break;
+
+    case TangentFrame::QUATERNION:
+        layout.addStream({
+            { Attribute::TANGENT_FRAME, Format::SNORM_4x16 },
+            { Attribute::UV, Format::FLOAT2 }
+        });
+        break;
+    }
+
+    return layout;
+}
+
+VertexLayout& VertexLayout::addStream(const std::vector<std::pair<Attribute, Format>>& attributes)
+{
+    Stream stream { .elements = {}, .stride = 0 };
+
+    // every format is a multiple of 4 bytes, so the attributes stay aligned without any padding
+    for (const auto& [attribute, format] : attributes)
+    {
+        stream.elements.push_back({ .attribute = attribute, .format = format, .offset = stream.stride });
+        stream.stride += getFormatSize(format);
+    }
+
+    m_streams.push_back(std::move(stream));
+
+    return *this;
+}
+
+const std::vector<VertexLayout::Stream>& VertexLayout::getStreams() const
+{
+    return m_streams;
+}
+
+unsigned int VertexLayout::getVertexSize() const
+{
+    unsigned int vertexSize = 0;
+
+    for (const auto& stream : m_streams)
+    {
+        vertexSize += stream.stride;
+    }
+
+    return vertexSize;
+}
+
+std::vector<std::byte> VertexLayout::pack(std::size_t streamIndex, const VertexData& vertices) const
+{
+    const auto& stream = m_streams[streamIndex];
+
+    std::vector<std::byte> data(vertices.positions.size() * stream.stride);
+
+    for (std::size_t vertexIndex = 0; vertexIndex < vertices.positions.size(); ++vertexIndex)
+    {
+        auto vertex = data.data() + vertexIndex * stream.stride;
+
+        for (const auto& element : stream.elements)
+        {
+            writeElement(vertex + element.offset, element.format, getAttribute(element.attribute, vertices, vertexIndex));
+        }
+    }
+
+    return data;
+}
+
+void VertexLayout::bind(globjects::VertexArray* vao, const std::vector<globjects::Buffer*>& buffers, const AttributeIndices& attributeIndices) const
+{
+    for (std::size_t streamIndex = 0; streamIndex < m_streams.size(); ++streamIndex)
+    {
+        const auto& stream = m_streams[streamIndex];
+
+        if (buffers[streamIndex] == nullptr)
+        {
+            continue;
+        }
+
+        for (const auto& element : stream.elements)
+        {
+            const auto attributeIndex = attributeIndices[static_cast<std::size_t>(element.attribute)];
+
+            vao->binding(attributeIndex)->setAttribute(attributeIndex);
+            vao->binding(attributeIndex)->setBuffer(buffers[streamIndex], element.offset, stream.stride);
+
+            switch (element.format)
+            {
+            case Format::FLOAT2:
+                vao->binding(attributeIndex)->setFormat(2, static_cast<gl::GLenum>(GL_FLOAT));
+                break;
+
+            case Format::FLOAT3:
+                vao->binding(attributeIndex)->setFormat(3, static_cast<gl::GLenum>(GL_FLOAT));
+                break;
+
+            case Format::PACKED_SNORM_3x10:
+                vao->binding(attributeIndex)->setFormat(4, static_cast<gl::GLenum>(GL_INT_2_10_10_10_REV), static_cast<gl::GLboolean>(GL_TRUE));
+                break;
+
+            case Format::SNORM_4x16:
+                vao->binding(attributeIndex)->setFormat(4, static_cast<gl::GLenum>(GL_SHORT), static_cast<gl::GLboolean>(GL_TRUE));
+                break;
+            }
+
+            vao->enable(attributeIndex);
+        }
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "stdafx.hpp"
+
+// vertex attributes of a mesh as they come from the model loader; all the arrays but the positions may be empty
+struct VertexData
+{
+    const std::vector<glm::vec3>& positions;
+    const std::vector<glm::vec3>& normals;
+    const std::vector<glm::vec2>& uvs;
+    const std::vector<glm::vec3>& tangents;
+    const std::vector<glm::vec3>& bitangents;
+};
+
+/**
+ * How the vertex attributes are laid out in the GPU buffers: which attributes share a buffer (a stream), in what format and
+ * in what order. The offsets and the strides follow from the formats; pack() produces the bytes of a stream and bind() points
+ * the VAO attributes at the buffers.
+ *
+ * Two layouts are predefined, any other can be put together with addStream():
+ *
+ *   - separateStreams(): a buffer per attribute, all of them floats - 56 bytes per vertex spread over five buffers, so every
+ *     vertex fetch touches five cache lines
+ *   - interleaved(): the positions in a buffer of their own, the rest of the attributes interleaved in a second one; depth-only
+ *     passes read just the positions, everything else reads two cache lines per vertex at most
+ *
+ * The tangent frame can be stored as three float vectors, as three vectors packed into GL_INT_2_10_10_10_REV (read as vec3 /
+ * vec4 by the shaders, just like the floats) or as a single quaternion, 4x16-bit snorm, which the shader has to decode:
+ *
+ *     vec3 rotate(vec4 q, vec3 v) { return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v); }
+ *
+ *     vec3 normal = rotate(vertexTangentFrame, vec3(0.0, 0.0, 1.0));
+ *     vec3 tangent = rotate(vertexTangentFrame, vec3(1.0, 0.0, 0.0));
+ *     vec3 bitangent = cross(normal, tangent) * sign(vertexTangentFrame.w); // w < 0 for the mirrored UVs
+ *
+ * The attributes a mesh does not have are filled with zeros (an identity-ish frame around the normal for the quaternion).
+ */
+class VertexLayout
+{
+public:
+    enum class Attribute
+    {
+        POSITION,
+        NORMAL,
+        UV,
+        TANGENT,
+        BITANGENT,
+        // normal, tangent and bitangent as one quaternion
+        TANGENT_FRAME
+    };
+
+    static constexpr std::size_t ATTRIBUTE_COUNT = 6;
+
+    enum class Format
+    {
+        FLOAT2,
+        FLOAT3,
+        // normalized GL_INT_2_10_10_10_REV; for the unit vectors
+        PACKED_SNORM_3x10,
+        // normalized GL_SHORT x 4; for the quaternions
+        SNORM_4x16
+    };
+
+    enum class TangentFrame
+    {
+        FLOAT_VECTORS,
+        PACKED_VECTORS,
+        QUATERNION
+    };
+
+    struct Element
+    {
+        Attribute attribute;
+        Format format;
+        unsigned int offset;
+
+        bool operator==(const Element&) const = default;
+    };
+
+    struct Stream
+    {
+        std::vector<Element> elements;
+        unsigned int stride;
+
+        bool operator==(const Stream&) const = default;
+    };
+
+    // shader input location of every attribute; the tangent frame takes the place of the tangent
+    using AttributeIndices = std::array<unsigned int, ATTRIBUTE_COUNT>;
+
+    static constexpr AttributeIndices DEFAULT_ATTRIBUTE_INDICES = { 0, 1, 2, 3, 4, 3 };
+
+    static VertexLayout separateStreams();
+
+    static VertexLayout interleaved(TangentFrame tangentFrame = TangentFrame::PACKED_VECTORS);
+
+    // the attributes are stored in the order given
+    VertexLayout& addStream(const std::vector<std::pair<Attribute, Format>>& attributes);
+
+    const std::vector<Stream>& getStreams() const;
+
+    // all the streams together
+    unsigned int getVertexSize() const;
+
+    std::vector<std::byte> pack(std::size_t streamIndex, const VertexData& vertices) const;
+
+    // one buffer per stream, holding whole vertices from offset 0; the attributes of the streams without a buffer (nullptr) are left disabled
+    void bind(globjects::VertexArray* vao, const std::vector<globjects::Buffer*>& buffers, const AttributeIndices& attributeIndices = DEFAULT_ATTRIBUTE_INDICES) const;
+
+    bool operator==(const VertexLayout&) const = default;
+
+protected:
+    std::vector<Stream> m_streams;
+};
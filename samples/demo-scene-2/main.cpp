@@ -3,6 +3,10 @@
 #include "Skybox.hpp"
 #include "Mesh.hpp"
 #include "AssimpMeshLoader.hpp"
+#include "GeometryArena.hpp"
+#include "RenderQueue.hpp"
+#include "SoftwareOcclusionCuller.hpp"
+#include "TransformHierarchy.hpp"
 
 struct alignas(16) PointLightDescriptor
 {
@@ -35,6 +39,8 @@ int main()
         return sf::Context::getFunction(name);
     });
 
+    PROFILE_GPU_CONTEXT();
+
     globjects::DebugMessage::enable(); // enable automatic messages if KHR_debug is available
 
     globjects::DebugMessage::setCallback([](const globjects::DebugMessage& message) {
@@ -223,27 +229,17 @@ int main()
 
     std::cout << "[INFO] Loading 3D model...";
 
-    auto quadModel = AssimpModelLoader::fromFile("media/quad.obj", {}, aiProcess_Triangulate | aiProcess_CalcTangentSpace);
-
-    auto houseModel = AssimpModelLoader::fromFile("media/house1.obj", { "media" });
-
-    // INFO: this transformation is hard-coded specifically for Chicken.3ds model
-    houseModel->setTransformation(glm::translate(glm::scale(glm::mat4(1.0f), glm::vec3(2.0f)), glm::vec3(0.0f, 0.75f, 0.0f)));
+    // the scene meshes share a single set of buffers and a single VAO; declared before the models, as it has to outlive them.
+    // positions in a stream of their own for the shadow pass, the rest interleaved, with the normals and tangents packed to 4 bytes each
+    GeometryArena geometryArena(VertexLayout::interleaved(VertexLayout::TangentFrame::PACKED_VECTORS));
 
-    auto tableModel = AssimpModelLoader::fromFile("media/table.obj", { "media" });
+    auto quadModel = AssimpModelLoader::fromFile("media/quad.obj", {}, aiProcess_Triangulate | aiProcess_CalcTangentSpace);
 
-    tableModel->setTransformation(
-        // glm::translate(glm::vec3(0.0f, 0.06f, 0.0f)) *
-        glm::scale(glm::vec3(1.0f)) *
-        (glm::rotate(glm::radians(-90.0f), glm::vec3(0.0f, 1.0f, 0.0f)))
-    );
+    auto houseModel = AssimpModelLoader::fromFile("media/house1.obj", { "media" }, 0, &geometryArena);
 
-    auto lanternModel = AssimpModelLoader::fromFile("media/lantern.obj", { "media" });
+    auto tableModel = AssimpModelLoader::fromFile("media/table.obj", { "media" }, 0, &geometryArena);
 
-    lanternModel->setTransformation(
-        glm::translate(glm::vec3(-1.75f, 3.91f, -0.75f)) *
-        glm::scale(glm::vec3(0.5f))
-    );
+    auto lanternModel = AssimpModelLoader::fromFile("media/lantern.obj", { "media" }, 0, &geometryArena);
 
     // TODO: extract this to material class
     sf::Image lanternEmissionMapImage;
@@ -319,22 +315,9 @@ int main()
         static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
         reinterpret_cast<const gl::GLvoid*>(penNormalMapImage.getPixelsPtr()));
 
-    auto penModel = AssimpModelLoader::fromFile("media/pen-lowpoly.obj", { "media" });
-
-    // rotate -> scale -> translate; can be done as series of matrix multiplications M_translation * M_scale * M_rotation
-    // each of the components, in turn, can also be a series of matrix multiplications: M_rotation = M_rotate_z * M_rotate_y * M_rotate_x
-    penModel->setTransformation(
-        glm::translate(glm::vec3(0.35f, 3.91f, -0.75f)) *
-        glm::scale(glm::vec3(0.05f)) *
-        (glm::rotate(glm::radians(12.5f), glm::vec3(0.0f, 1.0f, 0.0f)) * glm::rotate(glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f)))
-    );
-
-    auto scrollModel = AssimpModelLoader::fromFile("media/scroll.obj", { "media" });
+    auto penModel = AssimpModelLoader::fromFile("media/pen-lowpoly.obj", { "media" }, 0, &geometryArena);
 
-    scrollModel->setTransformation(
-        glm::translate(glm::vec3(0.0f, 3.85f, 0.0f)) *
-        glm::scale(glm::vec3(0.5f))
-    );
+    auto scrollModel = AssimpModelLoader::fromFile("media/scroll.obj", { "media" }, 0, &geometryArena);
 
     sf::Image inkBottleNormalMapImage;
 
@@ -360,12 +343,67 @@ int main()
         static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
         reinterpret_cast<const gl::GLvoid*>(inkBottleNormalMapImage.getPixelsPtr()));
 
-    auto inkBottleModel = AssimpModelLoader::fromFile("media/ink-bottle.obj", { "media" });
+    auto inkBottleModel = AssimpModelLoader::fromFile("media/ink-bottle.obj", { "media" }, 0, &geometryArena);
 
-    inkBottleModel->setTransformation(
-        glm::translate(glm::vec3(-1.75f, 3.86f, 1.05f)) *
-        glm::scale(glm::vec3(0.5f))
-    );
+    std::cout << "done" << std::endl;
+
+    const auto geometryArenaStatistics = geometryArena.getStatistics();
+
+    std::cout << "[INFO] Geometry arena: " << geometryArenaStatistics.liveRanges << " meshes, "
+              << (geometryArenaStatistics.vertexCapacity - geometryArenaStatistics.freeVertices) << " vertices, "
+              << (geometryArenaStatistics.indexCapacity - geometryArenaStatistics.freeIndices) << " indices, "
+              << geometryArena.getVertexLayout().getVertexSize() << " bytes per vertex" << std::endl;
+
+    std::cout << "[INFO] Building scene hierarchy...";
+
+    // the props stand on the table top - moving the table moves everything on it
+    TransformHierarchy transformHierarchy;
+
+    const auto houseNode = transformHierarchy.createNode({ .translation = glm::vec3(0.0f, 1.5f, 0.0f), .scale = glm::vec3(2.0f) });
+
+    const auto tableNode = transformHierarchy.createNode({ .rotation = glm::angleAxis(glm::radians(-90.0f), glm::vec3(0.0f, 1.0f, 0.0f)) });
+
+    // undoes the rotation of the table, so the props are placed in the world axes
+    const auto tableTopNode = transformHierarchy.createNode({ .translation = glm::vec3(0.0f, 3.85f, 0.0f), .rotation = glm::angleAxis(glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f)) }, tableNode);
+
+    const auto lanternNode = transformHierarchy.createNode({ .translation = glm::vec3(-1.75f, 0.06f, -0.75f), .scale = glm::vec3(0.5f) }, tableTopNode);
+
+    // lying on the table, turned a bit
+    const auto penNode = transformHierarchy.createNode(
+        {
+            .translation = glm::vec3(0.35f, 0.06f, -0.75f),
+            .rotation = glm::angleAxis(glm::radians(12.5f), glm::vec3(0.0f, 1.0f, 0.0f)) * glm::angleAxis(glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f)),
+            .scale = glm::vec3(0.05f)
+        },
+        tableTopNode);
+
+    const auto scrollNode = transformHierarchy.createNode({ .scale = glm::vec3(0.5f) }, tableTopNode);
+
+    const auto inkBottleNode = transformHierarchy.createNode({ .translation = glm::vec3(-1.75f, 0.01f, 1.05f), .scale = glm::vec3(0.5f) }, tableTopNode);
+
+    const std::vector<std::pair<MultiMeshModel*, TransformHierarchy::Node>> sceneNodes {
+        { houseModel.get(), houseNode },
+        { tableModel.get(), tableNode },
+        { lanternModel.get(), lanternNode },
+        { penModel.get(), penNode },
+        { scrollModel.get(), scrollNode },
+        { inkBottleModel.get(), inkBottleNode },
+    };
+
+    // only the models whose world matrices have actually changed are touched
+    const auto updateSceneTransformations = [&]() {
+        transformHierarchy.update();
+
+        for (auto& [model, node] : sceneNodes)
+        {
+            if (transformHierarchy.isUpdated(node))
+            {
+                model->setTransformation(transformHierarchy.getWorldMatrix(node));
+            }
+        }
+    };
+
+    updateSceneTransformations();
 
     std::cout << "done" << std::endl;
 
@@ -553,7 +591,86 @@ int main()
 
     glm::mat4 lightSpaceMatrix = lightProjection * lightView;
 
+    std::cout << "[DEBUG] Initializing render queue...";
+
+    // passes are rendered in the order of their indices
+    const unsigned int DEFERRED_PRE_PASS = 0;
+    const unsigned int SHADOW_MAPPING_PASS = 1;
+
+    deferredRenderingPrePassProgram->setUniform("diffuseTexture", 1);
+    deferredRenderingPrePassProgram->setUniform("normalMapTexture", 2);
+
+    RenderMaterial deferredRenderingMaterial {
+        .program = deferredRenderingPrePassProgram.get(),
+        .transformationUniform = deferredRenderingPrePassProgram->getUniform<glm::mat4>("model")
+    };
+
+    RenderMaterial penDeferredRenderingMaterial = deferredRenderingMaterial;
+    penDeferredRenderingMaterial.textures[2] = penNormalMapTexture.get();
+
+    RenderMaterial inkBottleDeferredRenderingMaterial = deferredRenderingMaterial;
+    inkBottleDeferredRenderingMaterial.textures[2] = inkBottleNormalMapTexture.get();
+
+    // scroll model needs culling to be disabled since this is a modified plane
+    RenderMaterial scrollDeferredRenderingMaterial = deferredRenderingMaterial;
+    scrollDeferredRenderingMaterial.cullFaces = false;
+
+    RenderMaterial shadowMappingMaterial {
+        .program = shadowMappingProgram.get(),
+        .transformationUniform = shadowMappingProgram->getUniform<glm::mat4>("model")
+    };
+
+    RenderMaterial scrollShadowMappingMaterial = shadowMappingMaterial;
+    scrollShadowMappingMaterial.cullFaces = false;
+
+    const std::vector<std::pair<MultiMeshModel*, RenderMaterial>> deferredRenderingItems {
+        { houseModel.get(), deferredRenderingMaterial },
+        { tableModel.get(), deferredRenderingMaterial },
+        { lanternModel.get(), deferredRenderingMaterial },
+        { penModel.get(), penDeferredRenderingMaterial },
+        { inkBottleModel.get(), inkBottleDeferredRenderingMaterial },
+        { scrollModel.get(), scrollDeferredRenderingMaterial },
+    };
+
+    const std::vector<std::pair<MultiMeshModel*, RenderMaterial>> shadowMappingItems {
+        { houseModel.get(), shadowMappingMaterial },
+        { tableModel.get(), shadowMappingMaterial },
+        { lanternModel.get(), shadowMappingMaterial },
+        { penModel.get(), shadowMappingMaterial },
+        { inkBottleModel.get(), shadowMappingMaterial },
+        { scrollModel.get(), scrollShadowMappingMaterial },
+    };
+
+    RenderQueue renderQueue;
+    RenderStateCache renderStateCache;
+
+    std::cout << "done" << std::endl;
+
+    std::cout << "[INFO] Preparing occluders...";
+
+    // only the big things hide anything - the walls of the house and the table
+    SoftwareOcclusionCuller occlusionCuller;
+
+    for (auto& [filename, model] : std::vector<std::pair<std::string, MultiMeshModel*>> { { "media/house1.obj", houseModel.get() }, { "media/table.obj", tableModel.get() } })
+    {
+        std::vector<glm::vec3> occluderPositions;
+        std::vector<unsigned int> occluderIndices;
+
+        if (!AssimpModelLoader::geometryFromFile(filename, occluderPositions, occluderIndices))
+        {
+            return 1;
+        }
+
+        occlusionCuller.addOccluder(std::move(occluderPositions), std::move(occluderIndices), model->getTransformation());
+    }
+
+    bool isOcclusionCullingEnabled = true;
+    unsigned int occlusionCullingFrames = 0;
+
+    std::cout << "done" << std::endl;
+
     sf::Clock clock;
+    sf::Clock statisticsClock;
 
     glEnable(static_cast<gl::GLenum>(GL_DEPTH_TEST));
 
@@ -575,6 +692,13 @@ int main()
                 window.close();
                 break;
             }
+
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::O)
+            {
+                isOcclusionCullingEnabled = !isOcclusionCullingEnabled;
+
+                std::cout << "[INFO] Occlusion culling " << (isOcclusionCullingEnabled ? "enabled" : "disabled") << std::endl;
+            }
         }
 
 #ifdef WIN32
@@ -657,8 +781,68 @@ int main()
             cameraPos + cameraForward,
             cameraUp);
 
+        updateSceneTransformations();
+
+        renderStateCache.resetStatistics();
+
+        renderQueue.begin(cameraPos, 100.0f);
+
+        if (isOcclusionCullingEnabled)
+        {
+            PROFILE_ZONE("occlusion culling");
+
+            occlusionCuller.render(cameraProjection * cameraView);
+
+            ++occlusionCullingFrames;
+
+            // the shadow map is rendered from the light, so only the camera pass is culled
+            for (auto& [model, material] : deferredRenderingItems)
+            {
+                for (auto& mesh : model->getMeshes())
+                {
+                    const auto boundingBox = mesh->getBoundingBox();
+
+                    if (occlusionCuller.isVisible(boundingBox.min, boundingBox.max, model->getTransformation()))
+                    {
+                        renderQueue.submit(DEFERRED_PRE_PASS, material, mesh.get(), model->getTransformation());
+                    }
+                }
+            }
+
+            if (statisticsClock.getElapsedTime().asSeconds() > 5.0f)
+            {
+                const auto statistics = occlusionCuller.getStatistics();
+
+                // per frame, on average
+                std::cout << "[DEBUG] Occlusion culling: " << statistics.culledObjects / occlusionCullingFrames << " of " << statistics.testedObjects / occlusionCullingFrames << " meshes culled, "
+                    << statistics.rasterizedTriangles / occlusionCullingFrames << " of " << statistics.occluderTriangles / occlusionCullingFrames << " occluder triangles rasterized, "
+                    << statistics.rasterizationTime / occlusionCullingFrames << " ms rasterizing, " << statistics.testTime / occlusionCullingFrames << " ms testing" << std::endl;
+
+                occlusionCuller.resetStatistics();
+                occlusionCullingFrames = 0;
+                statisticsClock.restart();
+            }
+        }
+        else
+        {
+            for (auto& [model, material] : deferredRenderingItems)
+            {
+                renderQueue.submit(DEFERRED_PRE_PASS, material, model);
+            }
+        }
+
+        for (auto& [model, material] : shadowMappingItems)
+        {
+            renderQueue.submit(SHADOW_MAPPING_PASS, material, model);
+        }
+
+        PROFILE_COUNTER("render queue size", static_cast<std::int64_t>(renderQueue.size()));
+
         // first render pass - prepare for deferred rendering by rendering to the entire scene to a deferred rendering framebuffer's attachments
         {
+            PROFILE_ZONE("deferred pre-pass");
+            PROFILE_GPU_ZONE("deferred pre-pass");
+
             deferredRenderingFramebuffer->bind();
 
             ::glViewport(0, 0, static_cast<GLsizei>(window.getSize().x), static_cast<GLsizei>(window.getSize().y));
@@ -681,71 +865,20 @@ int main()
 
             skyboxRenderingProgram->release();*/
 
-            deferredRenderingPrePassProgram->use();
-
             deferredRenderingPrePassProgram->setUniform("projection", cameraProjection);
             deferredRenderingPrePassProgram->setUniform("view", cameraView);
             deferredRenderingPrePassProgram->setUniform("lightSpaceMatrix", lightProjection);
 
-            deferredRenderingPrePassProgram->setUniform("diffuseTexture", 1);
-            deferredRenderingPrePassProgram->setUniform("normalMapTexture", 2);
-
-            deferredRenderingPrePassProgram->setUniform("model", houseModel->getTransformation());
-
-            houseModel->bind();
-            houseModel->draw();
-            houseModel->unbind();
-
-            deferredRenderingPrePassProgram->setUniform("model", tableModel->getTransformation());
-
-            tableModel->bind();
-            tableModel->draw();
-            tableModel->unbind();
-
-            deferredRenderingPrePassProgram->setUniform("model", lanternModel->getTransformation());
-
-            lanternModel->bind();
-            lanternModel->draw();
-            lanternModel->unbind();
-
-            deferredRenderingPrePassProgram->setUniform("model", penModel->getTransformation());
-            deferredRenderingPrePassProgram->setUniform("normalMapTexture", 2);
-
-            penNormalMapTexture->bindActive(2);
-
-            penModel->bind();
-            penModel->draw();
-            penModel->unbind();
-
-            penNormalMapTexture->unbindActive(2);
-
-            deferredRenderingPrePassProgram->setUniform("model", inkBottleModel->getTransformation());
-
-            inkBottleNormalMapTexture->bindActive(2);
-
-            inkBottleModel->bind();
-            inkBottleModel->draw();
-            inkBottleModel->unbind();
-
-            inkBottleNormalMapTexture->unbindActive(2);
-
-            deferredRenderingPrePassProgram->setUniform("model", scrollModel->getTransformation());
-
-            glDisable(GL_CULL_FACE);
-
-            scrollModel->bind();
-            scrollModel->draw();
-            scrollModel->unbind();
-
-            glEnable(GL_CULL_FACE);
-
-            deferredRenderingPrePassProgram->release();
+            renderQueue.flush(DEFERRED_PRE_PASS, renderStateCache);
 
             deferredRenderingFramebuffer->unbind();
         }
 
         // second render pass - shadow mapping
         {
+            PROFILE_ZONE("shadow mapping");
+            PROFILE_GPU_ZONE("shadow mapping");
+
             shadowMapFramebuffer->bind();
 
             ::glViewport(0, 0, static_cast<GLsizei>(shadowMapSize), static_cast<GLsizei>(shadowMapSize));
@@ -770,66 +903,21 @@ int main()
 
             skyboxRenderingProgram->release();*/
 
-            shadowMappingProgram->use();
-
             shadowMappingProgram->setUniform("lightSpaceMatrix", lightSpaceMatrix);
 
-            shadowMappingProgram->setUniform("model", houseModel->getTransformation());
-
-            houseModel->bind();
-            houseModel->draw();
-            houseModel->unbind();
-
-            shadowMappingProgram->setUniform("model", tableModel->getTransformation());
-
-            tableModel->bind();
-            tableModel->draw();
-            tableModel->unbind();
-
-            shadowMappingProgram->setUniform("model", lanternModel->getTransformation());
+            renderQueue.flush(SHADOW_MAPPING_PASS, renderStateCache);
 
-            lanternModel->bind();
-            lanternModel->draw();
-            lanternModel->unbind();
-
-            shadowMappingProgram->setUniform("model", penModel->getTransformation());
-
-            // penNormalMapTexture->bindActive(2);
-
-            penModel->bind();
-            penModel->draw();
-            penModel->unbind();
-
-            // penNormalMapTexture->unbindActive(2);
-
-            shadowMappingProgram->setUniform("model", inkBottleModel->getTransformation());
-
-            // inkBottleNormalMapTexture->bindActive(2);
-
-            inkBottleModel->bind();
-            inkBottleModel->draw();
-            inkBottleModel->unbind();
-
-            // inkBottleNormalMapTexture->unbindActive(2);
-
-            shadowMappingProgram->setUniform("model", scrollModel->getTransformation());
-
-            glDisable(GL_CULL_FACE);
-
-            scrollModel->bind();
-            scrollModel->draw();
-            scrollModel->unbind();
-
-            //glEnable(GL_CULL_FACE);
-            //glCullFace(GL_BACK);
-
-            shadowMappingProgram->release();
+            // the final pass does not go through the render queue
+            renderStateCache.reset();
 
             shadowMapFramebuffer->unbind();
         }
 
         // third render pass - merge textures from the deferred rendering pre-pass into a final frame
         {
+            PROFILE_ZONE("final pass");
+            PROFILE_GPU_ZONE("final pass");
+
             ::glViewport(0, 0, static_cast<GLsizei>(window.getSize().x), static_cast<GLsizei>(window.getSize().y));
             ::glClearColor(static_cast<gl::GLfloat>(1.0f), static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(1.0f));
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -879,6 +967,9 @@ int main()
         // done rendering the frame
 
         window.display();
+
+        PROFILE_FRAME();
+        PROFILE_GPU_COLLECT();
     }
 
     return 0;
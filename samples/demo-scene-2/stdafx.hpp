@@ -1,9 +1,22 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <random>
+#include <thread>
+#include <unordered_map>
 
 #include <glbinding/gl/gl.h>
 
@@ -26,6 +39,8 @@
 #include <glm/ext/matrix_transform.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/rotate_vector.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/quaternion.hpp>
 #include <glm/mat4x4.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
@@ -38,6 +53,8 @@
 #include <SFML/OpenGL.hpp>
 #include <SFML/Window.hpp>
 
+#include <Profiling.hpp>
+
 #ifdef WIN32
 using namespace gl;
 #endif
@@ -0,0 +1,312 @@
+#include "GpuProfiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#include <imgui.h>
+
+#include <Profiling.hpp>
+
+GpuProfiler::Scope::Scope(GpuProfiler& profiler, const std::string& name) :
+    m_profiler(profiler)
+{
+    m_profiler.begin(name);
+}
+
+GpuProfiler::Scope::~Scope()
+{
+    m_profiler.end();
+}
+
+GpuProfiler::GpuProfiler() :
+    m_frame(0),
+    m_firstTimestamp(0)
+{
+}
+
+void GpuProfiler::beginFrame()
+{
+    auto& frame = m_pendingFrames[m_frame % FRAMES_IN_FLIGHT];
+
+    // the slot was last used FRAMES_IN_FLIGHT frames ago
+    collect(frame);
+
+    frame.frame = m_frame;
+    frame.usedQueries = 0;
+    frame.events.clear();
+
+    m_openEvents.clear();
+
+    begin("frame");
+}
+
+void GpuProfiler::endFrame()
+{
+    end();
+
+    ++m_frame;
+}
+
+void GpuProfiler::begin(const std::string& name)
+{
+    auto& frame = m_pendingFrames[m_frame % FRAMES_IN_FLIGHT];
+
+    size_t parent = m_openEvents.empty() ? NO_MARKER : frame.events[m_openEvents.back()].marker;
+
+    frame.events.push_back(PendingEvent{
+        .marker = findMarker(name, parent),
+        .beginQuery = recordTimestamp(frame),
+        .endQuery = 0
+    });
+
+    m_openEvents.push_back(frame.events.size() - 1);
+}
+
+void GpuProfiler::end()
+{
+    if (m_openEvents.empty())
+    {
+        std::cerr << "[ERROR] GPU profiler marker ended without being started" << std::endl;
+        return;
+    }
+
+    auto& frame = m_pendingFrames[m_frame % FRAMES_IN_FLIGHT];
+
+    frame.events[m_openEvents.back()].endQuery = recordTimestamp(frame);
+
+    m_openEvents.pop_back();
+}
+
+GpuProfiler::Scope GpuProfiler::scope(const std::string& name)
+{
+    return Scope(*this, name);
+}
+
+void GpuProfiler::drawImGuiOverlay()
+{
+    const ImGuiViewport* viewport = ImGui::GetMainViewport();
+
+    const float PAD = 20.0f;
+
+    // top right corner, away from the other windows
+    ImGui::SetNextWindowPos(ImVec2(viewport->WorkPos.x + viewport->WorkSize.x - PAD, viewport->WorkPos.y + PAD), ImGuiCond_FirstUseEver, ImVec2(1.0f, 0.0f));
+    ImGui::SetNextWindowBgAlpha(0.45f);
+
+    if (!ImGui::Begin("GPU profiler"))
+    {
+        ImGui::End();
+        return;
+    }
+
+    if (ImGui::BeginTable("markers", 5, ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_RowBg))
+    {
+        ImGui::TableSetupColumn("Marker");
+        ImGui::TableSetupColumn("Last, ms");
+        ImGui::TableSetupColumn("Average, ms");
+        ImGui::TableSetupColumn("Max, ms");
+        ImGui::TableSetupColumn("History");
+        ImGui::TableHeadersRow();
+
+        for (auto& marker : m_markers)
+        {
+            if (marker.historySize == 0)
+            {
+                continue;
+            }
+
+            float last = marker.history[(marker.historyHead + HISTORY_SIZE - 1) % HISTORY_SIZE];
+            float sum = 0.0f;
+            float max = 0.0f;
+
+            for (size_t i = 0; i < marker.historySize; ++i)
+            {
+                sum += marker.history[i];
+                max = std::max(max, marker.history[i]);
+            }
+
+            ImGui::TableNextRow();
+
+            ImGui::TableNextColumn();
+            ImGui::Indent(static_cast<float>(marker.depth) * 10.0f + 1.0f);
+            ImGui::TextUnformatted(marker.name.c_str());
+            ImGui::Unindent(static_cast<float>(marker.depth) * 10.0f + 1.0f);
+
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", last);
+
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", sum / static_cast<float>(marker.historySize));
+
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", max);
+
+            ImGui::TableNextColumn();
+
+            // oldest to newest, once the history is full
+            size_t offset = marker.historySize < HISTORY_SIZE ? 0 : marker.historyHead;
+
+            ImGui::PushID(marker.path.c_str());
+            ImGui::PlotLines("", marker.history.data(), static_cast<int>(marker.historySize), static_cast<int>(offset), nullptr, 0.0f, max, ImVec2(120.0f, 0.0f));
+            ImGui::PopID();
+        }
+
+        ImGui::EndTable();
+    }
+
+    if (ImGui::Button("Save CSV"))
+    {
+        writeCsv("gpu-profile.csv");
+    }
+
+    ImGui::SameLine();
+
+    if (ImGui::Button("Save trace"))
+    {
+        writeTrace("gpu-trace.json");
+    }
+
+    ImGui::End();
+}
+
+bool GpuProfiler::writeCsv(const std::filesystem::path& path) const
+{
+    std::ofstream file(path);
+
+    if (!file)
+    {
+        std::cerr << "[ERROR] Can not write GPU profile to " << path << std::endl;
+        return false;
+    }
+
+    file << "frame,marker,depth,start_ms,duration_ms\n";
+
+    for (auto& event : m_resolvedEvents)
+    {
+        const auto& marker = m_markers[event.marker];
+
+        file << event.frame << ",\"" << marker.path << "\"," << marker.depth << "," << event.start << "," << event.duration << "\n";
+    }
+
+    std::cout << "[INFO] GPU profile written to " << path << std::endl;
+
+    return true;
+}
+
+bool GpuProfiler::writeTrace(const std::filesystem::path& path) const
+{
+    std::ofstream file(path);
+
+    if (!file)
+    {
+        std::cerr << "[ERROR] Can not write GPU trace to " << path << std::endl;
+        return false;
+    }
+
+    // Chrome trace event format, complete events in microseconds; the nesting comes from the timestamps
+    file << "{\"traceEvents\":[\n";
+
+    for (size_t i = 0; i < m_resolvedEvents.size(); ++i)
+    {
+        const auto& event = m_resolvedEvents[i];
+
+        file << (i > 0 ? ",\n" : "")
+            << "{\"name\":\"" << m_markers[event.marker].name
+            << "\",\"ph\":\"X\",\"pid\":0,\"tid\":0"
+            << ",\"ts\":" << event.start * 1000.0
+            << ",\"dur\":" << event.duration * 1000.0
+            << ",\"args\":{\"frame\":" << event.frame << "}}";
+    }
+
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    std::cout << "[INFO] GPU trace written to " << path << std::endl;
+
+    return true;
+}
+
+size_t GpuProfiler::recordTimestamp(PendingFrame& frame)
+{
+    if (frame.usedQueries == frame.queries.size())
+    {
+        frame.queries.push_back(std::make_unique<globjects::Query>());
+    }
+
+    frame.queries[frame.usedQueries]->counter();
+
+    return frame.usedQueries++;
+}
+
+void GpuProfiler::collect(PendingFrame& frame)
+{
+    if (frame.events.empty())
+    {
+        return;
+    }
+
+    // the results of the last query come last; waits in the (unlikely) case the GPU is more than FRAMES_IN_FLIGHT frames behind
+    std::vector<gl::GLuint64> timestamps(frame.usedQueries);
+
+    for (size_t i = 0; i < frame.usedQueries; ++i)
+    {
+        timestamps[i] = frame.queries[i]->get64(gl::GL_QUERY_RESULT);
+    }
+
+    if (m_firstTimestamp == 0)
+    {
+        m_firstTimestamp = timestamps.front();
+    }
+
+    for (auto& event : frame.events)
+    {
+        // nanoseconds
+        float duration = static_cast<float>(static_cast<double>(timestamps[event.endQuery] - timestamps[event.beginQuery]) / 1e6);
+
+        auto& marker = m_markers[event.marker];
+
+        marker.history[marker.historyHead] = duration;
+        marker.historyHead = (marker.historyHead + 1) % HISTORY_SIZE;
+        marker.historySize = std::min<size_t>(marker.historySize + 1, HISTORY_SIZE);
+
+        PROFILE_COUNTER(marker.path.c_str(), duration);
+
+        m_resolvedEvents.push_back(ResolvedEvent{
+            .frame = frame.frame,
+            .marker = event.marker,
+            .start = static_cast<double>(timestamps[event.beginQuery] - m_firstTimestamp) / 1e6,
+            .duration = duration
+        });
+    }
+
+    while (!m_resolvedEvents.empty() && m_resolvedEvents.front().frame + TRACE_FRAMES < frame.frame)
+    {
+        m_resolvedEvents.pop_front();
+    }
+
+    frame.events.clear();
+}
+
+size_t GpuProfiler::findMarker(const std::string& name, size_t parent)
+{
+    for (size_t i = 0; i < m_markers.size(); ++i)
+    {
+        if (m_markers[i].parent == parent && m_markers[i].name == name)
+        {
+            return i;
+        }
+    }
+
+    Marker marker{
+        .name = name,
+        .path = parent == NO_MARKER ? name : m_markers[parent].path + "/" + name,
+        .parent = parent,
+        .depth = parent == NO_MARKER ? 0 : m_markers[parent].depth + 1,
+        .history = {},
+        .historySize = 0,
+        .historyHead = 0
+    };
+
+    m_markers.push_back(std::move(marker));
+
+    return m_markers.size() - 1;
+}
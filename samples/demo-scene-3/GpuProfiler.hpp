@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glbinding/gl/gl.h>
+
+#include <globjects/Query.h>
+#include <globjects/globjects.h>
+
+/**
+ * Measures how long the GPU spends on the parts of the frame with GL_TIMESTAMP queries.
+ *
+ * The queries of a frame are read FRAMES_IN_FLIGHT frames later, by when the GPU is most likely done with them, so the
+ * profiler does not stall the pipeline. Markers can be nested; each one keeps a rolling history of its timings.
+ *
+ * The results are shown in an ImGui window, sent to Tracy as plots (when the profiling is enabled) and can be saved as CSV or as
+ * a Chrome trace (chrome://tracing, ui.perfetto.dev).
+ */
+class GpuProfiler
+{
+public:
+    static constexpr unsigned int FRAMES_IN_FLIGHT = 3;
+    static constexpr unsigned int HISTORY_SIZE = 240;
+
+    // frames kept for the CSV and the trace
+    static constexpr unsigned int TRACE_FRAMES = 300;
+
+    class Scope
+    {
+    public:
+        Scope(GpuProfiler& profiler, const std::string& name);
+
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        GpuProfiler& m_profiler;
+    };
+
+    GpuProfiler();
+
+    // the whole frame is the outermost marker
+    void beginFrame();
+
+    void endFrame();
+
+    void begin(const std::string& name);
+
+    void end();
+
+    // ends the marker when goes out of scope
+    Scope scope(const std::string& name);
+
+    void drawImGuiOverlay();
+
+    bool writeCsv(const std::filesystem::path& path) const;
+
+    bool writeTrace(const std::filesystem::path& path) const;
+
+protected:
+    struct Marker
+    {
+        std::string name;
+        // names of all the parent markers, e.g. "frame/shadow mapping/chicken"; also the name of the Tracy plot
+        std::string path;
+        size_t parent;
+        unsigned int depth;
+
+        // milliseconds
+        std::array<float, HISTORY_SIZE> history;
+        size_t historySize;
+        size_t historyHead;
+    };
+
+    struct PendingEvent
+    {
+        size_t marker;
+        size_t beginQuery;
+        size_t endQuery;
+    };
+
+    struct PendingFrame
+    {
+        unsigned int frame;
+        std::vector<std::unique_ptr<globjects::Query>> queries;
+        size_t usedQueries;
+        std::vector<PendingEvent> events;
+    };
+
+    struct ResolvedEvent
+    {
+        unsigned int frame;
+        size_t marker;
+        // milliseconds since the first timestamp the profiler got
+        double start;
+        float duration;
+    };
+
+    size_t recordTimestamp(PendingFrame& frame);
+
+    void collect(PendingFrame& frame);
+
+    size_t findMarker(const std::string& name, size_t parent);
+
+    static constexpr size_t NO_MARKER = static_cast<size_t>(-1);
+
+    unsigned int m_frame;
+    std::array<PendingFrame, FRAMES_IN_FLIGHT> m_pendingFrames;
+
+    // markers being measured, innermost last; indices into m_pendingFrames[...].events
+    std::vector<size_t> m_openEvents;
+
+    // never shrinks, so the names stay put for Tracy
+    std::deque<Marker> m_markers;
+
+    std::deque<ResolvedEvent> m_resolvedEvents;
+    gl::GLuint64 m_firstTimestamp;
+};
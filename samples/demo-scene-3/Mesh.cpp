@@ -29,8 +29,23 @@ Mesh::Mesh(
 {
 }
 
+Mesh::~Mesh()
+{
+    PROFILE_GPU_FREE(m_vertexBuffer.get(), "buffers");
+    PROFILE_GPU_FREE(m_indexBuffer.get(), "buffers");
+    PROFILE_GPU_FREE(m_normalBuffer.get(), "buffers");
+    PROFILE_GPU_FREE(m_uvBuffer.get(), "buffers");
+
+    for (auto& texture : m_textures)
+    {
+        PROFILE_GPU_FREE(texture.get(), "textures");
+    }
+}
+
 std::unique_ptr<Mesh> Mesh::fromAiMesh(const aiScene* scene, aiMesh* mesh, std::vector<std::filesystem::path> materialLookupPaths)
 {
+    PROFILE_FUNCTION();
+
     std::cout << "[INFO] Creating buffer objects...";
 
     std::vector<glm::vec3> vertices;
@@ -83,10 +98,14 @@ std::unique_ptr<Mesh> Mesh::fromAiMesh(const aiScene* scene, aiMesh* mesh, std::
 
     vertexBuffer->setData(vertices, static_cast<gl::GLenum>(GL_STATIC_DRAW));
 
+    PROFILE_GPU_ALLOC(vertexBuffer.get(), vertices.size() * sizeof(glm::vec3), "buffers");
+
     auto indexBuffer = std::make_unique<globjects::Buffer>();
 
     indexBuffer->setData(indices, static_cast<gl::GLenum>(GL_STATIC_DRAW));
 
+    PROFILE_GPU_ALLOC(indexBuffer.get(), indices.size() * sizeof(indices[0]), "buffers");
+
     auto vao = std::make_unique<globjects::VertexArray>();
 
     vao->bindElementBuffer(indexBuffer.get());
@@ -102,6 +121,8 @@ std::unique_ptr<Mesh> Mesh::fromAiMesh(const aiScene* scene, aiMesh* mesh, std::
     {
         normalBuffer->setData(normals, static_cast<gl::GLenum>(GL_STATIC_DRAW));
 
+        PROFILE_GPU_ALLOC(normalBuffer.get(), normals.size() * sizeof(glm::vec3), "buffers");
+
         vao->binding(1)->setAttribute(1);
         vao->binding(1)->setBuffer(normalBuffer.get(), 0, sizeof(glm::vec3)); // number of elements in buffer, stride, size of buffer element
         vao->binding(1)->setFormat(3, static_cast<gl::GLenum>(GL_FLOAT)); // number of data elements per buffer element (vertex), type of data
@@ -116,6 +137,8 @@ std::unique_ptr<Mesh> Mesh::fromAiMesh(const aiScene* scene, aiMesh* mesh, std::
     {
         uvBuffer->setData(uvs, static_cast<gl::GLenum>(GL_STATIC_DRAW));
 
+        PROFILE_GPU_ALLOC(uvBuffer.get(), uvs.size() * sizeof(glm::vec2), "buffers");
+
         vao->binding(2)->setAttribute(2);
         vao->binding(2)->setBuffer(uvBuffer.get(), 0, sizeof(glm::vec2)); // number of elements in buffer, stride, size of buffer element
         vao->binding(2)->setFormat(2, static_cast<gl::GLenum>(GL_FLOAT)); // number of data elements per buffer element (vertex), type of data
@@ -186,6 +209,8 @@ std::unique_ptr<Mesh> Mesh::fromAiMesh(const aiScene* scene, aiMesh* mesh, std::
                 static_cast<gl::GLenum>(GL_UNSIGNED_BYTE),
                 reinterpret_cast<const gl::GLvoid*>(textureImage.getPixelsPtr()));
 
+            PROFILE_GPU_ALLOC(texture.get(), textureImage.getSize().x * textureImage.getSize().y * 4, "textures");
+
             textures.push_back(std::move(texture));
         }
 
@@ -35,6 +35,8 @@
 #include <SFML/OpenGL.hpp>
 #include <SFML/Window.hpp>
 
+#include <Profiling.hpp>
+
 class Mesh
 {
 public:
@@ -50,6 +52,8 @@ public:
         std::unique_ptr<globjects::Buffer> normalBuffer,
         std::unique_ptr<globjects::Buffer> uvBuffer);
 
+    ~Mesh();
+
     static std::unique_ptr<Mesh> fromAiMesh(const aiScene* scene, aiMesh* mesh, std::vector<std::filesystem::path> materialLookupPaths = {});
 
     void draw();
@@ -8,6 +8,8 @@ Model::Model(std::vector<std::unique_ptr<Mesh>> meshes) :
 
 std::unique_ptr<Model> Model::fromAiNode(const aiScene* scene, aiNode* node, std::vector<std::filesystem::path> materialLookupPaths)
 {
+    PROFILE_FUNCTION();
+
     std::vector<std::unique_ptr<Mesh>> meshes;
 
     processAiNode(scene, node, materialLookupPaths, meshes);
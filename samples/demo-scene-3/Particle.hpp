@@ -7,6 +7,8 @@
 #include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
 
+#include <Profiling.hpp>
+
 #include "AbstractParticleParamsGenerator.hpp"
 
 class Particle
@@ -96,6 +98,8 @@ public:
 
     void update(float deltaTime)
     {
+        PROFILE_ZONE("ParticleSystem#update");
+
         for (auto& particle : m_particles)
         {
             if (!particle->isAlive())
@@ -113,6 +117,9 @@ public:
 
     void draw(glm::mat4 projectionMatrix, glm::mat4 viewMatrix)
     {
+        PROFILE_ZONE("ParticleSystem#draw");
+        PROFILE_GPU_ZONE("ParticleSystem#draw");
+
         for (auto& particle : m_particles)
         {
             m_renderer->draw(particle.get(), projectionMatrix, viewMatrix);
@@ -35,6 +35,7 @@
 #include <SFML/OpenGL.hpp>
 #include <SFML/Window.hpp>
 
+#include "GpuProfiler.hpp"
 #include "ImGuiSfmlBackend.hpp"
 
 #include "Model.hpp"
@@ -52,7 +53,8 @@ int main()
     settings.stencilBits = 8;
     settings.antialiasingLevel = 4;
     settings.majorVersion = 3;
-    settings.minorVersion = 2;
+    // GL_TIMESTAMP queries need OpenGL 3.3
+    settings.minorVersion = 3;
     settings.attributeFlags = sf::ContextSettings::Attribute::Core;
 
 #if defined(SYSTEM_DARWIN) || defined(HIGH_DPI)
@@ -67,6 +69,8 @@ int main()
         return sf::Context::getFunction(name);
     });
 
+    PROFILE_GPU_CONTEXT();
+
     globjects::DebugMessage::enable(); // enable automatic messages if KHR_debug is available
 
     globjects::DebugMessage::setCallback([](const globjects::DebugMessage& message) {
@@ -352,6 +356,8 @@ int main()
     auto previousMousePos = glm::vec2(sf::Mouse::getPosition(window).x, sf::Mouse::getPosition(window).y);
 #endif
 
+    GpuProfiler gpuProfiler;
+
     while (window->isOpen())
     {
         sf::Event event {};
@@ -463,10 +469,14 @@ int main()
 
         glm::mat4 lightSpaceMatrix = lightProjection * lightView;
 
+        gpuProfiler.beginFrame();
+
         ::glViewport(0, 0, 2048, 2048);
 
         // first render pass - shadow mapping
 
+        gpuProfiler.begin("shadow mapping");
+
         framebuffer->bind();
 
         ::glClearColor(static_cast<gl::GLfloat>(1.0f), static_cast<gl::GLfloat>(1.0f), static_cast<gl::GLfloat>(1.0f), static_cast<gl::GLfloat>(1.0f));
@@ -485,28 +495,40 @@ int main()
 
         shadowMappingModelTransformationUniform->set(chickenModel->getTransformation());
 
-        chickenModel->bind();
-        chickenModel->draw();
-        chickenModel->unbind();
+        {
+            auto scope = gpuProfiler.scope("chicken");
+
+            chickenModel->bind();
+            chickenModel->draw();
+            chickenModel->unbind();
+        }
 
         // the ground plane will get culled, we don't want that
         glDisable(GL_CULL_FACE);
 
         shadowMappingModelTransformationUniform->set(quadModel->getTransformation());
 
-        quadModel->bind();
-        quadModel->draw();
-        quadModel->unbind();
+        {
+            auto scope = gpuProfiler.scope("ground");
+
+            quadModel->bind();
+            quadModel->draw();
+            quadModel->unbind();
+        }
 
         framebuffer->unbind();
 
         shadowMappingProgram->release();
 
+        gpuProfiler.end();
+
         glEnable(GL_CULL_FACE);
         glCullFace(GL_BACK);
 
         // second pass - switch to normal shader and render picture with depth information to the viewport
 
+        gpuProfiler.begin("scene");
+
         ::glViewport(0, 0, static_cast<GLsizei>(window->getSize().x), static_cast<GLsizei>(window->getSize().y));
         ::glClearColor(static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(0.0f), static_cast<gl::GLfloat>(1.0f));
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -530,17 +552,25 @@ int main()
 
         shadowRenderingModelTransformationUniform->set(chickenModel->getTransformation());
 
-        chickenModel->bind();
-        chickenModel->draw();
-        chickenModel->unbind();
+        {
+            auto scope = gpuProfiler.scope("chicken");
+
+            chickenModel->bind();
+            chickenModel->draw();
+            chickenModel->unbind();
+        }
 
         shadowRenderingModelTransformationUniform->set(quadModel->getTransformation());
 
         defaultTexture->bindActive(1);
 
-        quadModel->bind();
-        quadModel->draw();
-        quadModel->unbind();
+        {
+            auto scope = gpuProfiler.scope("ground");
+
+            quadModel->bind();
+            quadModel->draw();
+            quadModel->unbind();
+        }
 
         defaultTexture->unbindActive(1);
 
@@ -548,9 +578,16 @@ int main()
 
         shadowRenderingProgram->release();
 
+        gpuProfiler.end();
+
         particleSystem->update(deltaTime);
+
+        gpuProfiler.begin("particles");
+
         particleSystem->draw(cameraProjection, cameraView);
 
+        gpuProfiler.end();
+
         // done rendering the frame
 
         ImGui::NewFrame();
@@ -658,9 +695,20 @@ int main()
             ImGui::End();
         }
 
+        gpuProfiler.drawImGuiOverlay();
+
+        gpuProfiler.begin("ui");
+
         renderImGui(window, clock.restart().asSeconds());
 
+        gpuProfiler.end();
+
+        gpuProfiler.endFrame();
+
         window->display();
+
+        PROFILE_FRAME();
+        PROFILE_GPU_COLLECT();
     }
 
     ImGui::DestroyContext();
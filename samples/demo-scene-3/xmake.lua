@@ -19,7 +19,9 @@ target("demo-scene-3")
     add_frameworks("Foundation", "OpenGL", "IOKit", "Cocoa", "Carbon")
   end
 
-  add_files("main.cpp", "ImGuiSfmlBackend.cpp")
+  add_deps("profiling")
+
+  add_files("main.cpp", "ImGuiSfmlBackend.cpp", "GpuProfiler.cpp")
 
   add_defines("HIGH_DPI")
 
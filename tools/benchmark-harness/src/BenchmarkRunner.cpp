@@ -0,0 +1,381 @@
+#include "BenchmarkRunner.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+
+#include <glbinding/gl/gl.h>
+
+#include <globjects/globjects.h>
+
+namespace
+{
+    struct Percentiles
+    {
+        float mean;
+        float p50;
+        float p95;
+        float p99;
+        float max;
+    };
+
+    Percentiles calculatePercentiles(std::vector<float> samples)
+    {
+        if (samples.empty())
+        {
+            return Percentiles{};
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        // nearest rank
+        auto percentile = [&samples](float p) {
+            size_t rank = static_cast<size_t>(std::ceil(p * static_cast<float>(samples.size())));
+
+            return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+        };
+
+        return Percentiles{
+            .mean = std::accumulate(samples.begin(), samples.end(), 0.0f) / static_cast<float>(samples.size()),
+            .p50 = percentile(0.5f),
+            .p95 = percentile(0.95f),
+            .p99 = percentile(0.99f),
+            .max = samples.back()
+        };
+    }
+
+    std::string escapeJson(const std::string& value)
+    {
+        std::string result;
+
+        for (auto c : value)
+        {
+            if (c == '"' || c == '\\')
+            {
+                result += '\\';
+            }
+
+            // control characters do not make it into the GL strings or the pass names
+            result += c;
+        }
+
+        return result;
+    }
+
+    void writeTimings(std::ostream& output, const std::vector<float>& cpuTimes, const std::vector<float>& gpuTimes)
+    {
+        auto writePercentiles = [&output](const std::vector<float>& times) {
+            auto percentiles = calculatePercentiles(times);
+
+            output << "{ \"samples\": " << times.size()
+                << ", \"mean\": " << percentiles.mean
+                << ", \"p50\": " << percentiles.p50
+                << ", \"p95\": " << percentiles.p95
+                << ", \"p99\": " << percentiles.p99
+                << ", \"max\": " << percentiles.max << " }";
+        };
+
+        output << "\"cpu\": ";
+        writePercentiles(cpuTimes);
+        output << ", \"gpu\": ";
+        writePercentiles(gpuTimes);
+    }
+
+    float millisecondsBetween(std::chrono::high_resolution_clock::time_point start, std::chrono::high_resolution_clock::time_point end)
+    {
+        return std::chrono::duration<float, std::milli>(end - start).count();
+    }
+}
+
+std::optional<BenchmarkSettings> BenchmarkSettings::fromCommandLine(std::string sampleName, int argc, char* argv[])
+{
+    BenchmarkSettings settings{ .sampleName = std::move(sampleName) };
+
+    bool isBenchmark = false;
+
+    for (auto i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+
+        // all the options but --benchmark take a value
+        if (argument == "--benchmark")
+        {
+            isBenchmark = true;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            std::cerr << "[ERROR] Missing value for " << argument << std::endl;
+            return std::nullopt;
+        }
+
+        std::string value = argv[++i];
+
+        if (argument == "--warmup")
+        {
+            settings.warmupFrames = static_cast<unsigned int>(std::stoul(value));
+        }
+        else if (argument == "--frames")
+        {
+            settings.measuredFrames = static_cast<unsigned int>(std::stoul(value));
+        }
+        else if (argument == "--size")
+        {
+            auto separator = value.find('x');
+
+            if (separator == std::string::npos)
+            {
+                std::cerr << "[ERROR] Benchmark size has to be WIDTHxHEIGHT, got " << value << std::endl;
+                return std::nullopt;
+            }
+
+            settings.size = glm::uvec2(std::stoul(value.substr(0, separator)), std::stoul(value.substr(separator + 1)));
+        }
+        else if (argument == "--output")
+        {
+            settings.outputPath = value;
+        }
+
+        // anything else is left to the other command line options of the sample (see InputRecordingSettings)
+    }
+
+    if (!isBenchmark)
+    {
+        return std::nullopt;
+    }
+
+    return settings;
+}
+
+BenchmarkRunner::BenchmarkRunner(BenchmarkSettings settings, CameraPath cameraPath) :
+    m_settings(std::move(settings)),
+    m_cameraPath(std::move(cameraPath)),
+    m_frame(0),
+    m_currentPass(0),
+    m_pendingFrames(FRAMES_IN_FLIGHT)
+{
+    m_frameTimings.name = "frame";
+
+    m_colorRenderbuffer = std::make_unique<globjects::Renderbuffer>();
+    m_colorRenderbuffer->storage(gl::GL_RGBA8, m_settings.size.x, m_settings.size.y);
+
+    m_depthRenderbuffer = std::make_unique<globjects::Renderbuffer>();
+    m_depthRenderbuffer->storage(gl::GL_DEPTH24_STENCIL8, m_settings.size.x, m_settings.size.y);
+
+    m_framebuffer = std::make_unique<globjects::Framebuffer>();
+    m_framebuffer->attachRenderBuffer(gl::GL_COLOR_ATTACHMENT0, m_colorRenderbuffer.get());
+    m_framebuffer->attachRenderBuffer(gl::GL_DEPTH_STENCIL_ATTACHMENT, m_depthRenderbuffer.get());
+    m_framebuffer->setDrawBuffers({ gl::GL_COLOR_ATTACHMENT0 });
+
+    m_framebuffer->printStatus(true);
+
+    std::cout << "[INFO] Benchmarking " << m_settings.sampleName << " at " << m_settings.size.x << "x" << m_settings.size.y
+        << ": " << m_settings.warmupFrames << " warmup frames, " << m_settings.measuredFrames << " measured frames" << std::endl;
+}
+
+bool BenchmarkRunner::beginFrame()
+{
+    if (m_frame >= m_settings.warmupFrames + m_settings.measuredFrames)
+    {
+        for (auto& frame : m_pendingFrames)
+        {
+            collectGpuTimes(frame);
+        }
+
+        return false;
+    }
+
+    // this slot was used FRAMES_IN_FLIGHT frames ago, its queries are most likely done by now
+    auto& frame = m_pendingFrames[m_frame % FRAMES_IN_FLIGHT];
+
+    collectGpuTimes(frame);
+
+    frame.isMeasured = isMeasuredFrame();
+    frame.passes.clear();
+
+    // the second one is the end of the frame
+    frame.usedTimestamps = 2;
+    recordTimestamp(frame, 0);
+
+    m_frameStart = Clock::now();
+
+    return true;
+}
+
+void BenchmarkRunner::endFrame()
+{
+    auto& frame = m_pendingFrames[m_frame % FRAMES_IN_FLIGHT];
+
+    recordTimestamp(frame, 1);
+
+    if (frame.isMeasured)
+    {
+        m_frameTimings.cpuTimes.push_back(millisecondsBetween(m_frameStart, Clock::now()));
+    }
+
+    ++m_frame;
+}
+
+void BenchmarkRunner::beginPass(const std::string& name)
+{
+    auto pass = std::find_if(m_passTimings.begin(), m_passTimings.end(), [&name](const PassTimings& timings) {
+        return timings.name == name;
+    });
+
+    if (pass == m_passTimings.end())
+    {
+        m_passTimings.push_back(PassTimings{ .name = name });
+        pass = m_passTimings.end() - 1;
+    }
+
+    m_currentPass = static_cast<size_t>(pass - m_passTimings.begin());
+
+    auto& frame = m_pendingFrames[m_frame % FRAMES_IN_FLIGHT];
+
+    frame.passes.push_back(m_currentPass);
+    recordTimestamp(frame, frame.usedTimestamps++);
+
+    m_passStart = Clock::now();
+}
+
+void BenchmarkRunner::endPass()
+{
+    auto& frame = m_pendingFrames[m_frame % FRAMES_IN_FLIGHT];
+
+    recordTimestamp(frame, frame.usedTimestamps++);
+
+    if (frame.isMeasured)
+    {
+        m_passTimings[m_currentPass].cpuTimes.push_back(millisecondsBetween(m_passStart, Clock::now()));
+    }
+}
+
+float BenchmarkRunner::getTime() const
+{
+    return static_cast<float>(m_frame) * m_settings.timeStep;
+}
+
+float BenchmarkRunner::getDeltaTime() const
+{
+    return m_settings.timeStep;
+}
+
+glm::vec3 BenchmarkRunner::getCameraPosition() const
+{
+    return m_cameraPath.getPosition(getTime());
+}
+
+glm::vec3 BenchmarkRunner::getCameraForward() const
+{
+    return m_cameraPath.getForward(getTime());
+}
+
+glm::uvec2 BenchmarkRunner::getSize() const
+{
+    return m_settings.size;
+}
+
+void BenchmarkRunner::bindFramebuffer() const
+{
+    m_framebuffer->bind();
+}
+
+globjects::Framebuffer* BenchmarkRunner::getFramebuffer() const
+{
+    return m_framebuffer.get();
+}
+
+bool BenchmarkRunner::writeReport() const
+{
+    std::ofstream file;
+
+    if (!m_settings.outputPath.empty())
+    {
+        file.open(m_settings.outputPath);
+
+        if (!file)
+        {
+            std::cerr << "[ERROR] Can not write benchmark report to " << m_settings.outputPath << std::endl;
+            return false;
+        }
+    }
+
+    std::ostream& output = m_settings.outputPath.empty() ? std::cout : file;
+
+    output << "{\n";
+    output << "  \"sample\": \"" << escapeJson(m_settings.sampleName) << "\",\n";
+    output << "  \"renderer\": \"" << escapeJson(globjects::renderer()) << "\",\n";
+    output << "  \"vendor\": \"" << escapeJson(globjects::vendor()) << "\",\n";
+    output << "  \"width\": " << m_settings.size.x << ",\n";
+    output << "  \"height\": " << m_settings.size.y << ",\n";
+    output << "  \"warmupFrames\": " << m_settings.warmupFrames << ",\n";
+    output << "  \"measuredFrames\": " << m_settings.measuredFrames << ",\n";
+    output << "  \"timeStep\": " << m_settings.timeStep << ",\n";
+    output << "  \"unit\": \"ms\",\n";
+
+    output << "  \"frame\": { ";
+    writeTimings(output, m_frameTimings.cpuTimes, m_frameTimings.gpuTimes);
+    output << " },\n";
+
+    output << "  \"passes\": [";
+
+    for (size_t i = 0; i < m_passTimings.size(); ++i)
+    {
+        output << (i > 0 ? ",\n" : "\n") << "    { \"name\": \"" << escapeJson(m_passTimings[i].name) << "\", ";
+        writeTimings(output, m_passTimings[i].cpuTimes, m_passTimings[i].gpuTimes);
+        output << " }";
+    }
+
+    output << "\n  ]\n";
+    output << "}" << std::endl;
+
+    if (!m_settings.outputPath.empty())
+    {
+        std::cout << "[INFO] Benchmark report written to " << m_settings.outputPath << std::endl;
+    }
+
+    return true;
+}
+
+void BenchmarkRunner::recordTimestamp(PendingFrame& frame, size_t index)
+{
+    while (frame.timestamps.size() <= index)
+    {
+        frame.timestamps.push_back(std::make_unique<globjects::Query>());
+    }
+
+    frame.timestamps[index]->counter();
+}
+
+void BenchmarkRunner::collectGpuTimes(PendingFrame& frame)
+{
+    if (!frame.isMeasured)
+    {
+        return;
+    }
+
+    auto millisecondsBetweenTimestamps = [&frame](size_t start, size_t end) {
+        auto startTime = frame.timestamps[start]->get64(gl::GL_QUERY_RESULT);
+        auto endTime = frame.timestamps[end]->get64(gl::GL_QUERY_RESULT);
+
+        // nanoseconds
+        return static_cast<float>(static_cast<double>(endTime - startTime) / 1e6);
+    };
+
+    m_frameTimings.gpuTimes.push_back(millisecondsBetweenTimestamps(0, 1));
+
+    for (size_t i = 0; i < frame.passes.size(); ++i)
+    {
+        m_passTimings[frame.passes[i]].gpuTimes.push_back(millisecondsBetweenTimestamps(2 + i * 2, 3 + i * 2));
+    }
+
+    frame.isMeasured = false;
+}
+
+bool BenchmarkRunner::isMeasuredFrame() const
+{
+    return m_frame >= m_settings.warmupFrames;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <globjects/Framebuffer.h>
+#include <globjects/Query.h>
+#include <globjects/Renderbuffer.h>
+
+#include <glm/vec2.hpp>
+
+#include "CameraPath.hpp"
+
+struct BenchmarkSettings
+{
+    std::string sampleName;
+
+    glm::uvec2 size = glm::uvec2(1280, 720);
+
+    // not measured, to let the driver settle (shader compilation, buffer uploads, caches)
+    unsigned int warmupFrames = 60;
+    unsigned int measuredFrames = 600;
+
+    // the animation and the camera move by this much every frame, regardless of how long the frame took
+    float timeStep = 1.0f / 60.0f;
+
+    // the report goes to the standard output if empty
+    std::filesystem::path outputPath;
+
+    // `--benchmark [--warmup N] [--frames N] [--size WIDTHxHEIGHT] [--output report.json]`; nothing without `--benchmark`
+    static std::optional<BenchmarkSettings> fromCommandLine(std::string sampleName, int argc, char* argv[]);
+};
+
+/**
+ * Drives the frame loop of a sample in the benchmark mode: fixed timestep, scripted camera, warmup frames and measured
+ * frames. Collects CPU (wall clock) and GPU (timestamp queries) times of the whole frames and of the named passes and
+ * writes their percentiles as JSON.
+ *
+ * The GPU timestamps are read a few frames later, once they are surely available, so measuring does not stall the
+ * pipeline.
+ *
+ * Needs a current GL context with globjects initialized.
+ */
+class BenchmarkRunner
+{
+public:
+    static constexpr unsigned int FRAMES_IN_FLIGHT = 3;
+
+    BenchmarkRunner(BenchmarkSettings settings, CameraPath cameraPath);
+
+    // false once all the frames are done
+    bool beginFrame();
+
+    void endFrame();
+
+    // passes are not nested; the same names are expected in the same order every frame
+    void beginPass(const std::string& name);
+
+    void endPass();
+
+    // seconds since the start of the benchmark, in the fixed steps
+    float getTime() const;
+
+    float getDeltaTime() const;
+
+    glm::vec3 getCameraPosition() const;
+
+    glm::vec3 getCameraForward() const;
+
+    glm::uvec2 getSize() const;
+
+    // headless contexts might not have the default framebuffer; this one takes its place
+    void bindFramebuffer() const;
+
+    globjects::Framebuffer* getFramebuffer() const;
+
+    bool writeReport() const;
+
+protected:
+    using Clock = std::chrono::high_resolution_clock;
+
+    struct PassTimings
+    {
+        std::string name;
+        // milliseconds, one per measured frame
+        std::vector<float> cpuTimes;
+        std::vector<float> gpuTimes;
+    };
+
+    // timestamp queries of a frame still in flight
+    struct PendingFrame
+    {
+        bool isMeasured = false;
+        // frame begin and end, then begin and end of every pass
+        std::vector<std::unique_ptr<globjects::Query>> timestamps;
+        // indices into m_passTimings, in the order of the passes
+        std::vector<size_t> passes;
+        size_t usedTimestamps = 0;
+    };
+
+    void recordTimestamp(PendingFrame& frame, size_t index);
+
+    // blocks until the queries of the frame are available
+    void collectGpuTimes(PendingFrame& frame);
+
+    bool isMeasuredFrame() const;
+
+    BenchmarkSettings m_settings;
+    CameraPath m_cameraPath;
+
+    std::unique_ptr<globjects::Framebuffer> m_framebuffer;
+    std::unique_ptr<globjects::Renderbuffer> m_colorRenderbuffer;
+    std::unique_ptr<globjects::Renderbuffer> m_depthRenderbuffer;
+
+    unsigned int m_frame;
+
+    Clock::time_point m_frameStart;
+    Clock::time_point m_passStart;
+    size_t m_currentPass;
+
+    std::vector<PendingFrame> m_pendingFrames;
+
+    PassTimings m_frameTimings;
+    std::vector<PassTimings> m_passTimings;
+};
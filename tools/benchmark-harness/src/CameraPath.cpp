@@ -0,0 +1,99 @@
+#include "CameraPath.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/geometric.hpp>
+
+namespace
+{
+    glm::vec3 catmullRom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, float t)
+    {
+        float t2 = t * t;
+        float t3 = t2 * t;
+
+        return 0.5f * ((2.0f * p1) + (-p0 + p2) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 + (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t3);
+    }
+}
+
+CameraPath::CameraPath(std::vector<Keyframe> keyframes) :
+    m_keyframes(std::move(keyframes))
+{
+}
+
+glm::vec3 CameraPath::getPosition(float time) const
+{
+    if (m_keyframes.size() < 2)
+    {
+        return m_keyframes.empty() ? glm::vec3(0.0f) : m_keyframes.front().position;
+    }
+
+    auto [segment, t] = findSegment(wrapTime(time));
+
+    // the first and the last segments repeat their end keyframes
+    const size_t last = m_keyframes.size() - 1;
+
+    return catmullRom(
+        m_keyframes[segment > 0 ? segment - 1 : 0].position,
+        m_keyframes[segment].position,
+        m_keyframes[segment + 1].position,
+        m_keyframes[std::min(segment + 2, last)].position,
+        t);
+}
+
+glm::vec3 CameraPath::getTarget(float time) const
+{
+    if (m_keyframes.size() < 2)
+    {
+        return m_keyframes.empty() ? glm::vec3(0.0f, 0.0f, -1.0f) : m_keyframes.front().target;
+    }
+
+    auto [segment, t] = findSegment(wrapTime(time));
+
+    const size_t last = m_keyframes.size() - 1;
+
+    return catmullRom(
+        m_keyframes[segment > 0 ? segment - 1 : 0].target,
+        m_keyframes[segment].target,
+        m_keyframes[segment + 1].target,
+        m_keyframes[std::min(segment + 2, last)].target,
+        t);
+}
+
+glm::vec3 CameraPath::getForward(float time) const
+{
+    return glm::normalize(getTarget(time) - getPosition(time));
+}
+
+float CameraPath::getDuration() const
+{
+    return m_keyframes.empty() ? 0.0f : m_keyframes.back().time;
+}
+
+std::pair<size_t, float> CameraPath::findSegment(float time) const
+{
+    // first keyframe after `time`
+    auto next = std::upper_bound(m_keyframes.begin() + 1, m_keyframes.end() - 1, time, [](float time, const Keyframe& keyframe) {
+        return time < keyframe.time;
+    });
+
+    size_t segment = static_cast<size_t>(next - m_keyframes.begin()) - 1;
+
+    float segmentDuration = m_keyframes[segment + 1].time - m_keyframes[segment].time;
+
+    float t = segmentDuration > 0.0f ? (time - m_keyframes[segment].time) / segmentDuration : 0.0f;
+
+    return { segment, std::clamp(t, 0.0f, 1.0f) };
+}
+
+float CameraPath::wrapTime(float time) const
+{
+    float duration = getDuration();
+
+    if (duration <= 0.0f)
+    {
+        return 0.0f;
+    }
+
+    return std::fmod(time, duration);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+/**
+ * A scripted camera fly-through: a smooth (Catmull-Rom) curve through the keyframes, so the benchmarks see exactly the
+ * same frames on every run.
+ */
+class CameraPath
+{
+public:
+    struct Keyframe
+    {
+        // seconds since the start of the path
+        float time;
+        glm::vec3 position;
+        // the point the camera looks at
+        glm::vec3 target;
+    };
+
+    // keyframes have to be sorted by time, starting at 0
+    CameraPath(std::vector<Keyframe> keyframes);
+
+    // `time` wraps around the path duration
+    glm::vec3 getPosition(float time) const;
+
+    glm::vec3 getTarget(float time) const;
+
+    // normalized
+    glm::vec3 getForward(float time) const;
+
+    float getDuration() const;
+
+protected:
+    // index of the segment `time` is in and how far along it is; time has to be within the path duration
+    std::pair<size_t, float> findSegment(float time) const;
+
+    float wrapTime(float time) const;
+
+    std::vector<Keyframe> m_keyframes;
+};
@@ -0,0 +1,189 @@
+#include "HeadlessContext.hpp"
+
+#include <iostream>
+
+#if defined(BENCHMARK_HEADLESS_CONTEXT) && defined(BENCHMARK_USE_OSMESA)
+#include <GL/osmesa.h>
+#elif defined(BENCHMARK_HEADLESS_CONTEXT)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#if !defined(BENCHMARK_HEADLESS_CONTEXT)
+
+std::unique_ptr<HeadlessContext> HeadlessContext::create(int majorVersion, int minorVersion)
+{
+    std::cerr << "[ERROR] Headless contexts are not supported on this platform" << std::endl;
+    return nullptr;
+}
+
+HeadlessContext::ProcAddress HeadlessContext::getFunction(const char* name)
+{
+    return nullptr;
+}
+
+HeadlessContext::~HeadlessContext()
+{
+}
+
+#elif defined(BENCHMARK_USE_OSMESA)
+
+namespace
+{
+    // the default framebuffer is not used, so the size does not matter much
+    const int DEFAULT_FRAMEBUFFER_SIZE = 16;
+}
+
+std::unique_ptr<HeadlessContext> HeadlessContext::create(int majorVersion, int minorVersion)
+{
+    const int attributes[] = {
+        OSMESA_FORMAT, OSMESA_RGBA,
+        OSMESA_DEPTH_BITS, 24,
+        OSMESA_STENCIL_BITS, 8,
+        OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+        OSMESA_CONTEXT_MAJOR_VERSION, majorVersion,
+        OSMESA_CONTEXT_MINOR_VERSION, minorVersion,
+        0
+    };
+
+    OSMesaContext context = OSMesaCreateContextAttribs(attributes, nullptr);
+
+    if (!context)
+    {
+        std::cerr << "[ERROR] Can not create OSMesa context" << std::endl;
+        return nullptr;
+    }
+
+    std::unique_ptr<HeadlessContext> headlessContext(new HeadlessContext());
+
+    headlessContext->m_context = context;
+    headlessContext->m_colorBuffer.resize(DEFAULT_FRAMEBUFFER_SIZE * DEFAULT_FRAMEBUFFER_SIZE * 4);
+
+    if (!OSMesaMakeCurrent(context, headlessContext->m_colorBuffer.data(), GL_UNSIGNED_BYTE, DEFAULT_FRAMEBUFFER_SIZE, DEFAULT_FRAMEBUFFER_SIZE))
+    {
+        std::cerr << "[ERROR] Can not make OSMesa context current" << std::endl;
+        return nullptr;
+    }
+
+    return headlessContext;
+}
+
+HeadlessContext::ProcAddress HeadlessContext::getFunction(const char* name)
+{
+    return reinterpret_cast<ProcAddress>(OSMesaGetProcAddress(name));
+}
+
+HeadlessContext::~HeadlessContext()
+{
+    if (m_context)
+    {
+        OSMesaDestroyContext(static_cast<OSMesaContext>(m_context));
+    }
+}
+
+#else
+
+std::unique_ptr<HeadlessContext> HeadlessContext::create(int majorVersion, int minorVersion)
+{
+    EGLDisplay display = EGL_NO_DISPLAY;
+
+    // the surfaceless platform does not need any window system at all; other EGL implementations only have the default display
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+    if (getPlatformDisplay)
+    {
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+
+    if (display == EGL_NO_DISPLAY)
+    {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    EGLint eglMajorVersion = 0;
+    EGLint eglMinorVersion = 0;
+
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &eglMajorVersion, &eglMinorVersion))
+    {
+        std::cerr << "[ERROR] Can not initialize EGL display" << std::endl;
+        return nullptr;
+    }
+
+    std::unique_ptr<HeadlessContext> headlessContext(new HeadlessContext());
+
+    headlessContext->m_display = display;
+
+    // the default surface type is a window, which the surfaceless platform does not have - any will do, as none is created
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, 0,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount < 1)
+    {
+        std::cerr << "[ERROR] Can not find EGL config for desktop OpenGL" << std::endl;
+        return nullptr;
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        std::cerr << "[ERROR] Can not bind desktop OpenGL API" << std::endl;
+        return nullptr;
+    }
+
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION_KHR, majorVersion,
+        EGL_CONTEXT_MINOR_VERSION_KHR, minorVersion,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+        EGL_NONE
+    };
+
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+
+    if (context == EGL_NO_CONTEXT)
+    {
+        std::cerr << "[ERROR] Can not create OpenGL " << majorVersion << "." << minorVersion << " context" << std::endl;
+        return nullptr;
+    }
+
+    headlessContext->m_context = context;
+
+    // no surface at all - needs EGL_KHR_surfaceless_context
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+    {
+        std::cerr << "[ERROR] Can not make EGL context current without a surface" << std::endl;
+        return nullptr;
+    }
+
+    std::cout << "[INFO] Created headless EGL " << eglMajorVersion << "." << eglMinorVersion << " context" << std::endl;
+
+    return headlessContext;
+}
+
+HeadlessContext::ProcAddress HeadlessContext::getFunction(const char* name)
+{
+    return reinterpret_cast<ProcAddress>(eglGetProcAddress(name));
+}
+
+HeadlessContext::~HeadlessContext()
+{
+    if (m_display == nullptr)
+    {
+        return;
+    }
+
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+    if (m_context)
+    {
+        eglDestroyContext(m_display, m_context);
+    }
+
+    eglTerminate(m_display);
+}
+
+#endif
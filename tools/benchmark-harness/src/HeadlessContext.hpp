@@ -0,0 +1,36 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+/**
+ * An OpenGL context without a window, for running the samples where there is no display (CI machines, llvmpipe).
+ *
+ * Uses EGL on the surfaceless Mesa platform by default and OSMesa when built with BENCHMARK_USE_OSMESA. There might be
+ * no default framebuffer at all, so everything has to be rendered to a framebuffer object (see BenchmarkRunner).
+ * Only built on Linux (or with BENCHMARK_HEADLESS_CONTEXT); on the other platforms create() always returns null.
+ */
+class HeadlessContext
+{
+public:
+    using ProcAddress = void (*)();
+
+    // null if the context could not be created
+    static std::unique_ptr<HeadlessContext> create(int majorVersion, int minorVersion);
+
+    // for globjects::init(), once the context is created
+    static ProcAddress getFunction(const char* name);
+
+    ~HeadlessContext();
+
+protected:
+    HeadlessContext() = default;
+
+    // EGLDisplay / EGLContext or OSMesaContext, depending on the backend
+    void* m_display = nullptr;
+    void* m_context = nullptr;
+
+    // OSMesa renders the default framebuffer into the memory
+    std::vector<std::uint8_t> m_colorBuffer;
+};
@@ -0,0 +1,39 @@
+add_requires("glm")
+add_requires("vcpkg::globjects", { alias = "globjects" })
+add_requires("vcpkg::glbinding", { alias = "glbinding" })
+
+-- EGL and OSMesa are only there on Linux; elsewhere HeadlessContext::create() always fails, unless asked for explicitly
+option("benchmark_headless_context")
+  set_default(false)
+  set_showmenu(true)
+  set_description("Build the headless benchmark contexts on platforms other than Linux")
+option_end()
+
+option("benchmark_use_osmesa")
+  set_default(false)
+  set_showmenu(true)
+  set_description("Create the headless benchmark contexts with OSMesa instead of EGL")
+option_end()
+
+target("benchmark-harness")
+  set_languages("cxx20")
+  set_kind("static")
+
+  add_packages("glm", "globjects", "glbinding", { public = true })
+
+  add_options("benchmark_headless_context", "benchmark_use_osmesa")
+
+  if has_config("benchmark_headless_context") or is_plat("linux", "bsd") then
+    add_defines("BENCHMARK_HEADLESS_CONTEXT")
+
+    if has_config("benchmark_use_osmesa") then
+      add_defines("BENCHMARK_USE_OSMESA")
+      add_syslinks("OSMesa")
+    else
+      add_syslinks("EGL")
+    end
+  end
+
+  add_includedirs("src/", { public = true })
+
+  add_files("src/BenchmarkRunner.cpp", "src/CameraPath.cpp", "src/HeadlessContext.cpp")
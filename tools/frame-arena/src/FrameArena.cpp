@@ -0,0 +1,172 @@
+#include "FrameArena.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+
+namespace
+{
+    std::mutex& threadArenasMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    std::vector<FrameArena*>& threadArenas()
+    {
+        static std::vector<FrameArena*> arenas;
+        return arenas;
+    }
+
+    // the arena of one thread, known to resetAll() for as long as the thread lives
+    struct ThreadArena
+    {
+        ThreadArena()
+        {
+            std::lock_guard<std::mutex> lock(threadArenasMutex());
+            threadArenas().push_back(&arena);
+        }
+
+        ~ThreadArena()
+        {
+            std::lock_guard<std::mutex> lock(threadArenasMutex());
+            std::erase(threadArenas(), &arena);
+        }
+
+        FrameArena arena;
+    };
+}
+
+FrameArena::FrameArena(std::size_t blockSize, std::pmr::memory_resource* upstream) :
+    m_upstream(upstream),
+    m_blockSize(blockSize),
+    m_currentBlock(0),
+    m_offset(0),
+    m_usedBytes(0),
+    m_peakUsedBytes(0),
+    m_upstreamAllocationCount(0)
+{
+}
+
+FrameArena::~FrameArena()
+{
+    releaseBlocks();
+}
+
+void FrameArena::reset()
+{
+    if (m_blocks.size() > 1)
+    {
+        // the frame did not fit into a single block; the next ones will
+        std::size_t totalSize = 0;
+
+        for (auto& block : m_blocks)
+        {
+            totalSize += block.size;
+        }
+
+        releaseBlocks();
+        addBlock(totalSize);
+    }
+
+    m_currentBlock = 0;
+    m_offset = 0;
+    m_usedBytes = 0;
+}
+
+std::size_t FrameArena::getUsedBytes() const
+{
+    return m_usedBytes;
+}
+
+std::size_t FrameArena::getPeakUsedBytes() const
+{
+    return m_peakUsedBytes;
+}
+
+std::size_t FrameArena::getCapacity() const
+{
+    std::size_t capacity = 0;
+
+    for (auto& block : m_blocks)
+    {
+        capacity += block.size;
+    }
+
+    return capacity;
+}
+
+unsigned int FrameArena::getUpstreamAllocationCount() const
+{
+    return m_upstreamAllocationCount;
+}
+
+FrameArena& FrameArena::forThisThread()
+{
+    thread_local ThreadArena threadArena;
+
+    return threadArena.arena;
+}
+
+void FrameArena::resetAll()
+{
+    std::lock_guard<std::mutex> lock(threadArenasMutex());
+
+    for (auto arena : threadArenas())
+    {
+        arena->reset();
+    }
+}
+
+void* FrameArena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    for (; m_currentBlock < m_blocks.size(); ++m_currentBlock, m_offset = 0)
+    {
+        auto& block = m_blocks[m_currentBlock];
+
+        void* pointer = block.data + m_offset;
+        std::size_t space = block.size - m_offset;
+
+        if (std::align(alignment, bytes, pointer, space))
+        {
+            m_offset = static_cast<std::size_t>(static_cast<std::byte*>(pointer) - block.data) + bytes;
+
+            m_usedBytes += bytes;
+            m_peakUsedBytes = std::max(m_peakUsedBytes, m_usedBytes);
+
+            return pointer;
+        }
+    }
+
+    // the blocks are aligned for any type, but the alignment asked for could be even stricter
+    addBlock(std::max(m_blockSize, bytes + alignment));
+
+    return do_allocate(bytes, alignment);
+}
+
+void FrameArena::do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment)
+{
+    // released all at once by reset()
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+void FrameArena::addBlock(std::size_t size)
+{
+    m_blocks.push_back({ .data = static_cast<std::byte*>(m_upstream->allocate(size, alignof(std::max_align_t))), .size = size });
+
+    ++m_upstreamAllocationCount;
+}
+
+void FrameArena::releaseBlocks()
+{
+    for (auto& block : m_blocks)
+    {
+        m_upstream->deallocate(block.data, block.size, alignof(std::max_align_t));
+    }
+
+    m_blocks.clear();
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+/**
+ * Linear (bump) allocator for the data which only lives for one frame: the instance data uploaded to the GPU, the scratch
+ * lists of the culling and so on. Allocating is moving a pointer forward, deallocating does nothing at all; everything is
+ * released at once by reset(), at the end of the frame.
+ *
+ * Plugs into the standard containers as a std::pmr::memory_resource:
+ *
+ *     std::pmr::vector<InstanceData> instances(&FrameArena::forThisThread());
+ *
+ * The memory is taken from the upstream resource in blocks and is kept between the frames. When a frame does not fit into
+ * the first block, the next reset() replaces all the blocks with a single one big enough for that frame - so after the
+ * first few frames the arena does not allocate anything anymore.
+ *
+ * Not thread-safe; every thread gets an arena of its own with forThisThread().
+ */
+class FrameArena : public std::pmr::memory_resource
+{
+public:
+    static constexpr std::size_t DEFAULT_BLOCK_SIZE = 1 << 20;
+
+    explicit FrameArena(std::size_t blockSize = DEFAULT_BLOCK_SIZE, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+    ~FrameArena() override;
+
+    FrameArena(const FrameArena&) = delete;
+
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // invalidates everything allocated since the previous reset()
+    void reset();
+
+    // since the previous reset()
+    std::size_t getUsedBytes() const;
+
+    // the most any frame has used so far
+    std::size_t getPeakUsedBytes() const;
+
+    std::size_t getCapacity() const;
+
+    // number of the blocks taken from the upstream resource over the lifetime of the arena - stops growing once the arena is warmed up
+    unsigned int getUpstreamAllocationCount() const;
+
+    // the arena of the calling thread, created on the first call
+    static FrameArena& forThisThread();
+
+    // resets the arenas of all the threads; once per frame, at the frame mark, while no other thread is using its arena
+    static void resetAll();
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    struct Block
+    {
+        std::byte* data;
+        std::size_t size;
+    };
+
+    void addBlock(std::size_t size);
+
+    void releaseBlocks();
+
+    std::pmr::memory_resource* m_upstream;
+    std::size_t m_blockSize;
+
+    std::vector<Block> m_blocks;
+    std::size_t m_currentBlock;
+    std::size_t m_offset;
+
+    std::size_t m_usedBytes;
+    std::size_t m_peakUsedBytes;
+    unsigned int m_upstreamAllocationCount;
+};
@@ -0,0 +1,7 @@
+target("frame-arena")
+  set_languages("cxx20")
+  set_kind("static")
+
+  add_includedirs("src/", { public = true })
+
+  add_files("src/FrameArena.cpp")
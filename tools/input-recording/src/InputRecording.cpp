@@ -0,0 +1,209 @@
+#include "InputRecording.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <limits>
+#include <string>
+
+namespace
+{
+    constexpr std::array<char, 4> MAGIC { 'I', 'N', 'P', 'T' };
+    constexpr std::uint32_t VERSION = 1;
+
+    // deltaTime, mouseDelta.x, mouseDelta.y, number of pressed keys; followed by the key codes
+    struct FrameHeader
+    {
+        float deltaTime;
+        std::int16_t mouseDeltaX;
+        std::int16_t mouseDeltaY;
+        std::uint8_t pressedKeyCount;
+    };
+
+    static_assert(sf::Keyboard::KeyCount <= std::numeric_limits<std::uint8_t>::max(), "key codes are stored as bytes");
+
+    template <typename T>
+    void write(std::ofstream& file, const T& value)
+    {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool read(std::ifstream& file, T& value)
+    {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    std::int16_t clampToInt16(int value)
+    {
+        return static_cast<std::int16_t>(std::clamp<int>(value, std::numeric_limits<std::int16_t>::min(), std::numeric_limits<std::int16_t>::max()));
+    }
+}
+
+bool FrameInput::isKeyPressed(sf::Keyboard::Key key) const
+{
+    return key >= 0 && key < sf::Keyboard::KeyCount && pressedKeys.test(static_cast<size_t>(key));
+}
+
+FrameInput FrameInput::capture(float deltaTime, glm::ivec2 mouseDelta, std::initializer_list<sf::Keyboard::Key> keys)
+{
+    FrameInput input { .deltaTime = deltaTime, .mouseDelta = mouseDelta, .pressedKeys = {} };
+
+    for (auto key : keys)
+    {
+        if (sf::Keyboard::isKeyPressed(key))
+        {
+            input.pressedKeys.set(static_cast<size_t>(key));
+        }
+    }
+
+    return input;
+}
+
+std::optional<InputRecordingSettings> InputRecordingSettings::fromCommandLine(int argc, char* argv[])
+{
+    std::optional<InputRecordingSettings> settings;
+
+    for (auto i = 1; i + 1 < argc; ++i)
+    {
+        std::string argument = argv[i];
+
+        // anything else is left to the other command line options of the sample
+        if (argument == "--record")
+        {
+            settings = InputRecordingSettings{ .recordPath = argv[++i], .replayPath = {} };
+        }
+        else if (argument == "--replay")
+        {
+            settings = InputRecordingSettings{ .recordPath = {}, .replayPath = argv[++i] };
+        }
+    }
+
+    return settings;
+}
+
+std::unique_ptr<InputRecorder> InputRecorder::create(const std::filesystem::path& path, glm::uvec2 windowSize)
+{
+    std::unique_ptr<InputRecorder> recorder(new InputRecorder());
+
+    recorder->m_file.open(path, std::ios::binary | std::ios::trunc);
+
+    if (!recorder->m_file)
+    {
+        std::cerr << "[ERROR] Can not create input recording " << path << std::endl;
+        return nullptr;
+    }
+
+    recorder->m_file.write(MAGIC.data(), MAGIC.size());
+    write(recorder->m_file, VERSION);
+    write(recorder->m_file, static_cast<std::uint32_t>(windowSize.x));
+    write(recorder->m_file, static_cast<std::uint32_t>(windowSize.y));
+
+    return recorder;
+}
+
+void InputRecorder::record(const FrameInput& input)
+{
+    std::array<std::uint8_t, sf::Keyboard::KeyCount> pressedKeys;
+    std::uint8_t pressedKeyCount = 0;
+
+    for (size_t key = 0; key < input.pressedKeys.size(); ++key)
+    {
+        if (input.pressedKeys.test(key))
+        {
+            pressedKeys[pressedKeyCount++] = static_cast<std::uint8_t>(key);
+        }
+    }
+
+    // written field by field, so there is no padding in the file
+    write(m_file, input.deltaTime);
+    write(m_file, clampToInt16(input.mouseDelta.x));
+    write(m_file, clampToInt16(input.mouseDelta.y));
+    write(m_file, pressedKeyCount);
+
+    m_file.write(reinterpret_cast<const char*>(pressedKeys.data()), pressedKeyCount);
+
+    ++m_frameCount;
+}
+
+unsigned int InputRecorder::getFrameCount() const
+{
+    return m_frameCount;
+}
+
+std::unique_ptr<InputReplay> InputReplay::fromFile(const std::filesystem::path& path)
+{
+    std::unique_ptr<InputReplay> replay(new InputReplay());
+
+    replay->m_file.open(path, std::ios::binary);
+
+    if (!replay->m_file)
+    {
+        std::cerr << "[ERROR] Can not open input recording " << path << std::endl;
+        return nullptr;
+    }
+
+    std::array<char, 4> magic {};
+    std::uint32_t version = 0;
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+
+    replay->m_file.read(magic.data(), magic.size());
+
+    if (!replay->m_file || magic != MAGIC || !read(replay->m_file, version) || version != VERSION)
+    {
+        std::cerr << "[ERROR] " << path << " is not an input recording (or was made by another version)" << std::endl;
+        return nullptr;
+    }
+
+    if (!read(replay->m_file, width) || !read(replay->m_file, height))
+    {
+        std::cerr << "[ERROR] Input recording " << path << " is truncated" << std::endl;
+        return nullptr;
+    }
+
+    replay->m_windowSize = glm::uvec2(width, height);
+
+    return replay;
+}
+
+glm::uvec2 InputReplay::getWindowSize() const
+{
+    return m_windowSize;
+}
+
+bool InputReplay::nextFrame(FrameInput& input)
+{
+    FrameHeader header {};
+
+    if (!read(m_file, header.deltaTime) || !read(m_file, header.mouseDeltaX) || !read(m_file, header.mouseDeltaY) || !read(m_file, header.pressedKeyCount))
+    {
+        return false;
+    }
+
+    input = FrameInput{ .deltaTime = header.deltaTime, .mouseDelta = glm::ivec2(header.mouseDeltaX, header.mouseDeltaY), .pressedKeys = {} };
+
+    for (std::uint8_t i = 0; i < header.pressedKeyCount; ++i)
+    {
+        std::uint8_t key = 0;
+
+        if (!read(m_file, key))
+        {
+            return false;
+        }
+
+        if (key < sf::Keyboard::KeyCount)
+        {
+            input.pressedKeys.set(key);
+        }
+    }
+
+    ++m_frame;
+
+    return true;
+}
+
+unsigned int InputReplay::getFrame() const
+{
+    return m_frame;
+}
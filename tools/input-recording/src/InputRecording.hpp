@@ -0,0 +1,92 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+
+#include <glm/vec2.hpp>
+
+#include <SFML/Window.hpp>
+
+/**
+ * Everything a sample reads from the user in one frame, together with the time step of that frame.
+ */
+struct FrameInput
+{
+    // seconds
+    float deltaTime = 0.0f;
+
+    // pixels
+    glm::ivec2 mouseDelta = glm::ivec2(0);
+
+    std::bitset<sf::Keyboard::KeyCount> pressedKeys;
+
+    bool isKeyPressed(sf::Keyboard::Key key) const;
+
+    // only samples `keys` - querying the keyboard is not free on every platform
+    static FrameInput capture(float deltaTime, glm::ivec2 mouseDelta, std::initializer_list<sf::Keyboard::Key> keys);
+};
+
+struct InputRecordingSettings
+{
+    // only one of them is set
+    std::filesystem::path recordPath;
+    std::filesystem::path replayPath;
+
+    // `--record input.rec` or `--replay input.rec`; nothing without either of them
+    static std::optional<InputRecordingSettings> fromCommandLine(int argc, char* argv[]);
+};
+
+/**
+ * Writes the input of every frame to a file, to be fed back to the sample later with InputReplay.
+ *
+ * The file is a small header (magic, version, window size) followed by one record per frame: the time step, the mouse
+ * movement and the codes of the pressed keys - around ten bytes per frame. Written in the byte order of the machine.
+ */
+class InputRecorder
+{
+public:
+    // null if the file can not be created
+    static std::unique_ptr<InputRecorder> create(const std::filesystem::path& path, glm::uvec2 windowSize);
+
+    void record(const FrameInput& input);
+
+    unsigned int getFrameCount() const;
+
+protected:
+    InputRecorder() = default;
+
+    std::ofstream m_file;
+    unsigned int m_frameCount = 0;
+};
+
+/**
+ * Plays back the input recorded by InputRecorder: the same keys, the same mouse movement and the same time steps, no matter
+ * how long the frames take now - so the camera takes exactly the same path through the scene every run.
+ *
+ * The sample has to use the recorded window size too, the mouse movement is usually scaled by it.
+ */
+class InputReplay
+{
+public:
+    // null if the file can not be read or is not a recording
+    static std::unique_ptr<InputReplay> fromFile(const std::filesystem::path& path);
+
+    glm::uvec2 getWindowSize() const;
+
+    // false once all the frames are played back
+    bool nextFrame(FrameInput& input);
+
+    unsigned int getFrame() const;
+
+protected:
+    InputReplay() = default;
+
+    std::ifstream m_file;
+    glm::uvec2 m_windowSize;
+    unsigned int m_frame = 0;
+};
@@ -0,0 +1,12 @@
+add_requires("sfml ~2.5.1", { alias = "sfml" })
+add_requires("glm")
+
+target("input-recording")
+  set_languages("cxx20")
+  set_kind("static")
+
+  add_packages("sfml", "glm", { public = true })
+
+  add_includedirs("src/", { public = true })
+
+  add_files("src/InputRecording.cpp")
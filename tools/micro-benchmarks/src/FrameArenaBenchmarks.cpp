@@ -0,0 +1,86 @@
+#include <memory_resource>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <glm/mat4x4.hpp>
+
+#include <FrameArena.hpp>
+
+#include "MicroBenchmarks.hpp"
+
+namespace
+{
+    // per-instance data of the kind the samples upload every frame
+    struct InstanceData
+    {
+        glm::mat4 transformation;
+        float lifetime;
+    };
+
+    template <typename TVector>
+    void fillFrame(TVector& instances, std::size_t count)
+    {
+        // no reserve(), like most of the transient lists - they grow as the items are collected
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            instances.push_back({ .transformation = glm::mat4(static_cast<float>(i)), .lifetime = 1.0f });
+        }
+
+        benchmark::DoNotOptimize(instances.data());
+    }
+}
+
+// a fresh std::vector every frame - what the samples used to do
+static void BM_TransientVector_Heap(benchmark::State& state)
+{
+    HeapAllocationCounter heapAllocations;
+
+    for (auto _ : state)
+    {
+        std::vector<InstanceData> instances;
+
+        fillFrame(instances, static_cast<std::size_t>(state.range(0)));
+    }
+
+    heapAllocations.report(state);
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_TransientVector_Heap)->RangeMultiplier(16)->Range(16, 65536);
+
+static void BM_TransientVector_FrameArena(benchmark::State& state)
+{
+    FrameArena frameArena;
+
+    const auto runFrame = [&]() {
+        {
+            std::pmr::vector<InstanceData> instances(&frameArena);
+
+            fillFrame(instances, static_cast<std::size_t>(state.range(0)));
+        }
+
+        frameArena.reset();
+    };
+
+    // lets the arena settle on its block size
+    runFrame();
+    runFrame();
+
+    state.counters["arena bytes"] = static_cast<double>(frameArena.getCapacity());
+
+    HeapAllocationCounter heapAllocations;
+
+    for (auto _ : state)
+    {
+        runFrame();
+    }
+
+    // the whole point of the arena
+    heapAllocations.expectNone(state);
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_TransientVector_FrameArena)->RangeMultiplier(16)->Range(16, 65536);
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <streambuf>
+
+#include <benchmark/benchmark.h>
+
+// whether main() has managed to create the headless OpenGL context, needed by the benchmarks of the classes owning GL objects
+bool isGlContextAvailable();
+
+// calls to the global operator new so far, on all the threads (main.cpp replaces it)
+std::uint64_t getHeapAllocationCount();
+
+/**
+ * Counts the heap allocations of the benchmark loop and reports them as the "heap allocations" counter, per iteration;
+ * expectNone() turns a non-zero count into a failed run.
+ *
+ * Created right before the loop, after the warm-up - the point is to show the steady state; report() has to be called
+ * right after the loop, before any other counter is set (SetItemsProcessed() included), since they allocate too.
+ */
+class HeapAllocationCounter
+{
+public:
+    HeapAllocationCounter() :
+        m_initialCount(getHeapAllocationCount())
+    {
+    }
+
+    void report(benchmark::State& state) const
+    {
+        const auto allocations = static_cast<double>(getHeapAllocationCount() - m_initialCount);
+
+        state.counters["heap allocations"] = benchmark::Counter(allocations, benchmark::Counter::kAvgIterations);
+    }
+
+    // for the code which must not allocate in the steady state: fails the benchmark if the loop did, reports otherwise
+    void expectNone(benchmark::State& state) const
+    {
+        if (getHeapAllocationCount() != m_initialCount)
+        {
+            state.SkipWithError("heap allocations in the steady state");
+            return;
+        }
+
+        report(state);
+    }
+
+private:
+    std::uint64_t m_initialCount;
+};
+
+/**
+ * Swallows everything written to std::cout while it is alive - the code under test logs its progress, which would both
+ * flood the console and add the terminal I/O to the measured time.
+ *
+ * Has to be destroyed before the benchmark function returns, the console reporter writes to std::cout as well.
+ */
+class SilencedOutput
+{
+public:
+    SilencedOutput() :
+        m_previousBuffer(std::cout.rdbuf(&m_sink))
+    {
+    }
+
+    ~SilencedOutput()
+    {
+        std::cout.rdbuf(m_previousBuffer);
+    }
+
+private:
+    class NullBuffer : public std::streambuf
+    {
+    protected:
+        int overflow(int character) override
+        {
+            return traits_type::not_eof(character);
+        }
+
+        std::streamsize xsputn(const char*, std::streamsize count) override
+        {
+            return count;
+        }
+    };
+
+    NullBuffer m_sink;
+    std::streambuf* m_previousBuffer;
+};
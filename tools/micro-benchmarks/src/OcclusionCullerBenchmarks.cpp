@@ -0,0 +1,179 @@
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include "demo-scene-2/SoftwareOcclusionCuller.hpp"
+
+namespace
+{
+    // camera at the origin, looking down -Z, at the aspect ratio of the culler's depth buffer
+    glm::mat4 getViewProjection()
+    {
+        const auto projection = glm::perspective(glm::radians(60.0f), static_cast<float>(SoftwareOcclusionCuller::DEFAULT_WIDTH) / static_cast<float>(SoftwareOcclusionCuller::DEFAULT_HEIGHT), 0.1f, 100.0f);
+        const auto view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+        return projection * view;
+    }
+
+    // unit cube around the origin, twelve triangles
+    void addBoxOccluder(SoftwareOcclusionCuller& culler, const glm::mat4& transformation)
+    {
+        std::vector<glm::vec3> positions;
+
+        for (int i = 0; i < 8; ++i)
+        {
+            positions.push_back(glm::vec3((i & 1) ? 0.5f : -0.5f, (i & 2) ? 0.5f : -0.5f, (i & 4) ? 0.5f : -0.5f));
+        }
+
+        std::vector<unsigned int> indices = {
+            0, 2, 1, 1, 2, 3, // -Z
+            4, 5, 6, 5, 7, 6, // +Z
+            0, 1, 4, 1, 5, 4, // -Y
+            2, 6, 3, 3, 6, 7, // +Y
+            0, 4, 2, 2, 4, 6, // -X
+            1, 3, 5, 3, 7, 5  // +X
+        };
+
+        culler.addOccluder(std::move(positions), std::move(indices), transformation);
+    }
+
+    /**
+     * A 4x4 wall five units in front of the camera: a box right behind it has to be culled, the ones next to it and in
+     * front of it have to stay visible. Returns the description of the first failed check, nullptr if all of them pass.
+     */
+    const char* checkCulling(unsigned int workerCount)
+    {
+        SoftwareOcclusionCuller culler(SoftwareOcclusionCuller::DEFAULT_WIDTH, SoftwareOcclusionCuller::DEFAULT_HEIGHT, workerCount);
+
+        culler.addOccluder(
+            { glm::vec3(-2.0f, -2.0f, -5.0f), glm::vec3(2.0f, -2.0f, -5.0f), glm::vec3(2.0f, 2.0f, -5.0f), glm::vec3(-2.0f, 2.0f, -5.0f) },
+            { 0, 1, 2, 0, 2, 3 },
+            glm::mat4(1.0f));
+
+        culler.render(getViewProjection());
+
+        const auto box = [&](glm::vec3 center) {
+            return culler.isVisible(glm::vec3(-0.5f), glm::vec3(0.5f), glm::translate(glm::mat4(1.0f), center));
+        };
+
+        if (box(glm::vec3(0.0f, 0.0f, -10.0f)))
+        {
+            return "box behind the occluder is not culled";
+        }
+
+        if (!box(glm::vec3(6.0f, 0.0f, -10.0f)))
+        {
+            return "box beside the occluder is culled";
+        }
+
+        if (!box(glm::vec3(0.0f, 0.0f, -3.0f)))
+        {
+            return "box in front of the occluder is culled";
+        }
+
+        return nullptr;
+    }
+
+    // a wall of `count` boxes at different depths, covering most of the screen
+    void addOccluders(SoftwareOcclusionCuller& culler, unsigned int count)
+    {
+        std::mt19937 random(42);
+        std::uniform_real_distribution<float> depth(8.0f, 20.0f);
+
+        const auto columns = static_cast<unsigned int>(std::ceil(std::sqrt(static_cast<float>(count))));
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            const auto cell = glm::vec2(static_cast<float>(i % columns), static_cast<float>(i / columns)) / static_cast<float>(columns) - 0.5f;
+            const auto z = depth(random);
+
+            const auto transformation = glm::scale(
+                glm::translate(glm::mat4(1.0f), glm::vec3(cell.x * z * 2.0f, cell.y * z, -z)),
+                glm::vec3(z * 2.0f / static_cast<float>(columns), z / static_cast<float>(columns), 1.0f));
+
+            addBoxOccluder(culler, transformation);
+        }
+    }
+}
+
+// rasterizing the occluders and building the depth hierarchy; arguments: occluder boxes, worker threads
+static void BM_SoftwareOcclusionCuller_Render(benchmark::State& state)
+{
+    const auto workerCount = static_cast<unsigned int>(state.range(1));
+
+    if (const auto error = checkCulling(workerCount))
+    {
+        state.SkipWithError(error);
+        return;
+    }
+
+    SoftwareOcclusionCuller culler(SoftwareOcclusionCuller::DEFAULT_WIDTH, SoftwareOcclusionCuller::DEFAULT_HEIGHT, workerCount);
+
+    addOccluders(culler, static_cast<unsigned int>(state.range(0)));
+
+    const auto viewProjection = getViewProjection();
+
+    for (auto _ : state)
+    {
+        culler.render(viewProjection);
+
+        benchmark::DoNotOptimize(culler.getDepthBuffer().data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 12);
+}
+
+BENCHMARK(BM_SoftwareOcclusionCuller_Render)
+    ->ArgsProduct({ { 16, 64, 256 }, { 0, 3 } })
+    ->ArgNames({ "occluders", "workers" })
+    ->UseRealTime();
+
+// testing the bounding boxes against the depth hierarchy; argument: boxes per iteration
+static void BM_SoftwareOcclusionCuller_IsVisible(benchmark::State& state)
+{
+    if (const auto error = checkCulling(0))
+    {
+        state.SkipWithError(error);
+        return;
+    }
+
+    SoftwareOcclusionCuller culler(SoftwareOcclusionCuller::DEFAULT_WIDTH, SoftwareOcclusionCuller::DEFAULT_HEIGHT, 0);
+
+    addOccluders(culler, 64);
+
+    culler.render(getViewProjection());
+
+    // small boxes scattered over the view, both in front of the occluders and behind them
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> depth(2.0f, 40.0f);
+    std::uniform_real_distribution<float> offset(-0.5f, 0.5f);
+
+    std::vector<glm::mat4> transformations;
+
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+    {
+        const auto z = depth(random);
+
+        transformations.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(offset(random) * z * 2.0f, offset(random) * z, -z)));
+    }
+
+    for (auto _ : state)
+    {
+        unsigned int visibleCount = 0;
+
+        for (const auto& transformation : transformations)
+        {
+            visibleCount += culler.isVisible(glm::vec3(-0.5f), glm::vec3(0.5f), transformation) ? 1 : 0;
+        }
+
+        benchmark::DoNotOptimize(visibleCount);
+    }
+
+    const auto statistics = culler.getStatistics();
+
+    state.counters["culled share"] = static_cast<double>(statistics.culledObjects) / static_cast<double>(std::max(statistics.testedObjects, 1u));
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_SoftwareOcclusionCuller_IsVisible)->RangeMultiplier(4)->Range(256, 4096);
@@ -0,0 +1,144 @@
+#include <benchmark/benchmark.h>
+
+#include "11-instance-rendering/src/Particle.hpp"
+#include "11-instance-rendering/src/SimpleParticle.hpp"
+
+#include "MicroBenchmarks.hpp"
+
+namespace
+{
+    // the particle system needs a renderer, but only its update() is measured
+    class NullParticleRenderer : public AbstractParticleRenderer<SimpleParticle>
+    {
+    public:
+        void draw(const std::vector<std::shared_ptr<SimpleParticle>>& particles, glm::mat4 projectionMatrix, glm::mat4 viewMatrix) override
+        {
+        }
+    };
+
+    std::unique_ptr<SimpleParticleEmitter> createEmitter()
+    {
+        // same as the sample
+        return std::make_unique<SimpleParticleEmitter>(5.0f, glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), 0.5f, 0.01f);
+    }
+}
+
+class ParticleSystemFixture : public benchmark::Fixture
+{
+public:
+    void SetUp(benchmark::State& state) override
+    {
+        // the emitter uses std::rand()
+        std::srand(42);
+
+        std::vector<std::shared_ptr<AbstractParticleAffector<SimpleParticle>>> affectors { std::make_shared<SimpleParticleAffector>() };
+
+        m_particleSystem = std::make_unique<ParticleSystem<SimpleParticle>>(
+            static_cast<unsigned int>(state.range(0)),
+            createEmitter(),
+            affectors,
+            std::make_unique<NullParticleRenderer>());
+
+        // a couple of seconds in, the particles are at different stages of their lifetime
+        for (int i = 0; i < 120; ++i)
+        {
+            m_particleSystem->update(DELTA_TIME);
+        }
+    }
+
+    void TearDown(benchmark::State& state) override
+    {
+        m_particleSystem = nullptr;
+    }
+
+protected:
+    static constexpr float DELTA_TIME = 1.0f / 60.0f;
+
+    std::unique_ptr<ParticleSystem<SimpleParticle>> m_particleSystem;
+};
+
+BENCHMARK_DEFINE_F(ParticleSystemFixture, Update)(benchmark::State& state)
+{
+    HeapAllocationCounter heapAllocations;
+
+    for (auto _ : state)
+    {
+        m_particleSystem->update(DELTA_TIME);
+
+        benchmark::ClobberMemory();
+    }
+
+    heapAllocations.report(state);
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(ParticleSystemFixture, Update)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+
+class ParticleDataFixture : public benchmark::Fixture
+{
+public:
+    void SetUp(benchmark::State& state) override
+    {
+        std::srand(42);
+
+        auto emitter = createEmitter();
+
+        m_particles.clear();
+
+        for (auto i = 0; i < state.range(0); ++i)
+        {
+            auto particle = std::make_shared<SimpleParticle>();
+
+            emitter->emit(particle.get());
+
+            m_particles.push_back(particle);
+        }
+    }
+
+    void TearDown(benchmark::State& state) override
+    {
+        m_particles.clear();
+    }
+
+protected:
+    std::vector<std::shared_ptr<SimpleParticle>> m_particles;
+};
+
+BENCHMARK_DEFINE_F(ParticleDataFixture, GenerateParticleData)(benchmark::State& state)
+{
+    const auto projectionMatrix = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    const auto viewMatrix = glm::lookAt(glm::vec3(0.0f, 1.0f, 5.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    // same as the sample: the data lives in the frame arena, which is reset at the end of every frame
+    FrameArena frameArena;
+
+    const auto generateFrame = [&]() {
+        {
+            std::pmr::vector<SimpleParticleData> particleData(&frameArena);
+
+            SimpleParticleRenderer::generateParticleData(m_particles, projectionMatrix, viewMatrix, particleData);
+
+            benchmark::DoNotOptimize(particleData.data());
+        }
+
+        frameArena.reset();
+    };
+
+    // the arena takes its memory on the first frame
+    generateFrame();
+
+    HeapAllocationCounter heapAllocations;
+
+    for (auto _ : state)
+    {
+        generateFrame();
+    }
+
+    heapAllocations.expectNone(state);
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(SimpleParticleData));
+}
+
+BENCHMARK_REGISTER_F(ParticleDataFixture, GenerateParticleData)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+
+#include "12-cascade-shadow-mapping/src/ShadowCascades.hpp"
+
+static void BM_ShadowCascades_Update(benchmark::State& state)
+{
+    const auto cascades = static_cast<int>(state.range(0));
+
+    // evenly spaced, the sample itself uses { 0.0, 0.05, 0.2, 0.5, 1.0 }
+    std::vector<float> splits;
+
+    for (int i = 0; i <= cascades; ++i)
+    {
+        splits.push_back(static_cast<float>(i) / static_cast<float>(cascades));
+    }
+
+    const float nearPlane = 0.1f;
+    const float farPlane = 100.0f;
+
+    const auto cameraProjection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, nearPlane, farPlane);
+    const auto lightDirection = glm::normalize(glm::vec3(-1.0f, -2.0f, -0.5f));
+
+    ShadowCascades shadowCascades;
+
+    float angle = 0.0f;
+
+    for (auto _ : state)
+    {
+        // the camera turns a little every frame, like it would in the sample
+        const auto cameraView = glm::lookAt(glm::vec3(0.0f, 2.0f, 5.0f), glm::vec3(std::sin(angle), 2.0f, 5.0f - std::cos(angle)), glm::vec3(0.0f, 1.0f, 0.0f));
+
+        shadowCascades.update(cameraProjection, cameraView, nearPlane, farPlane, lightDirection, splits);
+
+        benchmark::DoNotOptimize(shadowCascades.getLightViewProjectionMatrices().data());
+
+        angle += 0.01f;
+    }
+
+    state.SetItemsProcessed(state.iterations() * cascades);
+}
+
+BENCHMARK(BM_ShadowCascades_Update)->DenseRange(1, 8);
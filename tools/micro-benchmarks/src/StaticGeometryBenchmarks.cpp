@@ -0,0 +1,380 @@
+#include <array>
+#include <fstream>
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include "28-multi-draw-indirect/src/AssimpStaticModelLoader.hpp"
+#include "28-multi-draw-indirect/src/StaticGeometryDrawable.hpp"
+
+#include "MicroBenchmarks.hpp"
+
+namespace
+{
+    // `size` x `size` quads on a wavy surface, two triangles each
+    StaticMesh generateGridMesh(unsigned int size)
+    {
+        StaticMesh mesh;
+
+        for (unsigned int z = 0; z <= size; ++z)
+        {
+            for (unsigned int x = 0; x <= size; ++x)
+            {
+                const auto u = static_cast<float>(x) / static_cast<float>(size);
+                const auto v = static_cast<float>(z) / static_cast<float>(size);
+
+                mesh.vertexPositions.push_back(glm::vec3(u * 10.0f, std::sin(u * 20.0f) * std::cos(v * 20.0f) * 0.5f, v * 10.0f));
+                mesh.normals.push_back(glm::normalize(glm::vec3(-std::cos(u * 20.0f) * std::cos(v * 20.0f), 1.0f, std::sin(u * 20.0f) * std::sin(v * 20.0f))));
+                mesh.uvs.push_back(glm::vec2(u, v));
+            }
+        }
+
+        for (unsigned int z = 0; z < size; ++z)
+        {
+            for (unsigned int x = 0; x < size; ++x)
+            {
+                const auto i = z * (size + 1) + x;
+
+                mesh.indices.insert(mesh.indices.end(), { i, i + size + 1, i + 1 });
+                mesh.indices.insert(mesh.indices.end(), { i + 1, i + size + 1, i + size + 2 });
+            }
+        }
+
+        return mesh;
+    }
+
+    // the grid mesh the way a careless exporter would write it: triangles in random order, starting at a random corner,
+    // each with its own three vertices
+    StaticMesh generateShuffledGridMesh(unsigned int size)
+    {
+        const auto grid = generateGridMesh(size);
+
+        std::vector<unsigned int> triangles(grid.indices.size() / 3);
+        std::iota(triangles.begin(), triangles.end(), 0);
+
+        std::mt19937 random(42);
+        std::shuffle(triangles.begin(), triangles.end(), random);
+
+        std::uniform_int_distribution<unsigned int> firstCorner(0, 2);
+
+        StaticMesh mesh;
+
+        for (auto triangle : triangles)
+        {
+            const auto first = firstCorner(random);
+
+            for (unsigned int t = 0; t < 3; ++t)
+            {
+                const auto index = grid.indices[triangle * 3 + (first + t) % 3];
+
+                mesh.indices.push_back(static_cast<unsigned int>(mesh.vertexPositions.size()));
+                mesh.vertexPositions.push_back(grid.vertexPositions[index]);
+                mesh.normals.push_back(grid.normals[index]);
+                mesh.uvs.push_back(grid.uvs[index]);
+            }
+        }
+
+        return mesh;
+    }
+
+    using TriangleKey = std::array<std::array<float, 3>, 3>;
+
+    // triangles by their corner positions, each rotated to start at the smallest corner - so the same triangle with the
+    // same winding gives the same key, no matter which corner it starts at; sorted, to compare as multisets
+    std::vector<TriangleKey> getTriangleKeys(const std::vector<unsigned int>& indices, const std::vector<glm::vec3>& positions)
+    {
+        std::vector<TriangleKey> keys;
+
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            TriangleKey key;
+
+            for (size_t t = 0; t < 3; ++t)
+            {
+                const auto& position = positions[indices[i + t]];
+
+                key[t] = { position.x, position.y, position.z };
+            }
+
+            std::rotate(key.begin(), std::min_element(key.begin(), key.end()), key.end());
+
+            keys.push_back(key);
+        }
+
+        std::sort(keys.begin(), keys.end());
+
+        return keys;
+    }
+
+    // Wavefront OBJ file with the grid mesh, once per size
+    std::filesystem::path writeGridModel(unsigned int size)
+    {
+        const auto path = std::filesystem::temp_directory_path() / ("micro-benchmarks-grid-" + std::to_string(size) + ".obj");
+
+        if (std::filesystem::exists(path))
+        {
+            return path;
+        }
+
+        const auto mesh = generateGridMesh(size);
+
+        std::ofstream file(path);
+
+        for (auto& position : mesh.vertexPositions)
+        {
+            file << "v " << position.x << " " << position.y << " " << position.z << "\n";
+        }
+
+        for (auto& normal : mesh.normals)
+        {
+            file << "vn " << normal.x << " " << normal.y << " " << normal.z << "\n";
+        }
+
+        for (auto& uv : mesh.uvs)
+        {
+            file << "vt " << uv.x << " " << uv.y << "\n";
+        }
+
+        // OBJ indices start at 1
+        for (size_t i = 0; i < mesh.indices.size(); i += 3)
+        {
+            file << "f";
+
+            for (size_t t = 0; t < 3; ++t)
+            {
+                const auto index = mesh.indices[i + t] + 1;
+
+                file << " " << index << "/" << index << "/" << index;
+            }
+
+            file << "\n";
+        }
+
+        return path;
+    }
+}
+
+class AssimpStaticModelLoaderFixture : public benchmark::Fixture
+{
+public:
+    void SetUp(benchmark::State& state) override
+    {
+        m_modelPath = writeGridModel(static_cast<unsigned int>(state.range(0)));
+    }
+
+protected:
+    std::filesystem::path m_modelPath;
+};
+
+// reading, optimizing the mesh and generating the LODs
+BENCHMARK_DEFINE_F(AssimpStaticModelLoaderFixture, FromFile)(benchmark::State& state)
+{
+    SilencedOutput silencedOutput;
+
+    for (auto _ : state)
+    {
+        auto scene = AssimpStaticModelLoader::fromFile(m_modelPath.string());
+
+        benchmark::DoNotOptimize(scene.get());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0) * 2);
+}
+
+BENCHMARK_REGISTER_F(AssimpStaticModelLoaderFixture, FromFile)->RangeMultiplier(4)->Range(16, 256)->Unit(benchmark::kMillisecond);
+
+// encoding of the vertices into the 16-byte format; fails if the decoded vertices are further off than the encoding promises
+static void BM_StaticGeometry_QuantizeVertices(benchmark::State& state)
+{
+    const auto mesh = generateGridMesh(static_cast<unsigned int>(state.range(0)));
+
+    glm::vec3 boundsMin(std::numeric_limits<float>::max());
+    glm::vec3 boundsMax(std::numeric_limits<float>::lowest());
+
+    for (auto& position : mesh.vertexPositions)
+    {
+        boundsMin = glm::min(boundsMin, position);
+        boundsMax = glm::max(boundsMax, position);
+    }
+
+    const auto extent = glm::max(boundsMax - boundsMin, glm::vec3(std::numeric_limits<float>::epsilon()));
+
+    std::vector<QuantizedVertex> vertices(mesh.vertexPositions.size());
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < vertices.size(); ++i)
+        {
+            vertices[i] = quantizeVertex(mesh.vertexPositions[i], mesh.normals[i], mesh.uvs[i], boundsMin, extent);
+        }
+
+        benchmark::DoNotOptimize(vertices.data());
+        benchmark::ClobberMemory();
+    }
+
+    // half a step plus some float slack; octahedral 2x16 stays well below a hundredth of a degree; half floats have 11 significant bits
+    constexpr float maxPositionError = 0.5f / 65535.0f + 1e-6f;
+    constexpr float maxNormalError = 0.01f;
+    constexpr float maxUvError = 1.0f / 2048.0f;
+
+    float positionError = 0.0f; // relative to the mesh extent
+    float normalError = 0.0f; // degrees
+    float uvError = 0.0f; // relative to the UV magnitude
+
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        const auto position = glm::abs(dequantizePosition(vertices[i].position, boundsMin, extent) - mesh.vertexPositions[i]) / extent;
+
+        positionError = std::max({ positionError, position.x, position.y, position.z });
+
+        const auto decodedNormal = decodeOctahedral(glm::unpackSnorm2x16(vertices[i].normal));
+        const float cosine = glm::clamp(glm::dot(decodedNormal, glm::normalize(mesh.normals[i])), -1.0f, 1.0f);
+
+        normalError = std::max(normalError, glm::degrees(std::acos(cosine)));
+
+        const auto uv = glm::abs(glm::unpackHalf2x16(vertices[i].uv) - mesh.uvs[i]) / glm::max(glm::abs(mesh.uvs[i]), glm::vec2(1.0f));
+
+        uvError = std::max({ uvError, uv.x, uv.y });
+    }
+
+    if (positionError > maxPositionError || normalError > maxNormalError || uvError > maxUvError)
+    {
+        state.SkipWithError("vertex quantization error is out of bounds");
+        return;
+    }
+
+    state.counters["position error"] = positionError;
+    state.counters["normal error, deg"] = normalError;
+    state.counters["uv error"] = uvError;
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(vertices.size()));
+}
+
+BENCHMARK(BM_StaticGeometry_QuantizeVertices)->RangeMultiplier(4)->Range(32, 512);
+
+// the whole optimization pipeline over a shuffled grid with no shared vertices; fails if the triangles or their windings
+// change, if the vertices are not welded back into the grid or if the vertex cache does not get any better
+static void BM_MeshOptimizer_Optimize(benchmark::State& state)
+{
+    const auto size = static_cast<unsigned int>(state.range(0));
+    const auto mesh = generateShuffledGridMesh(size);
+    const auto vertexCount = mesh.vertexPositions.size();
+
+    const std::vector<MeshOptimizer::VertexStream> streams {
+        { mesh.vertexPositions.data(), sizeof(glm::vec3) },
+        { mesh.normals.data(), sizeof(glm::vec3) },
+        { mesh.uvs.data(), sizeof(glm::vec2) }
+    };
+
+    auto indices = mesh.indices;
+    const auto result = MeshOptimizer::optimize(indices, vertexCount, streams, mesh.vertexPositions);
+
+    if (getTriangleKeys(indices, MeshOptimizer::remapVertices(mesh.vertexPositions, result.remap, result.vertexCount)) != getTriangleKeys(mesh.indices, mesh.vertexPositions))
+    {
+        state.SkipWithError("optimized mesh has different triangles or windings");
+        return;
+    }
+
+    if (result.vertexCount != static_cast<size_t>(size + 1) * (size + 1))
+    {
+        state.SkipWithError("duplicate vertices are not merged");
+        return;
+    }
+
+    if (result.after.acmr >= result.before.acmr)
+    {
+        state.SkipWithError("ACMR does not drop");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        indices = mesh.indices;
+
+        auto iterationResult = MeshOptimizer::optimize(indices, vertexCount, streams, mesh.vertexPositions);
+
+        benchmark::DoNotOptimize(iterationResult.remap.data());
+        benchmark::DoNotOptimize(indices.data());
+    }
+
+    state.counters["ACMR before"] = result.before.acmr;
+    state.counters["ACMR after"] = result.after.acmr;
+    state.counters["ATVR before"] = result.before.atvr;
+    state.counters["ATVR after"] = result.after.atvr;
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(mesh.indices.size() / 3));
+}
+
+BENCHMARK(BM_MeshOptimizer_Optimize)->RangeMultiplier(4)->Range(16, 256)->Unit(benchmark::kMillisecond);
+
+class StaticGeometryDrawableFixture : public benchmark::Fixture
+{
+public:
+    static constexpr unsigned int SCENES = 4;
+    static constexpr unsigned int INSTANCES_PER_SCENE = 64;
+
+    void SetUp(benchmark::State& state) override
+    {
+        // the constructor creates the buffer objects right away
+        if (!isGlContextAvailable())
+        {
+            return;
+        }
+
+        const auto vertexCompression = state.range(1) ? VertexCompression::QUANTIZED : VertexCompression::NONE;
+        const auto meshletCulling = state.range(2) ? MeshletCulling::CPU : MeshletCulling::NONE;
+
+        m_drawable = std::make_unique<StaticGeometryDrawable>(false, vertexCompression, meshletCulling);
+
+        const auto mesh = generateGridMesh(static_cast<unsigned int>(state.range(0)));
+
+        for (unsigned int i = 0; i < SCENES; ++i)
+        {
+            auto scene = std::make_shared<StaticScene>();
+            scene->meshes.push_back(mesh);
+
+            const auto sceneName = "grid" + std::to_string(i);
+
+            m_drawable->addScene(sceneName, scene);
+
+            for (unsigned int t = 0; t < INSTANCES_PER_SCENE; ++t)
+            {
+                m_drawable->addSceneInstance(sceneName, { .transformation = glm::translate(glm::mat4(1.0f), glm::vec3(t * 12.0f, 0.0f, i * 12.0f)) });
+            }
+        }
+    }
+
+    void TearDown(benchmark::State& state) override
+    {
+        m_drawable = nullptr;
+    }
+
+protected:
+    std::unique_ptr<StaticGeometryDrawable> m_drawable;
+};
+
+// the CPU side of build() only - packing the vertices and indices, meshlets and instance data; arguments: grid size, quantized vertices, meshlets
+BENCHMARK_DEFINE_F(StaticGeometryDrawableFixture, BuildGeometry)(benchmark::State& state)
+{
+    if (!m_drawable)
+    {
+        state.SkipWithError("no OpenGL context");
+        return;
+    }
+
+    SilencedOutput silencedOutput;
+
+    for (auto _ : state)
+    {
+        m_drawable->buildGeometry();
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * SCENES * (state.range(0) + 1) * (state.range(0) + 1));
+}
+
+BENCHMARK_REGISTER_F(StaticGeometryDrawableFixture, BuildGeometry)
+    ->ArgsProduct({ { 32, 128, 512 }, { 0, 1 }, { 0, 1 } })
+    ->ArgNames({ "grid", "quantized", "meshlets" })
+    ->Unit(benchmark::kMillisecond);
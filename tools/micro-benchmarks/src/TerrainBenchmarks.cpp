@@ -0,0 +1,44 @@
+#include <benchmark/benchmark.h>
+
+#include "13-terrain/src/TerrainGeometry.hpp"
+
+namespace
+{
+    // rolling hills, so that the normals are not all the same
+    sf::Image generateHeightmap(unsigned int size)
+    {
+        sf::Image heightmap;
+        heightmap.create(size, size);
+
+        for (unsigned int y = 0; y < size; ++y)
+        {
+            for (unsigned int x = 0; x < size; ++x)
+            {
+                const auto value = static_cast<sf::Uint8>(127.5f * (1.0f + std::sin(x * 0.05f) * std::cos(y * 0.07f)));
+
+                heightmap.setPixel(x, y, sf::Color(value, value, value));
+            }
+        }
+
+        return heightmap;
+    }
+}
+
+static void BM_TerrainGeometry_FromHeightmap(benchmark::State& state)
+{
+    const auto size = static_cast<unsigned int>(state.range(0));
+    const auto heightmap = generateHeightmap(size);
+
+    for (auto _ : state)
+    {
+        auto geometry = TerrainGeometry::fromHeightmap(heightmap, 0.5f);
+
+        benchmark::DoNotOptimize(geometry.vertices.data());
+        benchmark::DoNotOptimize(geometry.indices.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * size * size);
+    state.counters["vertices"] = static_cast<double>(size * size);
+}
+
+BENCHMARK(BM_TerrainGeometry_FromHeightmap)->RangeMultiplier(2)->Range(64, 1024)->Unit(benchmark::kMillisecond);
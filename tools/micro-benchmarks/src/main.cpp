@@ -0,0 +1,81 @@
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include <benchmark/benchmark.h>
+
+#include <globjects/globjects.h>
+
+#include <HeadlessContext.hpp>
+
+#include "MicroBenchmarks.hpp"
+
+namespace
+{
+    bool glContextAvailable = false;
+
+    std::atomic<std::uint64_t> heapAllocationCount { 0 };
+}
+
+bool isGlContextAvailable()
+{
+    return glContextAvailable;
+}
+
+std::uint64_t getHeapAllocationCount()
+{
+    return heapAllocationCount.load(std::memory_order_relaxed);
+}
+
+// the array and nothrow versions end up here as well; the aligned ones are left alone, they are not counted
+void* operator new(std::size_t size)
+{
+    heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (auto pointer = std::malloc(size == 0 ? 1 : size))
+    {
+        return pointer;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+int main(int argc, char* argv[])
+{
+    // nothing is rendered - the context is only there for the objects to be created, so llvmpipe will do
+    auto headlessContext = HeadlessContext::create(4, 5);
+
+    if (headlessContext)
+    {
+        globjects::init(HeadlessContext::getFunction);
+
+        glContextAvailable = true;
+    }
+    else
+    {
+        std::cerr << "[ERROR] Can not create headless context, the benchmarks which need OpenGL will be skipped" << std::endl;
+    }
+
+    benchmark::Initialize(&argc, argv);
+
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return 0;
+}
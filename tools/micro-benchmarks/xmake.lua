@@ -0,0 +1,36 @@
+add_requires("benchmark")
+add_requires("sfml ~2.5.1", { alias = "sfml" })
+add_requires("glm")
+add_requires("vcpkg::globjects", { alias = "globjects" })
+add_requires("vcpkg::glbinding", { alias = "glbinding" })
+add_requires("assimp")
+
+target("micro-benchmarks")
+  set_languages("cxx20")
+  set_kind("binary")
+
+  add_includedirs("src/", "$(scriptdir)/../../samples")
+
+  add_packages("benchmark", "sfml", "glm", "globjects", "glbinding", "assimp")
+
+  add_deps("benchmark-harness", "frame-arena", "profiling")
+
+  if is_plat("macosx") then
+    -- this prevents linker errors
+    add_frameworks("Foundation", "OpenGL", "IOKit", "Cocoa", "Carbon")
+  end
+
+  add_files("src/main.cpp", "src/FrameArenaBenchmarks.cpp", "src/OcclusionCullerBenchmarks.cpp", "src/ParticleBenchmarks.cpp", "src/ShadowCascadesBenchmarks.cpp", "src/StaticGeometryBenchmarks.cpp", "src/TerrainBenchmarks.cpp")
+
+  -- the code under test, straight from the samples
+  add_files(
+    "../../samples/11-instance-rendering/src/Particle.cpp",
+    "../../samples/11-instance-rendering/src/SimpleParticle.cpp",
+    "../../samples/11-instance-rendering/src/common/Mesh.cpp",
+    "../../samples/11-instance-rendering/src/common/Model.cpp",
+    "../../samples/12-cascade-shadow-mapping/src/ShadowCascades.cpp",
+    "../../samples/13-terrain/src/TerrainGeometry.cpp",
+    "../../samples/28-multi-draw-indirect/src/common/MeshOptimizer.cpp",
+    "../../samples/28-multi-draw-indirect/src/common/MeshSimplifier.cpp",
+    "../../samples/28-multi-draw-indirect/src/common/MeshletBuilder.cpp",
+    "../../samples/demo-scene-2/SoftwareOcclusionCuller.cpp")
@@ -0,0 +1,117 @@
+#include "Profiling.hpp"
+
+#ifdef TRACY_ENABLE
+
+#include <new>
+#include <unordered_map>
+
+#include <glbinding/gl/gl.h>
+
+using namespace gl;
+
+// TracyOpenGL.hpp looks for the GL headers with the preprocessor, but glbinding has no macros
+#ifndef GL_TIMESTAMP
+#define GL_TIMESTAMP gl::GL_TIMESTAMP
+#endif
+
+#include <tracy/TracyOpenGL.hpp>
+
+namespace
+{
+    struct GpuMemory
+    {
+        std::mutex mutex;
+        std::unordered_map<const void*, std::size_t> objectSizes;
+        std::unordered_map<const char*, std::int64_t> poolSizes;
+    };
+
+    GpuMemory& getGpuMemory()
+    {
+        static GpuMemory s_gpuMemory;
+
+        return s_gpuMemory;
+    }
+}
+
+namespace profiling
+{
+#ifdef __APPLE__
+    // Tracy does not support GPU zones on macOS, TracyOpenGL.hpp only defines empty macros there
+    GpuZone::GpuZone(const tracy::SourceLocationData*)
+    {
+    }
+
+    GpuZone::~GpuZone()
+    {
+    }
+#else
+    static_assert(sizeof(tracy::GpuCtxScope) <= sizeof(GpuZone), "GpuZone::m_scope is too small for tracy::GpuCtxScope");
+
+    GpuZone::GpuZone(const tracy::SourceLocationData* sourceLocation)
+    {
+        new (m_scope) tracy::GpuCtxScope(sourceLocation, true);
+    }
+
+    GpuZone::~GpuZone()
+    {
+        std::launder(reinterpret_cast<tracy::GpuCtxScope*>(m_scope))->~GpuCtxScope();
+    }
+#endif
+
+    void initGpuContext()
+    {
+        TracyGpuContext;
+    }
+
+    void collectGpuZones()
+    {
+        TracyGpuCollect;
+    }
+
+    void trackGpuAllocation(const void* object, std::size_t bytes, const char* pool)
+    {
+        auto& memory = getGpuMemory();
+
+        std::lock_guard<std::mutex> lock(memory.mutex);
+
+        auto previous = memory.objectSizes.find(object);
+
+        // the data of an object was replaced - Tracy expects every allocation to be freed before the address is reused
+        if (previous != memory.objectSizes.end())
+        {
+            TracyFreeN(object, pool);
+
+            memory.poolSizes[pool] -= static_cast<std::int64_t>(previous->second);
+        }
+
+        TracyAllocN(object, bytes, pool);
+
+        memory.objectSizes[object] = bytes;
+        memory.poolSizes[pool] += static_cast<std::int64_t>(bytes);
+
+        TracyPlot(pool, memory.poolSizes[pool]);
+    }
+
+    void trackGpuRelease(const void* object, const char* pool)
+    {
+        auto& memory = getGpuMemory();
+
+        std::lock_guard<std::mutex> lock(memory.mutex);
+
+        auto previous = memory.objectSizes.find(object);
+
+        if (previous == memory.objectSizes.end())
+        {
+            return;
+        }
+
+        TracyFreeN(object, pool);
+
+        memory.poolSizes[pool] -= static_cast<std::int64_t>(previous->second);
+        memory.objectSizes.erase(previous);
+
+        TracyPlot(pool, memory.poolSizes[pool]);
+    }
+}
+
+#endif
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include <tracy/Tracy.hpp>
+
+/**
+ * Instrumentation shared by the samples, on top of Tracy.
+ *
+ * All of it compiles to nothing unless the project is configured with -DTRACY_ENABLE=ON, so the macros can stay in the
+ * code for good:
+ *
+ *  - PROFILE_FUNCTION(), PROFILE_ZONE("name") - CPU zone until the end of the scope
+ *  - PROFILE_FRAME() - end of a frame, once per iteration of the main loop
+ *  - PROFILE_GPU_CONTEXT(), PROFILE_GPU_ZONE("name"), PROFILE_GPU_COLLECT() - GPU zones (timer queries); the context is
+ *    set up once after the GL functions are loaded, the finished zones are collected once per frame
+ *  - PROFILE_COUNTER("name", value) - a value plotted over time; the name has to stay alive until the program exits
+ *  - PROFILE_ALLOC(pointer, bytes, "pool"), PROFILE_FREE(pointer, "pool") - CPU memory, e.g. from a custom operator new
+ *  - PROFILE_GPU_ALLOC(object, bytes, "pool"), PROFILE_GPU_FREE(object, "pool") - video memory taken by an object
+ *    (a buffer or a texture); calling PROFILE_GPU_ALLOC again for the same object replaces its previous size, the total
+ *    size of every pool is plotted, too
+ *  - PROFILE_LOCKABLE(type, name, "description"), PROFILE_LOCK_TYPE(type) - a mutex which reports how long the threads
+ *    wait on it and the type to use with std::unique_lock, std::lock_guard, etc.; profiling::ConditionVariable works with both
+ */
+
+#define PROFILING_CONCAT_INDIRECT(a, b) a##b
+#define PROFILING_CONCAT(a, b) PROFILING_CONCAT_INDIRECT(a, b)
+
+#ifdef TRACY_ENABLE
+
+namespace profiling
+{
+    class GpuZone
+    {
+    public:
+        explicit GpuZone(const tracy::SourceLocationData* sourceLocation);
+
+        ~GpuZone();
+
+        GpuZone(const GpuZone&) = delete;
+
+        GpuZone& operator=(const GpuZone&) = delete;
+
+    private:
+        // tracy::GpuCtxScope; its header needs the GL functions in the global namespace, so it is only included by Profiling.cpp
+        alignas(std::max_align_t) unsigned char m_scope[16];
+    };
+
+    void initGpuContext();
+
+    void collectGpuZones();
+
+    void trackGpuAllocation(const void* object, std::size_t bytes, const char* pool);
+
+    void trackGpuRelease(const void* object, const char* pool);
+
+    using ConditionVariable = std::condition_variable_any;
+}
+
+#define PROFILE_FUNCTION() ZoneScoped
+#define PROFILE_ZONE(name) ZoneScopedN(name)
+#define PROFILE_FRAME() FrameMark
+
+#define PROFILE_GPU_CONTEXT() ::profiling::initGpuContext()
+#define PROFILE_GPU_ZONE(name) \
+    static constexpr tracy::SourceLocationData PROFILING_CONCAT(profilingGpuSourceLocation, __LINE__) { name, __FUNCTION__, __FILE__, static_cast<std::uint32_t>(__LINE__), 0 }; \
+    ::profiling::GpuZone PROFILING_CONCAT(profilingGpuZone, __LINE__)(&PROFILING_CONCAT(profilingGpuSourceLocation, __LINE__))
+#define PROFILE_GPU_COLLECT() ::profiling::collectGpuZones()
+
+#define PROFILE_COUNTER(name, value) TracyPlot(name, value)
+
+#define PROFILE_ALLOC(pointer, bytes, pool) TracyAllocN(pointer, bytes, pool)
+#define PROFILE_FREE(pointer, pool) TracyFreeN(pointer, pool)
+
+#define PROFILE_GPU_ALLOC(object, bytes, pool) ::profiling::trackGpuAllocation(object, bytes, pool)
+#define PROFILE_GPU_FREE(object, pool) ::profiling::trackGpuRelease(object, pool)
+
+#define PROFILE_LOCKABLE(type, name, description) TracyLockableN(type, name, description)
+#define PROFILE_LOCK_TYPE(type) LockableBase(type)
+
+#else
+
+namespace profiling
+{
+    using ConditionVariable = std::condition_variable;
+}
+
+#define PROFILE_FUNCTION()
+#define PROFILE_ZONE(name)
+#define PROFILE_FRAME()
+
+#define PROFILE_GPU_CONTEXT()
+#define PROFILE_GPU_ZONE(name)
+#define PROFILE_GPU_COLLECT()
+
+#define PROFILE_COUNTER(name, value)
+
+#define PROFILE_ALLOC(pointer, bytes, pool)
+#define PROFILE_FREE(pointer, pool)
+
+#define PROFILE_GPU_ALLOC(object, bytes, pool)
+#define PROFILE_GPU_FREE(object, pool)
+
+#define PROFILE_LOCKABLE(type, name, description) type name
+#define PROFILE_LOCK_TYPE(type) type
+
+#endif
@@ -0,0 +1,25 @@
+add_requires("vcpkg::glbinding", { alias = "glbinding" })
+add_requires("vcpkg::tracy", { alias = "tracy" })
+
+option("tracy_enable")
+  set_default(false)
+  set_showmenu(true)
+  set_description("Instrument the samples linking the profiling library with Tracy")
+option_end()
+
+target("profiling")
+  set_languages("cxx20")
+  set_kind("static")
+
+  add_packages("glbinding")
+  add_packages("tracy", { public = true })
+
+  add_options("tracy_enable")
+
+  if has_config("tracy_enable") then
+    add_defines("TRACY_ENABLE", { public = true })
+  end
+
+  add_includedirs("src/", { public = true })
+
+  add_files("src/Profiling.cpp")
@@ -0,0 +1,272 @@
+#include "BlockCompressor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    std::uint16_t packColor565(const float* color)
+    {
+        const auto r = static_cast<std::uint16_t>(std::clamp(std::lround(color[0] * 31.0f / 255.0f), 0l, 31l));
+        const auto g = static_cast<std::uint16_t>(std::clamp(std::lround(color[1] * 63.0f / 255.0f), 0l, 63l));
+        const auto b = static_cast<std::uint16_t>(std::clamp(std::lround(color[2] * 31.0f / 255.0f), 0l, 31l));
+
+        return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    std::array<int, 3> unpackColor565(std::uint16_t color)
+    {
+        const int r = (color >> 11) & 31;
+        const int g = (color >> 5) & 63;
+        const int b = color & 31;
+
+        return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) };
+    }
+}
+
+std::size_t BlockCompressor::getBlockSize(Format format)
+{
+    return format == Format::BC1 ? 8 : 16;
+}
+
+std::vector<std::uint8_t> BlockCompressor::compress(const std::uint8_t* pixels, unsigned int width, unsigned int height, Format format)
+{
+    const unsigned int blocksWide = (width + 3) / 4;
+    const unsigned int blocksHigh = (height + 3) / 4;
+    const auto blockSize = getBlockSize(format);
+
+    std::vector<std::uint8_t> result(blocksWide * blocksHigh * blockSize);
+
+    std::array<std::uint8_t, 16 * 4> block;
+
+    for (unsigned int blockY = 0; blockY < blocksHigh; ++blockY)
+    {
+        for (unsigned int blockX = 0; blockX < blocksWide; ++blockX)
+        {
+            // blocks hanging over the edge of the image repeat the last column / row
+            for (unsigned int y = 0; y < 4; ++y)
+            {
+                const auto sourceY = std::min(blockY * 4 + y, height - 1);
+
+                for (unsigned int x = 0; x < 4; ++x)
+                {
+                    const auto sourceX = std::min(blockX * 4 + x, width - 1);
+
+                    std::copy_n(pixels + (sourceY * width + sourceX) * 4, 4, block.data() + (y * 4 + x) * 4);
+                }
+            }
+
+            auto* output = result.data() + (blockY * blocksWide + blockX) * blockSize;
+
+            switch (format)
+            {
+                case Format::BC1:
+                    encodeColorBlock(block.data(), output);
+                    break;
+
+                case Format::BC3:
+                    encodeChannelBlock(block.data(), 3, output);
+                    encodeColorBlock(block.data(), output + 8);
+                    break;
+
+                case Format::BC5:
+                    encodeChannelBlock(block.data(), 0, output);
+                    encodeChannelBlock(block.data(), 1, output + 8);
+                    break;
+            }
+        }
+    }
+
+    return result;
+}
+
+void BlockCompressor::encodeColorBlock(const std::uint8_t* block, std::uint8_t* output)
+{
+    float mean[3] = { 0.0f, 0.0f, 0.0f };
+
+    for (unsigned int i = 0; i < 16; ++i)
+    {
+        for (unsigned int c = 0; c < 3; ++c)
+        {
+            mean[c] += block[i * 4 + c] / 16.0f;
+        }
+    }
+
+    float covariance[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+    for (unsigned int i = 0; i < 16; ++i)
+    {
+        const float r = block[i * 4 + 0] - mean[0];
+        const float g = block[i * 4 + 1] - mean[1];
+        const float b = block[i * 4 + 2] - mean[2];
+
+        covariance[0] += r * r;
+        covariance[1] += r * g;
+        covariance[2] += r * b;
+        covariance[3] += g * g;
+        covariance[4] += g * b;
+        covariance[5] += b * b;
+    }
+
+    // principal axis of the colors, a few power iterations are plenty for a 3x3 matrix
+    float axis[3] = { 1.0f, 1.0f, 1.0f };
+
+    for (unsigned int iteration = 0; iteration < 4; ++iteration)
+    {
+        const float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+        const float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+        const float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+
+        const float length = std::max({ std::abs(x), std::abs(y), std::abs(z) });
+
+        if (length < std::numeric_limits<float>::epsilon())
+        {
+            break;
+        }
+
+        axis[0] = x / length;
+        axis[1] = y / length;
+        axis[2] = z / length;
+    }
+
+    float minProjection = std::numeric_limits<float>::max();
+    float maxProjection = std::numeric_limits<float>::lowest();
+    unsigned int minIndex = 0;
+    unsigned int maxIndex = 0;
+
+    for (unsigned int i = 0; i < 16; ++i)
+    {
+        const float projection = block[i * 4 + 0] * axis[0] + block[i * 4 + 1] * axis[1] + block[i * 4 + 2] * axis[2];
+
+        if (projection < minProjection)
+        {
+            minProjection = projection;
+            minIndex = i;
+        }
+
+        if (projection > maxProjection)
+        {
+            maxProjection = projection;
+            maxIndex = i;
+        }
+    }
+
+    const float maxColor[3] = { static_cast<float>(block[maxIndex * 4 + 0]), static_cast<float>(block[maxIndex * 4 + 1]), static_cast<float>(block[maxIndex * 4 + 2]) };
+    const float minColor[3] = { static_cast<float>(block[minIndex * 4 + 0]), static_cast<float>(block[minIndex * 4 + 1]), static_cast<float>(block[minIndex * 4 + 2]) };
+
+    auto color0 = packColor565(maxColor);
+    auto color1 = packColor565(minColor);
+
+    // color0 > color1 selects the four-color mode (no transparent texel)
+    if (color0 < color1)
+    {
+        std::swap(color0, color1);
+    }
+
+    std::uint32_t indices = 0;
+
+    if (color0 != color1)
+    {
+        const auto endpoint0 = unpackColor565(color0);
+        const auto endpoint1 = unpackColor565(color1);
+
+        std::array<std::array<int, 3>, 4> palette;
+        palette[0] = endpoint0;
+        palette[1] = endpoint1;
+
+        for (unsigned int c = 0; c < 3; ++c)
+        {
+            palette[2][c] = (2 * endpoint0[c] + endpoint1[c]) / 3;
+            palette[3][c] = (endpoint0[c] + 2 * endpoint1[c]) / 3;
+        }
+
+        for (unsigned int i = 0; i < 16; ++i)
+        {
+            unsigned int bestIndex = 0;
+            int bestDistance = std::numeric_limits<int>::max();
+
+            for (unsigned int p = 0; p < 4; ++p)
+            {
+                const int dr = block[i * 4 + 0] - palette[p][0];
+                const int dg = block[i * 4 + 1] - palette[p][1];
+                const int db = block[i * 4 + 2] - palette[p][2];
+
+                const int distance = dr * dr + dg * dg + db * db;
+
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    bestIndex = p;
+                }
+            }
+
+            indices |= bestIndex << (i * 2);
+        }
+    }
+
+    output[0] = static_cast<std::uint8_t>(color0 & 0xff);
+    output[1] = static_cast<std::uint8_t>(color0 >> 8);
+    output[2] = static_cast<std::uint8_t>(color1 & 0xff);
+    output[3] = static_cast<std::uint8_t>(color1 >> 8);
+
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        output[4 + i] = static_cast<std::uint8_t>((indices >> (i * 8)) & 0xff);
+    }
+}
+
+void BlockCompressor::encodeChannelBlock(const std::uint8_t* block, unsigned int channel, std::uint8_t* output)
+{
+    std::uint8_t minValue = 255;
+    std::uint8_t maxValue = 0;
+
+    for (unsigned int i = 0; i < 16; ++i)
+    {
+        minValue = std::min(minValue, block[i * 4 + channel]);
+        maxValue = std::max(maxValue, block[i * 4 + channel]);
+    }
+
+    // value0 > value1 selects the eight-value mode
+    output[0] = maxValue;
+    output[1] = minValue;
+
+    std::uint64_t indices = 0;
+
+    if (maxValue != minValue)
+    {
+        std::array<int, 8> palette;
+        palette[0] = maxValue;
+        palette[1] = minValue;
+
+        for (unsigned int p = 1; p < 7; ++p)
+        {
+            palette[p + 1] = ((7 - p) * maxValue + p * minValue) / 7;
+        }
+
+        for (unsigned int i = 0; i < 16; ++i)
+        {
+            unsigned int bestIndex = 0;
+            int bestDistance = std::numeric_limits<int>::max();
+
+            for (unsigned int p = 0; p < 8; ++p)
+            {
+                const int distance = std::abs(block[i * 4 + channel] - palette[p]);
+
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    bestIndex = p;
+                }
+            }
+
+            indices |= static_cast<std::uint64_t>(bestIndex) << (i * 3);
+        }
+    }
+
+    for (unsigned int i = 0; i < 6; ++i)
+    {
+        output[2 + i] = static_cast<std::uint8_t>((indices >> (i * 8)) & 0xff);
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Encodes RGBA8 images into GPU block-compressed formats (4x4 texel blocks).
+ *
+ * The encoder fits the block endpoints along the principal axis of the block colors - it is nowhere near as good as
+ * the exhaustive encoders, but it is fast and good enough for the sample assets.
+ */
+class BlockCompressor
+{
+public:
+    enum class Format
+    {
+        // RGB, 1-bit alpha is not used; 8 bytes per block
+        BC1,
+        // BC1 color + interpolated alpha; 16 bytes per block
+        BC3,
+        // two interpolated channels (R and G), for tangent-space normal maps; 16 bytes per block
+        BC5,
+    };
+
+    static std::size_t getBlockSize(Format format);
+
+    // pixels are tightly packed RGBA8 rows; returns the blocks row by row
+    static std::vector<std::uint8_t> compress(const std::uint8_t* pixels, unsigned int width, unsigned int height, Format format);
+
+private:
+    // block is 16 RGBA8 texels
+    static void encodeColorBlock(const std::uint8_t* block, std::uint8_t* output);
+
+    // block is 16 RGBA8 texels, only one channel of which is encoded
+    static void encodeChannelBlock(const std::uint8_t* block, unsigned int channel, std::uint8_t* output);
+};
@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+#include "BlockCompressor.hpp"
+
+/**
+ * Converts the images in the given media directories (or the given image files) into block-compressed DDS textures
+ * with precomputed mip chains, so the samples can upload them straight away with glCompressedTexImage2D.
+ *
+ * Every `<name>.<ext>` gets a `<name>.<ext>.dds` in the output directory (next to the image when there is none); the
+ * samples look for that file first and fall back to the original image. Images are stored bottom row first, the way
+ * OpenGL expects them (the samples flip the source images with `sf::Image::flipVertically()` for the same reason).
+ *
+ * Usage: texture-cooker [--output <directory>] <directory or image>...
+ */
+
+struct DdsPixelFormat
+{
+    std::uint32_t size;
+    std::uint32_t flags;
+    std::uint32_t fourCC;
+    std::uint32_t rgbBitCount;
+    std::uint32_t redBitMask;
+    std::uint32_t greenBitMask;
+    std::uint32_t blueBitMask;
+    std::uint32_t alphaBitMask;
+};
+
+struct DdsHeader
+{
+    std::uint32_t size;
+    std::uint32_t flags;
+    std::uint32_t height;
+    std::uint32_t width;
+    std::uint32_t pitchOrLinearSize;
+    std::uint32_t depth;
+    std::uint32_t mipMapCount;
+    std::uint32_t reserved1[11];
+    DdsPixelFormat pixelFormat;
+    std::uint32_t caps;
+    std::uint32_t caps2;
+    std::uint32_t caps3;
+    std::uint32_t caps4;
+    std::uint32_t reserved2;
+};
+
+static_assert(sizeof(DdsHeader) == 124, "DDS header has to be exactly 124 bytes");
+
+constexpr std::uint32_t makeFourCC(char a, char b, char c, char d)
+{
+    return static_cast<std::uint32_t>(a) | (static_cast<std::uint32_t>(b) << 8) | (static_cast<std::uint32_t>(c) << 16) | (static_cast<std::uint32_t>(d) << 24);
+}
+
+struct MipLevel
+{
+    unsigned int width;
+    unsigned int height;
+    std::vector<std::uint8_t> pixels;
+};
+
+std::vector<MipLevel> buildMipChain(const sf::Image& image)
+{
+    std::vector<MipLevel> mipLevels;
+
+    mipLevels.push_back({
+        .width = image.getSize().x,
+        .height = image.getSize().y,
+        .pixels = std::vector<std::uint8_t>(image.getPixelsPtr(), image.getPixelsPtr() + image.getSize().x * image.getSize().y * 4)
+    });
+
+    // box filter, down to 1x1; odd dimensions clamp to the last column / row
+    while (mipLevels.back().width > 1 || mipLevels.back().height > 1)
+    {
+        const auto& source = mipLevels.back();
+
+        MipLevel target {
+            .width = std::max(source.width / 2, 1u),
+            .height = std::max(source.height / 2, 1u)
+        };
+
+        target.pixels.resize(target.width * target.height * 4);
+
+        for (unsigned int y = 0; y < target.height; ++y)
+        {
+            const auto y0 = std::min(y * 2, source.height - 1);
+            const auto y1 = std::min(y * 2 + 1, source.height - 1);
+
+            for (unsigned int x = 0; x < target.width; ++x)
+            {
+                const auto x0 = std::min(x * 2, source.width - 1);
+                const auto x1 = std::min(x * 2 + 1, source.width - 1);
+
+                for (unsigned int channel = 0; channel < 4; ++channel)
+                {
+                    const unsigned int sum =
+                        source.pixels[(y0 * source.width + x0) * 4 + channel] +
+                        source.pixels[(y0 * source.width + x1) * 4 + channel] +
+                        source.pixels[(y1 * source.width + x0) * 4 + channel] +
+                        source.pixels[(y1 * source.width + x1) * 4 + channel];
+
+                    target.pixels[(y * target.width + x) * 4 + channel] = static_cast<std::uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+
+        mipLevels.push_back(std::move(target));
+    }
+
+    return mipLevels;
+}
+
+BlockCompressor::Format chooseFormat(const std::filesystem::path& path, const sf::Image& image)
+{
+    auto name = path.filename().string();
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    // BC5 keeps only the red and green channels, blue reads as zero - the shaders sampling these have to rebuild it
+    // (see 26-raymarching/media/deferred-rendering-pre-pass.frag)
+    if (name.find("normal") != std::string::npos)
+    {
+        return BlockCompressor::Format::BC5;
+    }
+
+    const auto* pixels = image.getPixelsPtr();
+    const auto pixelCount = image.getSize().x * image.getSize().y;
+
+    for (unsigned int i = 0; i < pixelCount; ++i)
+    {
+        if (pixels[i * 4 + 3] < 255)
+        {
+            return BlockCompressor::Format::BC3;
+        }
+    }
+
+    return BlockCompressor::Format::BC1;
+}
+
+bool writeDds(const std::filesystem::path& path, const std::vector<MipLevel>& mipLevels, BlockCompressor::Format format)
+{
+    DdsHeader header {};
+
+    header.size = sizeof(DdsHeader);
+    // DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE
+    header.flags = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000;
+    header.width = mipLevels.front().width;
+    header.height = mipLevels.front().height;
+    header.mipMapCount = static_cast<std::uint32_t>(mipLevels.size());
+
+    header.pixelFormat.size = sizeof(DdsPixelFormat);
+    // DDPF_FOURCC
+    header.pixelFormat.flags = 0x4;
+
+    switch (format)
+    {
+        case BlockCompressor::Format::BC1:
+            header.pixelFormat.fourCC = makeFourCC('D', 'X', 'T', '1');
+            break;
+
+        case BlockCompressor::Format::BC3:
+            header.pixelFormat.fourCC = makeFourCC('D', 'X', 'T', '5');
+            break;
+
+        case BlockCompressor::Format::BC5:
+            header.pixelFormat.fourCC = makeFourCC('A', 'T', 'I', '2');
+            break;
+    }
+
+    // DDSCAPS_COMPLEX | DDSCAPS_TEXTURE | DDSCAPS_MIPMAP
+    header.caps = 0x8 | 0x1000 | 0x400000;
+
+    std::vector<std::vector<std::uint8_t>> levels;
+
+    for (const auto& mipLevel : mipLevels)
+    {
+        levels.push_back(BlockCompressor::compress(mipLevel.pixels.data(), mipLevel.width, mipLevel.height, format));
+    }
+
+    header.pitchOrLinearSize = static_cast<std::uint32_t>(levels.front().size());
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+    const auto magic = makeFourCC('D', 'D', 'S', ' ');
+
+    file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const auto& level : levels)
+    {
+        file.write(reinterpret_cast<const char*>(level.data()), static_cast<std::streamsize>(level.size()));
+    }
+
+    return static_cast<bool>(file);
+}
+
+bool isSourceImage(const std::filesystem::path& path)
+{
+    auto extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    // DDS files are left alone - SFML can not decode them, and those which exist are already authored by hand
+    return extension == ".png" || extension == ".bmp" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga";
+}
+
+bool cook(const std::filesystem::path& sourcePath, const std::filesystem::path& outputDirectory)
+{
+    auto targetPath = outputDirectory.empty() ? sourcePath : outputDirectory / sourcePath.filename();
+    targetPath += ".dds";
+
+    std::error_code error;
+
+    if (std::filesystem::exists(targetPath, error) && std::filesystem::last_write_time(targetPath, error) >= std::filesystem::last_write_time(sourcePath, error))
+    {
+        std::cout << "[INFO] " << targetPath << " is up to date" << std::endl;
+        return true;
+    }
+
+    std::cout << "[INFO] Cooking " << sourcePath << "...";
+
+    sf::Image image;
+
+    if (!image.loadFromFile(sourcePath.string()))
+    {
+        std::cerr << "[ERROR] Can not load image " << sourcePath << std::endl;
+        return false;
+    }
+
+    if (image.getSize().x == 0 || image.getSize().y == 0)
+    {
+        std::cerr << "[ERROR] Image " << sourcePath << " is empty" << std::endl;
+        return false;
+    }
+
+    image.flipVertically();
+
+    const auto format = chooseFormat(sourcePath, image);
+
+    if (!writeDds(targetPath, buildMipChain(image), format))
+    {
+        std::cerr << "[ERROR] Can not write " << targetPath << std::endl;
+        return false;
+    }
+
+    std::cout << "done" << std::endl;
+
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    std::filesystem::path outputDirectory;
+
+    int firstInput = 1;
+
+    if (argc > 2 && std::string(argv[1]) == "--output")
+    {
+        outputDirectory = argv[2];
+        firstInput = 3;
+    }
+
+    if (argc <= firstInput)
+    {
+        std::cerr << "Usage: " << argv[0] << " [--output <directory>] <directory or image>..." << std::endl;
+        return 1;
+    }
+
+    if (!outputDirectory.empty())
+    {
+        std::error_code error;
+        std::filesystem::create_directories(outputDirectory, error);
+
+        if (error)
+        {
+            std::cerr << "[ERROR] Can not create output directory " << outputDirectory << ": " << error.message() << std::endl;
+            return 1;
+        }
+    }
+
+    bool isSuccessful = true;
+
+    for (int i = firstInput; i < argc; ++i)
+    {
+        const std::filesystem::path path(argv[i]);
+
+        if (std::filesystem::is_directory(path))
+        {
+            for (const auto& entry : std::filesystem::directory_iterator(path))
+            {
+                if (entry.is_regular_file() && isSourceImage(entry.path()))
+                {
+                    isSuccessful &= cook(entry.path(), outputDirectory);
+                }
+            }
+        }
+        else if (isSourceImage(path))
+        {
+            isSuccessful &= cook(path, outputDirectory);
+        }
+        else
+        {
+            std::cerr << "[ERROR] " << path << " is neither a directory nor a supported image" << std::endl;
+            isSuccessful = false;
+        }
+    }
+
+    return isSuccessful ? 0 : 1;
+}
@@ -0,0 +1,16 @@
+add_requires("sfml ~2.5.1", { alias = "sfml" })
+
+target("texture-cooker")
+  set_languages("cxx20")
+  set_kind("binary")
+
+  add_includedirs("src/")
+
+  add_packages("sfml")
+
+  if is_plat("macosx") then
+    -- this prevents linker errors
+    add_frameworks("Foundation", "OpenGL", "IOKit", "Cocoa", "Carbon")
+  end
+
+  add_files("src/main.cpp", "src/BlockCompressor.cpp")
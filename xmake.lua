@@ -33,3 +33,10 @@ includes("samples/28-multi-draw-indirect/xmake.lua")
 includes("samples/demo-scene-1/xmake.lua")
 -- includes("samples/demo-scene-2/xmake.lua")
 includes("samples/demo-scene-3/xmake.lua")
+
+includes("tools/profiling/xmake.lua")
+includes("tools/benchmark-harness/xmake.lua")
+includes("tools/input-recording/xmake.lua")
+includes("tools/frame-arena/xmake.lua")
+includes("tools/texture-cooker/xmake.lua")
+includes("tools/micro-benchmarks/xmake.lua")